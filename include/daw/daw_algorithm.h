@@ -12,10 +12,13 @@
 #include "daw_do_n.h"
 #include "daw_enable_if.h"
 #include "daw_exception.h"
+#include "daw_execution_policy.h"
+#include "daw_is_constant_evaluated.h"
 #include "daw_move.h"
 #include "daw_swap.h"
 #include "daw_traits.h"
 #include "daw_view.h"
+#include "impl/daw_algorithm_simd.h"
 #include "impl/daw_math_impl.h"
 
 #include <algorithm>
@@ -25,6 +28,7 @@
 #include <iterator>
 #include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -290,6 +294,14 @@ namespace daw::algorithm {
 	template<class InputIterator, class T>
 	constexpr InputIterator find( InputIterator first, InputIterator last,
 	                              T const &value ) {
+		if constexpr( algorithm_simd_impl::is_simd_range_v<InputIterator> and
+		              std::is_same_v<T, simd_impl::iter_value_t<InputIterator>> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and first != last ) {
+				auto const size = static_cast<std::size_t>( last - first );
+				return first + static_cast<std::ptrdiff_t>( algorithm_simd_impl::find(
+				                 simd_impl::to_pointer( first ), size, value ) );
+			}
+		}
 		for( ; first != last; ++first ) {
 			if( *first == value ) {
 				return first;
@@ -336,7 +348,7 @@ namespace daw::algorithm {
 		traits::is_input_iterator_test<ForwardIterator>( );
 		traits::is_unary_predicate_test<UnaryPredicate, decltype( *first )>( );
 
-		first = find_if_not( first, last, unary_predicate );
+		first = daw::algorithm::find_if_not( first, last, unary_predicate );
 		if( first == last ) {
 			return first;
 		}
@@ -994,6 +1006,19 @@ namespace daw::algorithm {
 		traits::is_compare_test<Compare, decltype( *first2 ),
 		                        decltype( *first1 )>( );
 
+		if constexpr( algorithm_simd_impl::is_simd_pair_v<
+		                InputIterator1, LastType1, InputIterator2, LastType2> and
+		              algorithm_simd_impl::is_less_v<
+		                Compare, simd_impl::iter_value_t<InputIterator1>> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and first1 != last1 and
+			    first2 != last2 ) {
+				return algorithm_simd_impl::lexicographical_compare(
+				  simd_impl::to_pointer( first1 ),
+				  static_cast<std::size_t>( last1 - first1 ),
+				  simd_impl::to_pointer( first2 ),
+				  static_cast<std::size_t>( last2 - first2 ) );
+			}
+		}
 		while( ( first1 != last1 ) and ( first2 != last2 ) ) {
 			if( daw::invoke( comp, *first1, *first2 ) ) {
 				return true;
@@ -1117,6 +1142,18 @@ namespace daw::algorithm {
 		                                decltype( unary_op( *first ) )>( );
 
 		if constexpr( traits::is_callable_v<UnaryOperation, decltype( *first )> ) {
+			if constexpr( algorithm_simd_impl::is_simd_transform_v<
+			                InputIterator, OutputIterator> ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) and count > 0 ) {
+					if( algorithm_simd_impl::transform(
+					      simd_impl::to_pointer( first ),
+					      simd_impl::to_pointer( first_out ), count, unary_op ) ) {
+						first += static_cast<std::ptrdiff_t>( count );
+						first_out += static_cast<std::ptrdiff_t>( count );
+						count = 0;
+					}
+				}
+			}
 			while( count-- > 0 ) {
 				*first_out = unary_op( *first );
 				++first;
@@ -1376,6 +1413,21 @@ namespace daw::algorithm {
 		traits::is_compare_test<Compare, decltype( *first1 ),
 		                        decltype( *first2 )>( );
 
+		if constexpr( algorithm_simd_impl::is_simd_pair_v<
+		                InputIterator1, LastType1, InputIterator2, LastType2> and
+		              algorithm_simd_impl::is_equal_to_v<
+		                Compare, simd_impl::iter_value_t<InputIterator1>> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and first1 != last1 and
+			    first2 != last2 ) {
+				auto const size = static_cast<std::size_t>( last1 - first1 );
+				if( size != static_cast<std::size_t>( last2 - first2 ) ) {
+					return false;
+				}
+				return algorithm_simd_impl::mismatch(
+				         simd_impl::to_pointer( first1 ),
+				         simd_impl::to_pointer( first2 ), size ) == size;
+			}
+		}
 		while( ( first1 != last1 ) and ( first2 != last2 ) and
 		       daw::invoke( comp, *first1, *first2 ) ) {
 			++first1;
@@ -1432,6 +1484,15 @@ namespace daw::algorithm {
 		traits::is_input_iterator_test<InputIterator1>( );
 		traits::is_input_iterator_test<InputIterator2>( );
 
+		if constexpr( algorithm_simd_impl::is_simd_pair_v<
+		                InputIterator1, LastType, InputIterator2, InputIterator2> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and first1 != last1 ) {
+				auto const size = static_cast<std::size_t>( last1 - first1 );
+				return algorithm_simd_impl::mismatch(
+				         simd_impl::to_pointer( first1 ),
+				         simd_impl::to_pointer( first2 ), size ) == size;
+			}
+		}
 		while( first1 != last1 and std::equal_to<>{ }( *first1, *first2 ) ) {
 			++first1;
 			++first2;
@@ -1775,6 +1836,13 @@ namespace daw::algorithm {
 	template<typename InputIterator, typename T>
 	constexpr T accumulate( InputIterator first, InputIterator last,
 	                        T init ) noexcept {
+		if constexpr( algorithm_simd_impl::is_simd_sum_v<InputIterator, T> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and first != last ) {
+				return algorithm_simd_impl::accumulate(
+				  simd_impl::to_pointer( first ),
+				  static_cast<std::size_t>( last - first ), init );
+			}
+		}
 		for( ; first != last; ++first ) {
 			init = daw::move( init ) + *first;
 		}
@@ -1812,6 +1880,15 @@ static_assert(
 	"http://en.cppreference.com/w/cpp/concept/Iterator" );
 	*/
 
+		if constexpr( std::is_same_v<InputIterator, LastType> and
+		              algorithm_simd_impl::is_simd_sum_v<InputIterator, T> and
+		              algorithm_simd_impl::is_plus_v<BinaryOperation, T> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and first != last ) {
+				return algorithm_simd_impl::accumulate(
+				  simd_impl::to_pointer( first ),
+				  static_cast<std::size_t>( last - first ), init );
+			}
+		}
 		while( first != last ) {
 			init = daw::invoke( binary_op, daw::move( init ), *first );
 			++first;
@@ -1876,6 +1953,23 @@ static_assert(
 		if( not( first != last ) ) {
 			return result;
 		}
+		if constexpr( std::is_same_v<ForwardIterator, LastType> and
+		              algorithm_simd_impl::is_simd_minmax_v<ForwardIterator> and
+		              algorithm_simd_impl::is_less_v<
+		                Compare, simd_impl::iter_value_t<ForwardIterator>> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) ) {
+				auto const pos = algorithm_simd_impl::minmax_element(
+				  simd_impl::to_pointer( first ),
+				  static_cast<std::size_t>( last - first ) );
+				if( pos ) {
+					result.min_element =
+					  first + static_cast<std::ptrdiff_t>( pos->first );
+					result.max_element =
+					  first + static_cast<std::ptrdiff_t>( pos->second );
+					return result;
+				}
+			}
+		}
 		++first;
 		if( not( first != last ) ) {
 			return result;
@@ -2024,8 +2118,43 @@ static_assert(
 		}
 	};
 
+	namespace algorithm_details {
+		// When every iterator is random access the ranges can be walked with a
+		// single index, which the compiler can vectorize and policies can split
+		template<typename Iterator1, typename LastType, typename... Iterators>
+		inline constexpr bool is_indexable_v =
+		  std::is_same_v<Iterator1, LastType> and
+		  ( traits::is_random_access_iterator_v<Iterator1> and ... and
+		    traits::is_random_access_iterator_v<Iterators> );
+
+		template<typename Outputs, typename Result, std::size_t... Is>
+		constexpr void assign_soa( Outputs &outs, std::size_t n, Result &&result,
+		                           std::index_sequence<Is...> ) {
+			( (void)( execution_impl::at( std::get<Is>( outs ), n ) =
+			            std::get<Is>( std::forward<Result>( result ) ) ),
+			  ... );
+		}
+
+		template<typename... OutputIterators>
+		constexpr std::tuple<OutputIterators...>
+		advance_soa( std::tuple<OutputIterators...> const &outs,
+		             std::size_t n ) {
+			return std::apply(
+			  [n]( auto const &...out ) {
+				  return std::tuple<OutputIterators...>(
+				    execution_impl::advance( out, n )... );
+			  },
+			  outs );
+		}
+	} // namespace algorithm_details
+
+	/// @brief Call func with the elements at the same position in [first1,
+	/// last1) and the ranges starting at its..., writing each result to out_it
+	/// @return end of output range
 	template<typename Function, typename Iterator1, typename LastType,
-	         typename OutputIterator, typename... Iterators>
+	         typename OutputIterator, typename... Iterators,
+	         daw::enable_when_t<
+	           not execution::is_execution_policy_v<Function>> = nullptr>
 	constexpr OutputIterator
 	cartesian_product_map( Function func, Iterator1 first1, LastType last1,
 	                       OutputIterator out_it, Iterators... its ) {
@@ -2033,6 +2162,17 @@ static_assert(
 		static_assert(
 		  std::is_invocable_v<Function, decltype( *first1 ), decltype( *its )...>,
 		  "Function must be invokable with dereferenced iterators" );
+		if constexpr( algorithm_details::is_indexable_v<Iterator1, LastType,
+		                                                OutputIterator,
+		                                                Iterators...> ) {
+			auto const size = static_cast<std::size_t>( last1 - first1 );
+			for( std::size_t n = 0; n < size; ++n ) {
+				execution_impl::at( out_it, n ) =
+				  daw::invoke( func, execution_impl::at( first1, n ),
+				               execution_impl::at( its, n )... );
+			}
+			return execution_impl::advance( out_it, size );
+		}
 		while( first1 != last1 ) {
 			// std invoke isn't constexpr
 			*out_it = daw::invoke( func, *first1, *its... );
@@ -2084,7 +2224,9 @@ static_assert(
 	}
 
 	template<typename Function, typename Iterator1, typename LastType,
-	         typename... Iterators>
+	         typename... Iterators,
+	         daw::enable_when_t<
+	           not execution::is_execution_policy_v<Function>> = nullptr>
 	constexpr void cartesian_product( Function func, Iterator1 first1,
 	                                  LastType last1, Iterators... its ) {
 
@@ -2092,6 +2234,15 @@ static_assert(
 		  std::is_invocable_v<Function, decltype( *first1 ), decltype( *its )...>,
 		  "Function must be invokable with dereferenced iterators" );
 
+		if constexpr( algorithm_details::is_indexable_v<Iterator1, LastType,
+		                                                Iterators...> ) {
+			auto const size = static_cast<std::size_t>( last1 - first1 );
+			for( std::size_t n = 0; n < size; ++n ) {
+				daw::invoke( func, execution_impl::at( first1, n ),
+				             execution_impl::at( its, n )... );
+			}
+			return;
+		}
 		while( first1 != last1 ) {
 			// std invoke isn't constexpr
 			daw::invoke( func, *first1, *its... );
@@ -2099,6 +2250,40 @@ static_assert(
 		}
 	}
 
+	/// @brief As cartesian_product_map, but func returns a tuple like value
+	/// whose I'th element is written to the I'th iterator of outs.  This
+	/// produces the results in a structure of arrays layout.  All iterators
+	/// must be random access
+	/// @return end of each output range
+	template<typename Function, typename RandomIterator1,
+	         typename... OutputIterators, typename... RandomIterators,
+	         daw::enable_when_t<
+	           not execution::is_execution_policy_v<Function>> = nullptr>
+	constexpr std::tuple<OutputIterators...>
+	cartesian_product_map_soa( Function func, RandomIterator1 first1,
+	                           RandomIterator1 last1,
+	                           std::tuple<OutputIterators...> outs,
+	                           RandomIterators... its ) {
+		static_assert(
+		  algorithm_details::is_indexable_v<RandomIterator1, RandomIterator1,
+		                                    OutputIterators..., RandomIterators...>,
+		  "All iterators must be random access" );
+		static_assert(
+		  std::tuple_size_v<daw::remove_cvref_t<std::invoke_result_t<
+		    Function, decltype( *first1 ), decltype( *its )...>>> ==
+		    sizeof...( OutputIterators ),
+		  "Function must return a tuple with an element for each output" );
+		auto const size = static_cast<std::size_t>( last1 - first1 );
+		for( std::size_t n = 0; n < size; ++n ) {
+			algorithm_details::assign_soa(
+			  outs, n,
+			  daw::invoke( func, execution_impl::at( first1, n ),
+			               execution_impl::at( its, n )... ),
+			  std::index_sequence_for<OutputIterators...>{ } );
+		}
+		return algorithm_details::advance_soa( outs, size );
+	}
+
 	template<typename InputIterator, typename OutputIterator,
 	         typename BinaryOperator = std::plus<>>
 	constexpr OutputIterator
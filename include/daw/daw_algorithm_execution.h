@@ -0,0 +1,563 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "cpp_17.h"
+#include "daw_algorithm.h"
+#include "daw_container_algorithm.h"
+#include "daw_enable_if.h"
+#include "daw_execution_policy.h"
+#include "daw_move.h"
+#include "daw_swap.h"
+#include "daw_traits.h"
+#include "parallel/daw_sort.h"
+#include "parallel/daw_thread_pool.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/***
+ * The daw::algorithm and daw::container overloads taking an execution policy
+ * from daw_execution_policy.h as their first argument.  They are kept out of
+ * daw_algorithm.h and daw_container_algorithm.h so that those do not pull in
+ * the thread pool
+ */
+namespace daw::execution_impl {
+	template<typename ExecutionPolicy>
+	[[nodiscard]] thread_pool &get_pool( ExecutionPolicy const &policy ) {
+		if( policy.pool ) {
+			return *policy.pool;
+		}
+		return default_thread_pool( );
+	}
+
+	/***
+	 * @return how many chunks to split size items into for policy.  Each gets
+	 * at least min_chunk_size items and each thread a few chunks
+	 */
+	template<typename ExecutionPolicy>
+	[[nodiscard]] std::size_t chunk_count( ExecutionPolicy const &policy,
+	                                       std::size_t size ) {
+		if constexpr( std::is_same_v<ExecutionPolicy,
+		                             execution::sequenced_policy> ) {
+			(void)policy;
+			(void)size;
+			return 1;
+		} else {
+			return std::max(
+			  std::min( size / min_chunk_size, get_pool( policy ).size( ) * 4U ),
+			  std::size_t{ 1 } );
+		}
+	}
+
+	/***
+	 * Call func( chunk, first, last ) for each of the chunks evenly sized parts
+	 * of [0, size), in parallel unless there is only one
+	 */
+	template<typename ExecutionPolicy, typename Function>
+	void for_each_chunk( ExecutionPolicy const &policy, std::size_t size,
+	                     std::size_t chunks, Function &&func ) {
+		auto const run = [&]( std::size_t n ) {
+			func( n, ( size * n ) / chunks, ( size * ( n + 1U ) ) / chunks );
+		};
+		if( chunks <= 1 ) {
+			run( 0 );
+			return;
+		}
+		if constexpr( not std::is_same_v<ExecutionPolicy,
+		                                 execution::sequenced_policy> ) {
+			get_pool( policy ).for_each_index( chunks, run );
+		}
+	}
+} // namespace daw::execution_impl
+
+namespace daw::algorithm {
+	/// @brief Transform [first, last) to [first_out, first_out +
+	/// std::distance( first, last )) using policy.  With par or par_unseq and
+	/// random access iterators, chunks of the range run on a daw::thread_pool
+	/// @param policy one of daw::execution::seq, par, or par_unseq
+	/// @return end of output range
+	template<typename ExecutionPolicy, typename InputIterator,
+	         typename OutputIterator, typename UnaryOperation,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	OutputIterator transform( ExecutionPolicy &&policy, InputIterator first,
+	                          InputIterator last, OutputIterator first_out,
+	                          UnaryOperation unary_op ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<policy_t, InputIterator,
+		                                            OutputIterator> ) {
+			auto const size = static_cast<std::size_t>( last - first );
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  execution_impl::loop<policy_t>(
+				    chunk_first, chunk_last, [&]( std::size_t n ) {
+					    execution_impl::at( first_out, n ) =
+					      daw::invoke( unary_op, execution_impl::at( first, n ) );
+				    } );
+			  } );
+			return execution_impl::advance( first_out, size );
+		} else {
+			(void)policy;
+			return daw::algorithm::transform( first, last, first_out,
+			                                  daw::move( unary_op ) );
+		}
+	}
+
+	/// @brief Copy [first, last) to [first_out, first_out + std::distance(
+	/// first, last )) using policy
+	/// @return end of output range
+	template<typename ExecutionPolicy, typename InputIterator,
+	         typename OutputIterator,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	OutputIterator copy( ExecutionPolicy &&policy, InputIterator first,
+	                     InputIterator last, OutputIterator first_out ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<policy_t, InputIterator,
+		                                            OutputIterator> ) {
+			auto const size = static_cast<std::size_t>( last - first );
+			// std::copy uses memmove on trivially copyable contiguous ranges
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  std::copy( execution_impl::advance( first, chunk_first ),
+				             execution_impl::advance( first, chunk_last ),
+				             execution_impl::advance( first_out, chunk_first ) );
+			  } );
+			return execution_impl::advance( first_out, size );
+		} else {
+			(void)policy;
+			return daw::algorithm::copy( first, last, first_out );
+		}
+	}
+
+	/// @brief Assign value to each element of [first, last) using policy
+	template<typename ExecutionPolicy, typename ForwardIterator, typename T,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	void fill( ExecutionPolicy &&policy, ForwardIterator first,
+	           ForwardIterator last, T const &value ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<policy_t, ForwardIterator> ) {
+			auto const size = static_cast<std::size_t>( last - first );
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  std::fill( execution_impl::advance( first, chunk_first ),
+				             execution_impl::advance( first, chunk_last ), value );
+			  } );
+		} else {
+			(void)policy;
+			daw::algorithm::fill( first, last, value );
+		}
+	}
+
+	/// @brief Reduce [first, last) with binary_op starting at init, using
+	/// policy.  As with std::reduce, binary_op must be associative and
+	/// commutative for the result not to depend on how the range is split
+	/// @return init combined with each element
+	template<typename ExecutionPolicy, typename RandomIterator, typename T,
+	         typename BinaryOperation,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	T reduce( ExecutionPolicy &&policy, RandomIterator first,
+	          RandomIterator last, T init, BinaryOperation binary_op ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<policy_t, RandomIterator> ) {
+			auto const size = static_cast<std::size_t>( last - first );
+			auto const chunks = execution_impl::chunk_count( policy, size );
+			if( chunks > 1 ) {
+				// Each chunk starts from its first element, so no identity value
+				// is needed
+				auto partial = std::vector<std::optional<T>>( chunks );
+				execution_impl::for_each_chunk(
+				  policy, size, chunks,
+				  [&]( std::size_t chunk, std::size_t chunk_first,
+				       std::size_t chunk_last ) {
+					  auto sum = T( execution_impl::at( first, chunk_first ) );
+					  for( std::size_t n = chunk_first + 1U; n < chunk_last; ++n ) {
+						  sum = daw::invoke( binary_op, daw::move( sum ),
+						                     execution_impl::at( first, n ) );
+					  }
+					  partial[chunk] = daw::move( sum );
+				  } );
+				for( auto &sum : partial ) {
+					init = daw::invoke( binary_op, daw::move( init ), daw::move( *sum ) );
+				}
+				return init;
+			}
+		}
+		(void)policy;
+		return daw::algorithm::reduce( first, last, daw::move( init ),
+		                               daw::move( binary_op ) );
+	}
+
+	namespace algorithm_details {
+		// A run of positions [first, last) in a range being partitioned
+		struct partition_run {
+			std::size_t first;
+			std::size_t last;
+		};
+
+		// The run index and position of the n'th element of runs
+		inline std::pair<std::size_t, std::size_t>
+		locate( std::vector<partition_run> const &runs, std::size_t n ) {
+			std::size_t idx = 0;
+			while( n >= runs[idx].last - runs[idx].first ) {
+				n -= runs[idx].last - runs[idx].first;
+				++idx;
+			}
+			return { idx, runs[idx].first + n };
+		}
+	} // namespace algorithm_details
+
+	/// @brief Reorder [first, last) so the elements satisfying unary_predicate
+	/// come first, using policy.  Chunks are partitioned in parallel and the
+	/// elements left on the wrong side of the final split point are then
+	/// swapped in parallel.  As with std::partition, the order is not kept
+	/// @return the first element of the second group
+	template<typename ExecutionPolicy, typename ForwardIterator,
+	         typename UnaryPredicate,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	ForwardIterator partition( ExecutionPolicy &&policy, ForwardIterator first,
+	                           ForwardIterator last,
+	                           UnaryPredicate unary_predicate ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<policy_t, ForwardIterator> ) {
+			using algorithm_details::partition_run;
+			auto const size = static_cast<std::size_t>( last - first );
+			auto const chunks = execution_impl::chunk_count( policy, size );
+			if( chunks > 1 ) {
+				auto splits = std::vector<partition_run>( chunks );
+				execution_impl::for_each_chunk(
+				  policy, size, chunks,
+				  [&]( std::size_t chunk, std::size_t chunk_first,
+				       std::size_t chunk_last ) {
+					  auto const chunk_begin =
+					    execution_impl::advance( first, chunk_first );
+					  auto const split = daw::algorithm::partition(
+					    chunk_begin, execution_impl::advance( first, chunk_last ),
+					    unary_predicate );
+					  splits[chunk] = partition_run{
+					    chunk_first,
+					    chunk_first + static_cast<std::size_t>( split - chunk_begin ) };
+				  } );
+				std::size_t matched = 0;
+				for( auto const &s : splits ) {
+					matched += s.last - s.first;
+				}
+				// Non-matching elements before the split point are swapped with
+				// matching ones after it, k'th with k'th
+				auto misplaced_left = std::vector<partition_run>( );
+				auto misplaced_right = std::vector<partition_run>( );
+				std::size_t misplaced = 0;
+				for( std::size_t c = 0; c < chunks; ++c ) {
+					auto const chunk_last = ( size * ( c + 1U ) ) / chunks;
+					auto const left_last = std::min( chunk_last, matched );
+					if( splits[c].last < left_last ) {
+						misplaced_left.push_back( { splits[c].last, left_last } );
+						misplaced += left_last - splits[c].last;
+					}
+					auto const right_first = std::max( splits[c].first, matched );
+					if( right_first < splits[c].last ) {
+						misplaced_right.push_back( { right_first, splits[c].last } );
+					}
+				}
+				execution_impl::for_each_chunk(
+				  policy, misplaced, execution_impl::chunk_count( policy, misplaced ),
+				  [&]( std::size_t, std::size_t piece_first, std::size_t piece_last ) {
+					  if( piece_first == piece_last ) {
+						  return;
+					  }
+					  auto [li, lpos] =
+					    algorithm_details::locate( misplaced_left, piece_first );
+					  auto [ri, rpos] =
+					    algorithm_details::locate( misplaced_right, piece_first );
+					  for( std::size_t n = piece_first; n < piece_last; ++n ) {
+						  daw::iter_swap( execution_impl::advance( first, lpos ),
+						                  execution_impl::advance( first, rpos ) );
+						  if( ++lpos == misplaced_left[li].last and
+						      li + 1U < misplaced_left.size( ) ) {
+							  lpos = misplaced_left[++li].first;
+						  }
+						  if( ++rpos == misplaced_right[ri].last and
+						      ri + 1U < misplaced_right.size( ) ) {
+							  rpos = misplaced_right[++ri].first;
+						  }
+					  }
+				  } );
+				return execution_impl::advance( first, matched );
+			}
+		}
+		(void)policy;
+		return daw::algorithm::partition( first, last, unary_predicate );
+	}
+
+	/// @brief cartesian_product_map using policy.  With par or par_unseq and
+	/// random access iterators, blocks of positions run on a
+	/// daw::thread_pool.  The output range must already be sized
+	/// @return end of output range
+	template<typename ExecutionPolicy, typename Function, typename Iterator1,
+	         typename LastType, typename OutputIterator, typename... Iterators,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	OutputIterator cartesian_product_map( ExecutionPolicy &&policy,
+	                                      Function func, Iterator1 first1,
+	                                      LastType last1, OutputIterator out_it,
+	                                      Iterators... its ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( std::is_same_v<Iterator1, LastType> and
+		              execution_impl::is_parallel_v<
+		                policy_t, Iterator1, OutputIterator, Iterators...> ) {
+			auto const size = static_cast<std::size_t>( last1 - first1 );
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  execution_impl::loop<policy_t>(
+				    chunk_first, chunk_last, [&]( std::size_t n ) {
+					    execution_impl::at( out_it, n ) =
+					      daw::invoke( func, execution_impl::at( first1, n ),
+					                   execution_impl::at( its, n )... );
+				    } );
+			  } );
+			return execution_impl::advance( out_it, size );
+		} else {
+			(void)policy;
+			return daw::algorithm::cartesian_product_map(
+			  daw::move( func ), first1, last1, out_it, its... );
+		}
+	}
+
+	/// @brief cartesian_product using policy.  func may be called
+	/// concurrently for different positions
+	template<typename ExecutionPolicy, typename Function, typename Iterator1,
+	         typename LastType, typename... Iterators,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	void cartesian_product( ExecutionPolicy &&policy, Function func,
+	                        Iterator1 first1, LastType last1, Iterators... its ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( std::is_same_v<Iterator1, LastType> and
+		              execution_impl::is_parallel_v<policy_t, Iterator1,
+		                                            Iterators...> ) {
+			auto const size = static_cast<std::size_t>( last1 - first1 );
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  execution_impl::loop<policy_t>(
+				    chunk_first, chunk_last, [&]( std::size_t n ) {
+					    daw::invoke( func, execution_impl::at( first1, n ),
+					                 execution_impl::at( its, n )... );
+				    } );
+			  } );
+		} else {
+			(void)policy;
+			daw::algorithm::cartesian_product( daw::move( func ), first1, last1,
+			                                   its... );
+		}
+	}
+
+	/// @brief cartesian_product_map_soa using policy.  The output ranges must
+	/// already be sized
+	/// @return end of each output range
+	template<typename ExecutionPolicy, typename Function,
+	         typename RandomIterator1, typename... OutputIterators,
+	         typename... RandomIterators,
+	         daw::enable_when_t<
+	           execution::is_execution_policy_v<ExecutionPolicy>> = nullptr>
+	std::tuple<OutputIterators...>
+	cartesian_product_map_soa( ExecutionPolicy &&policy, Function func,
+	                           RandomIterator1 first1, RandomIterator1 last1,
+	                           std::tuple<OutputIterators...> outs,
+	                           RandomIterators... its ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<policy_t, RandomIterator1> ) {
+			auto const size = static_cast<std::size_t>( last1 - first1 );
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  execution_impl::loop<policy_t>(
+				    chunk_first, chunk_last, [&]( std::size_t n ) {
+					    algorithm_details::assign_soa(
+					      outs, n,
+					      daw::invoke( func, execution_impl::at( first1, n ),
+					                   execution_impl::at( its, n )... ),
+					      std::index_sequence_for<OutputIterators...>{ } );
+				    } );
+			  } );
+			return algorithm_details::advance_soa( outs, size );
+		} else {
+			(void)policy;
+			return daw::algorithm::cartesian_product_map_soa(
+			  daw::move( func ), first1, last1, daw::move( outs ), its... );
+		}
+	}
+} // namespace daw::algorithm
+
+namespace daw::container {
+	template<typename ExecutionPolicy, typename Sortable,
+	         typename Compare = std::less<>,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	void sort( ExecutionPolicy &&policy, Sortable &container,
+	           Compare compare = Compare{ } ) {
+		static_assert( traits::is_sortable_container_v<Sortable>, "" );
+		using std::begin;
+		using std::end;
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<
+		                policy_t, decltype( begin( container ) )> ) {
+			daw::parallel::sort( execution_impl::get_pool( policy ),
+			                     begin( container ), end( container ),
+			                     daw::move( compare ) );
+		} else {
+			(void)policy;
+			std::sort( begin( container ), end( container ), daw::move( compare ) );
+		}
+	}
+
+	template<typename ExecutionPolicy, typename Container,
+	         typename OutputIterator,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	void copy( ExecutionPolicy &&policy, Container const &source,
+	           OutputIterator destination ) {
+		daw::algorithm::copy( std::forward<ExecutionPolicy>( policy ),
+		                      std::cbegin( source ), std::cend( source ),
+		                      destination );
+	}
+
+	/***
+	 * Append source to destination.  With a parallel policy, destination is
+	 * resized when it can be and the elements copied in parallel
+	 */
+	template<typename ExecutionPolicy, typename Source, typename Destination,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	void append( ExecutionPolicy &&policy, Source const &source,
+	             Destination &destination ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		using value_t = typename Destination::value_type;
+		if constexpr( execution_impl::is_parallel_v<
+		                policy_t, decltype( std::cbegin( source ) ),
+		                decltype( std::begin( destination ) )> and
+		              std::is_default_constructible_v<value_t> ) {
+			auto const old_size = std::size( destination );
+			destination.resize( old_size + std::size( source ) );
+			daw::algorithm::copy(
+			  policy, std::cbegin( source ), std::cend( source ),
+			  execution_impl::advance( std::begin( destination ), old_size ) );
+		} else {
+			(void)policy;
+			append( source, destination );
+		}
+	}
+
+	/***
+	 * Run func( container[n], n ) for each n in [first_inclusive,
+	 * last_exclusive) using policy
+	 */
+	template<typename ExecutionPolicy, typename Container, typename Function,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	void for_each_with_pos( ExecutionPolicy &&policy, Container &container,
+	                        size_t const first_inclusive,
+	                        size_t const last_exclusive, Function func ) {
+		using policy_t = daw::remove_cvref_t<ExecutionPolicy>;
+		if constexpr( execution_impl::is_parallel_v<
+		                policy_t, decltype( std::begin( container ) )> ) {
+			auto const first = std::begin( container );
+			auto const size = last_exclusive - first_inclusive;
+			execution_impl::for_each_chunk(
+			  policy, size, execution_impl::chunk_count( policy, size ),
+			  [&]( std::size_t, std::size_t chunk_first, std::size_t chunk_last ) {
+				  execution_impl::loop<policy_t>(
+				    first_inclusive + chunk_first, first_inclusive + chunk_last,
+				    [&]( std::size_t n ) {
+					    func( execution_impl::at( first, n ), n );
+				    } );
+			  } );
+		} else {
+			(void)policy;
+			for_each_with_pos( container, first_inclusive, last_exclusive,
+			                   daw::move( func ) );
+		}
+	}
+
+	template<typename ExecutionPolicy, typename Container, typename Function,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	void for_each_with_pos( ExecutionPolicy &&policy, Container &container,
+	                        Function func ) {
+		for_each_with_pos( std::forward<ExecutionPolicy>( policy ), container, 0,
+		                   container_size( container ), daw::move( func ) );
+	}
+
+	template<typename ExecutionPolicy, typename Container,
+	         typename UnaryPredicate,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	decltype( auto ) partition( ExecutionPolicy &&policy, Container &container,
+	                            UnaryPredicate pred ) {
+		return daw::algorithm::partition( std::forward<ExecutionPolicy>( policy ),
+		                                  std::begin( container ),
+		                                  std::end( container ), pred );
+	}
+
+	// Transform the elements of container in place
+	template<typename ExecutionPolicy, typename Container,
+	         typename UnaryOperator,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	decltype( auto ) transform( ExecutionPolicy &&policy, Container &container,
+	                            UnaryOperator unary_operator ) {
+		return daw::algorithm::transform( std::forward<ExecutionPolicy>( policy ),
+		                                  std::begin( container ),
+		                                  std::end( container ),
+		                                  std::begin( container ),
+		                                  daw::move( unary_operator ) );
+	}
+
+	template<typename ExecutionPolicy, typename Container,
+	         typename OutputIterator, typename UnaryOperator,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	decltype( auto ) transform( ExecutionPolicy &&policy,
+	                            Container const &container,
+	                            OutputIterator first_out,
+	                            UnaryOperator unary_operator ) {
+		return daw::algorithm::transform( std::forward<ExecutionPolicy>( policy ),
+		                                  std::cbegin( container ),
+		                                  std::cend( container ), first_out,
+		                                  daw::move( unary_operator ) );
+	}
+
+	template<typename ExecutionPolicy, typename Container, typename T,
+	         typename BinaryOperation = std::plus<>,
+	         std::enable_if_t<execution::is_execution_policy_v<ExecutionPolicy>,
+	                          std::nullptr_t> = nullptr>
+	T reduce( ExecutionPolicy &&policy, Container const &container, T init,
+	          BinaryOperation binary_op = BinaryOperation{ } ) {
+		return daw::algorithm::reduce( std::forward<ExecutionPolicy>( policy ),
+		                               std::cbegin( container ),
+		                               std::cend( container ), daw::move( init ),
+		                               daw::move( binary_op ) );
+	}
+} // namespace daw::container
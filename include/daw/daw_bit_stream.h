@@ -9,13 +9,18 @@
 #pragma once
 
 #include "daw_bit_queues.h"
+#include "daw_endian.h"
 #include "daw_exception.h"
 
+#include <algorithm>
 #include <ciso646>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 namespace daw {
 	/*template<typename InputIteratorF, typename InputIteratorL> class bit_stream;
@@ -192,4 +197,256 @@ namespace daw {
 		return bit_stream<InputIteratorF, InputIteratorL, BitQueueLSB>{ first,
 		                                                                last };
 	}
+
+	enum class bit_order { msb_first, lsb_first };
+
+	namespace bit_stream_impl {
+		template<bit_order Order>
+		[[nodiscard]] inline std::uint64_t load64( unsigned char const *ptr ) {
+			std::uint64_t result;
+			std::memcpy( &result, ptr, sizeof( result ) );
+			// Swapping bytes is its own inverse, so this converts from big/little
+			// endian as well
+			if constexpr( Order == bit_order::msb_first ) {
+				return daw::to_big_endian( result );
+			} else {
+				return daw::to_little_endian( result );
+			}
+		}
+
+		template<bit_order Order>
+		inline void store64( unsigned char *ptr, std::uint64_t value ) {
+			if constexpr( Order == bit_order::msb_first ) {
+				value = daw::to_big_endian( value );
+			} else {
+				value = daw::to_little_endian( value );
+			}
+			std::memcpy( ptr, &value, sizeof( value ) );
+		}
+
+		[[nodiscard]] constexpr std::uint64_t low_mask( std::size_t bits ) noexcept {
+			return bits >= 64U ? ~std::uint64_t{ 0 }
+			                   : ( std::uint64_t{ 1 } << bits ) - 1U;
+		}
+	} // namespace bit_stream_impl
+
+	/***
+	 * Reads bit fields from a contiguous byte buffer.  A 64 bit accumulator is
+	 * refilled with one unaligned 8 byte load, leaving at least 56 bits to peek
+	 * at, and consume drops bits without refilling.  With msb_first the first
+	 * bit is the high bit of the first byte, with lsb_first the low bit.  Near
+	 * the end of the buffer refill reads a byte at a time and bits past the end
+	 * read as zero
+	 */
+	template<bit_order Order = bit_order::msb_first>
+	class bit_reader {
+		unsigned char const *m_first;
+		unsigned char const *m_last;
+		// Bits past m_count are the following bits of the buffer or zero, so
+		// reloading them is harmless
+		std::uint64_t m_bits = 0;
+		std::size_t m_count = 0;
+
+	public:
+		static constexpr std::size_t max_peek_bits = 56;
+
+		bit_reader( unsigned char const *first, std::size_t size ) noexcept
+		  : m_first( first )
+		  , m_last( first + size ) {}
+
+		template<typename Byte,
+		         std::enable_if_t<sizeof( Byte ) == 1 and
+		                            not std::is_same_v<Byte, unsigned char>,
+		                          std::nullptr_t> = nullptr>
+		bit_reader( Byte const *first, std::size_t size ) noexcept
+		  : bit_reader( reinterpret_cast<unsigned char const *>( first ), size ) {}
+
+		/// @return how many bits are left to read
+		[[nodiscard]] std::size_t size( ) const noexcept {
+			return m_count + static_cast<std::size_t>( m_last - m_first ) * 8U;
+		}
+
+		[[nodiscard]] bool empty( ) const noexcept {
+			return size( ) == 0;
+		}
+
+		/// Fill the accumulator to at least max_peek_bits, or the rest of the
+		/// buffer
+		void refill( ) noexcept {
+			if( m_last - m_first >= 8 ) {
+				auto const next = bit_stream_impl::load64<Order>( m_first );
+				if constexpr( Order == bit_order::msb_first ) {
+					m_bits |= next >> m_count;
+				} else {
+					m_bits |= next << m_count;
+				}
+				m_first += ( 63U - m_count ) >> 3U;
+				m_count |= 56U;
+				return;
+			}
+			while( m_count <= 56U and m_first != m_last ) {
+				std::uint64_t const byte = *m_first++;
+				if constexpr( Order == bit_order::msb_first ) {
+					m_bits |= byte << ( 56U - m_count );
+				} else {
+					m_bits |= byte << m_count;
+				}
+				m_count += 8U;
+			}
+		}
+
+		/// @return the next bit_count bits without consuming them.  Only the
+		/// bits available since the last refill can be peeked at
+		[[nodiscard]] std::uint64_t peek( std::size_t bit_count ) const noexcept {
+			if constexpr( Order == bit_order::msb_first ) {
+				// Two shifts so that a count of 0 is not a shift by 64
+				return ( m_bits >> 1U ) >> ( 63U - bit_count );
+			} else {
+				return m_bits & bit_stream_impl::low_mask( bit_count );
+			}
+		}
+
+		void consume( std::size_t bit_count ) {
+			daw::exception::dbg_throw_on_true<std::out_of_range>(
+			  bit_count > m_count, "Attempt to consume more bits than available" );
+			if constexpr( Order == bit_order::msb_first ) {
+				m_bits <<= bit_count;
+			} else {
+				m_bits >>= bit_count;
+			}
+			m_count -= bit_count;
+		}
+
+		/// Read bit_count bits, up to 64.  In msb_first order the first bit read
+		/// is the high bit of the result, in lsb_first order the low bit
+		[[nodiscard]] std::uint64_t read( std::size_t bit_count ) {
+			if( bit_count <= max_peek_bits ) {
+				refill( );
+				auto const result = peek( bit_count );
+				consume( bit_count );
+				return result;
+			}
+			auto const first_part = read( 32U );
+			auto const second_part = read( bit_count - 32U );
+			if constexpr( Order == bit_order::msb_first ) {
+				return ( first_part << ( bit_count - 32U ) ) | second_part;
+			} else {
+				return first_part | ( second_part << 32U );
+			}
+		}
+
+		[[nodiscard]] bool read_bit( ) {
+			return read( 1U ) != 0U;
+		}
+
+		void skip( std::size_t bit_count ) {
+			while( bit_count > max_peek_bits ) {
+				refill( );
+				consume( max_peek_bits );
+				bit_count -= max_peek_bits;
+			}
+			refill( );
+			consume( bit_count );
+		}
+
+		/// Skip to the start of the next byte of the buffer
+		void align_to_byte( ) noexcept {
+			auto const partial = m_count % 8U;
+			if constexpr( Order == bit_order::msb_first ) {
+				m_bits <<= partial;
+			} else {
+				m_bits >>= partial;
+			}
+			m_count -= partial;
+		}
+	};
+
+	/***
+	 * Writes bit fields to a byte buffer in the layout bit_reader reads.  Bits
+	 * collect in a 64 bit accumulator that is stored with one unaligned 8 byte
+	 * store after each write, keeping only the partial byte
+	 */
+	template<bit_order Order = bit_order::msb_first>
+	class bit_writer {
+		std::vector<unsigned char> m_buffer;
+		std::size_t m_pos = 0;
+		std::uint64_t m_bits = 0;
+		std::size_t m_count = 0;
+
+		void flush( ) {
+			if( m_buffer.size( ) < m_pos + 8U ) {
+				m_buffer.resize( std::max( m_buffer.size( ) * 2U, m_pos + 64U ) );
+			}
+			bit_stream_impl::store64<Order>( m_buffer.data( ) + m_pos, m_bits );
+			auto const full_bits = m_count & ~std::size_t{ 7U };
+			m_pos += full_bits >> 3U;
+			if constexpr( Order == bit_order::msb_first ) {
+				m_bits <<= full_bits;
+			} else {
+				m_bits >>= full_bits;
+			}
+			m_count &= 7U;
+		}
+
+	public:
+		static constexpr std::size_t max_write_bits = 56;
+
+		bit_writer( ) = default;
+
+		/// @param reserve_bytes expected size of the output
+		explicit bit_writer( std::size_t reserve_bytes )
+		  : m_buffer( reserve_bytes + 8U ) {}
+
+		/// @return how many bits have been written
+		[[nodiscard]] std::size_t size( ) const noexcept {
+			return m_pos * 8U + m_count;
+		}
+
+		/// Write the low bit_count bits of value, up to 64.  In msb_first order
+		/// the high bit of those is written first, in lsb_first order the low
+		void write( std::uint64_t value, std::size_t bit_count ) {
+			if( bit_count > max_write_bits ) {
+				if constexpr( Order == bit_order::msb_first ) {
+					write( value >> 32U, bit_count - 32U );
+					write( value, 32U );
+				} else {
+					write( value, 32U );
+					write( value >> 32U, bit_count - 32U );
+				}
+				return;
+			}
+			value &= bit_stream_impl::low_mask( bit_count );
+			// m_count is at most 7 here, so the bits always fit
+			if constexpr( Order == bit_order::msb_first ) {
+				m_bits |= ( value << ( 63U - bit_count ) << 1U ) >> m_count;
+			} else {
+				m_bits |= value << m_count;
+			}
+			m_count += bit_count;
+			flush( );
+		}
+
+		void write_bit( bool bit ) {
+			write( bit ? 1U : 0U, 1U );
+		}
+
+		/// Pad with zero bits to the start of the next byte
+		void align_to_byte( ) {
+			if( m_count != 0 ) {
+				write( 0U, 8U - m_count );
+			}
+		}
+
+		/// @return the bytes written, with the last one zero padded
+		[[nodiscard]] std::vector<unsigned char> release( ) {
+			align_to_byte( );
+			m_buffer.resize( m_pos );
+			auto result = std::move( m_buffer );
+			m_buffer = { };
+			m_pos = 0;
+			m_bits = 0;
+			m_count = 0;
+			return result;
+		}
+	};
 } // namespace daw
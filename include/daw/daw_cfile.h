@@ -9,11 +9,28 @@
 #pragma once
 
 #include "daw_exchange.h"
+#include "daw_string_view.h"
 
+#include <algorithm>
 #include <ciso646>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
 #include <utility>
 
+#if not defined( _MSC_VER )
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
 namespace daw {
 	class CFile {
 		FILE *ptr = nullptr;
@@ -49,4 +66,416 @@ namespace daw {
 			close( );
 		}
 	};
+
+	namespace cfile_impl {
+		template<std::size_t Alignment>
+		struct aligned_deleter {
+			void operator( )( char *ptr ) const noexcept {
+				::operator delete( ptr, std::align_val_t{ Alignment } );
+			}
+		};
+
+		template<std::size_t Alignment>
+		using aligned_buffer_t =
+		  std::unique_ptr<char[], aligned_deleter<Alignment>>;
+
+		template<std::size_t Alignment>
+		[[nodiscard]] aligned_buffer_t<Alignment>
+		make_aligned_buffer( std::size_t size ) {
+			return aligned_buffer_t<Alignment>( static_cast<char *>(
+			  ::operator new( size, std::align_val_t{ Alignment } ) ) );
+		}
+	} // namespace cfile_impl
+
+	/***
+	 * Buffered record reader over a CFile.  The file is read in large blocks
+	 * into an aligned buffer and each record is returned as a view into that
+	 * buffer, without the delimiter.  A record that straddles the end of the
+	 * buffer is moved to the front before the next block is read and the
+	 * buffer grows when a single record is larger than it.  Views are only
+	 * valid until the next call to next_record.
+	 */
+	class cfile_reader {
+		static inline constexpr std::size_t buffer_alignment = 64;
+
+		CFile m_file;
+		cfile_impl::aligned_buffer_t<buffer_alignment> m_buffer;
+		std::size_t m_capacity;
+		// [m_first, m_last) is the unconsumed data, m_scanned is where the search
+		// for a delimiter will resume so carried over data is not searched twice
+		std::size_t m_first = 0;
+		std::size_t m_scanned = 0;
+		std::size_t m_last = 0;
+		bool m_eof = false;
+		bool m_error = false;
+
+		// Make room after m_last and read the next block
+		void refill( ) {
+			if( m_first > 0 ) {
+				std::memmove( m_buffer.get( ), m_buffer.get( ) + m_first,
+				              m_last - m_first );
+				m_scanned -= m_first;
+				m_last -= m_first;
+				m_first = 0;
+			}
+			if( m_last == m_capacity ) {
+				auto new_capacity = m_capacity * 2;
+				auto new_buffer =
+				  cfile_impl::make_aligned_buffer<buffer_alignment>( new_capacity );
+				std::memcpy( new_buffer.get( ), m_buffer.get( ), m_last );
+				m_buffer = std::move( new_buffer );
+				m_capacity = new_capacity;
+			}
+			auto const count = std::fread( m_buffer.get( ) + m_last, 1,
+			                               m_capacity - m_last, m_file.get( ) );
+			m_last += count;
+			if( count == 0 ) {
+				m_eof = true;
+				m_error = std::ferror( m_file.get( ) ) != 0;
+			}
+		}
+
+	public:
+		static inline constexpr std::size_t default_buffer_size = 1024U * 1024U;
+
+		explicit cfile_reader( CFile &&file,
+		                       std::size_t buffer_size = default_buffer_size )
+		  : m_file( std::move( file ) )
+		  , m_buffer( cfile_impl::make_aligned_buffer<buffer_alignment>(
+		      std::max( buffer_size, std::size_t{ 1 } ) ) )
+		  , m_capacity( std::max( buffer_size, std::size_t{ 1 } ) ) {}
+
+		/***
+		 * @param delimiter character separating records
+		 * @return the next record or nullopt when the input is exhausted.  A
+		 * final record without a trailing delimiter is returned as is
+		 */
+		[[nodiscard]] std::optional<daw::string_view>
+		next_record( char delimiter = '\n' ) {
+			while( true ) {
+				auto const *const first = m_buffer.get( ) + m_first;
+				if( auto const *pos = static_cast<char const *>(
+				      std::memchr( m_buffer.get( ) + m_scanned, delimiter,
+				                   m_last - m_scanned ) );
+				    pos != nullptr ) {
+					auto const len = static_cast<std::size_t>( pos - first );
+					m_first += len + 1;
+					m_scanned = m_first;
+					return daw::string_view( first, len );
+				}
+				m_scanned = m_last;
+				if( m_eof ) {
+					if( m_first == m_last ) {
+						return std::nullopt;
+					}
+					auto const len = m_last - m_first;
+					m_first = m_last;
+					m_scanned = m_last;
+					return daw::string_view( first, len );
+				}
+				refill( );
+			}
+		}
+
+		[[nodiscard]] std::optional<daw::string_view> next_line( ) {
+			return next_record( '\n' );
+		}
+
+		/***
+		 * Call visitor with each remaining record
+		 * @return number of records visited
+		 */
+		template<typename Visitor>
+		std::size_t for_each_record( Visitor &&visitor,
+		                             char delimiter = '\n' ) {
+			std::size_t count = 0;
+			while( auto rec = next_record( delimiter ) ) {
+				visitor( *rec );
+				++count;
+			}
+			return count;
+		}
+
+		[[nodiscard]] bool eof( ) const noexcept {
+			return m_eof and m_first == m_last;
+		}
+
+		[[nodiscard]] bool has_error( ) const noexcept {
+			return m_error;
+		}
+
+		[[nodiscard]] CFile &file( ) noexcept {
+			return m_file;
+		}
+	};
+
+	enum class cfile_write_mode : bool { buffered, direct };
+
+	/***
+	 * Double buffered writer over a CFile.  Writes are copied into one buffer
+	 * while the other is written to the file by a background thread, so the
+	 * producer only waits when it fills a buffer before the previous one is on
+	 * disk.  On POSIX the blocks are written with pwrite at tracked offsets.
+	 * With cfile_write_mode::direct the file is switched to O_DIRECT where
+	 * supported and only aligned blocks are written that way, a partial tail is
+	 * written normally and rewritten as part of the next aligned block.  If
+	 * O_DIRECT is not available the writer silently stays buffered.
+	 */
+	class cfile_async_writer {
+	public:
+		static inline constexpr std::size_t default_buffer_size =
+		  4U * 1024U * 1024U;
+		static inline constexpr std::size_t direct_alignment = 4096;
+
+	private:
+		struct job_t {
+			char const *data = nullptr;
+			std::size_t size = 0;
+			// Bytes after size that must not be written with O_DIRECT
+			std::size_t tail = 0;
+			std::size_t offset = 0;
+		};
+
+		CFile m_file;
+		std::size_t m_capacity;
+		cfile_impl::aligned_buffer_t<direct_alignment> m_buffers[2];
+		std::size_t m_current = 0;
+		std::size_t m_used = 0;
+		std::size_t m_offset = 0;
+		bool m_seekable = false;
+		bool m_direct = false;
+
+		mutable std::mutex m_mutex{ };
+		std::condition_variable m_cv{ };
+		job_t m_job{ };
+		bool m_job_active = false;
+		bool m_stop = false;
+		bool m_error = false;
+		std::thread m_thread{ };
+
+		static std::size_t round_up( std::size_t sz ) noexcept {
+			return ( ( std::max( sz, std::size_t{ 1 } ) + direct_alignment - 1 ) /
+			         direct_alignment ) *
+			       direct_alignment;
+		}
+
+#if not defined( _MSC_VER )
+		[[nodiscard]] int fd( ) const noexcept {
+			return ::fileno( m_file.get( ) );
+		}
+
+		void set_direct( bool enabled ) const noexcept {
+#if defined( O_DIRECT )
+			int const flags = ::fcntl( fd( ), F_GETFL );
+			(void)::fcntl( fd( ), F_SETFL,
+			               enabled ? flags | O_DIRECT : flags & ~O_DIRECT );
+#else
+			(void)enabled;
+#endif
+		}
+
+		[[nodiscard]] bool write_block( char const *data, std::size_t size,
+		                                std::size_t offset ) const noexcept {
+			while( size > 0 ) {
+				auto const n =
+				  m_seekable
+				    ? ::pwrite( fd( ), data, size, static_cast<off_t>( offset ) )
+				    : ::write( fd( ), data, size );
+				if( n < 0 ) {
+					if( errno == EINTR ) {
+						continue;
+					}
+					return false;
+				}
+				data += n;
+				size -= static_cast<std::size_t>( n );
+				offset += static_cast<std::size_t>( n );
+			}
+			return true;
+		}
+#else
+		[[nodiscard]] bool write_block( char const *data, std::size_t size,
+		                                std::size_t ) const noexcept {
+			return std::fwrite( data, 1, size, m_file.get( ) ) == size;
+		}
+#endif
+
+		[[nodiscard]] bool run_job( job_t const &job ) const noexcept {
+			if( not write_block( job.data, job.size, job.offset ) ) {
+				return false;
+			}
+			if( job.tail == 0 ) {
+				return true;
+			}
+#if not defined( _MSC_VER )
+			set_direct( false );
+#endif
+			bool const result =
+			  write_block( job.data + job.size, job.tail, job.offset + job.size );
+#if not defined( _MSC_VER )
+			set_direct( true );
+#endif
+			return result;
+		}
+
+		void worker( ) {
+			auto lck = std::unique_lock<std::mutex>( m_mutex );
+			while( true ) {
+				m_cv.wait( lck, [&] { return m_job_active or m_stop; } );
+				if( not m_job_active ) {
+					return;
+				}
+				auto const job = m_job;
+				lck.unlock( );
+				bool const good = run_job( job );
+				lck.lock( );
+				m_error = m_error or not good;
+				m_job_active = false;
+				m_cv.notify_all( );
+			}
+		}
+
+		void wait_idle( std::unique_lock<std::mutex> &lck ) {
+			m_cv.wait( lck, [&] { return not m_job_active; } );
+		}
+
+		// Hand the current buffer to the worker and switch to the other one
+		void submit( ) {
+			auto lck = std::unique_lock<std::mutex>( m_mutex );
+			wait_idle( lck );
+			char const *const data = m_buffers[m_current].get( );
+			std::size_t size = m_used;
+			std::size_t tail = 0;
+			if( m_direct ) {
+				size = ( m_used / direct_alignment ) * direct_alignment;
+				tail = m_used - size;
+			}
+			m_job = job_t{ data, size, tail, m_offset };
+			m_job_active = true;
+			m_offset += size;
+			lck.unlock( );
+			m_cv.notify_all( );
+
+			m_current ^= 1U;
+			m_used = 0;
+			if( tail > 0 ) {
+				// Only read by the worker, so the copy can happen concurrently
+				std::memcpy( m_buffers[m_current].get( ), data + size, tail );
+				m_used = tail;
+			}
+		}
+
+	public:
+		explicit cfile_async_writer(
+		  CFile &&file, cfile_write_mode mode = cfile_write_mode::buffered,
+		  std::size_t buffer_size = default_buffer_size )
+		  : m_file( std::move( file ) )
+		  , m_capacity( round_up( buffer_size ) )
+		  , m_buffers{
+		      cfile_impl::make_aligned_buffer<direct_alignment>( m_capacity ),
+		      cfile_impl::make_aligned_buffer<direct_alignment>( m_capacity ) } {
+
+			std::fflush( m_file.get( ) );
+#if not defined( _MSC_VER )
+			if( auto const pos = ::lseek( fd( ), 0, SEEK_CUR ); pos >= 0 ) {
+				m_seekable = true;
+				m_offset = static_cast<std::size_t>( pos );
+			}
+#if defined( O_DIRECT )
+			if( mode == cfile_write_mode::direct and m_seekable and
+			    m_offset % direct_alignment == 0 ) {
+				int const flags = ::fcntl( fd( ), F_GETFL );
+				m_direct = ::fcntl( fd( ), F_SETFL, flags | O_DIRECT ) == 0;
+			}
+#endif
+#endif
+			(void)mode;
+			m_thread = std::thread( [this] { worker( ); } );
+		}
+
+		cfile_async_writer( cfile_async_writer const & ) = delete;
+		cfile_async_writer &operator=( cfile_async_writer const & ) = delete;
+		cfile_async_writer( cfile_async_writer && ) = delete;
+		cfile_async_writer &operator=( cfile_async_writer && ) = delete;
+
+		~cfile_async_writer( ) {
+			(void)close( );
+		}
+
+		void write( char const *data, std::size_t size ) {
+			while( size > 0 ) {
+				auto const n = std::min( size, m_capacity - m_used );
+				std::memcpy( m_buffers[m_current].get( ) + m_used, data, n );
+				m_used += n;
+				data += n;
+				size -= n;
+				if( m_used == m_capacity ) {
+					submit( );
+				}
+			}
+		}
+
+		void write( daw::string_view str ) {
+			write( str.data( ), str.size( ) );
+		}
+
+		/***
+		 * Write out all buffered data and wait for it to reach the file
+		 * @return false if any write has failed
+		 */
+		[[nodiscard]] bool flush( ) {
+			if( not m_thread.joinable( ) ) {
+				return not m_error;
+			}
+			if( m_used > 0 ) {
+				submit( );
+			}
+			auto lck = std::unique_lock<std::mutex>( m_mutex );
+			wait_idle( lck );
+			return not m_error;
+		}
+
+		/***
+		 * Flush, stop the background thread and close the file
+		 * @return false if any write has failed
+		 */
+		[[nodiscard]] bool close( ) {
+			if( not m_thread.joinable( ) ) {
+				return not m_error;
+			}
+			(void)flush( );
+			{
+				auto const lck = std::lock_guard<std::mutex>( m_mutex );
+				m_stop = true;
+			}
+			m_cv.notify_all( );
+			m_thread.join( );
+#if not defined( _MSC_VER )
+			if( m_direct ) {
+				set_direct( false );
+			}
+			// Leave the file position after the data written
+			if( m_seekable ) {
+				// In direct mode the retained tail is already in the file
+				(void)::lseek( fd( ), static_cast<off_t>( m_offset + m_used ),
+				               SEEK_SET );
+			}
+#endif
+			m_used = 0;
+			m_file.close( );
+			return not m_error;
+		}
+
+		/***
+		 * @return true if blocks are being written with O_DIRECT
+		 */
+		[[nodiscard]] bool is_direct( ) const noexcept {
+			return m_direct;
+		}
+
+		[[nodiscard]] bool has_error( ) const {
+			auto const lck = std::lock_guard<std::mutex>( m_mutex );
+			return m_error;
+		}
+	};
 } // namespace daw
@@ -8,29 +8,60 @@
 
 #pragma once
 
-#include "daw_algorithm.h"
+#include "daw_span.h"
 
+#include <algorithm>
 #include <ciso646>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace daw {
-	template<typename T>
+	template<typename T,
+	         typename Allocator = std::allocator<std::remove_const_t<T>>>
 	struct clumpy_sparsy_iterator;
 
-	template<typename T>
-	using clumpy_sparsy_const_iterator = clumpy_sparsy_iterator<T const>;
-
-	// Provide a vector like structure that assumes that the sparseness has clumps
-	template<typename T>
+	template<typename T, typename Allocator = std::allocator<T>>
+	using clumpy_sparsy_const_iterator =
+	  clumpy_sparsy_iterator<T const, Allocator>;
+
+	/***
+	 * A sparse array that assumes the set positions come in clumps.  Each run
+	 * of consecutive positions is a chunk holding its values contiguously.
+	 * Chunks are found by a binary search over a separate array of their
+	 * starts, and neighbouring chunks are merged when an insert joins them.
+	 * The buffers of merged and erased chunks are kept for reuse.  Allocator
+	 * is used for the chunk list and for the items of each chunk
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
 	class clumpy_sparsy {
 		class Chunk {
-			size_t m_start;
-			std::vector<T> m_items;
+			size_t m_start = 0;
+			std::vector<T, Allocator> m_items;
 
 		public:
+			using allocator_type = Allocator;
+
 			Chunk( ) = default;
 
+			Chunk( std::allocator_arg_t, allocator_type const &alloc )
+			  : m_items( alloc ) {}
+
+			Chunk( std::allocator_arg_t, allocator_type const &alloc,
+			       Chunk const &other )
+			  : m_start( other.m_start )
+			  , m_items( other.m_items, alloc ) {}
+
+			Chunk( std::allocator_arg_t, allocator_type const &alloc,
+			       Chunk &&other )
+			  : m_start( other.m_start )
+			  , m_items( std::move( other.m_items ), alloc ) {}
+
 			[[nodiscard]] size_t size( ) const {
 				return m_items.size( );
 			}
@@ -47,253 +78,411 @@ namespace daw {
 				return m_start + size( );
 			}
 
-			[[nodiscard]] std::vector<T> &items( ) {
+			[[nodiscard]] std::vector<T, Allocator> &items( ) {
 				return m_items;
 			}
 
-			[[nodiscard]] std::vector<T> const &items( ) const {
+			[[nodiscard]] std::vector<T, Allocator> const &items( ) const {
 				return m_items;
 			}
 
-			[[nodiscard]] bool operator<( Chunk const &rhs ) {
+			[[nodiscard]] bool operator<( Chunk const &rhs ) const {
 				return start( ) < rhs.start( );
 			}
 		}; // class Chunk
+
+		template<typename, typename>
+		friend struct clumpy_sparsy_iterator;
+
 	public:
-		using values_type = std::vector<Chunk>;
-		using value_type = typename values_type::value_type;
-		using reference = typename values_type::reference;
-		using const_reference = typename values_type::reference;
-		using iterator = clumpy_sparsy_iterator<T>;
-		using const_iterator = clumpy_sparsy_const_iterator<T>;
+		using allocator_type = Allocator;
+		using values_type = std::vector<
+		  Chunk,
+		  typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>>;
+		using value_type = T;
+		using reference = T &;
+		using const_reference = T const &;
+		using size_type = size_t;
+		using iterator = clumpy_sparsy_iterator<T, Allocator>;
+		using const_iterator = clumpy_sparsy_const_iterator<T, Allocator>;
+
+		// How many emptied chunk buffers are kept for reuse
+		static constexpr size_t spare_chunk_count = 8;
 
 	private:
-		// Must be mutable as we hide our size and expand the values < size to fit
-		// as needed
-		values_type mutable m_items;
-		size_t m_size;
-
-		[[nodiscard]] auto lfind( size_t pos ) {
-			if( pos >= size( ) ) {
-				return size( );
+		using starts_type = std::vector<
+		  size_t,
+		  typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>>;
+
+		static constexpr size_t npos = std::numeric_limits<size_t>::max( );
+
+		values_type m_items;
+		// m_items[n].start( ), kept apart so the search touches less memory
+		starts_type m_starts;
+		values_type m_spare;
+		size_t m_size = 0;
+		size_t m_count = 0;
+
+		// The index of the last chunk starting at or before pos, or npos
+		[[nodiscard]] size_t chunk_before( size_t pos ) const {
+			auto const it =
+			  std::upper_bound( m_starts.begin( ), m_starts.end( ), pos );
+			if( it == m_starts.begin( ) ) {
+				return npos;
 			}
-			auto item_pos = daw::algorithm::find_last_of(
-			  m_items.begin( ), m_items.end( ),
-			  [pos]( auto const &item ) { return pos >= item.start( ); } );
-			if( item_pos < size( ) ) {
-				// We are within the max size of the container.  Feel free to add it
-				auto offset = pos - item_pos->start( );
-				if( offset > item_pos->size( ) + 1 ) {
-					++item_pos;
-					item_pos = m_items.emplace( item_pos );
-					item_pos->start( ) = pos;
-					item_pos->items( ).emplace_back( );
-				}
-			}
-			return item_pos;
+			return static_cast<size_t>( it - m_starts.begin( ) ) - 1U;
 		}
 
-	public:
-		[[nodiscard]] size_t size( ) const {
-			return m_size;
+		[[nodiscard]] Chunk take_spare( ) {
+			if( m_spare.empty( ) ) {
+				return Chunk( std::allocator_arg, get_allocator( ) );
+			}
+			Chunk result = std::move( m_spare.back( ) );
+			m_spare.pop_back( );
+			return result;
 		}
 
-		[[nodiscard]] reference operator[]( size_t pos ) {
-			auto item = lfind( pos );
+		// Keep an emptied chunk's buffer, never allocating to do so
+		void recycle( Chunk &&chunk ) noexcept {
+			if( m_spare.size( ) < m_spare.capacity( ) ) {
+				chunk.items( ).clear( );
+				m_spare.push_back( std::move( chunk ) );
+			}
 		}
 
-		[[nodiscard]] iterator begin( ) {
-			return clumpy_sparsy_iterator<T>( this );
+		void remove_chunk( size_t index ) {
+			Chunk chunk = std::move( m_items[index] );
+			m_items.erase( m_items.begin( ) + static_cast<std::ptrdiff_t>( index ) );
+			m_starts.erase( m_starts.begin( ) +
+			                static_cast<std::ptrdiff_t>( index ) );
+			recycle( std::move( chunk ) );
 		}
 
-		[[nodiscard]] const_iterator begin( ) const {
-			return clumpy_sparsy_const_iterator<T>( this );
+		// Put chunk at index in both lists
+		void insert_chunk( size_t index, Chunk &&chunk ) {
+			if( m_spare.capacity( ) == 0 ) {
+				m_spare.reserve( spare_chunk_count );
+			}
+			auto const offset = static_cast<std::ptrdiff_t>( index );
+			m_starts.insert( m_starts.begin( ) + offset, chunk.start( ) );
+			try {
+				m_items.insert( m_items.begin( ) + offset, std::move( chunk ) );
+			} catch( ... ) {
+				m_starts.erase( m_starts.begin( ) + offset );
+				throw;
+			}
 		}
 
-		[[nodiscard]] const_iterator cbegin( ) const {
-			return clumpy_sparsy_const_iterator<T>( this );
+		// Join chunk index with the one after it when they now touch
+		void merge_next( size_t index ) {
+			if( index + 1U >= m_items.size( ) or
+			    m_starts[index + 1U] != m_items[index].end( ) ) {
+				return;
+			}
+			auto &items = m_items[index].items( );
+			auto &next = m_items[index + 1U].items( );
+			items.insert( items.end( ), std::make_move_iterator( next.begin( ) ),
+			              std::make_move_iterator( next.end( ) ) );
+			remove_chunk( index + 1U );
+		}
+
+		/***
+		 * Construct a value at pos, which must not be set, extending or joining
+		 * the neighbouring chunks when they touch it
+		 */
+		template<typename... Args>
+		T &emplace_new( size_t pos, Args &&...args ) {
+			auto const before = chunk_before( pos );
+			size_t const after = before == npos ? 0 : before + 1U;
+			T *result = nullptr;
+			if( before != npos and m_items[before].end( ) == pos ) {
+				auto &items = m_items[before].items( );
+				items.emplace_back( std::forward<Args>( args )... );
+				merge_next( before );
+				result = &items[pos - m_starts[before]];
+			} else if( after < m_items.size( ) and m_starts[after] == pos + 1U ) {
+				auto &items = m_items[after].items( );
+				items.emplace( items.begin( ), std::forward<Args>( args )... );
+				m_items[after].start( ) = pos;
+				m_starts[after] = pos;
+				result = &items.front( );
+			} else {
+				Chunk chunk = take_spare( );
+				chunk.start( ) = pos;
+				chunk.items( ).emplace_back( std::forward<Args>( args )... );
+				insert_chunk( after, std::move( chunk ) );
+				result = &m_items[after].items( ).front( );
+			}
+			++m_count;
+			m_size = std::max( m_size, pos + 1U );
+			return *result;
 		}
 
-		[[nodiscard]] iterator end( ) {
-			return clumpy_sparsy_iterator<T>( this, size( ) );
-		}
+	public:
+		clumpy_sparsy( ) = default;
 
-		[[nodiscard]] const_iterator end( ) const {
-			return clumpy_sparsy_const_iterator<T>( this, size( ) );
+		explicit clumpy_sparsy( allocator_type const &alloc )
+		  : m_items( typename values_type::allocator_type( alloc ) )
+		  , m_starts( typename starts_type::allocator_type( alloc ) )
+		  , m_spare( typename values_type::allocator_type( alloc ) ) {}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return allocator_type( m_items.get_allocator( ) );
 		}
 
-		[[nodiscard]] const_iterator cend( ) const {
-			return clumpy_sparsy_const_iterator<T>( this, size( ) );
+		// One past the highest position set
+		[[nodiscard]] size_t size( ) const {
+			return m_size;
 		}
 
-	}; // class clumpy_sparsy
+		[[nodiscard]] bool empty( ) const {
+			return m_count == 0;
+		}
 
-	template<typename T>
-	struct clumpy_sparsy_iterator {
-		using difference_type = std::ptrdiff_t;
-		using size_type = std::size_t;
-		using value_type = typename clumpy_sparsy<T>::value_type;
-		using pointer = std::add_pointer_t<value_type>;
-		using const_pointer = std::add_pointer_t<std::add_const_t<value_type>>;
-		using iterator_category = std::random_access_iterator_tag;
-		using reference = typename clumpy_sparsy<T>::reference;
-		using const_reference = typename clumpy_sparsy<T>::const_reference;
+		// The number of positions set
+		[[nodiscard]] size_t element_count( ) const {
+			return m_count;
+		}
 
-	private:
-		size_t m_position = std::numeric_limits<size_t>::max( );
-		clumpy_sparsy<T> *m_items = nullptr;
+		[[nodiscard]] size_t chunk_count( ) const {
+			return m_items.size( );
+		}
 
-	public:
-		constexpr clumpy_sparsy_iterator( ) noexcept = default;
+		[[nodiscard]] T *find( size_t pos ) {
+			auto const index = chunk_before( pos );
+			if( index == npos or pos >= m_items[index].end( ) ) {
+				return nullptr;
+			}
+			return m_items[index].items( ).data( ) + ( pos - m_starts[index] );
+		}
 
-		constexpr clumpy_sparsy_iterator( clumpy_sparsy<T> *items,
-		                                  size_t position = 0 ) noexcept
-		  : m_position( items ? position : std::numeric_limits<size_t>::max( ) )
-		  , m_items( items ? items : nullptr ) {}
+		[[nodiscard]] T const *find( size_t pos ) const {
+			auto const index = chunk_before( pos );
+			if( index == npos or pos >= m_items[index].end( ) ) {
+				return nullptr;
+			}
+			return m_items[index].items( ).data( ) + ( pos - m_starts[index] );
+		}
 
-	private:
-		[[nodiscard]] auto as_tuple( ) {
-			return std::tie( m_position, m_items );
+		[[nodiscard]] bool contains( size_t pos ) const {
+			return find( pos ) != nullptr;
 		}
 
-		void increment( ) {
-			if( m_items->size( ) == m_position ) {
-				return;
+		// The value at pos, default constructing it if unset
+		[[nodiscard]] reference operator[]( size_t pos ) {
+			if( T *value = find( pos ); value != nullptr ) {
+				return *value;
 			}
-			++m_position;
+			return emplace_new( pos );
 		}
 
-		void decrement( ) {
-			if( 0 == m_position ) {
-				return;
+		template<typename U>
+		reference insert_or_assign( size_t pos, U &&value ) {
+			if( T *current = find( pos ); current != nullptr ) {
+				*current = std::forward<U>( value );
+				return *current;
 			}
-			--m_position;
+			return emplace_new( pos, std::forward<U>( value ) );
 		}
 
-		[[nodiscard]] bool equal( clumpy_sparsy_iterator const &other ) {
-			return as_tuple( ) == other.as_tuple( );
+		/***
+		 * Unset pos, splitting its chunk when it is in the middle
+		 * @return true if pos was set
+		 */
+		bool erase( size_t pos ) {
+			auto const index = chunk_before( pos );
+			if( index == npos or pos >= m_items[index].end( ) ) {
+				return false;
+			}
+			Chunk &chunk = m_items[index];
+			auto &items = chunk.items( );
+			auto const offset = static_cast<std::ptrdiff_t>( pos - chunk.start( ) );
+			if( items.size( ) == 1U ) {
+				remove_chunk( index );
+			} else if( offset == 0 ) {
+				items.erase( items.begin( ) );
+				++chunk.start( );
+				++m_starts[index];
+			} else if( pos + 1U == chunk.end( ) ) {
+				items.pop_back( );
+			} else {
+				Chunk tail = take_spare( );
+				tail.start( ) = pos + 1U;
+				tail.items( ).assign(
+				  std::make_move_iterator( items.begin( ) + offset + 1 ),
+				  std::make_move_iterator( items.end( ) ) );
+				insert_chunk( index + 1U, std::move( tail ) );
+				auto &head = m_items[index].items( );
+				head.erase( head.begin( ) + offset, head.end( ) );
+			}
+			--m_count;
+			if( pos + 1U == m_size ) {
+				m_size = m_items.empty( ) ? 0 : m_items.back( ).end( );
+			}
+			return true;
 		}
 
-		[[nodiscard]] decltype( auto ) dereference( ) const {
-			return ( *m_items )[m_position];
+		void clear( ) {
+			while( not m_items.empty( ) ) {
+				remove_chunk( m_items.size( ) - 1U );
+			}
+			m_size = 0;
+			m_count = 0;
+		}
+
+		/***
+		 * Call func( start, span ) for each run of set positions overlapping
+		 * [first, last), with span holding the values from position start on.
+		 * Each span is contiguous so it can be processed with SIMD
+		 */
+		template<typename Function>
+		void for_each_dense( Function &&func, size_t first = 0,
+		                     size_t last = npos ) {
+			auto index = chunk_before( first );
+			if( index == npos or m_items[index].end( ) <= first ) {
+				index = index == npos ? 0 : index + 1U;
+			}
+			for( ; index < m_items.size( ) and m_starts[index] < last; ++index ) {
+				auto &items = m_items[index].items( );
+				size_t const start = std::max( first, m_starts[index] );
+				size_t const end = std::min( last, m_items[index].end( ) );
+				func( start, daw::span<T>( items.data( ) + ( start - m_starts[index] ),
+				                           end - start ) );
+			}
 		}
 
-		void advance( ptrdiff_t n ) {
-			if( 0 > n ) {
-				n *= -1;
-				if( n >= m_position ) {
-					m_position = 0;
-				} else {
-					m_position -= n;
-				}
-			} else {
-				m_position += n;
-				{
-					auto sz = m_items->size( );
-					if( sz < m_position ) {
-						m_position = sz;
-					}
-				}
+		template<typename Function>
+		void for_each_dense( Function &&func, size_t first = 0,
+		                     size_t last = npos ) const {
+			auto index = chunk_before( first );
+			if( index == npos or m_items[index].end( ) <= first ) {
+				index = index == npos ? 0 : index + 1U;
+			}
+			for( ; index < m_items.size( ) and m_starts[index] < last; ++index ) {
+				auto const &items = m_items[index].items( );
+				size_t const start = std::max( first, m_starts[index] );
+				size_t const end = std::min( last, m_items[index].end( ) );
+				func( start,
+				      daw::span<T const>( items.data( ) + ( start - m_starts[index] ),
+				                          end - start ) );
 			}
 		}
 
-		[[nodiscard]] reference operator*( ) {
-			return dereference( );
+		// Iteration visits the set positions in order
+		[[nodiscard]] iterator begin( ) {
+			return iterator( this, 0, 0 );
 		}
 
-		[[nodiscard]] pointer operator->( ) {
-			return &dereference( );
+		[[nodiscard]] const_iterator begin( ) const {
+			return const_iterator( this, 0, 0 );
 		}
 
-		[[nodiscard]] const_reference operator*( ) const {
-			return dereference( );
+		[[nodiscard]] const_iterator cbegin( ) const {
+			return begin( );
 		}
 
-		[[nodiscard]] const_pointer operator->( ) const {
-			return &dereference( );
+		[[nodiscard]] iterator end( ) {
+			return iterator( this, m_items.size( ), 0 );
 		}
 
-		clumpy_sparsy_iterator &operator++( ) {
-			increment( );
-			return *this;
+		[[nodiscard]] const_iterator end( ) const {
+			return const_iterator( this, m_items.size( ), 0 );
 		}
 
-		clumpy_sparsy_iterator operator++( int ) {
-			auto result = *this;
-			increment( );
-			return result;
+		[[nodiscard]] const_iterator cend( ) const {
+			return end( );
 		}
+	}; // class clumpy_sparsy
 
-		clumpy_sparsy_iterator &operator--( ) {
-			decrement( );
-			return *this;
+	template<typename T, typename Allocator>
+	struct clumpy_sparsy_iterator {
+		using container_type =
+		  std::conditional_t<std::is_const_v<T>,
+		                     clumpy_sparsy<std::remove_const_t<T>, Allocator> const,
+		                     clumpy_sparsy<std::remove_const_t<T>, Allocator>>;
+		using difference_type = std::ptrdiff_t;
+		using size_type = std::size_t;
+		using value_type = std::remove_const_t<T>;
+		using pointer = T *;
+		using reference = T &;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+	private:
+		container_type *m_items = nullptr;
+		size_t m_chunk = 0;
+		size_t m_offset = 0;
+
+		template<typename, typename>
+		friend struct clumpy_sparsy_iterator;
+
+	public:
+		constexpr clumpy_sparsy_iterator( ) noexcept = default;
+
+		constexpr clumpy_sparsy_iterator( container_type *items, size_t chunk,
+		                                  size_t offset ) noexcept
+		  : m_items( items )
+		  , m_chunk( chunk )
+		  , m_offset( offset ) {}
+
+		template<typename U = T,
+		         std::enable_if_t<std::is_const_v<U>, std::nullptr_t> = nullptr>
+		constexpr clumpy_sparsy_iterator(
+		  clumpy_sparsy_iterator<std::remove_const_t<T>, Allocator> const
+		    &other ) noexcept
+		  : m_items( other.m_items )
+		  , m_chunk( other.m_chunk )
+		  , m_offset( other.m_offset ) {}
+
+		// The position in the container of the current value
+		[[nodiscard]] size_t position( ) const {
+			return m_items->m_starts[m_chunk] + m_offset;
 		}
 
-		clumpy_sparsy_iterator operator--( int ) {
-			clumpy_sparsy_iterator result = *this;
-			decrement( );
-			return result;
+		[[nodiscard]] reference operator*( ) const {
+			return m_items->m_items[m_chunk].items( )[m_offset];
 		}
 
-		clumpy_sparsy_iterator &operator+=( difference_type n ) {
-			advance( n );
-			return *this;
+		[[nodiscard]] pointer operator->( ) const {
+			return &**this;
 		}
 
-		clumpy_sparsy_iterator &operator-=( difference_type n ) {
-			advance( -n );
+		clumpy_sparsy_iterator &operator++( ) {
+			if( ++m_offset == m_items->m_items[m_chunk].size( ) ) {
+				++m_chunk;
+				m_offset = 0;
+			}
 			return *this;
 		}
 
-		clumpy_sparsy_iterator operator+( difference_type n ) const noexcept {
+		clumpy_sparsy_iterator operator++( int ) {
 			auto result = *this;
-			advance( n );
+			++*this;
 			return result;
 		}
 
-		clumpy_sparsy_iterator operator-( difference_type n ) const noexcept {
-			clumpy_sparsy_iterator result = *this;
-			advance( -n );
-			return result;
-		}
-
-		[[nodiscard]] reference operator[]( size_type n ) noexcept {
-			return ( *m_items )[m_position + n];
+		clumpy_sparsy_iterator &operator--( ) {
+			if( m_offset == 0 ) {
+				--m_chunk;
+				m_offset = m_items->m_items[m_chunk].size( );
+			}
+			--m_offset;
+			return *this;
 		}
 
-		[[nodiscard]] const_reference operator[]( size_type n ) const noexcept {
-			return ( *m_items )[m_position + n];
+		clumpy_sparsy_iterator operator--( int ) {
+			auto result = *this;
+			--*this;
+			return result;
 		}
 
 		friend bool operator==( clumpy_sparsy_iterator const &lhs,
 		                        clumpy_sparsy_iterator const &rhs ) {
-			return lhs.ptr == rhs.ptr;
+			return lhs.m_chunk == rhs.m_chunk and lhs.m_offset == rhs.m_offset;
 		}
 
 		friend bool operator!=( clumpy_sparsy_iterator const &lhs,
 		                        clumpy_sparsy_iterator const &rhs ) {
-			return lhs.ptr != rhs.ptr;
-		}
-
-		friend bool operator<( clumpy_sparsy_iterator const &lhs,
-		                       clumpy_sparsy_iterator const &rhs ) {
-			return lhs.ptr < rhs.ptr;
-		}
-
-		friend bool operator<=( clumpy_sparsy_iterator const &lhs,
-		                        clumpy_sparsy_iterator const &rhs ) {
-			return lhs.ptr <= rhs.ptr;
-		}
-
-		friend bool operator>( clumpy_sparsy_iterator const &lhs,
-		                       clumpy_sparsy_iterator const &rhs ) {
-			return lhs.ptr > rhs.ptr;
-		}
-
-		friend bool operator>=( clumpy_sparsy_iterator const &lhs,
-		                        clumpy_sparsy_iterator const &rhs ) {
-			return lhs.ptr >= rhs.ptr;
+			return not( lhs == rhs );
 		}
 	}; // class clumpy_sparsy_iterator
-
 } // namespace daw
@@ -51,11 +51,11 @@ namespace daw::mixins {
 			return derived( ).container( ).end( );
 		}
 
-		[[nodiscard]] const_iterator cbegin( ) {
+		[[nodiscard]] const_iterator cbegin( ) const {
 			return derived( ).container( ).cbegin( );
 		}
 
-		[[nodiscard]] const_iterator cend( ) {
+		[[nodiscard]] const_iterator cend( ) const {
 			return derived( ).container( ).cend( );
 		}
 
@@ -64,7 +64,7 @@ namespace daw::mixins {
 		}
 
 		template<typename... Args>
-		void emplace( iterator where, Args &&...args ) {
+		iterator emplace( iterator where, Args &&...args ) {
 			return derived( ).container( ).emplace( where,
 			                                        std::forward<Args>( args )... );
 		}
@@ -10,6 +10,7 @@
 
 #include "cpp_17.h"
 #include "daw_algorithm.h"
+#include "daw_execution_policy.h"
 #include "daw_math.h"
 #include "daw_traits.h"
 
@@ -90,7 +91,10 @@ namespace daw {
 			std::sort( begin( container ), end( container ) );
 		}
 
-		template<typename Sortable, typename Compare>
+		template<
+		  typename Sortable, typename Compare,
+		  std::enable_if_t<not execution::is_execution_policy_v<Sortable>,
+		                   std::nullptr_t> = nullptr>
 		void sort( Sortable &container, Compare &&compare ) noexcept(
 		  impl::is_nothrow_sortable<Sortable, Compare>( ) ) {
 			using std::begin;
@@ -0,0 +1,126 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_traits.h"
+
+#include <ciso646>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Tells the compiler iterations of the following loop are independent
+#if defined( __clang__ )
+#define DAW_UNSEQ_LOOP _Pragma( "clang loop vectorize( enable )" )
+#elif defined( __GNUC__ )
+#define DAW_UNSEQ_LOOP _Pragma( "GCC ivdep" )
+#else
+#define DAW_UNSEQ_LOOP
+#endif
+
+namespace daw {
+	class thread_pool;
+} // namespace daw
+
+/***
+ * Execution policies for the daw::algorithm and daw::container overloads that
+ * take one as their first argument, those are in daw_algorithm_execution.h.
+ * They mirror the ones in <execution> but run on a daw::thread_pool, so no
+ * TBB or library support is needed.  Parallel overloads require random
+ * access iterators and run sequentially otherwise.  Unlike std, an exception
+ * thrown by an element access or user callable is rethrown to the caller
+ * after all chunks finish
+ */
+namespace daw::execution {
+	struct sequenced_policy {};
+
+	struct parallel_policy {
+		thread_pool *pool = nullptr;
+
+		/***
+		 * @return a policy that runs on pool instead of default_thread_pool( )
+		 */
+		[[nodiscard]] constexpr parallel_policy on( thread_pool &p ) const {
+			return parallel_policy{ &p };
+		}
+	};
+
+	// Parallel and each chunk is a loop the compiler may vectorize
+	struct parallel_unsequenced_policy {
+		thread_pool *pool = nullptr;
+
+		[[nodiscard]] constexpr parallel_unsequenced_policy
+		on( thread_pool &p ) const {
+			return parallel_unsequenced_policy{ &p };
+		}
+	};
+
+	inline constexpr sequenced_policy seq{ };
+	inline constexpr parallel_policy par{ };
+	inline constexpr parallel_unsequenced_policy par_unseq{ };
+
+	template<typename T>
+	inline constexpr bool is_execution_policy_v =
+	  daw::traits::is_one_of_v<daw::remove_cvref_t<T>, sequenced_policy,
+	                           parallel_policy, parallel_unsequenced_policy>;
+} // namespace daw::execution
+
+namespace daw::execution_impl {
+	// Below this many elements per chunk the work is not split
+	inline constexpr std::size_t min_chunk_size = 1U << 12U;
+
+	template<typename Iterator>
+	inline constexpr bool is_random_iterator_v = std::is_base_of_v<
+	  std::random_access_iterator_tag,
+	  typename std::iterator_traits<Iterator>::iterator_category>;
+
+	template<typename ExecutionPolicy, typename... Iterators>
+	inline constexpr bool is_parallel_v =
+	  not std::is_same_v<daw::remove_cvref_t<ExecutionPolicy>,
+	                     execution::sequenced_policy> and
+	  ( is_random_iterator_v<Iterators> and ... );
+
+	template<typename ExecutionPolicy>
+	inline constexpr bool is_unsequenced_v =
+	  std::is_same_v<daw::remove_cvref_t<ExecutionPolicy>,
+	                 execution::parallel_unsequenced_policy>;
+
+	// it[n] without a sign conversion
+	template<typename Iterator>
+	[[nodiscard]] constexpr decltype( auto ) at( Iterator const &it,
+	                                             std::size_t n ) {
+		return it[static_cast<
+		  typename std::iterator_traits<Iterator>::difference_type>( n )];
+	}
+
+	template<typename Iterator>
+	[[nodiscard]] constexpr Iterator advance( Iterator it, std::size_t n ) {
+		using difference_t =
+		  typename std::iterator_traits<Iterator>::difference_type;
+		return it + static_cast<difference_t>( n );
+	}
+
+	/***
+	 * Call func( n ) for n in [first, last), telling the compiler the
+	 * iterations are independent for par_unseq
+	 */
+	template<typename ExecutionPolicy, typename Function>
+	inline void loop( std::size_t first, std::size_t last, Function &&func ) {
+		if constexpr( is_unsequenced_v<ExecutionPolicy> ) {
+			DAW_UNSEQ_LOOP
+			for( std::size_t n = first; n < last; ++n ) {
+				func( n );
+			}
+		} else {
+			for( std::size_t n = first; n < last; ++n ) {
+				func( n );
+			}
+		}
+	}
+} // namespace daw::execution_impl
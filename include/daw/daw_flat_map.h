@@ -0,0 +1,503 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_exception.h"
+#include "daw_span.h"
+#include "iterator/daw_zipiter.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/***
+	 * How flat_map lays out the keys it searches.
+	 * sorted: binary search over the sorted keys
+	 * eytzinger: a second copy of the keys in breadth first tree order, so the
+	 * first levels of every search share a few cache lines.  This costs an
+	 * O(n) rebuild on each change, prefer insert_range to fill it
+	 */
+	enum class flat_map_layout { sorted, eytzinger };
+
+	namespace flat_map_impl {
+		[[nodiscard]] inline std::size_t
+		countr_one( std::size_t value ) noexcept {
+#if defined( __GNUC__ ) or defined( __clang__ )
+			return static_cast<std::size_t>( __builtin_ctzll(
+			  static_cast<unsigned long long>( ~value ) ) );
+#else
+			std::size_t count = 0;
+			while( ( value & 1U ) == 1U ) {
+				value >>= 1U;
+				++count;
+			}
+			return count;
+#endif
+		}
+
+		/***
+		 * lower_bound without a data dependent branch, the loop runs
+		 * log2( size ) times and the step is chosen with a conditional move
+		 */
+		template<typename T, typename K, typename Compare>
+		[[nodiscard]] std::size_t branchless_lower_bound( T const *first,
+		                                                  std::size_t size,
+		                                                  K const &key,
+		                                                  Compare const &comp ) {
+			if( size == 0 ) {
+				return 0;
+			}
+			T const *base = first;
+			while( size > 1 ) {
+				std::size_t const half = size / 2U;
+				base = comp( base[half], key ) ? base + half : base;
+				size -= half;
+			}
+			return static_cast<std::size_t>( base - first ) +
+			       static_cast<std::size_t>( comp( *base, key ) );
+		}
+
+		/***
+		 * lower_bound over keys in Eytzinger order, where node k's children are
+		 * 2k and 2k + 1 and node k is stored at k - 1.
+		 * @return the node of the first key not less than key, or 0 for none
+		 */
+		template<typename T, typename K, typename Compare>
+		[[nodiscard]] std::size_t eytzinger_lower_bound( T const *nodes,
+		                                                 std::size_t size,
+		                                                 K const &key,
+		                                                 Compare const &comp ) {
+			std::size_t k = 1;
+			while( k <= size ) {
+				k = 2U * k + static_cast<std::size_t>( comp( nodes[k - 1U], key ) );
+			}
+			// Undo the right turns taken after the last left turn
+			return k >> ( countr_one( k ) + 1U );
+		}
+
+		// Fill index so that index[k - 1] is the sorted position of node k
+		inline std::size_t eytzinger_index( std::size_t *index, std::size_t size,
+		                                    std::size_t pos, std::size_t k ) {
+			if( k <= size ) {
+				pos = eytzinger_index( index, size, pos, 2U * k );
+				index[k - 1U] = pos++;
+				pos = eytzinger_index( index, size, pos, 2U * k + 1U );
+			}
+			return pos;
+		}
+	} // namespace flat_map_impl
+
+	/***
+	 * A map kept as a sorted array of keys and a parallel array of values.
+	 * Lookups search only the keys, which are contiguous, and iteration is in
+	 * key order.  Inserts and erases move the following elements, use
+	 * insert_range to add many elements with one sort and merge.  Iterators
+	 * dereference to a std::tuple<Key const &, Value &>
+	 */
+	template<typename Key, typename Value, typename Compare = std::less<Key>,
+	         typename Allocator = std::allocator<std::pair<Key const, Value>>,
+	         flat_map_layout Layout = flat_map_layout::sorted>
+	struct flat_map {
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<Key, Value>;
+		using key_compare = Compare;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using keys_type = std::vector<
+		  Key,
+		  typename std::allocator_traits<Allocator>::template rebind_alloc<Key>>;
+		using values_type = std::vector<
+		  Value,
+		  typename std::allocator_traits<Allocator>::template rebind_alloc<Value>>;
+		using iterator = daw::zip_iterator<typename keys_type::const_iterator,
+		                                   typename values_type::iterator>;
+		using const_iterator =
+		  daw::zip_iterator<typename keys_type::const_iterator,
+		                    typename values_type::const_iterator>;
+		static constexpr flat_map_layout layout = Layout;
+
+	private:
+		using index_type = std::vector<
+		  std::size_t, typename std::allocator_traits<
+		                 Allocator>::template rebind_alloc<std::size_t>>;
+
+		keys_type m_keys;
+		values_type m_values;
+		// The Eytzinger copy of m_keys and each node's sorted position.  Only
+		// used when it is the same size as m_keys
+		keys_type m_nodes;
+		index_type m_node_index;
+		key_compare m_compare{ };
+
+		static constexpr bool use_eytzinger = Layout == flat_map_layout::eytzinger;
+
+		[[nodiscard]] iterator make_iterator( std::size_t pos ) {
+			auto const offset = static_cast<difference_type>( pos );
+			return iterator( m_keys.cbegin( ) + offset, m_values.begin( ) + offset );
+		}
+
+		[[nodiscard]] const_iterator make_iterator( std::size_t pos ) const {
+			auto const offset = static_cast<difference_type>( pos );
+			return const_iterator( m_keys.cbegin( ) + offset,
+			                       m_values.cbegin( ) + offset );
+		}
+
+		[[nodiscard]] bool nodes_ready( ) const {
+			return m_nodes.size( ) == m_keys.size( ) and not m_keys.empty( );
+		}
+
+		/***
+		 * Bring the Eytzinger copy up to date.  The copy is only an index, if
+		 * building it fails lookups binary search the keys until the next change
+		 */
+		void rebuild_layout( ) noexcept {
+			if constexpr( use_eytzinger ) {
+				m_nodes.clear( );
+				try {
+					m_node_index.resize( m_keys.size( ) );
+					(void)flat_map_impl::eytzinger_index(
+					  m_node_index.data( ), m_keys.size( ), 0, 1 );
+					m_nodes.reserve( m_keys.size( ) );
+					for( std::size_t pos : m_node_index ) {
+						m_nodes.push_back( m_keys[pos] );
+					}
+				} catch( ... ) { m_nodes.clear( ); }
+			}
+		}
+
+		// The sorted position of the first key not less than key
+		template<typename K>
+		[[nodiscard]] std::size_t lower_bound_pos( K const &key ) const {
+			if constexpr( use_eytzinger ) {
+				if( nodes_ready( ) ) {
+					std::size_t const node = flat_map_impl::eytzinger_lower_bound(
+					  m_nodes.data( ), m_nodes.size( ), key, m_compare );
+					return node == 0 ? m_keys.size( ) : m_node_index[node - 1U];
+				}
+			}
+			return flat_map_impl::branchless_lower_bound(
+			  m_keys.data( ), m_keys.size( ), key, m_compare );
+		}
+
+		// The position of key, or size( ) when it is not present
+		template<typename K>
+		[[nodiscard]] std::size_t find_pos( K const &key ) const {
+			if constexpr( use_eytzinger ) {
+				if( nodes_ready( ) ) {
+					std::size_t const node = flat_map_impl::eytzinger_lower_bound(
+					  m_nodes.data( ), m_nodes.size( ), key, m_compare );
+					if( node == 0 or m_compare( key, m_nodes[node - 1U] ) ) {
+						return m_keys.size( );
+					}
+					return m_node_index[node - 1U];
+				}
+			}
+			std::size_t const pos = lower_bound_pos( key );
+			if( pos == m_keys.size( ) or m_compare( key, m_keys[pos] ) ) {
+				return m_keys.size( );
+			}
+			return pos;
+		}
+
+		template<typename K, typename... Args>
+		std::size_t insert_at( std::size_t pos, K &&key, Args &&...args ) {
+			auto const offset = static_cast<difference_type>( pos );
+			m_keys.insert( m_keys.begin( ) + offset, std::forward<K>( key ) );
+			try {
+				m_values.emplace( m_values.begin( ) + offset,
+				                  std::forward<Args>( args )... );
+			} catch( ... ) {
+				m_keys.erase( m_keys.begin( ) + offset );
+				throw;
+			}
+			rebuild_layout( );
+			return pos;
+		}
+
+	public:
+		flat_map( ) = default;
+
+		explicit flat_map( key_compare const &comp,
+		                   allocator_type const &alloc = allocator_type( ) )
+		  : m_keys( typename keys_type::allocator_type( alloc ) )
+		  , m_values( typename values_type::allocator_type( alloc ) )
+		  , m_nodes( typename keys_type::allocator_type( alloc ) )
+		  , m_node_index( typename index_type::allocator_type( alloc ) )
+		  , m_compare( comp ) {}
+
+		explicit flat_map( allocator_type const &alloc )
+		  : flat_map( key_compare( ), alloc ) {}
+
+		template<typename InputIterator>
+		flat_map( InputIterator first, InputIterator last,
+		          key_compare const &comp = key_compare( ),
+		          allocator_type const &alloc = allocator_type( ) )
+		  : flat_map( comp, alloc ) {
+			insert_range( first, last );
+		}
+
+		flat_map( std::initializer_list<value_type> init,
+		          key_compare const &comp = key_compare( ),
+		          allocator_type const &alloc = allocator_type( ) )
+		  : flat_map( comp, alloc ) {
+			insert_range( init.begin( ), init.end( ) );
+		}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return allocator_type( m_keys.get_allocator( ) );
+		}
+
+		[[nodiscard]] key_compare key_comp( ) const {
+			return m_compare;
+		}
+
+		[[nodiscard]] iterator begin( ) {
+			return make_iterator( 0 );
+		}
+
+		[[nodiscard]] const_iterator begin( ) const {
+			return make_iterator( 0 );
+		}
+
+		[[nodiscard]] const_iterator cbegin( ) const {
+			return make_iterator( 0 );
+		}
+
+		[[nodiscard]] iterator end( ) {
+			return make_iterator( size( ) );
+		}
+
+		[[nodiscard]] const_iterator end( ) const {
+			return make_iterator( size( ) );
+		}
+
+		[[nodiscard]] const_iterator cend( ) const {
+			return make_iterator( size( ) );
+		}
+
+		[[nodiscard]] bool empty( ) const {
+			return m_keys.empty( );
+		}
+
+		[[nodiscard]] size_type size( ) const {
+			return m_keys.size( );
+		}
+
+		// The keys in sorted order
+		[[nodiscard]] daw::span<Key const> keys( ) const {
+			return daw::span<Key const>( m_keys.data( ), m_keys.size( ) );
+		}
+
+		// The values, in the order of their keys
+		[[nodiscard]] daw::span<Value> values( ) {
+			return daw::span<Value>( m_values.data( ), m_values.size( ) );
+		}
+
+		[[nodiscard]] daw::span<Value const> values( ) const {
+			return daw::span<Value const>( m_values.data( ), m_values.size( ) );
+		}
+
+		void reserve( size_type count ) {
+			m_keys.reserve( count );
+			m_values.reserve( count );
+			if constexpr( use_eytzinger ) {
+				m_nodes.reserve( count );
+				m_node_index.reserve( count );
+			}
+		}
+
+		void clear( ) {
+			m_keys.clear( );
+			m_values.clear( );
+			m_nodes.clear( );
+			m_node_index.clear( );
+		}
+
+		template<typename K>
+		[[nodiscard]] iterator find( K const &key ) {
+			return make_iterator( find_pos( key ) );
+		}
+
+		template<typename K>
+		[[nodiscard]] const_iterator find( K const &key ) const {
+			return make_iterator( find_pos( key ) );
+		}
+
+		template<typename K>
+		[[nodiscard]] bool contains( K const &key ) const {
+			return find_pos( key ) != size( );
+		}
+
+		template<typename K>
+		[[nodiscard]] size_type count( K const &key ) const {
+			return contains( key ) ? 1U : 0U;
+		}
+
+		template<typename K>
+		[[nodiscard]] iterator lower_bound( K const &key ) {
+			return make_iterator( lower_bound_pos( key ) );
+		}
+
+		template<typename K>
+		[[nodiscard]] const_iterator lower_bound( K const &key ) const {
+			return make_iterator( lower_bound_pos( key ) );
+		}
+
+		template<typename K>
+		[[nodiscard]] Value &at( K const &key ) {
+			std::size_t const pos = find_pos( key );
+			daw::exception::precondition_check<std::out_of_range>( pos != size( ),
+			                                                       "key" );
+			return m_values[pos];
+		}
+
+		template<typename K>
+		[[nodiscard]] Value const &at( K const &key ) const {
+			std::size_t const pos = find_pos( key );
+			daw::exception::precondition_check<std::out_of_range>( pos != size( ),
+			                                                       "key" );
+			return m_values[pos];
+		}
+
+		/***
+		 * Construct the value from args if key is not present
+		 * @return the element for key and whether it was inserted
+		 */
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> try_emplace( K &&key, Args &&...args ) {
+			std::size_t const pos = lower_bound_pos( key );
+			if( pos != size( ) and not m_compare( key, m_keys[pos] ) ) {
+				return { make_iterator( pos ), false };
+			}
+			insert_at( pos, std::forward<K>( key ), std::forward<Args>( args )... );
+			return { make_iterator( pos ), true };
+		}
+
+		std::pair<iterator, bool> insert( value_type const &value ) {
+			return try_emplace( value.first, value.second );
+		}
+
+		std::pair<iterator, bool> insert( value_type &&value ) {
+			return try_emplace( std::move( value.first ), std::move( value.second ) );
+		}
+
+		template<typename K, typename V>
+		std::pair<iterator, bool> insert_or_assign( K &&key, V &&value ) {
+			std::size_t const pos = lower_bound_pos( key );
+			if( pos != size( ) and not m_compare( key, m_keys[pos] ) ) {
+				m_values[pos] = std::forward<V>( value );
+				return { make_iterator( pos ), false };
+			}
+			insert_at( pos, std::forward<K>( key ), std::forward<V>( value ) );
+			return { make_iterator( pos ), true };
+		}
+
+		template<typename K>
+		Value &operator[]( K &&key ) {
+			std::size_t const pos = lower_bound_pos( key );
+			if( pos != size( ) and not m_compare( key, m_keys[pos] ) ) {
+				return m_values[pos];
+			}
+			insert_at( pos, std::forward<K>( key ) );
+			return m_values[pos];
+		}
+
+		/***
+		 * Insert the pairs in [first, last) whose keys are not present, keeping
+		 * the first of any duplicates like repeated insert would.  The new
+		 * elements are sorted on their own and merged in with one pass
+		 */
+		template<typename InputIterator>
+		void insert_range( InputIterator first, InputIterator last ) {
+			using pair_alloc = typename std::allocator_traits<
+			  Allocator>::template rebind_alloc<value_type>;
+			auto added = std::vector<value_type, pair_alloc>(
+			  first, last, pair_alloc( get_allocator( ) ) );
+			if( added.empty( ) ) {
+				return;
+			}
+			auto const less = [&]( value_type const &lhs, value_type const &rhs ) {
+				return m_compare( lhs.first, rhs.first );
+			};
+			std::stable_sort( added.begin( ), added.end( ), less );
+			added.erase( std::unique( added.begin( ), added.end( ),
+			                          [&]( value_type const &lhs,
+			                               value_type const &rhs ) {
+				                          return not less( lhs, rhs );
+			                          } ),
+			             added.end( ) );
+
+			auto keys = keys_type( m_keys.get_allocator( ) );
+			auto values = values_type( m_values.get_allocator( ) );
+			keys.reserve( m_keys.size( ) + added.size( ) );
+			values.reserve( m_keys.size( ) + added.size( ) );
+			// Existing elements are copied unless moving cannot throw, so a
+			// failure part way leaves the map as it was
+			auto const take_existing = [&]( std::size_t pos ) {
+				if constexpr( std::is_nothrow_move_constructible_v<Key> and
+				              std::is_nothrow_move_constructible_v<Value> ) {
+					keys.push_back( std::move( m_keys[pos] ) );
+					values.push_back( std::move( m_values[pos] ) );
+				} else {
+					keys.push_back( m_keys[pos] );
+					values.push_back( m_values[pos] );
+				}
+			};
+			std::size_t pos = 0;
+			for( auto &item : added ) {
+				for( ; pos < m_keys.size( ) and m_compare( m_keys[pos], item.first );
+				     ++pos ) {
+					take_existing( pos );
+				}
+				if( pos == m_keys.size( ) or m_compare( item.first, m_keys[pos] ) ) {
+					keys.push_back( std::move( item.first ) );
+					values.push_back( std::move( item.second ) );
+				}
+			}
+			for( ; pos < m_keys.size( ); ++pos ) {
+				take_existing( pos );
+			}
+			m_keys = std::move( keys );
+			m_values = std::move( values );
+			rebuild_layout( );
+		}
+
+		template<typename K>
+		size_type erase( K const &key ) {
+			std::size_t const pos = find_pos( key );
+			if( pos == size( ) ) {
+				return 0;
+			}
+			auto const offset = static_cast<difference_type>( pos );
+			m_keys.erase( m_keys.begin( ) + offset );
+			m_values.erase( m_values.begin( ) + offset );
+			rebuild_layout( );
+			return 1;
+		}
+	}; // struct flat_map
+
+	// A flat_map searched in Eytzinger order
+	template<typename Key, typename Value, typename Compare = std::less<Key>,
+	         typename Allocator = std::allocator<std::pair<Key const, Value>>>
+	using eytzinger_flat_map =
+	  flat_map<Key, Value, Compare, Allocator, flat_map_layout::eytzinger>;
+} // namespace daw
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "daw/cpp_17.h"
+#include "daw/daw_musttail.h"
 #include "daw/daw_traits.h"
 
 #include <array>
@@ -18,8 +19,19 @@
 #include <cstdlib>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
 
+/***
+ * Threaded code dispatch.  A handler in a function_table_t of function
+ * pointers ends with DAW_TAIL_DISPATCH( table, next_op, args... ) instead
+ * of returning to a central loop.  Each handler then has its own indirect
+ * jump for the branch predictor, as with computed goto, and DAW_MUSTTAIL
+ * keeps the stack from growing.  Handlers must all share one signature
+ */
+#define DAW_TAIL_DISPATCH( table, idx, ... ) \
+	DAW_MUSTTAIL return ( table ).fns[( idx )]( __VA_ARGS__ )
+
 namespace daw {
 	namespace function_table_impl {
 		template<
@@ -61,25 +73,35 @@ namespace daw {
 		  is_detected_v<is_t_callable_test, std::integral_constant<size_t, I>, T,
 		                Args...>;
 
-		template<typename R, bool allow_empty, size_t I, typename T,
-		         typename... Args>
-		static constexpr R apply_at_impl( size_t idx, T &&t, Args &&...args ) {
-			if( idx == I ) {
-				if constexpr( is_t_callable_v<I, T, Args...> ) {
-					return sfinae_get<I>( std::forward<T>( t ) )(
-					  std::forward<Args>( args )... );
-				} else if constexpr( allow_empty and is_t_callable_v<I, T> ) {
-					return sfinae_get<I>( std::forward<T>( t ) )( );
+		/***
+		 * One thunk per function in the tuple Fns, so calling index idx is a
+		 * single indirect call through table[idx]
+		 */
+		template<typename R, bool allow_empty, typename Fns, typename... Args>
+		struct jump_table {
+			using thunk_t = R ( * )( Fns const &, Args &&... );
+
+			template<size_t I>
+			static constexpr R thunk( Fns const &fns, Args &&...args ) {
+				if constexpr( is_t_callable_v<I, Fns const &, Args...> ) {
+					return std::get<I>( fns )( std::forward<Args>( args )... );
+				} else if constexpr( allow_empty and
+				                     is_t_callable_v<I, Fns const &> ) {
+					return std::get<I>( fns )( );
 				} else {
 					std::abort( );
 				}
 			}
-			if constexpr( is_t_in_range_v<I + 1, T> ) {
-				return apply_at_impl<R, allow_empty, I + 1>(
-				  idx, std::forward<T>( t ), std::forward<Args>( args )... );
+
+			template<size_t... Is>
+			static constexpr std::array<thunk_t, sizeof...( Is )>
+			make_table( std::index_sequence<Is...> ) {
+				return { { thunk<Is>... } };
 			}
-			std::abort( );
-		}
+
+			static constexpr auto table =
+			  make_table( std::make_index_sequence<std::tuple_size_v<Fns>>{ } );
+		};
 
 		template<size_t I, typename T, typename Value>
 		static constexpr void set_at_impl( size_t idx, T &&t, Value &&v ) {
@@ -101,6 +123,12 @@ namespace daw {
 		} // namespace
 	}   // namespace function_table_impl
 
+	/***
+	 * A table of functions called by index.  When every function has the same
+	 * type they are stored in an array, otherwise in a tuple that is called
+	 * through a constexpr array of thunks.  Either way a call is one indirect
+	 * jump
+	 */
 	template<typename R, typename Function, typename... Functions>
 	struct function_table_t {
 		static constexpr bool using_array_v =
@@ -121,14 +149,18 @@ namespace daw {
 			if constexpr( using_array_v ) {
 				return fns[idx]( std::forward<Args>( args )... );
 			} else {
-				return function_table_impl::apply_at_impl<R, allow_empty, 0>(
-				  idx, fns, std::forward<Args>( args )... );
+				using jump_table_t =
+				  function_table_impl::jump_table<R, allow_empty, value_t, Args...>;
+				if( idx >= size( ) ) {
+					std::abort( );
+				}
+				return jump_table_t::table[idx]( fns, std::forward<Args>( args )... );
 			}
 		}
 
 		template<bool allow_empty = false, typename... Args>
 		constexpr R operator( )( size_t idx, Args &&...args ) const {
-			return call( idx, std::forward<Args>( args )... );
+			return call<allow_empty>( idx, std::forward<Args>( args )... );
 		}
 
 		template<typename Value>
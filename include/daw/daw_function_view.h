@@ -8,35 +8,23 @@
 
 #pragma once
 
-#include <array>
 #include <cstddef>
 #include <cstdio>
-#include <cstring>
 #include <functional>
+#include <memory>
+#include <type_traits>
 #include <utility>
-#if __has_include( <version> )
-#include <version>
-#endif
-
-#if __has_include( <bit> )  and defined(__cpp_lib_bit_cast)
-#include <bit>
-#define DAW_BITCAST std::bit_cast
-#else
-#include "cpp_17.h"
-#define DAW_BITCAST daw::bit_cast
-#endif
 
 namespace daw {
 	template<typename Result, typename... Args>
 	struct function_view_table_storage {
-		using ref_buffer_t = std::array<std::byte, sizeof( void * )>;
 		using fp_t = Result ( * )( Args... );
 		union data_t {
-			ref_buffer_t ref_storage;
+			void const *ref_storage;
 			fp_t fp_storage;
 
-			explicit constexpr data_t( ref_buffer_t &&r )
-			  : ref_storage( std::move( r ) ) {}
+			explicit constexpr data_t( void const *r )
+			  : ref_storage( r ) {}
 			explicit constexpr data_t( fp_t f )
 			  : fp_storage( f ) {}
 		} data;
@@ -46,20 +34,20 @@ namespace daw {
 		template<typename Func>
 		static constexpr function_view_table_storage make( Func &&f ) {
 			using fn_t = std::remove_reference_t<Func>;
-			if constexpr( std::is_pointer_v<fn_t> ) {
+			if constexpr( std::is_pointer_v<fn_t> or std::is_function_v<fn_t> ) {
 				return { data_t{ f }, []( data_t const &d, Args... args ) -> Result {
 					        return ( d.fp_storage )( std::move( args )... );
 				        } };
 			} else if constexpr( std::is_empty_v<fn_t> and
 			                     std::is_default_constructible_v<fn_t> ) {
-				return { data_t{ nullptr },
+				return { data_t{ static_cast<fp_t>( nullptr ) },
 				         []( data_t const &, Args... args ) -> Result {
 					         return fn_t{ }( std::move( args )... );
 				         } };
 			} else {
-				return { data_t{ DAW_BITCAST<ref_buffer_t>( std::addressof( f ) ) },
+				return { data_t{ static_cast<void const *>( std::addressof( f ) ) },
 				         +[]( data_t const &d, Args... args ) -> Result {
-					         return ( *DAW_BITCAST<fn_t const *>( d.ref_storage ) )(
+					         return ( *static_cast<fn_t const *>( d.ref_storage ) )(
 					           std::move( args )... );
 				         } };
 			}
@@ -68,14 +56,13 @@ namespace daw {
 
 	template<typename... Args>
 	struct function_view_table_storage<void, Args...> {
-		using ref_buffer_t = std::array<std::byte, sizeof( void * )>;
 		using fp_t = void ( * )( Args... );
 		union data_t {
-			ref_buffer_t ref_storage;
+			void const *ref_storage;
 			fp_t fp_storage;
 
-			explicit constexpr data_t( ref_buffer_t &&r )
-			  : ref_storage( std::move( r ) ) {}
+			explicit constexpr data_t( void const *r )
+			  : ref_storage( r ) {}
 			explicit constexpr data_t( fp_t f )
 			  : fp_storage( f ) {}
 		} data;
@@ -85,19 +72,20 @@ namespace daw {
 		template<typename Func>
 		static constexpr function_view_table_storage make( Func &&f ) {
 			using fn_t = std::remove_reference_t<Func>;
-			if constexpr( std::is_pointer_v<fn_t> ) {
+			if constexpr( std::is_pointer_v<fn_t> or std::is_function_v<fn_t> ) {
 				return { data_t{ f }, []( data_t const &d, Args... args ) -> void {
 					        ( d.fp_storage )( std::move( args )... );
 				        } };
 			} else if constexpr( std::is_empty_v<fn_t> and
 			                     std::is_default_constructible_v<fn_t> ) {
-				return { data_t{ nullptr }, []( data_t const &, Args... args ) -> void {
-					        fn_t{ }( std::move( args )... );
-				        } };
+				return { data_t{ static_cast<fp_t>( nullptr ) },
+				         []( data_t const &, Args... args ) -> void {
+					         fn_t{ }( std::move( args )... );
+				         } };
 			} else {
-				return { data_t{ DAW_BITCAST<ref_buffer_t>( std::addressof( f ) ) },
+				return { data_t{ static_cast<void const *>( std::addressof( f ) ) },
 				         +[]( data_t const &d, Args... args ) -> void {
-					         ( *DAW_BITCAST<fn_t const *>( d.ref_storage ) )(
+					         ( *static_cast<fn_t const *>( d.ref_storage ) )(
 					           std::move( args )... );
 				         } };
 			}
@@ -111,7 +99,10 @@ namespace daw {
 	struct function_view<Result( Args... )> {
 		function_view_table_storage<Result, Args...> function_view_table;
 
-		template<typename Func>
+		template<typename Func,
+		         std::enable_if_t<
+		           not std::is_same_v<std::decay_t<Func>, function_view>,
+		           std::nullptr_t> = nullptr>
 		constexpr function_view( Func &&f )
 		  : function_view_table(
 		      function_view_table_storage<Result, Args...>::make( f ) ) {}
@@ -125,7 +116,10 @@ namespace daw {
 	struct function_view<void( Args... )> {
 		function_view_table_storage<void, Args...> function_view_table;
 
-		template<typename Func>
+		template<typename Func,
+		         std::enable_if_t<
+		           not std::is_same_v<std::decay_t<Func>, function_view>,
+		           std::nullptr_t> = nullptr>
 		constexpr function_view( Func &&f )
 		  : function_view_table( function_view_table_storage<void, Args...>::make(
 		      std::forward<Func>( f ) ) ) {}
@@ -137,4 +131,3 @@ namespace daw {
 	};
 } // namespace daw
 
-#undef DAW_BIT_CAST
@@ -18,9 +18,11 @@
 
 #include <algorithm>
 #include <ciso646>
+#include <cmath>
 #include <functional>
 #include <iterator>
 #include <list>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <utility>
@@ -292,7 +294,9 @@ namespace daw {
 		lhs.swap( rhs );
 	}
 
-	template<typename Value>
+	// Allocator is rebound to allocate the table's slots
+	template<typename Value,
+	         typename Allocator = std::allocator<daw::traits::root_type_t<Value>>>
 	struct hash_table {
 		using value_type = daw::traits::root_type_t<Value>;
 		using mapped_type = daw::traits::root_type_t<Value>;
@@ -301,9 +305,13 @@ namespace daw {
 		using const_reference = value_type const &;
 		using iterator = hash_table_item_iterator<value_type>;
 		using const_iterator = hash_table_item_iterator<value_type const>;
+		using allocator_type = Allocator;
 
 	private:
-		using values_type = daw::heap_array<impl::hash_table_item<value_type>>;
+		using values_type = daw::heap_array<
+		  impl::hash_table_item<value_type>,
+		  typename std::allocator_traits<Allocator>::template rebind_alloc<
+		    impl::hash_table_item<value_type>>>;
 		using priv_iterator = typename values_type::iterator;
 		double m_resize_ratio;
 		size_t m_load;
@@ -329,12 +337,14 @@ namespace daw {
 
 	public:
 		hash_table( size_t start_size, double resize_ratio = 2.0,
-		            size_t max_load_percent = 70 )
+		            size_t max_load_percent = 70,
+		            allocator_type const &alloc = allocator_type( ) )
 		  : m_resize_ratio{ resize_ratio }
 		  , m_load{ 0 }
 		  , m_growth_counter{ 0 }
 		  , m_max_load{ max_load_percent }
-		  , m_values{ start_size } {
+		  , m_values( start_size,
+		              typename values_type::allocator_type( alloc ) ) {
 
 			daw::exception::daw_throw_on_false( start_size > 0 );
 		}
@@ -342,6 +352,13 @@ namespace daw {
 		hash_table( )
 		  : hash_table( 7, 2.6, 50 ) {}
 
+		explicit hash_table( allocator_type const &alloc )
+		  : hash_table( 7, 2.6, 50, alloc ) {}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return allocator_type( m_values.get_allocator( ) );
+		}
+
 		~hash_table( ) = default;
 
 		hash_table( hash_table && ) noexcept = default;
@@ -419,7 +436,7 @@ namespace daw {
 		}
 
 		static size_t resize_table( values_type &old_table, size_t new_size ) {
-			values_type new_hash_table{ new_size };
+			values_type new_hash_table( new_size, old_table.get_allocator( ) );
 			size_t load = 0;
 			for( auto &&current_item : old_table ) {
 				if( current_item ) {
@@ -482,7 +499,7 @@ namespace daw {
 					// without evidence to support it.
 				}
 			}
-			if( !pos ) {
+			if( not *pos ) {
 				++tbl.m_load;
 				pos->hash = hash;
 			}
@@ -680,8 +697,9 @@ namespace daw {
 		return result;
 	}
 
-	template<typename T>
-	void swap( hash_table<T> &lhs, hash_table<T> &rhs ) noexcept {
+	template<typename T, typename Allocator>
+	void swap( hash_table<T, Allocator> &lhs,
+	           hash_table<T, Allocator> &rhs ) noexcept {
 		lhs.swap( rhs );
 	}
 } // namespace daw
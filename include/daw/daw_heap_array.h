@@ -14,51 +14,115 @@
 
 #include <algorithm>
 #include <ciso646>
+#include <initializer_list>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace daw {
-	template<typename T>
+	/***
+	 * A fixed size heap allocated array.  One extra element past end( ) is
+	 * allocated as the sentinel for find_first_of
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
 	struct heap_array {
 		using value_type = T;
+		using allocator_type = Allocator;
 		using reference = T &;
 		using const_reference = T const &;
 		using iterator = T *;
 		using const_iterator = T const *;
 
 	private:
+		using alloc_traits = std::allocator_traits<allocator_type>;
+		static_assert( std::is_same_v<typename alloc_traits::value_type, T>,
+		               "Allocator must allocate T" );
+
+		// Move assignment can take rhs's memory without comparing allocators
+		static constexpr bool steals_on_move =
+		  alloc_traits::propagate_on_container_move_assignment::value or
+		  alloc_traits::is_always_equal::value;
+
 		value_type *m_begin = nullptr;
 		value_type *m_end = nullptr;
 		size_t m_size = 0;
+		allocator_type m_alloc{ };
 
-		static value_type *create_value( size_t n ) {
+		// Allocate and default construct n + 1 values
+		value_type *create_value( size_t n ) {
+			value_type *const result = alloc_traits::allocate( m_alloc, n + 1 );
+			size_t constructed = 0;
 			try {
-				return new value_type[n];
-			} catch( std::bad_alloc const & ) { std::abort( ); } catch( ... ) {
-				return nullptr;
+				for( ; constructed <= n; ++constructed ) {
+					alloc_traits::construct( m_alloc, result + constructed );
+				}
+			} catch( ... ) {
+				destroy_values( result, constructed );
+				alloc_traits::deallocate( m_alloc, result, n + 1 );
+				throw;
 			}
+			return result;
+		}
+
+		void destroy_values( value_type *values, size_t count ) noexcept {
+			while( count-- > 0 ) {
+				alloc_traits::destroy( m_alloc, values + count );
+			}
+		}
+
+		void assign_copy( heap_array const &other ) {
+			if( other.m_begin == nullptr ) {
+				return;
+			}
+			m_begin = create_value( other.m_size );
+			m_end = m_begin + other.m_size;
+			m_size = other.m_size;
+			std::copy_n( other.m_begin, m_size, m_begin );
 		}
 
 	public:
-		constexpr heap_array( ) noexcept = default;
+		constexpr heap_array( ) = default;
 
-		heap_array( size_t Size )
-		  : m_begin( create_value( Size + 1 ) )
-		  , m_end( m_begin + Size )
-		  , m_size( Size ) {}
+		explicit heap_array( allocator_type const &alloc ) noexcept
+		  : m_alloc( alloc ) {}
 
-		heap_array( size_t Size, value_type const &def_value )
-		  : heap_array( Size ) {
+		heap_array( size_t Size, allocator_type const &alloc = allocator_type( ) )
+		  : m_alloc( alloc ) {
+			m_begin = create_value( Size );
+			m_end = m_begin + Size;
+			m_size = Size;
+		}
+
+		heap_array( size_t Size, value_type const &def_value,
+		            allocator_type const &alloc = allocator_type( ) )
+		  : heap_array( Size, alloc ) {
 
 			std::fill( m_begin, m_end, def_value );
 		}
 
-		constexpr heap_array( heap_array &&other ) noexcept
+		heap_array( heap_array &&other ) noexcept
 		  : m_begin( daw::exchange( other.m_begin, nullptr ) )
-		  , m_end( daw::exchange( other.m_begin, nullptr ) )
-		  , m_size( daw::exchange( other.m_size, 0ULL ) ) {}
+		  , m_end( daw::exchange( other.m_end, nullptr ) )
+		  , m_size( daw::exchange( other.m_size, 0ULL ) )
+		  , m_alloc( std::move( other.m_alloc ) ) {}
 
-		constexpr heap_array &operator=( heap_array &&rhs ) noexcept {
+		heap_array &operator=( heap_array &&rhs ) noexcept( steals_on_move ) {
+			if( this == &rhs ) {
+				return *this;
+			}
+			clear( );
+			if constexpr( not steals_on_move ) {
+				if( m_alloc != rhs.m_alloc ) {
+					// Cannot take memory owned by another allocator
+					assign_copy( rhs );
+					return *this;
+				}
+			}
+			if constexpr( alloc_traits::propagate_on_container_move_assignment::
+			                value ) {
+				m_alloc = std::move( rhs.m_alloc );
+			}
 			m_begin = daw::exchange( rhs.m_begin, nullptr );
 			m_end = daw::exchange( rhs.m_end, nullptr );
 			m_size = daw::exchange( rhs.m_size, 0ULL );
@@ -66,53 +130,65 @@ namespace daw {
 		}
 
 		heap_array( heap_array const &other )
-		  : m_begin( other.m_size == 0 ? nullptr : create_value( other.m_size ) )
-		  , m_end( other.m_size == 0 ? nullptr : m_begin + other.m_size )
-		  , m_size( other.m_size ) {
+		  : m_alloc( alloc_traits::select_on_container_copy_construction(
+		      other.m_alloc ) ) {
+			assign_copy( other );
+		}
 
-			std::copy_n( other.m_begin, m_size, m_begin );
+		heap_array( heap_array const &other, allocator_type const &alloc )
+		  : m_alloc( alloc ) {
+			assign_copy( other );
 		}
 
 		heap_array &operator=( heap_array const &rhs ) {
 			if( this != &rhs ) {
 				clear( );
-				if( rhs.m_begin == nullptr ) {
-					return *this;
+				if constexpr( alloc_traits::propagate_on_container_copy_assignment::
+				                value ) {
+					m_alloc = rhs.m_alloc;
 				}
-				m_size = rhs.m_size;
-				m_begin = create_value( m_size );
-				m_end = m_begin + m_size;
-				std::copy_n( rhs.m_begin, m_size, m_begin );
+				assign_copy( rhs );
 			}
 			return *this;
 		}
 
 		heap_array &operator=( std::initializer_list<value_type> const &values ) {
-			heap_array tmp( values.size( ) );
+			heap_array tmp( values.size( ), m_alloc );
 			std::copy_n( values.begin( ), values.size( ), tmp.m_begin );
-			daw::cswap( *this, tmp );
+			daw::cswap( m_begin, tmp.m_begin );
+			daw::cswap( m_end, tmp.m_end );
+			daw::cswap( m_size, tmp.m_size );
 			return *this;
 		}
 
-		heap_array( iterator arry, size_t Size )
-		  : m_begin( create_value( Size ) )
-		  , m_end( m_begin + Size )
-		  , m_size( Size ) {
+		heap_array( iterator arry, size_t Size,
+		            allocator_type const &alloc = allocator_type( ) )
+		  : heap_array( Size, alloc ) {
 
 			std::copy_n( arry, Size, m_begin );
 		}
 
-		constexpr void clear( ) noexcept {
+		void clear( ) noexcept {
 			auto tmp = daw::exchange( m_begin, nullptr );
+			if( tmp != nullptr ) {
+				destroy_values( tmp, m_size + 1 );
+				alloc_traits::deallocate( m_alloc, tmp, m_size + 1 );
+			}
 			m_size = 0;
 			m_end = nullptr;
-			delete[] tmp;
+		}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return m_alloc;
 		}
 
 		constexpr void swap( heap_array &rhs ) noexcept {
 			daw::cswap( m_begin, rhs.m_begin );
 			daw::cswap( m_end, rhs.m_end );
 			daw::cswap( m_size, rhs.m_size );
+			if constexpr( alloc_traits::propagate_on_container_swap::value ) {
+				daw::cswap( m_alloc, rhs.m_alloc );
+			}
 		}
 
 		~heap_array( ) {
@@ -223,9 +299,9 @@ namespace daw {
 		}
 	}; // struct heap_array
 
-	template<typename T>
-	constexpr void swap( daw::heap_array<T> &lhs,
-	                     daw::heap_array<T> &rhs ) noexcept {
+	template<typename T, typename Allocator>
+	constexpr void swap( daw::heap_array<T, Allocator> &lhs,
+	                     daw::heap_array<T, Allocator> &rhs ) noexcept {
 		lhs.swap( rhs );
 	}
 } // namespace daw
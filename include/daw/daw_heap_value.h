@@ -16,19 +16,66 @@
 #include <type_traits>
 
 namespace daw {
+	namespace heap_value_details {
+		// Destroys and frees a value made with allocate_value
+		template<typename Allocator>
+		struct allocator_deleter {
+			using alloc_traits = std::allocator_traits<Allocator>;
+			using pointer = typename alloc_traits::pointer;
+
+			Allocator alloc;
+
+			void operator( )( pointer ptr ) {
+				alloc_traits::destroy( alloc, std::addressof( *ptr ) );
+				alloc_traits::deallocate( alloc, ptr, 1 );
+			}
+		};
+
+		// std::allocator keeps the std::unique_ptr<T> of before
+		template<typename T, typename Allocator>
+		using value_ptr_t = std::conditional_t<
+		  std::is_same_v<Allocator, std::allocator<T>>, std::unique_ptr<T>,
+		  std::unique_ptr<T, allocator_deleter<Allocator>>>;
+
+		template<typename T, typename Allocator, typename... Args>
+		value_ptr_t<T, Allocator> allocate_value( Allocator const &alloc,
+		                                          Args &&...args ) {
+			if constexpr( std::is_same_v<Allocator, std::allocator<T>> ) {
+				(void)alloc;
+				return std::make_unique<T>( std::forward<Args>( args )... );
+			} else {
+				using alloc_traits = std::allocator_traits<Allocator>;
+				auto a = alloc;
+				auto ptr = alloc_traits::allocate( a, 1 );
+				try {
+					alloc_traits::construct( a, std::addressof( *ptr ),
+					                         std::forward<Args>( args )... );
+				} catch( ... ) {
+					alloc_traits::deallocate( a, ptr, 1 );
+					throw;
+				}
+				return value_ptr_t<T, Allocator>(
+				  ptr, allocator_deleter<Allocator>{ std::move( a ) } );
+			}
+		}
+	} // namespace heap_value_details
+
 	/// Heap Value.  Access members via operator-> but copy/move constructors
 	/// operators utilized the pointed to's members This is used on larger classes
 	/// that are members of other classes but the space requirements is that of a
-	/// pointer instead of the full size
-	template<typename T>
+	/// pointer instead of the full size.  The value is allocated with Allocator,
+	/// the allocator_arg_t constructors take one for uses-allocator construction
+	template<typename T, typename Allocator = std::allocator<std::decay_t<T>>>
 	struct heap_value {
 		using value_t = std::decay_t<T>;
 		using reference = value_t &;
 		using const_reference = value_t const &;
 		using pointer = value_t *;
 		using const_pointer = value_t const *;
+		using allocator_type = Allocator;
 
-		std::unique_ptr<value_t> m_value{ std::make_unique<value_t>( ) };
+		heap_value_details::value_ptr_t<value_t, allocator_type> m_value =
+		  heap_value_details::allocate_value<value_t>( allocator_type( ) );
 
 	public:
 		heap_value( ) = default;
@@ -37,7 +84,10 @@ namespace daw {
 		~heap_value( ) = default;
 
 		heap_value( heap_value const &other )
-		  : m_value{ std::make_unique<value_t>( *other.m_value ) } {}
+		  : m_value{ heap_value_details::allocate_value<value_t>(
+		      std::allocator_traits<allocator_type>::
+		        select_on_container_copy_construction( other.get_allocator( ) ),
+		      *other.m_value ) } {}
 
 		heap_value &operator=( heap_value const &rhs ) {
 			if( this != &rhs ) {
@@ -47,15 +97,51 @@ namespace daw {
 		}
 
 		// Make this less perfect so that we can still do copy/move construction
-		template<typename Arg, typename = std::enable_if_t<
-		                         daw::traits::not_self<Arg, value_t>( )>>
+		template<typename Arg,
+		         typename = std::enable_if_t<
+		           daw::traits::not_self<Arg, value_t>( ) and
+		           not std::is_same_v<daw::remove_cvref_t<Arg>, heap_value> and
+		           not std::is_same_v<daw::remove_cvref_t<Arg>,
+		                              std::allocator_arg_t>>>
 		heap_value( Arg &&arg )
-		  : m_value{ std::make_unique<value_t>( std::forward<Arg>( arg ) ) } {}
+		  : m_value{ heap_value_details::allocate_value<value_t>(
+		      allocator_type( ), std::forward<Arg>( arg ) ) } {}
 
-		template<typename Arg, typename... Args>
+		template<typename Arg, typename... Args,
+		         typename = std::enable_if_t<not std::is_same_v<
+		           daw::remove_cvref_t<Arg>, std::allocator_arg_t>>>
 		heap_value( Arg &&arg, Args &&...args )
-		  : m_value{ std::make_unique<value_t>( std::forward<Arg>( arg ),
-		                                        std::forward<Args>( args )... ) } {}
+		  : m_value{ heap_value_details::allocate_value<value_t>(
+		      allocator_type( ), std::forward<Arg>( arg ),
+		      std::forward<Args>( args )... ) } {}
+
+		template<typename... Args>
+		heap_value( std::allocator_arg_t, allocator_type const &alloc,
+		            Args &&...args )
+		  : m_value{ heap_value_details::allocate_value<value_t>(
+		      alloc, std::forward<Args>( args )... ) } {}
+
+		heap_value( std::allocator_arg_t, allocator_type const &alloc,
+		            heap_value const &other )
+		  : m_value{ heap_value_details::allocate_value<value_t>(
+		      alloc, *other.m_value ) } {}
+
+		// Takes other's value when it has an equal allocator and moves from it
+		// otherwise
+		heap_value( std::allocator_arg_t, allocator_type const &alloc,
+		            heap_value &&other )
+		  : m_value{ alloc == other.get_allocator( )
+		               ? std::move( other.m_value )
+		               : heap_value_details::allocate_value<value_t>(
+		                   alloc, std::move( *other.m_value ) ) } {}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			if constexpr( std::is_same_v<allocator_type, std::allocator<value_t>> ) {
+				return allocator_type( );
+			} else {
+				return m_value.get_deleter( ).alloc;
+			}
+		}
 
 		void swap( heap_value &rhs ) noexcept {
 			daw::cswap( m_value, rhs.m_value );
@@ -114,38 +200,39 @@ namespace daw {
 		}
 	};
 
-	template<typename T>
-	void swap( heap_value<T> &lhs, heap_value<T> &rhs ) noexcept {
+	template<typename T, typename Allocator>
+	void swap( heap_value<T, Allocator> &lhs,
+	           heap_value<T, Allocator> &rhs ) noexcept {
 		lhs.swap( rhs );
 	}
 
-	template<typename T, typename U>
-	bool operator==( heap_value<T> const &lhs, heap_value<U> const &rhs ) {
+	template<typename T, typename A, typename U, typename B>
+	bool operator==( heap_value<T, A> const &lhs, heap_value<U, B> const &rhs ) {
 		return *lhs == *rhs;
 	}
 
-	template<typename T, typename U>
-	bool operator!=( heap_value<T> const &lhs, heap_value<U> const &rhs ) {
+	template<typename T, typename A, typename U, typename B>
+	bool operator!=( heap_value<T, A> const &lhs, heap_value<U, B> const &rhs ) {
 		return *lhs != *rhs;
 	}
 
-	template<typename T, typename U>
-	bool operator>=( heap_value<T> const &lhs, heap_value<U> const &rhs ) {
+	template<typename T, typename A, typename U, typename B>
+	bool operator>=( heap_value<T, A> const &lhs, heap_value<U, B> const &rhs ) {
 		return *lhs >= *rhs;
 	}
 
-	template<typename T, typename U>
-	bool operator<=( heap_value<T> const &lhs, heap_value<U> const &rhs ) {
+	template<typename T, typename A, typename U, typename B>
+	bool operator<=( heap_value<T, A> const &lhs, heap_value<U, B> const &rhs ) {
 		return *lhs <= *rhs;
 	}
 
-	template<typename T, typename U>
-	bool operator>( heap_value<T> const &lhs, heap_value<U> const &rhs ) {
+	template<typename T, typename A, typename U, typename B>
+	bool operator>( heap_value<T, A> const &lhs, heap_value<U, B> const &rhs ) {
 		return *lhs > *rhs;
 	}
 
-	template<typename T, typename U>
-	bool operator<( heap_value<T> const &lhs, heap_value<U> const &rhs ) {
+	template<typename T, typename A, typename U, typename B>
+	bool operator<( heap_value<T, A> const &lhs, heap_value<U, B> const &rhs ) {
 		return *lhs < *rhs;
 	}
 } // namespace daw
@@ -0,0 +1,366 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_endian.h"
+#include "daw_exception.h"
+#include "daw_span.h"
+#include "impl/daw_int_codec_simd.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+/***
+ * Bulk codecs for arrays of std::uint32_t or std::uint64_t.  Encoders write
+ * to a byte span and return the bytes used, decoders fill a value span and
+ * return the bytes read.  The value count is not stored, so decode into a
+ * span the size of the one encoded.  Words are in host byte order.
+ *
+ * The block codecs work on 128 values at a time and pad a short final block,
+ * so size buffers with the *_max_size functions.  Pass T explicitly when
+ * encoding from a container, e.g. delta_encode<std::uint32_t>( ids, buff )
+ */
+namespace daw::int_codec {
+	inline constexpr std::size_t block_size = int_codec_impl::block_size;
+
+	template<typename T>
+	inline constexpr bool is_codec_integer_v =
+	  std::is_same_v<T, std::uint32_t> or std::is_same_v<T, std::uint64_t>;
+
+	namespace int_codec_details {
+		constexpr std::size_t block_count( std::size_t count ) {
+			return ( count + block_size - 1U ) / block_size;
+		}
+
+		inline void check_output( bool has_room ) {
+			daw::exception::precondition_check<std::out_of_range>(
+			  has_room, "Output buffer is too small" );
+		}
+
+		inline void check_input( bool is_valid ) {
+			daw::exception::precondition_check<std::invalid_argument>(
+			  is_valid, "Encoded data is truncated or invalid" );
+		}
+
+		// Copy a short final block into a padded one
+		template<typename T>
+		void pad_block( T const *values, std::size_t size, T padding,
+		                T ( &block )[block_size] ) {
+			std::copy_n( values, size, block );
+			std::fill( block + size, block + block_size, padding );
+		}
+	} // namespace int_codec_details
+
+	/***
+	 * @return the number of bits needed to hold the largest of values
+	 */
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	[[nodiscard]] unsigned required_bits( daw::span<T const> values ) {
+		return int_codec_impl::bit_width(
+		  int_codec_impl::block_or( values.data( ), values.size( ) ) );
+	}
+
+	/// Bit packing at one width
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	[[nodiscard]] constexpr std::size_t bitpack_size( std::size_t count,
+	                                                  unsigned bits ) {
+		return int_codec_details::block_count( count ) * 16U * bits;
+	}
+
+	/***
+	 * Store the low bits bits of each value
+	 * @pre bits <= 8 * sizeof( T )
+	 */
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t bitpack_encode( daw::span<T const> values,
+	                            daw::span<unsigned char> out, unsigned bits ) {
+		daw::exception::precondition_check<std::invalid_argument>(
+		  bits <= int_codec_impl::word_bits<T>, "Invalid bit width" );
+		std::size_t const block_bytes = 16U * bits;
+		int_codec_details::check_output(
+		  out.size( ) >= bitpack_size<T>( values.size( ), bits ) );
+		auto const pack = int_codec_impl::pack_table<T>[bits];
+		T const *first = values.data( );
+		unsigned char *dst = out.data( );
+		std::size_t const full_blocks = values.size( ) / block_size;
+		for( std::size_t n = 0; n < full_blocks; ++n ) {
+			pack( first + n * block_size, dst );
+			dst += block_bytes;
+		}
+		if( std::size_t const rest = values.size( ) % block_size; rest != 0 ) {
+			T block[block_size];
+			int_codec_details::pad_block( first + full_blocks * block_size, rest,
+			                              T{ 0 }, block );
+			pack( block, dst );
+			dst += block_bytes;
+		}
+		return static_cast<std::size_t>( dst - out.data( ) );
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t bitpack_decode( daw::span<unsigned char const> in,
+	                            daw::span<T> values, unsigned bits ) {
+		daw::exception::precondition_check<std::invalid_argument>(
+		  bits <= int_codec_impl::word_bits<T>, "Invalid bit width" );
+		std::size_t const block_bytes = 16U * bits;
+		int_codec_details::check_input(
+		  in.size( ) >= bitpack_size<T>( values.size( ), bits ) );
+		auto const unpack = int_codec_impl::unpack_table<T>[bits];
+		unsigned char const *src = in.data( );
+		T *first = values.data( );
+		std::size_t const full_blocks = values.size( ) / block_size;
+		for( std::size_t n = 0; n < full_blocks; ++n ) {
+			unpack( src, first + n * block_size );
+			src += block_bytes;
+		}
+		if( std::size_t const rest = values.size( ) % block_size; rest != 0 ) {
+			T block[block_size];
+			unpack( src, block );
+			std::copy_n( block, rest, first + full_blocks * block_size );
+			src += block_bytes;
+		}
+		return static_cast<std::size_t>( src - in.data( ) );
+	}
+
+	/// Frame of reference: each block stores its minimum and the offsets from it
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	[[nodiscard]] constexpr std::size_t for_max_size( std::size_t count ) {
+		return int_codec_details::block_count( count ) *
+		       ( 1U + sizeof( T ) + 16U * int_codec_impl::word_bits<T> );
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t for_encode( daw::span<T const> values,
+	                        daw::span<unsigned char> out ) {
+		T const *first = values.data( );
+		unsigned char *dst = out.data( );
+		unsigned char *const dst_last = dst + out.size( );
+		for( std::size_t pos = 0; pos < values.size( ); pos += block_size ) {
+			std::size_t const size = std::min( block_size, values.size( ) - pos );
+			T const base = *std::min_element( first + pos, first + pos + size );
+			T block[block_size];
+			int_codec_details::pad_block( first + pos, size, base, block );
+			for( T &value : block ) {
+				value = static_cast<T>( value - base );
+			}
+			unsigned const bits = int_codec_impl::bit_width(
+			  int_codec_impl::block_or( block, block_size ) );
+			int_codec_details::check_output(
+			  static_cast<std::size_t>( dst_last - dst ) >=
+			  1U + sizeof( T ) + 16U * bits );
+			*dst++ = static_cast<unsigned char>( bits );
+			std::memcpy( dst, &base, sizeof( T ) );
+			dst += sizeof( T );
+			int_codec_impl::pack_table<T>[bits]( block, dst );
+			dst += 16U * bits;
+		}
+		return static_cast<std::size_t>( dst - out.data( ) );
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t for_decode( daw::span<unsigned char const> in,
+	                        daw::span<T> values ) {
+		unsigned char const *src = in.data( );
+		unsigned char const *const src_last = src + in.size( );
+		T *first = values.data( );
+		for( std::size_t pos = 0; pos < values.size( ); pos += block_size ) {
+			int_codec_details::check_input(
+			  static_cast<std::size_t>( src_last - src ) >= 1U + sizeof( T ) );
+			unsigned const bits = *src++;
+			T base;
+			std::memcpy( &base, src, sizeof( T ) );
+			src += sizeof( T );
+			int_codec_details::check_input(
+			  bits <= int_codec_impl::word_bits<T> and
+			  static_cast<std::size_t>( src_last - src ) >= 16U * bits );
+			std::size_t const size = std::min( block_size, values.size( ) - pos );
+			if( size == block_size ) {
+				int_codec_impl::unpack_table<T>[bits]( src, first + pos );
+			} else {
+				T block[block_size];
+				int_codec_impl::unpack_table<T>[bits]( src, block );
+				std::copy_n( block, size, first + pos );
+			}
+			int_codec_impl::add_base( first + pos, size, base );
+			src += 16U * bits;
+		}
+		return static_cast<std::size_t>( src - in.data( ) );
+	}
+
+	/***
+	 * Delta and zigzag: each value is stored as the zigzag encoded difference
+	 * from the one before it, so sorted values take the bits of their largest
+	 * gap in a block.  Unsorted values work too
+	 */
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	[[nodiscard]] constexpr std::size_t delta_max_size( std::size_t count ) {
+		return int_codec_details::block_count( count ) *
+		       ( 1U + 16U * int_codec_impl::word_bits<T> );
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t delta_encode( daw::span<T const> values,
+	                          daw::span<unsigned char> out ) {
+		T const *first = values.data( );
+		unsigned char *dst = out.data( );
+		unsigned char *const dst_last = dst + out.size( );
+		T prev = 0;
+		for( std::size_t pos = 0; pos < values.size( ); pos += block_size ) {
+			std::size_t const size = std::min( block_size, values.size( ) - pos );
+			T block[block_size]{ };
+			for( std::size_t n = 0; n < size; ++n ) {
+				block[n] = int_codec_impl::zigzag_encode(
+				  static_cast<T>( first[pos + n] - prev ) );
+				prev = first[pos + n];
+			}
+			unsigned const bits = int_codec_impl::bit_width(
+			  int_codec_impl::block_or( block, block_size ) );
+			int_codec_details::check_output(
+			  static_cast<std::size_t>( dst_last - dst ) >= 1U + 16U * bits );
+			*dst++ = static_cast<unsigned char>( bits );
+			int_codec_impl::pack_table<T>[bits]( block, dst );
+			dst += 16U * bits;
+		}
+		return static_cast<std::size_t>( dst - out.data( ) );
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t delta_decode( daw::span<unsigned char const> in,
+	                          daw::span<T> values ) {
+		unsigned char const *src = in.data( );
+		unsigned char const *const src_last = src + in.size( );
+		T *first = values.data( );
+		T prev = 0;
+		for( std::size_t pos = 0; pos < values.size( ); pos += block_size ) {
+			int_codec_details::check_input( src != src_last );
+			unsigned const bits = *src++;
+			int_codec_details::check_input(
+			  bits <= int_codec_impl::word_bits<T> and
+			  static_cast<std::size_t>( src_last - src ) >= 16U * bits );
+			std::size_t const size = std::min( block_size, values.size( ) - pos );
+			if( size == block_size ) {
+				int_codec_impl::unpack_table<T>[bits]( src, first + pos );
+			} else {
+				T block[block_size];
+				int_codec_impl::unpack_table<T>[bits]( src, block );
+				std::copy_n( block, size, first + pos );
+			}
+			prev = int_codec_impl::zigzag_prefix_sum( first + pos, size, prev );
+			src += 16U * bits;
+		}
+		return static_cast<std::size_t>( src - in.data( ) );
+	}
+
+	/// LEB128 varints: 7 bits a byte, low bits first, high bit set if more follow
+	template<typename T>
+	inline constexpr std::size_t varint_max_bytes =
+	  ( int_codec_impl::word_bits<T> + 6U ) / 7U;
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	[[nodiscard]] constexpr std::size_t varint_max_size( std::size_t count ) {
+		return count * varint_max_bytes<T>;
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	[[nodiscard]] constexpr std::size_t varint_size( T value ) {
+		unsigned const bits = int_codec_impl::bit_width( value );
+		return bits == 0 ? 1U : ( bits + 6U ) / 7U;
+	}
+
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t varint_encode( daw::span<T const> values,
+	                           daw::span<unsigned char> out ) {
+		unsigned char *dst = out.data( );
+		unsigned char *const dst_last = dst + out.size( );
+		for( T value : values ) {
+			if( static_cast<std::size_t>( dst_last - dst ) < varint_max_bytes<T> ) {
+				int_codec_details::check_output(
+				  static_cast<std::size_t>( dst_last - dst ) >=
+				  varint_size( value ) );
+			}
+			while( value >= 0x80U ) {
+				*dst++ = static_cast<unsigned char>( value | 0x80U );
+				value >>= 7U;
+			}
+			*dst++ = static_cast<unsigned char>( value );
+		}
+		return static_cast<std::size_t>( dst - out.data( ) );
+	}
+
+	/***
+	 * Reads eight bytes at a time while they are there.  Eight one byte
+	 * values are widened together and a longer value is found from the
+	 * continuation bits and gathered without a loop
+	 */
+	template<typename T, std::enable_if_t<is_codec_integer_v<T>,
+	                                      std::nullptr_t> = nullptr>
+	std::size_t varint_decode( daw::span<unsigned char const> in,
+	                           daw::span<T> values ) {
+		constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080ULL;
+		unsigned char const *src = in.data( );
+		unsigned char const *const src_last = src + in.size( );
+		T *dst = values.data( );
+		T *const dst_last = dst + values.size( );
+		while( dst != dst_last ) {
+			if( src_last - src >= 8 ) {
+				std::uint64_t word;
+				std::memcpy( &word, src, 8 );
+				word = daw::to_little_endian( word );
+				if( ( word & high_bits ) == 0 and dst_last - dst >= 8 ) {
+					int_codec_impl::widen_bytes( word, dst );
+					src += 8;
+					dst += 8;
+					continue;
+				}
+				if( std::uint64_t const ends = ~word & high_bits; ends != 0 ) {
+					std::size_t const length =
+					  int_codec_impl::countr_zero( ends ) / 8U + 1U;
+					int_codec_details::check_input( length <= varint_max_bytes<T> );
+					*dst++ = static_cast<T>( int_codec_impl::gather_varint(
+					  word & int_codec_impl::low_mask<std::uint64_t>( length * 8U ) ) );
+					src += length;
+					continue;
+				}
+			}
+			// Near the end of the input, or a value longer than eight bytes
+			T value = 0;
+			std::size_t shift = 0;
+			while( true ) {
+				int_codec_details::check_input(
+				  src != src_last and shift < int_codec_impl::word_bits<T> );
+				unsigned char const byte = *src++;
+				value |= static_cast<T>( static_cast<T>( byte & 0x7FU ) << shift );
+				if( ( byte & 0x80U ) == 0 ) {
+					break;
+				}
+				shift += 7U;
+			}
+			*dst++ = value;
+		}
+		return static_cast<std::size_t>( src - in.data( ) );
+	}
+} // namespace daw::int_codec
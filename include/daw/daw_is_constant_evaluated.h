@@ -0,0 +1,29 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+// DAW_IS_CONSTANT_EVALUATED( ) is true when evaluated in a constant
+// expression.  Where the compiler cannot tell, it is always true so that
+// callers select their constexpr safe path
+#if defined( __has_builtin )
+#if __has_builtin( __builtin_is_constant_evaluated )
+#define DAW_HAS_IS_CONSTANT_EVALUATED
+#endif
+#endif
+#if not defined( DAW_HAS_IS_CONSTANT_EVALUATED ) and                           \
+  ( ( defined( __GNUC__ ) and __GNUC__ >= 9 ) or                               \
+    ( defined( _MSC_VER ) and _MSC_VER >= 1925 ) )
+#define DAW_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+#if defined( DAW_HAS_IS_CONSTANT_EVALUATED )
+#define DAW_IS_CONSTANT_EVALUATED( ) __builtin_is_constant_evaluated( )
+#else
+#define DAW_IS_CONSTANT_EVALUATED( ) true
+#endif
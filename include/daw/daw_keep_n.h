@@ -8,13 +8,22 @@
 
 #pragma once
 
+#include "daw_is_constant_evaluated.h"
 #include "daw_move.h"
+#include "daw_simd_sort_n.h"
+#include "daw_sort_n.h"
 
+#include <algorithm>
 #include <array>
 #include <ciso646>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace daw {
 	enum class keep_n_order { ascending, descending };
@@ -50,6 +59,132 @@ namespace daw {
 				}
 			}
 		};
+
+		template<typename Function>
+		struct reversed_pred {
+			Function func = { };
+
+			template<typename T, typename U>
+			constexpr bool operator( )( T const &lhs, U const &rhs ) const {
+				return func( rhs, lhs );
+			}
+		};
+
+		/***
+		 * The strict ordering a keep_n keeps its values in.  std::less<> is
+		 * kept as std::less<>/std::greater<> so that the sort can recognize it
+		 */
+		template<keep_n_order Order, typename Predicate>
+		struct sort_compare {
+			using type = std::conditional_t<
+			  Order == keep_n_order::ascending, Predicate,
+			  std::conditional_t<std::is_same_v<Predicate, std::less<>>,
+			                     std::greater<>, reversed_pred<Predicate>>>;
+		};
+
+		template<keep_n_order Order, typename Predicate>
+		using sort_compare_t = typename sort_compare<Order, Predicate>::type;
+
+		template<typename Iterator, typename Compare>
+		inline constexpr bool is_simd_filterable_v =
+		  simd_sort_impl::is_simd_sortable_v<Iterator, Compare>;
+
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		/***
+		 * Skip whole vectors of values that cannot beat threshold.  A value
+		 * beats it when it is less, or greater when is_greater is set
+		 * @return the index of the first vector that may hold a candidate
+		 */
+		template<typename T>
+		DAW_TARGET_AVX2 std::size_t
+		skip_rejected_avx2( T const *ptr, std::size_t size, T threshold,
+		                    bool is_greater ) {
+			constexpr std::size_t width = 32U / sizeof( T );
+			std::size_t pos = 0;
+			if constexpr( std::is_floating_point_v<T> ) {
+				for( ; pos + width <= size; pos += width ) {
+					int mask = 0;
+					if constexpr( std::is_same_v<T, float> ) {
+						auto const thr = _mm256_set1_ps( threshold );
+						auto const v = _mm256_loadu_ps( ptr + pos );
+						mask = _mm256_movemask_ps(
+						  is_greater ? _mm256_cmp_ps( v, thr, _CMP_GT_OQ )
+						             : _mm256_cmp_ps( v, thr, _CMP_LT_OQ ) );
+					} else {
+						auto const thr = _mm256_set1_pd( threshold );
+						auto const v = _mm256_loadu_pd( ptr + pos );
+						mask = _mm256_movemask_pd(
+						  is_greater ? _mm256_cmp_pd( v, thr, _CMP_GT_OQ )
+						             : _mm256_cmp_pd( v, thr, _CMP_LT_OQ ) );
+					}
+					if( mask != 0 ) {
+						break;
+					}
+				}
+			} else {
+				// Unsigned values have the sign bit flipped to use signed compares
+				using signed_t = std::make_signed_t<T>;
+				auto const flip =
+				  std::is_signed_v<T>
+				    ? signed_t{ 0 }
+				    : static_cast<signed_t>( T{ 1 } << ( sizeof( T ) * 8U - 1U ) );
+				__m256i bias;
+				__m256i thr;
+				if constexpr( sizeof( T ) == 4 ) {
+					bias = _mm256_set1_epi32( flip );
+					thr = _mm256_set1_epi32( static_cast<signed_t>( threshold ) );
+				} else {
+					bias = _mm256_set1_epi64x( flip );
+					thr = _mm256_set1_epi64x( static_cast<signed_t>( threshold ) );
+				}
+				auto const bthr = _mm256_xor_si256( thr, bias );
+				for( ; pos + width <= size; pos += width ) {
+					auto const v = _mm256_xor_si256(
+					  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( ptr + pos ) ),
+					  bias );
+					__m256i m;
+					if constexpr( sizeof( T ) == 4 ) {
+						m = is_greater ? _mm256_cmpgt_epi32( v, bthr )
+						               : _mm256_cmpgt_epi32( bthr, v );
+					} else {
+						m = is_greater ? _mm256_cmpgt_epi64( v, bthr )
+						               : _mm256_cmpgt_epi64( bthr, v );
+					}
+					if( not _mm256_testz_si256( m, m ) ) {
+						break;
+					}
+				}
+			}
+			return pos;
+		}
+#endif
+
+		/***
+		 * @return the first position in [first, last) where comp( *it,
+		 * threshold ) holds.  Contiguous arithmetic ranges compared with
+		 * std::less/std::greater are checked a vector at a time
+		 */
+		template<typename Iterator, typename T, typename Compare>
+		constexpr Iterator next_candidate( Iterator first, Iterator last,
+		                                   T const &threshold,
+		                                   Compare const &comp ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+			if constexpr( is_simd_filterable_v<Iterator, Compare> ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) and first != last and
+				    simd_impl::has_avx2( ) ) {
+					using value_t = typename std::iterator_traits<Iterator>::value_type;
+					first += static_cast<std::ptrdiff_t>( skip_rejected_avx2<value_t>(
+					  std::addressof( *first ),
+					  static_cast<std::size_t>( last - first ), threshold,
+					  simd_sort_impl::is_greater_v<Compare, value_t> ) );
+				}
+			}
+#endif
+			while( first != last and not comp( *first, threshold ) ) {
+				++first;
+			}
+			return first;
+		}
 	} // namespace keep_n_impl
 
 	template<typename T, size_t MaxItems,
@@ -104,6 +239,41 @@ namespace daw {
 			}
 		}
 
+		/***
+		 * Insert many values.  Values that cannot beat the current last value
+		 * are skipped, a vector at a time for contiguous arithmetic ranges.  The
+		 * current values and up to MaxItems candidates at a time are sorted
+		 * together with daw::sort and the best MaxItems kept, for small
+		 * arithmetic keys this runs as a vector sorting network.  The relative
+		 * order of equivalent values is unspecified
+		 */
+		template<typename InputIterator>
+		constexpr void insert( InputIterator first, InputIterator last ) {
+			using compare_t = keep_n_impl::sort_compare_t<Order, Predicate>;
+			auto const comp = compare_t{ };
+			std::array<T, MaxItems * 2U> buffer{ };
+			while( true ) {
+				first = keep_n_impl::next_candidate( first, last, m_values.back( ),
+				                                     comp );
+				if( first == last ) {
+					return;
+				}
+				std::size_t count = MaxItems;
+				for( ; count < MaxItems * 2U and first != last; ++first ) {
+					if( comp( *first, m_values.back( ) ) ) {
+						buffer[count++] = *first;
+					}
+				}
+				for( std::size_t n = 0; n < MaxItems; ++n ) {
+					buffer[n] = daw::move( m_values[n] );
+				}
+				daw::sort( buffer.data( ), buffer.data( ) + count, comp );
+				for( std::size_t n = 0; n < MaxItems; ++n ) {
+					m_values[n] = daw::move( buffer[n] );
+				}
+			}
+		}
+
 		[[nodiscard]] constexpr const_reference
 		operator[]( size_type index ) const noexcept {
 			return m_values[index];
@@ -141,4 +311,136 @@ namespace daw {
 			return m_values.back( );
 		}
 	};
+
+	/***
+	 * Keep the first k values, in Compare order, of those inserted, with k
+	 * chosen at runtime.  The values are held in a heap whose top is the worst
+	 * kept value, so an insert is O(log k) and a rejected value one compare.
+	 * Better suited than keep_n once k is more than a few dozen.
+	 */
+	template<typename T, typename Compare = std::less<>>
+	class keep_n_heap {
+		std::vector<T> m_values{ };
+		std::size_t m_capacity;
+		Compare m_comp;
+
+		void push( T &&v ) {
+			if( m_values.size( ) < m_capacity ) {
+				m_values.push_back( daw::move( v ) );
+				std::push_heap( m_values.begin( ), m_values.end( ), m_comp );
+				return;
+			}
+			if( m_capacity == 0 or not m_comp( v, m_values.front( ) ) ) {
+				return;
+			}
+			std::pop_heap( m_values.begin( ), m_values.end( ), m_comp );
+			m_values.back( ) = daw::move( v );
+			std::push_heap( m_values.begin( ), m_values.end( ), m_comp );
+		}
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		explicit keep_n_heap( std::size_t k, Compare comp = Compare{ } )
+		  : m_capacity( k )
+		  , m_comp( daw::move( comp ) ) {}
+
+		/***
+		 * Make room for the values kept from count inputs.  Storage otherwise
+		 * grows as values are kept, so k may be larger than any input
+		 */
+		void reserve( std::size_t count ) {
+			m_values.reserve( std::min( count, m_capacity ) );
+		}
+
+		void insert( T const &v ) {
+			if( m_capacity == 0 or
+			    ( full( ) and not m_comp( v, m_values.front( ) ) ) ) {
+				return;
+			}
+			push( T( v ) );
+		}
+
+		void insert( T &&v ) {
+			push( daw::move( v ) );
+		}
+
+		/***
+		 * Insert many values.  Once full, values that cannot beat the current
+		 * threshold are skipped, a vector at a time for contiguous arithmetic
+		 * ranges compared with std::less/std::greater
+		 */
+		template<typename InputIterator>
+		void insert( InputIterator first, InputIterator last ) {
+			while( first != last and not full( ) ) {
+				push( T( *first ) );
+				++first;
+			}
+			if( first == last or m_capacity == 0 ) {
+				return;
+			}
+			while( true ) {
+				first =
+				  keep_n_impl::next_candidate( first, last, m_values.front( ), m_comp );
+				if( first == last ) {
+					return;
+				}
+				push( T( *first ) );
+				++first;
+			}
+		}
+
+		/***
+		 * Insert the values kept by other
+		 */
+		void merge( keep_n_heap const &other ) {
+			insert( other.m_values.begin( ), other.m_values.end( ) );
+		}
+
+		[[nodiscard]] bool full( ) const noexcept {
+			return m_values.size( ) == m_capacity;
+		}
+
+		[[nodiscard]] bool empty( ) const noexcept {
+			return m_values.empty( );
+		}
+
+		[[nodiscard]] size_type size( ) const noexcept {
+			return m_values.size( );
+		}
+
+		[[nodiscard]] size_type capacity( ) const noexcept {
+			return m_capacity;
+		}
+
+		/***
+		 * @return the worst of the kept values, requires not empty( )
+		 */
+		[[nodiscard]] T const &threshold( ) const noexcept {
+			return m_values.front( );
+		}
+
+		/***
+		 * The kept values in heap order
+		 */
+		[[nodiscard]] const_iterator begin( ) const noexcept {
+			return m_values.begin( );
+		}
+
+		[[nodiscard]] const_iterator end( ) const noexcept {
+			return m_values.end( );
+		}
+
+		/***
+		 * Move the kept values out in Compare order, leaving this empty
+		 */
+		[[nodiscard]] std::vector<T> take_sorted( ) {
+			std::sort_heap( m_values.begin( ), m_values.end( ), m_comp );
+			auto result = std::vector<T>( );
+			result.swap( m_values );
+			return result;
+		}
+	};
 } // namespace daw
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "daw_span.h"
 #include "daw_string_view.h"
 #include "daw_traits.h"
 
@@ -18,8 +19,12 @@
 #include <utility>
 
 #if not defined( _MSC_VER )
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <type_traits>
 #include <unistd.h>
@@ -33,8 +38,46 @@
 
 namespace daw::filesystem {
 	enum class open_mode : bool { read, read_write };
+	enum class flush_mode : bool { async, sync };
 
 #if not defined( _MSC_VER )
+	namespace mapfile_impl {
+		// Reserve the disk blocks for [0, size) so that writes through the
+		// mapping cannot fail with SIGBUS on a full disk
+		[[nodiscard]] inline bool allocate_file( int fd,
+		                                         std::size_t size ) noexcept {
+			auto const len = static_cast<off_t>( size );
+			struct stat st { };
+			if( ::fstat( fd, &st ) != 0 ) {
+				return false;
+			}
+			if( st.st_size >= len ) {
+				return true;
+			}
+#if defined( __linux__ )
+			int result = ::posix_fallocate( fd, 0, len );
+			while( result == EINTR ) {
+				result = ::posix_fallocate( fd, 0, len );
+			}
+			if( result == 0 ) {
+				return true;
+			}
+			// Not every file system supports preallocation, a sparse file still
+			// works
+			if( result != EOPNOTSUPP and result != EINVAL ) {
+				return false;
+			}
+#endif
+			return ::ftruncate( fd, len ) == 0;
+		}
+
+		[[nodiscard]] inline std::size_t page_size( ) noexcept {
+			static std::size_t const result =
+			  static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+			return result;
+		}
+	} // namespace mapfile_impl
+
 	template<typename T = char>
 	struct memory_mapped_file_t {
 		using value_type = T;
@@ -49,18 +92,53 @@ namespace daw::filesystem {
 	private:
 		int m_file = -1;
 		pointer m_ptr = nullptr;
+		// Bytes in use, the file is cut back to this when closed
 		size_type m_size = 0;
+		// Bytes mapped and allocated in the file
+		size_type m_capacity = 0;
+		bool m_writable = false;
 
 		void cleanup( ) noexcept {
 			if( m_ptr != nullptr ) {
-				munmap( m_ptr, m_size );
+				munmap( m_ptr, m_capacity );
 				m_ptr = nullptr;
 			}
-			m_size = 0;
 			if( m_file >= 0 ) {
+				if( m_writable and m_size < m_capacity ) {
+					(void)::ftruncate( m_file, static_cast<off_t>( m_size ) );
+				}
 				close( m_file );
 				m_file = -1;
 			}
+			m_size = 0;
+			m_capacity = 0;
+			m_writable = false;
+		}
+
+		// Map capacity bytes of the file, growing it if needed
+		[[nodiscard]] bool remap( size_type capacity ) noexcept {
+			if( capacity > m_capacity ) {
+				if( not mapfile_impl::allocate_file( m_file, capacity ) ) {
+					return false;
+				}
+			}
+#if defined( MREMAP_MAYMOVE )
+			auto ptr = ::mremap( static_cast<void *>( m_ptr ), m_capacity, capacity,
+			                     MREMAP_MAYMOVE );
+			if( ptr == MAP_FAILED ) {
+				return false;
+			}
+#else
+			auto ptr = mmap( nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+			                 m_file, 0 );
+			if( ptr == MAP_FAILED ) {
+				return false;
+			}
+			munmap( m_ptr, m_capacity );
+#endif
+			m_ptr = static_cast<pointer>( ptr );
+			m_capacity = capacity;
+			return true;
 		}
 
 	public:
@@ -98,9 +176,10 @@ namespace daw::filesystem {
 					return false;
 				}
 				m_size = static_cast<size_type>( fsz );
+				m_capacity = m_size;
 			}
 			m_ptr = static_cast<pointer>(
-			  mmap( nullptr, m_size,
+			  mmap( nullptr, m_capacity,
 			        mode == open_mode::read ? PROT_READ : PROT_READ | PROT_WRITE,
 			        MAP_SHARED, m_file, 0 ) );
 
@@ -109,9 +188,127 @@ namespace daw::filesystem {
 				cleanup( );
 				return false;
 			}
+			m_writable = mode == open_mode::read_write;
 			return true;
 		}
 
+		/***
+		 * Create, or open and extend, a file for writing through the mapping.
+		 * The file is preallocated to hold count elements of T
+		 * @param file path of file, must be zero terminated
+		 * @param count number of T the file must hold
+		 * @return true on success
+		 */
+		[[nodiscard]] bool create( std::string_view file,
+		                           size_type count ) noexcept {
+			cleanup( );
+			if( count == 0 ) {
+				return false;
+			}
+			m_file = ::open( file.data( ), O_RDWR | O_CREAT, 0644 );
+			if( m_file < 0 ) {
+				return false;
+			}
+			auto const bytes = count * sizeof( T );
+			if( not mapfile_impl::allocate_file( m_file, bytes ) ) {
+				cleanup( );
+				return false;
+			}
+			auto ptr = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+			                 m_file, 0 );
+			if( ptr == MAP_FAILED ) {
+				cleanup( );
+				return false;
+			}
+			m_ptr = static_cast<pointer>( ptr );
+			m_size = bytes;
+			m_capacity = bytes;
+			m_writable = true;
+			return true;
+		}
+
+		/***
+		 * Grow or shrink a writable mapping to count elements of T.  Growing
+		 * past capacity( ) at least doubles it, so appending an element at a
+		 * time remaps rarely.  New elements are zero.  The mapping may move,
+		 * invalidating pointers into it.  The file keeps the capacity while open
+		 * and is cut back to size( ) when closed.  On failure the existing
+		 * mapping is left as is
+		 */
+		[[nodiscard]] bool resize( size_type count ) noexcept {
+			if( not m_writable or m_ptr == nullptr or count == 0 ) {
+				return false;
+			}
+			auto const bytes = count * sizeof( T );
+			if( bytes > m_capacity and
+			    not remap( std::max( bytes, m_capacity * 2U ) ) ) {
+				return false;
+			}
+			if( bytes > m_size ) {
+				// Space kept from an earlier shrink may still hold old values
+				std::memset( reinterpret_cast<char *>( m_ptr ) + m_size, 0,
+				             bytes - m_size );
+			}
+			m_size = bytes;
+			return true;
+		}
+
+		/***
+		 * Make room for at least count elements of T without changing size( )
+		 */
+		[[nodiscard]] bool reserve( size_type count ) noexcept {
+			if( not m_writable or m_ptr == nullptr ) {
+				return false;
+			}
+			auto const bytes = count * sizeof( T );
+			return bytes <= m_capacity or remap( bytes );
+		}
+
+		/***
+		 * @return the number of bytes mapped, at least size( )
+		 */
+		[[nodiscard]] constexpr size_type capacity( ) const noexcept {
+			return m_capacity;
+		}
+
+		/***
+		 * Write back a range of elements to the file
+		 * @param pos first element
+		 * @param count number of elements
+		 * @param mode flush_mode::sync waits for the write to complete
+		 */
+		[[nodiscard]] bool flush( size_type pos, size_type count,
+		                          flush_mode mode = flush_mode::sync ) noexcept {
+			if( m_ptr == nullptr ) {
+				return false;
+			}
+			auto first = pos * sizeof( T );
+			auto last = std::min( first + count * sizeof( T ), m_size );
+			if( first >= last ) {
+				return true;
+			}
+			// msync requires a page aligned address
+			first -= first % mapfile_impl::page_size( );
+			auto *const addr = reinterpret_cast<char *>( m_ptr ) + first;
+			return ::msync( static_cast<void *>( addr ), last - first,
+			                mode == flush_mode::sync ? MS_SYNC : MS_ASYNC ) == 0;
+		}
+
+		[[nodiscard]] bool flush( flush_mode mode = flush_mode::sync ) noexcept {
+			return flush( 0, m_size / sizeof( T ), mode );
+		}
+
+		/***
+		 * @return the mapping as elements of T
+		 */
+		[[nodiscard]] daw::span<T> as_span( ) noexcept {
+			return daw::span<T>( m_ptr, m_size / sizeof( T ) );
+		}
+
+		[[nodiscard]] daw::span<T const> as_span( ) const noexcept {
+			return daw::span<T const>( m_ptr, m_size / sizeof( T ) );
+		}
+
 		[[nodiscard]] reference operator[]( size_type pos ) noexcept {
 			return m_ptr[pos];
 		}
@@ -166,13 +363,17 @@ namespace daw::filesystem {
 		memory_mapped_file_t( memory_mapped_file_t &&other ) noexcept
 		  : m_file( std::exchange( other.m_file, -1 ) )
 		  , m_ptr( std::exchange( other.m_ptr, nullptr ) )
-		  , m_size( std::exchange( other.m_size, 0 ) ) {}
+		  , m_size( std::exchange( other.m_size, 0 ) )
+		  , m_capacity( std::exchange( other.m_capacity, 0 ) )
+		  , m_writable( std::exchange( other.m_writable, false ) ) {}
 
 		memory_mapped_file_t &operator=( memory_mapped_file_t &&rhs ) noexcept {
 			if( this != &rhs ) {
 				m_file = std::exchange( rhs.m_file, -1 );
 				m_ptr = std::exchange( rhs.m_ptr, nullptr );
 				m_size = std::exchange( rhs.m_size, 0 );
+				m_capacity = std::exchange( rhs.m_capacity, 0 );
+				m_writable = std::exchange( rhs.m_writable, false );
 			}
 			return *this;
 		}
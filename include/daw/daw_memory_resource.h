@@ -0,0 +1,411 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_exchange.h"
+
+#include <array>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+namespace daw {
+	namespace memory_resource_details {
+		[[nodiscard]] inline std::uintptr_t align_up( std::uintptr_t value,
+		                                              std::size_t alignment ) {
+			return ( value + ( alignment - 1U ) ) &
+			       ~static_cast<std::uintptr_t>( alignment - 1U );
+		}
+
+		// The number of bits needed to hold value
+		[[nodiscard]] inline std::size_t bit_width( std::size_t value ) {
+#if defined( __GNUC__ ) or defined( __clang__ )
+			if( value == 0 ) {
+				return 0;
+			}
+			return static_cast<std::size_t>(
+			  64 - __builtin_clzll( static_cast<unsigned long long>( value ) ) );
+#else
+			std::size_t result = 0;
+			while( value != 0 ) {
+				value >>= 1U;
+				++result;
+			}
+			return result;
+#endif
+		}
+	} // namespace memory_resource_details
+
+	/***
+	 * A bump pointer arena.  Allocation moves a pointer through the current
+	 * block and deallocation does nothing, memory is reclaimed all at once by
+	 * reset( ) or release( ).  Blocks come from upstream and double in size
+	 * as the arena grows.  Not thread safe
+	 */
+	class arena_resource final : public std::pmr::memory_resource {
+		struct block_header {
+			block_header *next;
+			std::size_t size;
+		};
+
+		std::pmr::memory_resource *m_upstream;
+		block_header *m_blocks = nullptr;
+		std::uintptr_t m_current = 0;
+		std::uintptr_t m_last = 0;
+		std::size_t m_next_block_size;
+		unsigned char *m_buffer = nullptr;
+		std::size_t m_buffer_size = 0;
+
+		void use_buffer( ) noexcept {
+			m_current = reinterpret_cast<std::uintptr_t>( m_buffer );
+			m_last = m_current + m_buffer_size;
+		}
+
+		void add_block( std::size_t bytes, std::size_t alignment ) {
+			constexpr std::size_t max_size = std::numeric_limits<std::size_t>::max( );
+			if( bytes > max_size - sizeof( block_header ) - alignment ) {
+				throw std::bad_alloc( );
+			}
+			std::size_t const needed = sizeof( block_header ) + bytes + alignment;
+			std::size_t size = m_next_block_size;
+			while( size < needed ) {
+				// Doubling would wrap, take exactly what is needed instead
+				size = size > max_size / 2U ? needed : size * 2U;
+			}
+			auto *block = static_cast<block_header *>(
+			  m_upstream->allocate( size, alignof( std::max_align_t ) ) );
+			block->next = m_blocks;
+			block->size = size;
+			m_blocks = block;
+			m_current = reinterpret_cast<std::uintptr_t>( block + 1 );
+			m_last = reinterpret_cast<std::uintptr_t>( block ) + size;
+			m_next_block_size = size > max_size / 2U ? size : size * 2U;
+		}
+
+		void *do_allocate( std::size_t bytes, std::size_t alignment ) override {
+			// Every allocation gets its own address
+			if( bytes == 0 ) {
+				bytes = 1;
+			}
+			std::uintptr_t result =
+			  memory_resource_details::align_up( m_current, alignment );
+			// Compare against the room left so that nothing can wrap
+			if( result < m_current or result > m_last or bytes > m_last - result ) {
+				add_block( bytes, alignment );
+				result = memory_resource_details::align_up( m_current, alignment );
+			}
+			m_current = result + bytes;
+			return reinterpret_cast<void *>( result );
+		}
+
+		void do_deallocate( void *, std::size_t, std::size_t ) override {}
+
+		[[nodiscard]] bool do_is_equal(
+		  std::pmr::memory_resource const &other ) const noexcept override {
+			return this == &other;
+		}
+
+	public:
+		static constexpr std::size_t default_block_size = 64U * 1024U;
+
+		explicit arena_resource(
+		  std::size_t block_size = default_block_size,
+		  std::pmr::memory_resource *upstream = std::pmr::get_default_resource( ) )
+		  : m_upstream( upstream )
+		  , m_next_block_size( block_size < 2U * sizeof( block_header )
+		                         ? 2U * sizeof( block_header )
+		                         : block_size ) {}
+
+		/***
+		 * Use buffer before going upstream.  buffer must outlive the arena
+		 */
+		arena_resource(
+		  void *buffer, std::size_t buffer_size,
+		  std::pmr::memory_resource *upstream = std::pmr::get_default_resource( ) )
+		  : arena_resource( default_block_size, upstream ) {
+			m_buffer = static_cast<unsigned char *>( buffer );
+			m_buffer_size = buffer_size;
+			use_buffer( );
+		}
+
+		arena_resource( arena_resource const & ) = delete;
+		arena_resource &operator=( arena_resource const & ) = delete;
+
+		~arena_resource( ) override {
+			release( );
+		}
+
+		/***
+		 * Free everything allocated from the arena but keep the largest block,
+		 * so a steady state workload stops going upstream.  Objects still
+		 * alive in the arena are not destructed
+		 */
+		void reset( ) noexcept {
+			if( m_blocks == nullptr ) {
+				use_buffer( );
+				return;
+			}
+			block_header *const newest = m_blocks;
+			block_header *block = daw::exchange( newest->next, nullptr );
+			while( block != nullptr ) {
+				block_header *const next = block->next;
+				m_upstream->deallocate( block, block->size,
+				                        alignof( std::max_align_t ) );
+				block = next;
+			}
+			m_current = reinterpret_cast<std::uintptr_t>( newest + 1 );
+			m_last = reinterpret_cast<std::uintptr_t>( newest ) + newest->size;
+		}
+
+		// Return all blocks upstream
+		void release( ) noexcept {
+			while( m_blocks != nullptr ) {
+				block_header *const next = m_blocks->next;
+				m_upstream->deallocate( m_blocks, m_blocks->size,
+				                        alignof( std::max_align_t ) );
+				m_blocks = next;
+			}
+			use_buffer( );
+		}
+
+		// The bytes left before the next allocation goes upstream
+		[[nodiscard]] std::size_t remaining( ) const noexcept {
+			return static_cast<std::size_t>( m_last - m_current );
+		}
+
+		[[nodiscard]] std::pmr::memory_resource *
+		upstream_resource( ) const noexcept {
+			return m_upstream;
+		}
+	};
+
+	/***
+	 * Free lists of power of two size classes from 8 bytes to max_pooled_size.
+	 * Each class is refilled a slab at a time from upstream, larger requests go
+	 * straight there.  With an arena_resource upstream, releasing the pool and
+	 * resetting the arena frees everything.  Not thread safe
+	 */
+	class pool_resource final : public std::pmr::memory_resource {
+	public:
+		static constexpr std::size_t min_pooled_size = 8;
+		static constexpr std::size_t max_pooled_size = 4096;
+		static constexpr std::size_t class_count = 10;
+
+	private:
+		struct free_node {
+			free_node *next;
+		};
+
+		struct slab_header {
+			slab_header *next;
+			std::size_t size;
+			std::size_t alignment;
+		};
+
+		std::pmr::memory_resource *m_upstream;
+		std::array<free_node *, class_count> m_free{ };
+		slab_header *m_slabs = nullptr;
+		std::size_t m_slab_size;
+
+		// The size class for bytes, or class_count if it is too large to pool
+		[[nodiscard]] static std::size_t size_class( std::size_t bytes ) noexcept {
+			if( bytes <= min_pooled_size ) {
+				return 0;
+			}
+			if( bytes > max_pooled_size ) {
+				return class_count;
+			}
+			return memory_resource_details::bit_width( ( bytes - 1U ) >> 3U );
+		}
+
+		[[nodiscard]] static constexpr std::size_t
+		class_size( std::size_t index ) noexcept {
+			return min_pooled_size << index;
+		}
+
+		void refill( std::size_t index ) {
+			std::size_t const size = class_size( index );
+			// The header is padded to whole objects so the rest stay aligned
+			std::size_t const header_size =
+			  ( ( sizeof( slab_header ) + size - 1U ) / size ) * size;
+			std::size_t const count =
+			  m_slab_size / size > 8U ? m_slab_size / size : 8U;
+			std::size_t const bytes = header_size + count * size;
+			std::size_t const alignment = size < alignof( std::max_align_t )
+			                                ? alignof( std::max_align_t )
+			                                : size;
+			auto *const slab = static_cast<slab_header *>(
+			  m_upstream->allocate( bytes, alignment ) );
+			slab->next = m_slabs;
+			slab->size = bytes;
+			slab->alignment = alignment;
+			m_slabs = slab;
+			auto *const first =
+			  reinterpret_cast<unsigned char *>( slab ) + header_size;
+			for( std::size_t n = count; n-- > 0; ) {
+				auto *const node = reinterpret_cast<free_node *>( first + n * size );
+				node->next = m_free[index];
+				m_free[index] = node;
+			}
+		}
+
+		void *do_allocate( std::size_t bytes, std::size_t alignment ) override {
+			std::size_t const index =
+			  size_class( bytes < alignment ? alignment : bytes );
+			if( index == class_count ) {
+				return m_upstream->allocate( bytes, alignment );
+			}
+			if( m_free[index] == nullptr ) {
+				refill( index );
+			}
+			free_node *const node = m_free[index];
+			m_free[index] = node->next;
+			return node;
+		}
+
+		void do_deallocate( void *ptr, std::size_t bytes,
+		                    std::size_t alignment ) override {
+			std::size_t const index =
+			  size_class( bytes < alignment ? alignment : bytes );
+			if( index == class_count ) {
+				m_upstream->deallocate( ptr, bytes, alignment );
+				return;
+			}
+			auto *const node = static_cast<free_node *>( ptr );
+			node->next = m_free[index];
+			m_free[index] = node;
+		}
+
+		[[nodiscard]] bool do_is_equal(
+		  std::pmr::memory_resource const &other ) const noexcept override {
+			return this == &other;
+		}
+
+	public:
+		static constexpr std::size_t default_slab_size = 16U * 1024U;
+
+		explicit pool_resource(
+		  std::pmr::memory_resource *upstream = std::pmr::get_default_resource( ),
+		  std::size_t slab_size = default_slab_size )
+		  : m_upstream( upstream )
+		  , m_slab_size( slab_size ) {}
+
+		pool_resource( pool_resource const & ) = delete;
+		pool_resource &operator=( pool_resource const & ) = delete;
+
+		~pool_resource( ) override {
+			release( );
+		}
+
+		/***
+		 * Return the slabs upstream.  Memory allocated from the pool, but not
+		 * allocations too large to pool, becomes invalid
+		 */
+		void release( ) noexcept {
+			while( m_slabs != nullptr ) {
+				slab_header *const next = m_slabs->next;
+				m_upstream->deallocate( m_slabs, m_slabs->size, m_slabs->alignment );
+				m_slabs = next;
+			}
+			m_free.fill( nullptr );
+		}
+
+		[[nodiscard]] std::pmr::memory_resource *
+		upstream_resource( ) const noexcept {
+			return m_upstream;
+		}
+	};
+
+	/***
+	 * A std allocator over a concrete resource.  Unlike
+	 * std::pmr::polymorphic_allocator the calls are not virtual, as the
+	 * resources are final.  Like it, construct passes the allocator on to
+	 * types that use one, but std::pair is not special cased.  It follows its
+	 * container on move and swap
+	 */
+	template<typename T, typename Resource>
+	class resource_allocator {
+		Resource *m_resource;
+
+		template<typename, typename>
+		friend class resource_allocator;
+
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		template<typename U>
+		struct rebind {
+			using other = resource_allocator<U, Resource>;
+		};
+
+		constexpr resource_allocator( Resource &resource ) noexcept
+		  : m_resource( &resource ) {}
+
+		template<typename U>
+		constexpr resource_allocator(
+		  resource_allocator<U, Resource> const &other ) noexcept
+		  : m_resource( other.m_resource ) {}
+
+		[[nodiscard]] T *allocate( std::size_t n ) {
+			if( n > std::numeric_limits<std::size_t>::max( ) / sizeof( T ) ) {
+				throw std::bad_array_new_length( );
+			}
+			return static_cast<T *>(
+			  m_resource->allocate( n * sizeof( T ), alignof( T ) ) );
+		}
+
+		void deallocate( T *ptr, std::size_t n ) noexcept {
+			m_resource->deallocate( ptr, n * sizeof( T ), alignof( T ) );
+		}
+
+		template<typename U, typename... Args>
+		void construct( U *ptr, Args &&...args ) {
+			void *const where = static_cast<void *>( ptr );
+			if constexpr( not std::uses_allocator_v<U, resource_allocator> ) {
+				::new( where ) U( std::forward<Args>( args )... );
+			} else if constexpr( std::is_constructible_v<U, std::allocator_arg_t,
+			                                             resource_allocator const &,
+			                                             Args...> ) {
+				::new( where ) U( std::allocator_arg, *this,
+				                  std::forward<Args>( args )... );
+			} else {
+				::new( where ) U( std::forward<Args>( args )..., *this );
+			}
+		}
+
+		[[nodiscard]] constexpr Resource *resource( ) const noexcept {
+			return m_resource;
+		}
+
+		template<typename U>
+		[[nodiscard]] constexpr bool
+		operator==( resource_allocator<U, Resource> const &rhs ) const noexcept {
+			return m_resource == rhs.m_resource;
+		}
+
+		template<typename U>
+		[[nodiscard]] constexpr bool
+		operator!=( resource_allocator<U, Resource> const &rhs ) const noexcept {
+			return m_resource != rhs.m_resource;
+		}
+	};
+
+	template<typename T>
+	using arena_allocator = resource_allocator<T, arena_resource>;
+
+	template<typename T>
+	using pool_allocator = resource_allocator<T, pool_resource>;
+} // namespace daw
@@ -0,0 +1,26 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+// Put before a return statement that calls a function with the same
+// signature to guarantee it is a tail call.  Empty when the compiler cannot
+// guarantee it, optimized builds usually make the tail call anyway
+#if defined( __has_cpp_attribute )
+#if __has_cpp_attribute( clang::musttail )
+#define DAW_MUSTTAIL [[clang::musttail]]
+#elif __has_cpp_attribute( gnu::musttail )
+#define DAW_MUSTTAIL [[gnu::musttail]]
+#endif
+#endif
+
+#if defined( DAW_MUSTTAIL )
+#define DAW_HAS_MUSTTAIL
+#else
+#define DAW_MUSTTAIL
+#endif
@@ -81,7 +81,8 @@ namespace daw {
 			return size( c );
 		}
 	} // namespace ordered_map_impl
-	// Use linear searching for key, keep values in insertion order
+	// Use linear searching for key, keep values in insertion order.  For
+	// lookups by Compare in O(log n) see daw::flat_map in daw_flat_map.h
 	template<typename Key, typename Value, typename Compare = std::less<Key>,
 	         typename Allocator = std::allocator<std::pair<Key, Value>>,
 	         typename Container = std::vector<std::pair<Key, Value>, Allocator>>
@@ -0,0 +1,575 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "cpp_17.h"
+#include "daw_is_constant_evaluated.h"
+#include "daw_move.h"
+#include "daw_simd_sort_n.h"
+#include "daw_swap.h"
+#include "daw_traits.h"
+
+#include <ciso646>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace daw {
+	/***
+	 * Pattern defeating quicksort, based on the algorithm by Orson Peters.
+	 * Pivots are the median of 3 or, for larger ranges, Tukey's ninther.  Each
+	 * partition reports whether the range was already partitioned so that
+	 * sorted runs finish in linear time, unbalanced partitions shuffle the
+	 * range to break up patterns, and once too many occur the range is
+	 * heapsorted to keep the worst case at O(n log n).  For arithmetic types
+	 * compared with std::less/std::greater the partition compares blocks of
+	 * elements into offset buffers without branching on the result.
+	 */
+	namespace pdq_sort_impl {
+		inline constexpr std::ptrdiff_t insertion_sort_threshold = 24;
+		inline constexpr std::ptrdiff_t ninther_threshold = 128;
+		inline constexpr std::size_t partial_insertion_sort_limit = 8;
+		inline constexpr std::size_t block_size = 64;
+
+		template<typename Compare, typename T>
+		inline constexpr bool is_default_compare_v =
+		  daw::traits::is_one_of_v<daw::remove_cvref_t<Compare>, std::less<>,
+		                           std::less<T>, std::greater<>,
+		                           std::greater<T>>;
+
+		template<typename RandomIterator, typename Compare>
+		inline constexpr bool use_branchless_v = [] {
+			using value_type =
+			  typename std::iterator_traits<RandomIterator>::value_type;
+			return std::is_arithmetic_v<value_type> and
+			       is_default_compare_v<Compare, value_type>;
+		}( );
+
+		template<typename RandomIterator, typename Compare>
+		constexpr void insertion_sort( RandomIterator first, RandomIterator last,
+		                               Compare &comp ) {
+			if( first == last ) {
+				return;
+			}
+			for( auto cur = std::next( first ); cur != last; ++cur ) {
+				auto sift = cur;
+				auto sift_1 = std::prev( cur );
+				if( comp( *sift, *sift_1 ) ) {
+					auto tmp = daw::move( *sift );
+					do {
+						*sift-- = daw::move( *sift_1 );
+					} while( sift != first and comp( tmp, *--sift_1 ) );
+					*sift = daw::move( tmp );
+				}
+			}
+		}
+
+		// Requires that *std::prev( first ) is not greater than any element
+		template<typename RandomIterator, typename Compare>
+		constexpr void unguarded_insertion_sort( RandomIterator first,
+		                                         RandomIterator last,
+		                                         Compare &comp ) {
+			if( first == last ) {
+				return;
+			}
+			for( auto cur = std::next( first ); cur != last; ++cur ) {
+				auto sift = cur;
+				auto sift_1 = std::prev( cur );
+				if( comp( *sift, *sift_1 ) ) {
+					auto tmp = daw::move( *sift );
+					do {
+						*sift-- = daw::move( *sift_1 );
+					} while( comp( tmp, *--sift_1 ) );
+					*sift = daw::move( tmp );
+				}
+			}
+		}
+
+		/***
+		 * Insertion sort that gives up after moving
+		 * partial_insertion_sort_limit elements
+		 * @return true if the range is now sorted
+		 */
+		template<typename RandomIterator, typename Compare>
+		constexpr bool partial_insertion_sort( RandomIterator first,
+		                                       RandomIterator last,
+		                                       Compare &comp ) {
+			if( first == last ) {
+				return true;
+			}
+			std::size_t limit = 0;
+			for( auto cur = std::next( first ); cur != last; ++cur ) {
+				auto sift = cur;
+				auto sift_1 = std::prev( cur );
+				if( comp( *sift, *sift_1 ) ) {
+					auto tmp = daw::move( *sift );
+					do {
+						*sift-- = daw::move( *sift_1 );
+					} while( sift != first and comp( tmp, *--sift_1 ) );
+					*sift = daw::move( tmp );
+					limit += static_cast<std::size_t>( cur - sift );
+				}
+				if( limit > partial_insertion_sort_limit ) {
+					return std::next( cur ) == last;
+				}
+			}
+			return true;
+		}
+
+		template<typename RandomIterator, typename Compare>
+		constexpr void sort2( RandomIterator a, RandomIterator b,
+		                      Compare &comp ) {
+			if( comp( *b, *a ) ) {
+				daw::iter_swap( a, b );
+			}
+		}
+
+		template<typename RandomIterator, typename Compare>
+		constexpr void sort3( RandomIterator a, RandomIterator b, RandomIterator c,
+		                      Compare &comp ) {
+			sort2( a, b, comp );
+			sort2( b, c, comp );
+			sort2( a, b, comp );
+		}
+
+		template<typename RandomIterator, typename Compare>
+		constexpr void sift_down( RandomIterator first, std::ptrdiff_t len,
+		                          std::ptrdiff_t pos, Compare &comp ) {
+			auto tmp = daw::move( first[pos] );
+			while( true ) {
+				auto child = 2 * pos + 1;
+				if( child >= len ) {
+					break;
+				}
+				if( child + 1 < len and comp( first[child], first[child + 1] ) ) {
+					++child;
+				}
+				if( not comp( tmp, first[child] ) ) {
+					break;
+				}
+				first[pos] = daw::move( first[child] );
+				pos = child;
+			}
+			first[pos] = daw::move( tmp );
+		}
+
+		template<typename RandomIterator, typename Compare>
+		constexpr void heap_sort( RandomIterator first, RandomIterator last,
+		                          Compare &comp ) {
+			auto len = static_cast<std::ptrdiff_t>( last - first );
+			for( auto pos = len / 2; pos > 0; --pos ) {
+				sift_down( first, len, pos - 1, comp );
+			}
+			while( len > 1 ) {
+				--len;
+				daw::iter_swap( first, first + len );
+				sift_down( first, len, 0, comp );
+			}
+		}
+
+		/***
+		 * Sort [first, last) when it is already ascending, or reverse it when it
+		 * is strictly descending.  Stops at the first element that breaks both
+		 * patterns so random data costs only a few comparisons
+		 * @return true if the range is sorted
+		 */
+		template<typename RandomIterator, typename Compare>
+		constexpr bool sort_if_monotonic( RandomIterator first,
+		                                  RandomIterator last, Compare &comp ) {
+			if( last - first < 2 ) {
+				return true;
+			}
+			auto it = std::next( first );
+			if( comp( *it, *first ) ) {
+				while( ++it != last ) {
+					if( not comp( *it, *std::prev( it ) ) ) {
+						return false;
+					}
+				}
+				while( first < --last ) {
+					daw::iter_swap( first, last );
+					++first;
+				}
+				return true;
+			}
+			while( ++it != last ) {
+				if( comp( *it, *std::prev( it ) ) ) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/***
+		 * Move the pivot at *first into place with all the elements less than it
+		 * before.  Elements equal to the pivot go to the right
+		 * @return the pivot position and whether no elements had to be moved
+		 */
+		template<typename RandomIterator, typename Compare>
+		constexpr std::pair<RandomIterator, bool>
+		partition_right( RandomIterator begin, RandomIterator end,
+		                 Compare &comp ) {
+			auto pivot = daw::move( *begin );
+			auto first = begin;
+			auto last = end;
+
+			// The median of 3 guarantees an element not less than the pivot
+			// exists, so the first search is unguarded
+			while( comp( *++first, pivot ) ) {}
+			if( std::prev( first ) == begin ) {
+				while( first < last and not comp( *--last, pivot ) ) {}
+			} else {
+				while( not comp( *--last, pivot ) ) {}
+			}
+			bool const already_partitioned = first >= last;
+			while( first < last ) {
+				daw::iter_swap( first, last );
+				while( comp( *++first, pivot ) ) {}
+				while( not comp( *--last, pivot ) ) {}
+			}
+			auto const pivot_pos = std::prev( first );
+			*begin = daw::move( *pivot_pos );
+			*pivot_pos = daw::move( pivot );
+			return { pivot_pos, already_partitioned };
+		}
+
+		// Swap the elements at the given offsets, as a cyclic permutation when
+		// the counts differ as that does fewer moves
+		template<typename RandomIterator>
+		constexpr void swap_offsets( RandomIterator first, RandomIterator last,
+		                             unsigned char const *offsets_l,
+		                             unsigned char const *offsets_r,
+		                             std::size_t num, bool use_swaps ) {
+			if( use_swaps ) {
+				for( std::size_t n = 0; n < num; ++n ) {
+					daw::iter_swap( first + offsets_l[n], last - offsets_r[n] );
+				}
+			} else if( num > 0 ) {
+				auto l = first + offsets_l[0];
+				auto r = last - offsets_r[0];
+				auto tmp = daw::move( *l );
+				*l = daw::move( *r );
+				for( std::size_t n = 1; n < num; ++n ) {
+					l = first + offsets_l[n];
+					*r = daw::move( *l );
+					r = last - offsets_r[n];
+					*l = daw::move( *r );
+				}
+				*r = daw::move( tmp );
+			}
+		}
+
+		/***
+		 * partition_right that finds misplaced elements a block at a time.  The
+		 * comparison result is added to the offset count instead of branched on
+		 */
+		template<typename RandomIterator, typename Compare>
+		constexpr std::pair<RandomIterator, bool>
+		partition_right_branchless( RandomIterator begin, RandomIterator end,
+		                            Compare &comp ) {
+			auto pivot = daw::move( *begin );
+			auto first = begin;
+			auto last = end;
+
+			while( comp( *++first, pivot ) ) {}
+			if( std::prev( first ) == begin ) {
+				while( first < last and not comp( *--last, pivot ) ) {}
+			} else {
+				while( not comp( *--last, pivot ) ) {}
+			}
+			bool const already_partitioned = first >= last;
+			if( not already_partitioned ) {
+				daw::iter_swap( first, last );
+				++first;
+
+				alignas( 64 ) unsigned char offsets_l[block_size]{ };
+				alignas( 64 ) unsigned char offsets_r[block_size]{ };
+				auto offsets_l_base = first;
+				auto offsets_r_base = last;
+				std::size_t num_l = 0;
+				std::size_t num_r = 0;
+				std::size_t start_l = 0;
+				std::size_t start_r = 0;
+
+				while( first < last ) {
+					// Fill whichever offset blocks are empty, splitting what is left
+					// between them when both are
+					auto const num_unknown = static_cast<std::size_t>( last - first );
+					std::size_t const left_split =
+					  num_l == 0 ? ( num_r == 0 ? num_unknown / 2 : num_unknown ) : 0;
+					std::size_t const right_split =
+					  num_r == 0 ? ( num_unknown - left_split ) : 0;
+
+					for( std::size_t n = 0; n < std::min( left_split, block_size );
+					     ++n ) {
+						offsets_l[num_l] = static_cast<unsigned char>( n );
+						num_l += not comp( *first, pivot );
+						++first;
+					}
+					for( std::size_t n = 0; n < std::min( right_split, block_size );
+					     ++n ) {
+						offsets_r[num_r] = static_cast<unsigned char>( n + 1U );
+						num_r += comp( *--last, pivot );
+					}
+
+					auto const num = std::min( num_l, num_r );
+					swap_offsets( offsets_l_base, offsets_r_base, offsets_l + start_l,
+					              offsets_r + start_r, num, num_l == num_r );
+					num_l -= num;
+					num_r -= num;
+					start_l += num;
+					start_r += num;
+					if( num_l == 0 ) {
+						start_l = 0;
+						offsets_l_base = first;
+					}
+					if( num_r == 0 ) {
+						start_r = 0;
+						offsets_r_base = last;
+					}
+				}
+
+				// Only one side can have misplaced elements left, move them to the
+				// boundary
+				if( num_l != 0 ) {
+					while( num_l-- != 0 ) {
+						daw::iter_swap( offsets_l_base + offsets_l[start_l + num_l],
+						                --last );
+					}
+					first = last;
+				}
+				if( num_r != 0 ) {
+					while( num_r-- != 0 ) {
+						daw::iter_swap( offsets_r_base - offsets_r[start_r + num_r],
+						                first );
+						++first;
+					}
+					last = first;
+				}
+			}
+			auto const pivot_pos = std::prev( first );
+			*begin = daw::move( *pivot_pos );
+			*pivot_pos = daw::move( pivot );
+			return { pivot_pos, already_partitioned };
+		}
+
+		/***
+		 * Partition with elements equal to the pivot at *first on the left.  Used
+		 * when the pivot equals the element before the range, everything equal
+		 * is then in its final place
+		 * @return the position of the last element equal to the pivot
+		 */
+		template<typename RandomIterator, typename Compare>
+		constexpr RandomIterator partition_left( RandomIterator begin,
+		                                         RandomIterator end,
+		                                         Compare &comp ) {
+			auto pivot = daw::move( *begin );
+			auto first = begin;
+			auto last = end;
+
+			while( comp( pivot, *--last ) ) {}
+			if( std::next( last ) == end ) {
+				while( first < last and not comp( pivot, *++first ) ) {}
+			} else {
+				while( not comp( pivot, *++first ) ) {}
+			}
+			while( first < last ) {
+				daw::iter_swap( first, last );
+				while( comp( pivot, *--last ) ) {}
+				while( not comp( pivot, *++first ) ) {}
+			}
+			*begin = daw::move( *last );
+			*last = daw::move( pivot );
+			return last;
+		}
+
+		/***
+		 * Choose a pivot and move it to *first.  Uses the median of 3, or for
+		 * larger ranges Tukey's ninther
+		 */
+		template<typename RandomIterator, typename Compare>
+		constexpr void choose_pivot( RandomIterator first, RandomIterator last,
+		                             Compare &comp ) {
+			auto const size = last - first;
+			auto const s2 = size / 2;
+			if( size > ninther_threshold ) {
+				sort3( first, first + s2, last - 1, comp );
+				sort3( first + 1, first + ( s2 - 1 ), last - 2, comp );
+				sort3( first + 2, first + ( s2 + 1 ), last - 3, comp );
+				sort3( first + ( s2 - 1 ), first + s2, first + ( s2 + 1 ), comp );
+				daw::iter_swap( first, first + s2 );
+			} else {
+				sort3( first + s2, first, last - 1, comp );
+			}
+		}
+
+		// After a badly unbalanced partition, swap a few elements to break up
+		// patterns that caused it
+		template<typename RandomIterator>
+		constexpr void shuffle_after_bad_partition( RandomIterator first,
+		                                            RandomIterator pivot_pos,
+		                                            RandomIterator last ) {
+			auto const l_size = pivot_pos - first;
+			auto const r_size = last - ( pivot_pos + 1 );
+			if( l_size >= insertion_sort_threshold ) {
+				daw::iter_swap( first, first + l_size / 4 );
+				daw::iter_swap( pivot_pos - 1, pivot_pos - l_size / 4 );
+				if( l_size > ninther_threshold ) {
+					daw::iter_swap( first + 1, first + ( l_size / 4 + 1 ) );
+					daw::iter_swap( first + 2, first + ( l_size / 4 + 2 ) );
+					daw::iter_swap( pivot_pos - 2, pivot_pos - ( l_size / 4 + 1 ) );
+					daw::iter_swap( pivot_pos - 3, pivot_pos - ( l_size / 4 + 2 ) );
+				}
+			}
+			if( r_size >= insertion_sort_threshold ) {
+				daw::iter_swap( pivot_pos + 1, pivot_pos + ( 1 + r_size / 4 ) );
+				daw::iter_swap( last - 1, last - r_size / 4 );
+				if( r_size > ninther_threshold ) {
+					daw::iter_swap( pivot_pos + 2, pivot_pos + ( 2 + r_size / 4 ) );
+					daw::iter_swap( pivot_pos + 3, pivot_pos + ( 3 + r_size / 4 ) );
+					daw::iter_swap( last - 2, last - ( 1 + r_size / 4 ) );
+					daw::iter_swap( last - 3, last - ( 2 + r_size / 4 ) );
+				}
+			}
+		}
+
+		/***
+		 * The result of partitioning one range in pdq_step
+		 */
+		template<typename RandomIterator>
+		struct step_result {
+			// Nothing left to do for the range
+			bool done = false;
+			// The range was split at pivot_pos, both sides still need sorting
+			bool split = false;
+			RandomIterator pivot_pos{ };
+			// The left part is [first, pivot_pos) and the right part starts at
+			// pivot_pos + 1 when split, otherwise the range continues at next
+			RandomIterator next{ };
+		};
+
+		/***
+		 * Do one partitioning step of [first, last).  Shared by the recursive
+		 * driver and daw::quick_sort's explicit stack
+		 * @param bad_allowed number of unbalanced partitions left before falling
+		 * back to heap sort
+		 * @param leftmost false when *std::prev( first ) is a valid sentinel not
+		 * greater than any element in the range
+		 */
+		template<bool Branchless, typename RandomIterator, typename Compare>
+		constexpr step_result<RandomIterator>
+		pdq_step( RandomIterator first, RandomIterator last, Compare &comp,
+		          int &bad_allowed, bool leftmost ) {
+			auto const size = last - first;
+			if constexpr( simd_sort_impl::is_simd_sortable_v<RandomIterator,
+			                                                 Compare> ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) and
+				    size <= static_cast<std::ptrdiff_t>(
+				              simd_sort_impl::max_simd_sort_size ) and
+				    simd_sort_impl::try_sort( first, last, comp ) ) {
+					return { true, false, first, last };
+				}
+			}
+			if( size < insertion_sort_threshold ) {
+				if( leftmost ) {
+					insertion_sort( first, last, comp );
+				} else {
+					unguarded_insertion_sort( first, last, comp );
+				}
+				return { true, false, first, last };
+			}
+			choose_pivot( first, last, comp );
+
+			// The pivot equals the element before the range, so there are no
+			// smaller elements.  Put all the equal ones in place and move on
+			if( not leftmost and not comp( *std::prev( first ), *first ) ) {
+				return { false, false, first, std::next( partition_left( first, last,
+				                                                         comp ) ) };
+			}
+
+			auto const [pivot_pos, already_partitioned] = [&] {
+				if constexpr( Branchless ) {
+					return partition_right_branchless( first, last, comp );
+				} else {
+					return partition_right( first, last, comp );
+				}
+			}( );
+			auto const l_size = pivot_pos - first;
+			auto const r_size = last - ( pivot_pos + 1 );
+			if( l_size < size / 8 or r_size < size / 8 ) {
+				if( --bad_allowed == 0 ) {
+					heap_sort( first, last, comp );
+					return { true, false, first, last };
+				}
+				shuffle_after_bad_partition( first, pivot_pos, last );
+			} else if( already_partitioned and
+			           partial_insertion_sort( first, pivot_pos, comp ) and
+			           partial_insertion_sort( std::next( pivot_pos ), last,
+			                                   comp ) ) {
+				return { true, false, first, last };
+			}
+			return { false, true, pivot_pos, std::next( pivot_pos ) };
+		}
+
+		template<bool Branchless, typename RandomIterator, typename Compare>
+		constexpr void pdq_loop( RandomIterator first, RandomIterator last,
+		                         Compare &comp, int bad_allowed, bool leftmost ) {
+			while( true ) {
+				auto const step =
+				  pdq_step<Branchless>( first, last, comp, bad_allowed, leftmost );
+				if( step.done ) {
+					return;
+				}
+				if( step.split ) {
+					// Recurse into the smaller side so the depth stays logarithmic
+					if( step.pivot_pos - first < last - step.next ) {
+						pdq_loop<Branchless>( first, step.pivot_pos, comp, bad_allowed,
+						                      leftmost );
+						first = step.next;
+						leftmost = false;
+					} else {
+						pdq_loop<Branchless>( step.next, last, comp, bad_allowed,
+						                      false );
+						last = step.pivot_pos;
+					}
+					continue;
+				}
+				first = step.next;
+				leftmost = false;
+			}
+		}
+
+		template<typename Integer>
+		[[nodiscard]] constexpr int log2( Integer n ) {
+			int result = 0;
+			while( n >>= 1 ) {
+				++result;
+			}
+			return result;
+		}
+	} // namespace pdq_sort_impl
+
+	/***
+	 * Sort [first, last) with pattern defeating quicksort.  Not stable.  Sorted
+	 * and reverse sorted input take linear time and the worst case is
+	 * O(n log n)
+	 */
+	template<typename RandomIterator, typename Compare = std::less<>>
+	constexpr void pdq_sort( RandomIterator first, RandomIterator last,
+	                         Compare comp = Compare{ } ) {
+		if( pdq_sort_impl::sort_if_monotonic( first, last, comp ) ) {
+			return;
+		}
+		pdq_sort_impl::pdq_loop<
+		  pdq_sort_impl::use_branchless_v<RandomIterator, Compare>>(
+		  first, last, comp, pdq_sort_impl::log2( last - first ), true );
+	}
+} // namespace daw
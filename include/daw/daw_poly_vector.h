@@ -9,25 +9,708 @@
 #pragma once
 
 #include "daw_common_mixins.h"
+#include "daw_exception.h"
 #include "daw_heap_value.h"
+#include "daw_traits.h"
 
 #include <ciso646>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace daw {
-	template<typename T>
+	namespace poly_vector_details {
+		template<typename T, typename Allocator>
+		using values_t = std::vector<
+		  daw::heap_value<T, Allocator>,
+		  typename std::allocator_traits<Allocator>::template rebind_alloc<
+		    daw::heap_value<T, Allocator>>>;
+
+		/***
+		 * Moves, copies and destroys runs of one dynamic type for a
+		 * packed_poly_vector that only knows the type by this table
+		 */
+		struct type_ops {
+			std::size_t size;
+			std::size_t align;
+			// Construct n objects at dst from the n at src, then destroy those at src
+			void ( *relocate_n )( std::byte *dst, std::byte *src, std::size_t n );
+			// nullptr when the type is not copy constructible
+			void ( *copy_n )( std::byte *dst, std::byte const *src, std::size_t n );
+			void ( *destroy_n )( std::byte *ptr, std::size_t n ) noexcept;
+		};
+
+		template<typename D>
+		[[nodiscard]] D *object_at( std::byte *ptr ) noexcept {
+			return std::launder( reinterpret_cast<D *>( ptr ) );
+		}
+
+		template<typename D>
+		[[nodiscard]] D const *object_at( std::byte const *ptr ) noexcept {
+			return std::launder( reinterpret_cast<D const *>( ptr ) );
+		}
+
+		template<typename D>
+		void destroy_n( std::byte *ptr, std::size_t n ) noexcept {
+			if constexpr( not std::is_trivially_destructible_v<D> ) {
+				for( std::size_t i = 0; i < n; ++i ) {
+					object_at<D>( ptr + i * sizeof( D ) )->~D( );
+				}
+			}
+		}
+
+		template<typename D, typename Source>
+		void construct_n( std::byte *dst, Source *src, std::size_t n ) {
+			std::size_t i = 0;
+			try {
+				for( ; i < n; ++i ) {
+					auto &value = *object_at<D>( src + i * sizeof( D ) );
+					if constexpr( std::is_const_v<Source> ) {
+						::new( static_cast<void *>( dst + i * sizeof( D ) ) ) D( value );
+					} else {
+						::new( static_cast<void *>( dst + i * sizeof( D ) ) )
+						  D( std::move_if_noexcept( value ) );
+					}
+				}
+			} catch( ... ) {
+				destroy_n<D>( dst, i );
+				throw;
+			}
+		}
+
+		template<typename D>
+		void relocate_n( std::byte *dst, std::byte *src, std::size_t n ) {
+			construct_n<D>( dst, src, n );
+			destroy_n<D>( src, n );
+		}
+
+		template<typename D>
+		void copy_n( std::byte *dst, std::byte const *src, std::size_t n ) {
+			construct_n<D>( dst, src, n );
+		}
+
+		template<typename D>
+		constexpr auto copy_n_ptr( ) noexcept {
+			using copy_t = void ( * )( std::byte *, std::byte const *, std::size_t );
+			if constexpr( std::is_copy_constructible_v<D> ) {
+				return static_cast<copy_t>( copy_n<D> );
+			} else {
+				return static_cast<copy_t>( nullptr );
+			}
+		}
+
+		// One per type, its address identifies the type
+		template<typename D>
+		inline constexpr type_ops type_ops_for = {
+		  sizeof( D ), alignof( D ), relocate_n<D>, copy_n_ptr<D>( ),
+		  destroy_n<D> };
+
+		// The objects of one dynamic type, each sizeof( D ) apart
+		struct segment {
+			type_ops const *ops = nullptr;
+			std::byte *raw = nullptr;
+			std::size_t raw_size = 0;
+			// raw aligned up to ops->align
+			std::byte *data = nullptr;
+			std::size_t size = 0;
+			std::size_t capacity = 0;
+			// From an object to its base class subobject
+			std::ptrdiff_t base_offset = 0;
+		};
+
+		// Where an element is in insertion order
+		struct slot {
+			std::size_t segment;
+			std::size_t offset;
+		};
+	} // namespace poly_vector_details
+
+	/***
+	 * A vector of heap_value<T>.  Allocator is used for the vector and each
+	 * value.  With std::pmr::polymorphic_allocator or daw::resource_allocator
+	 * the vector passes itself to the values it constructs, std::allocator
+	 * values are default constructed.  Each value is stored as a T, see
+	 * packed_poly_vector for keeping derived types
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
 	class poly_vector_t
-	  : public daw::mixins::VectorLikeProxy<poly_vector_t<T>,
-	                                        std::vector<daw::heap_value<T>>> {
-		std::vector<daw::heap_value<T>> m_values;
+	  : public daw::mixins::VectorLikeProxy<
+	      poly_vector_t<T, Allocator>,
+	      poly_vector_details::values_t<T, Allocator>> {
+	public:
+		using allocator_type = Allocator;
+		using values_type = poly_vector_details::values_t<T, Allocator>;
+
+	private:
+		values_type m_values;
 
 	public:
-		std::vector<daw::heap_value<T>> &container( ) {
+		poly_vector_t( ) = default;
+
+		explicit poly_vector_t( allocator_type const &alloc )
+		  : m_values( typename values_type::allocator_type( alloc ) ) {}
+
+		values_type &container( ) {
 			return m_values;
 		}
 
-		std::vector<daw::heap_value<T>> const &container( ) const {
+		values_type const &container( ) const {
 			return m_values;
 		}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return allocator_type( m_values.get_allocator( ) );
+		}
 	}; // poly_vector_t
+
+	/***
+	 * A polymorphic vector that stores its objects inline rather than one heap
+	 * allocation each.  Objects of the same dynamic type share a contiguous
+	 * segment, and a table of segment/offset pairs keeps insertion order.
+	 * Segments grow by relocating their objects, which invalidates references
+	 * to that type only.  Objects are destroyed as their dynamic type, so T
+	 * does not need a virtual destructor
+	 */
+	template<typename T, typename Allocator = std::allocator<T>>
+	class packed_poly_vector {
+		template<bool IsConst>
+		class index_iterator;
+
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T &;
+		using const_reference = T const &;
+		using iterator = index_iterator<false>;
+		using const_iterator = index_iterator<true>;
+
+	private:
+		using segment = poly_vector_details::segment;
+		using slot = poly_vector_details::slot;
+		using alloc_traits = std::allocator_traits<allocator_type>;
+		using byte_allocator =
+		  typename alloc_traits::template rebind_alloc<std::byte>;
+		using byte_traits = std::allocator_traits<byte_allocator>;
+		using segments_type = std::vector<
+		  segment, typename alloc_traits::template rebind_alloc<segment>>;
+		using slots_type =
+		  std::vector<slot, typename alloc_traits::template rebind_alloc<slot>>;
+
+		static constexpr std::size_t npos = static_cast<std::size_t>( -1 );
+
+		segments_type m_segments;
+		slots_type m_slots;
+
+		template<typename D>
+		[[nodiscard]] std::size_t find_segment( ) const noexcept {
+			auto const *const ops = &poly_vector_details::type_ops_for<D>;
+			for( std::size_t n = 0; n < m_segments.size( ); ++n ) {
+				if( m_segments[n].ops == ops ) {
+					return n;
+				}
+			}
+			return npos;
+		}
+
+		template<typename D>
+		[[nodiscard]] std::size_t segment_for( ) {
+			auto const result = find_segment<D>( );
+			if( result != npos ) {
+				return result;
+			}
+			m_segments.push_back( segment{ &poly_vector_details::type_ops_for<D> } );
+			return m_segments.size( ) - 1U;
+		}
+
+		// Give seg a buffer for capacity objects, relocating what it has
+		void grow( segment &seg, std::size_t capacity ) {
+			auto alloc = byte_allocator( m_segments.get_allocator( ) );
+			// Allocators need not align bytes for the types stored in them
+			std::size_t const raw_size =
+			  capacity * seg.ops->size + seg.ops->align - 1U;
+			std::byte *const raw = byte_traits::allocate( alloc, raw_size );
+			void *data = raw;
+			std::size_t space = raw_size;
+			(void)std::align( seg.ops->align, capacity * seg.ops->size, data,
+			                  space );
+			if( seg.size > 0 ) {
+				try {
+					seg.ops->relocate_n( static_cast<std::byte *>( data ), seg.data,
+					                     seg.size );
+				} catch( ... ) {
+					byte_traits::deallocate( alloc, raw, raw_size );
+					throw;
+				}
+			}
+			if( seg.raw != nullptr ) {
+				byte_traits::deallocate( alloc, seg.raw, seg.raw_size );
+			}
+			seg.raw = raw;
+			seg.raw_size = raw_size;
+			seg.data = static_cast<std::byte *>( data );
+			seg.capacity = capacity;
+		}
+
+		void release_all( ) noexcept {
+			clear( );
+			auto alloc = byte_allocator( m_segments.get_allocator( ) );
+			for( segment &seg : m_segments ) {
+				if( seg.raw != nullptr ) {
+					byte_traits::deallocate( alloc, seg.raw, seg.raw_size );
+				}
+			}
+			m_segments.clear( );
+		}
+
+		// Copy or, when other is an rvalue, relocate the segments of other into
+		// this.  this must have no segments
+		template<typename Other>
+		void take_segments( Other &&other ) {
+			constexpr bool is_copy = std::is_lvalue_reference_v<Other>;
+			try {
+				m_segments.reserve( other.m_segments.size( ) );
+				for( auto &src : other.m_segments ) {
+					m_segments.push_back( segment{ src.ops } );
+					segment &dst = m_segments.back( );
+					dst.base_offset = src.base_offset;
+					if( src.size == 0 ) {
+						continue;
+					}
+					if constexpr( is_copy ) {
+						daw::exception::precondition_check<std::logic_error>(
+						  src.ops->copy_n != nullptr,
+						  "Cannot copy a type that is not copy constructible" );
+						grow( dst, src.size );
+						src.ops->copy_n( dst.data, src.data, src.size );
+						dst.size = src.size;
+					} else {
+						grow( dst, src.size );
+						src.ops->relocate_n( dst.data, src.data, src.size );
+						dst.size = std::exchange( src.size, 0U );
+					}
+				}
+			} catch( ... ) {
+				release_all( );
+				throw;
+			}
+		}
+
+		[[nodiscard]] T *get( slot s ) const noexcept {
+			segment const &seg = m_segments[s.segment];
+			return std::launder(
+			  reinterpret_cast<T *>( seg.data + s.offset + seg.base_offset ) );
+		}
+
+		// Call func( D & ) on each object in seg, as D is T or its dynamic type
+		template<typename D, typename Function>
+		static void visit_segment( segment const &seg, std::ptrdiff_t adjust,
+		                           Function &func ) {
+			std::size_t const stride = seg.ops->size;
+			std::byte *ptr = seg.data + adjust;
+			for( std::size_t n = 0; n < seg.size; ++n ) {
+				func( *std::launder( reinterpret_cast<D *>( ptr ) ) );
+				ptr += stride;
+			}
+		}
+
+	public:
+		packed_poly_vector( ) = default;
+
+		explicit packed_poly_vector( allocator_type const &alloc )
+		  : m_segments( typename segments_type::allocator_type( alloc ) )
+		  , m_slots( typename slots_type::allocator_type( alloc ) ) {}
+
+		packed_poly_vector( packed_poly_vector const &other )
+		  : packed_poly_vector( other,
+		                        alloc_traits::select_on_container_copy_construction(
+		                          other.get_allocator( ) ) ) {}
+
+		packed_poly_vector( packed_poly_vector const &other,
+		                    allocator_type const &alloc )
+		  : m_segments( typename segments_type::allocator_type( alloc ) )
+		  , m_slots( other.m_slots,
+		             typename slots_type::allocator_type( alloc ) ) {
+			take_segments( other );
+		}
+
+		packed_poly_vector( packed_poly_vector &&other ) noexcept = default;
+
+		packed_poly_vector &operator=( packed_poly_vector const &rhs ) {
+			if( this != &rhs ) {
+				allocator_type alloc = get_allocator( );
+				if constexpr( alloc_traits::propagate_on_container_copy_assignment::
+				                value ) {
+					alloc = rhs.get_allocator( );
+				}
+				*this = packed_poly_vector( rhs, alloc );
+			}
+			return *this;
+		}
+
+		packed_poly_vector &operator=( packed_poly_vector &&rhs ) noexcept(
+		  alloc_traits::propagate_on_container_move_assignment::value or
+		  alloc_traits::is_always_equal::value ) {
+			if( this == &rhs ) {
+				return *this;
+			}
+			release_all( );
+			if( alloc_traits::propagate_on_container_move_assignment::value or
+			    get_allocator( ) == rhs.get_allocator( ) ) {
+				m_segments = std::move( rhs.m_segments );
+				m_slots = std::move( rhs.m_slots );
+				rhs.m_segments.clear( );
+				rhs.m_slots.clear( );
+			} else {
+				take_segments( std::move( rhs ) );
+				m_slots.assign( rhs.m_slots.begin( ), rhs.m_slots.end( ) );
+				rhs.release_all( );
+			}
+			return *this;
+		}
+
+		~packed_poly_vector( ) {
+			release_all( );
+		}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return allocator_type( m_segments.get_allocator( ) );
+		}
+
+		/***
+		 * Construct a D at the end, in the segment for D
+		 * @return the new object
+		 */
+		template<typename D, typename... Args>
+		D &emplace_back( Args &&...args ) {
+			static_assert( std::is_base_of_v<T, D>, "D must be derived from T" );
+			if( m_slots.size( ) == m_slots.capacity( ) ) {
+				// Reserved first so nothing can throw once the object is built
+				m_slots.reserve( m_slots.empty( ) ? 8U : 2U * m_slots.size( ) );
+			}
+			auto const index = segment_for<D>( );
+			segment &seg = m_segments[index];
+			if( seg.size == seg.capacity ) {
+				grow( seg, seg.capacity == 0 ? 8U : 2U * seg.capacity );
+			}
+			std::size_t const offset = seg.size * sizeof( D );
+			D *const result = ::new( static_cast<void *>( seg.data + offset ) )
+			  D( std::forward<Args>( args )... );
+			seg.base_offset = reinterpret_cast<std::byte *>( static_cast<T *>(
+			                    result ) ) -
+			                  reinterpret_cast<std::byte *>( result );
+			m_slots.push_back( slot{ index, offset } );
+			++seg.size;
+			return *result;
+		}
+
+		/***
+		 * Add a copy of value as its static type
+		 */
+		template<typename U,
+		         std::enable_if_t<std::is_base_of_v<T, daw::remove_cvref_t<U>>,
+		                          std::nullptr_t> = nullptr>
+		daw::remove_cvref_t<U> &push_back( U &&value ) {
+			return emplace_back<daw::remove_cvref_t<U>>( std::forward<U>( value ) );
+		}
+
+		void pop_back( ) noexcept {
+			slot const s = m_slots.back( );
+			segment &seg = m_segments[s.segment];
+			--seg.size;
+			seg.ops->destroy_n( seg.data + s.offset, 1 );
+			m_slots.pop_back( );
+		}
+
+		// Destroys every object and keeps the segment buffers
+		void clear( ) noexcept {
+			for( segment &seg : m_segments ) {
+				seg.ops->destroy_n( seg.data, seg.size );
+				seg.size = 0;
+			}
+			m_slots.clear( );
+		}
+
+		void reserve( size_type count ) {
+			m_slots.reserve( count );
+		}
+
+		// Make room for count objects of type D without relocating
+		template<typename D>
+		void reserve_for( size_type count ) {
+			static_assert( std::is_base_of_v<T, D>, "D must be derived from T" );
+			segment &seg = m_segments[segment_for<D>( )];
+			if( seg.capacity < count ) {
+				grow( seg, count );
+			}
+		}
+
+		[[nodiscard]] size_type size( ) const noexcept {
+			return m_slots.size( );
+		}
+
+		[[nodiscard]] bool empty( ) const noexcept {
+			return m_slots.empty( );
+		}
+
+		// The number of dynamic types that have had a segment
+		[[nodiscard]] size_type type_count( ) const noexcept {
+			return m_segments.size( );
+		}
+
+		template<typename D>
+		[[nodiscard]] size_type count_of( ) const noexcept {
+			auto const index = find_segment<D>( );
+			return index == npos ? 0U : m_segments[index].size;
+		}
+
+		[[nodiscard]] reference operator[]( size_type index ) noexcept {
+			return *get( m_slots[index] );
+		}
+
+		[[nodiscard]] const_reference
+		operator[]( size_type index ) const noexcept {
+			return *get( m_slots[index] );
+		}
+
+		[[nodiscard]] reference at( size_type index ) {
+			daw::exception::precondition_check<std::out_of_range>(
+			  index < size( ), "Attempt to access past end of packed_poly_vector" );
+			return operator[]( index );
+		}
+
+		[[nodiscard]] const_reference at( size_type index ) const {
+			daw::exception::precondition_check<std::out_of_range>(
+			  index < size( ), "Attempt to access past end of packed_poly_vector" );
+			return operator[]( index );
+		}
+
+		[[nodiscard]] reference front( ) noexcept {
+			return operator[]( 0 );
+		}
+
+		[[nodiscard]] const_reference front( ) const noexcept {
+			return operator[]( 0 );
+		}
+
+		[[nodiscard]] reference back( ) noexcept {
+			return operator[]( size( ) - 1U );
+		}
+
+		[[nodiscard]] const_reference back( ) const noexcept {
+			return operator[]( size( ) - 1U );
+		}
+
+		// Iteration is in insertion order
+		[[nodiscard]] iterator begin( ) noexcept {
+			return iterator( this, 0 );
+		}
+
+		[[nodiscard]] const_iterator begin( ) const noexcept {
+			return const_iterator( this, 0 );
+		}
+
+		[[nodiscard]] const_iterator cbegin( ) const noexcept {
+			return begin( );
+		}
+
+		[[nodiscard]] iterator end( ) noexcept {
+			return iterator( this, static_cast<difference_type>( size( ) ) );
+		}
+
+		[[nodiscard]] const_iterator end( ) const noexcept {
+			return const_iterator( this, static_cast<difference_type>( size( ) ) );
+		}
+
+		[[nodiscard]] const_iterator cend( ) const noexcept {
+			return end( );
+		}
+
+		/***
+		 * Call func( T & ) on every object, one dynamic type after another.  The
+		 * virtual calls in a run all go to the same place, so they predict well
+		 */
+		template<typename Function>
+		void for_each_by_type( Function &&func ) {
+			for( segment const &seg : m_segments ) {
+				visit_segment<T>( seg, seg.base_offset, func );
+			}
+		}
+
+		template<typename Function>
+		void for_each_by_type( Function &&func ) const {
+			for( segment const &seg : m_segments ) {
+				visit_segment<T const>( seg, seg.base_offset, func );
+			}
+		}
+
+		/***
+		 * Call func( D & ) on every object whose dynamic type is exactly D
+		 */
+		template<typename D, typename Function>
+		void for_each_of( Function &&func ) {
+			auto const index = find_segment<D>( );
+			if( index != npos ) {
+				visit_segment<D>( m_segments[index], 0, func );
+			}
+		}
+
+		template<typename D, typename Function>
+		void for_each_of( Function &&func ) const {
+			auto const index = find_segment<D>( );
+			if( index != npos ) {
+				visit_segment<D const>( m_segments[index], 0, func );
+			}
+		}
+
+		void swap( packed_poly_vector &other ) noexcept {
+			m_segments.swap( other.m_segments );
+			m_slots.swap( other.m_slots );
+		}
+
+		friend void swap( packed_poly_vector &lhs,
+		                  packed_poly_vector &rhs ) noexcept {
+			lhs.swap( rhs );
+		}
+
+	private:
+		template<bool IsConst>
+		class index_iterator {
+			friend class packed_poly_vector;
+			template<bool>
+			friend class packed_poly_vector::index_iterator;
+
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::conditional_t<IsConst, T const &, T &>;
+			using pointer = std::conditional_t<IsConst, T const *, T *>;
+
+		private:
+			using container_t = std::conditional_t<IsConst, packed_poly_vector const,
+			                                       packed_poly_vector>;
+			container_t *m_container = nullptr;
+			difference_type m_index = 0;
+
+			index_iterator( container_t *container, difference_type index ) noexcept
+			  : m_container( container )
+			  , m_index( index ) {}
+
+		public:
+			index_iterator( ) noexcept = default;
+
+			template<bool B = IsConst, std::enable_if_t<B, std::nullptr_t> = nullptr>
+			index_iterator( index_iterator<false> const &other ) noexcept
+			  : m_container( other.m_container )
+			  , m_index( other.m_index ) {}
+
+			[[nodiscard]] reference operator*( ) const noexcept {
+				return ( *m_container )[static_cast<size_type>( m_index )];
+			}
+
+			[[nodiscard]] pointer operator->( ) const noexcept {
+				return &**this;
+			}
+
+			[[nodiscard]] reference operator[]( difference_type n ) const noexcept {
+				return *( *this + n );
+			}
+
+			index_iterator &operator++( ) noexcept {
+				++m_index;
+				return *this;
+			}
+
+			index_iterator operator++( int ) noexcept {
+				auto result = *this;
+				++m_index;
+				return result;
+			}
+
+			index_iterator &operator--( ) noexcept {
+				--m_index;
+				return *this;
+			}
+
+			index_iterator operator--( int ) noexcept {
+				auto result = *this;
+				--m_index;
+				return result;
+			}
+
+			index_iterator &operator+=( difference_type n ) noexcept {
+				m_index += n;
+				return *this;
+			}
+
+			index_iterator &operator-=( difference_type n ) noexcept {
+				m_index -= n;
+				return *this;
+			}
+
+			[[nodiscard]] friend index_iterator
+			operator+( index_iterator it, difference_type n ) noexcept {
+				return it += n;
+			}
+
+			[[nodiscard]] friend index_iterator
+			operator+( difference_type n, index_iterator it ) noexcept {
+				return it += n;
+			}
+
+			[[nodiscard]] friend index_iterator
+			operator-( index_iterator it, difference_type n ) noexcept {
+				return it -= n;
+			}
+
+			[[nodiscard]] friend difference_type
+			operator-( index_iterator const &lhs,
+			           index_iterator const &rhs ) noexcept {
+				return lhs.m_index - rhs.m_index;
+			}
+
+			[[nodiscard]] friend bool
+			operator==( index_iterator const &lhs,
+			            index_iterator const &rhs ) noexcept {
+				return lhs.m_index == rhs.m_index;
+			}
+
+			[[nodiscard]] friend bool
+			operator!=( index_iterator const &lhs,
+			            index_iterator const &rhs ) noexcept {
+				return lhs.m_index != rhs.m_index;
+			}
+
+			[[nodiscard]] friend bool
+			operator<( index_iterator const &lhs,
+			           index_iterator const &rhs ) noexcept {
+				return lhs.m_index < rhs.m_index;
+			}
+
+			[[nodiscard]] friend bool
+			operator<=( index_iterator const &lhs,
+			            index_iterator const &rhs ) noexcept {
+				return lhs.m_index <= rhs.m_index;
+			}
+
+			[[nodiscard]] friend bool
+			operator>( index_iterator const &lhs,
+			           index_iterator const &rhs ) noexcept {
+				return lhs.m_index > rhs.m_index;
+			}
+
+			[[nodiscard]] friend bool
+			operator>=( index_iterator const &lhs,
+			            index_iterator const &rhs ) noexcept {
+				return lhs.m_index >= rhs.m_index;
+			}
+		};
+	}; // packed_poly_vector
 } // namespace daw
@@ -0,0 +1,256 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "cpp_17.h"
+#include "daw_move.h"
+
+#include <array>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace daw {
+	enum class radix_order : bool { ascending, descending };
+
+	namespace radix_sort_impl {
+		template<std::size_t Size>
+		struct unsigned_of;
+
+		template<>
+		struct unsigned_of<1> {
+			using type = std::uint8_t;
+		};
+
+		template<>
+		struct unsigned_of<2> {
+			using type = std::uint16_t;
+		};
+
+		template<>
+		struct unsigned_of<4> {
+			using type = std::uint32_t;
+		};
+
+		template<>
+		struct unsigned_of<8> {
+			using type = std::uint64_t;
+		};
+
+		template<typename Key>
+		using unsigned_key_t = typename unsigned_of<sizeof( Key )>::type;
+
+		template<typename Key>
+		inline constexpr bool is_radix_key_v =
+		  ( std::is_integral_v<Key> or
+		    ( std::is_floating_point_v<Key> and
+		      std::numeric_limits<Key>::is_iec559 ) ) and
+		  not std::is_same_v<Key, bool> and
+		  ( sizeof( Key ) == 1 or sizeof( Key ) == 2 or sizeof( Key ) == 4 or
+		    sizeof( Key ) == 8 );
+
+		/***
+		 * Map a key to an unsigned integer with the same ordering.  Signed
+		 * integers have the sign bit flipped.  For IEEE floats negative values
+		 * have all bits flipped and positive values only the sign bit, this
+		 * orders -0.0 before 0.0 and NaNs at the ends
+		 */
+		template<typename Key>
+		[[nodiscard]] inline unsigned_key_t<Key> to_unsigned_key( Key key ) {
+			using uint_t = unsigned_key_t<Key>;
+			constexpr auto sign_bit =
+			  static_cast<uint_t>( uint_t{ 1 } << ( sizeof( Key ) * 8U - 1U ) );
+			if constexpr( std::is_floating_point_v<Key> ) {
+				uint_t bits{ };
+				std::memcpy( &bits, &key, sizeof( Key ) );
+				if( bits & sign_bit ) {
+					return static_cast<uint_t>( ~bits );
+				}
+				return static_cast<uint_t>( bits | sign_bit );
+			} else if constexpr( std::is_signed_v<Key> ) {
+				return static_cast<uint_t>( static_cast<uint_t>( key ) ^ sign_bit );
+			} else {
+				return static_cast<uint_t>( key );
+			}
+		}
+
+		// 32 and 64bit keys use 11 bit digits, 3 and 6 passes, as the 2048 entry
+		// histogram still fits in L1 and saves passes over memory.  Smaller keys
+		// are sorted a byte at a time
+		template<typename UInt>
+		inline constexpr std::size_t digit_bits_v =
+		  sizeof( UInt ) >= 4 ? 11 : 8;
+
+		template<typename UInt>
+		inline constexpr std::size_t pass_count_v =
+		  ( sizeof( UInt ) * 8U + digit_bits_v<UInt> - 1U ) / digit_bits_v<UInt>;
+
+		template<typename UInt>
+		inline constexpr std::size_t bucket_count_v = std::size_t{ 1 }
+		                                              << digit_bits_v<UInt>;
+
+		template<typename UInt>
+		[[nodiscard]] inline std::size_t digit( UInt key, std::size_t pass ) {
+			return static_cast<std::size_t>( key >> ( pass * digit_bits_v<UInt> ) ) &
+			       ( bucket_count_v<UInt> - 1U );
+		}
+
+		template<typename Iterator, typename Projection>
+		using key_t = daw::remove_cvref_t<std::invoke_result_t<
+		  Projection, typename std::iterator_traits<Iterator>::reference>>;
+
+		template<typename Key, radix_order Order, typename Projection,
+		         typename T>
+		[[nodiscard]] inline unsigned_key_t<Key> ukey( Projection &proj,
+		                                               T const &value ) {
+			auto const result = to_unsigned_key<Key>(
+			  static_cast<Key>( std::invoke( proj, value ) ) );
+			if constexpr( Order == radix_order::descending ) {
+				return static_cast<unsigned_key_t<Key>>( ~result );
+			} else {
+				return result;
+			}
+		}
+
+		/***
+		 * LSD radix sort of [first, first + size).  All digit histograms are
+		 * built in one pass over the data and passes where every element has the
+		 * same digit are skipped.  buffer must hold size elements
+		 */
+		template<radix_order Order, typename RandomIterator, typename T,
+		         typename Projection>
+		void lsd_sort( RandomIterator first, std::size_t size, T *buffer,
+		               Projection &proj ) {
+			using key_type = key_t<RandomIterator, Projection>;
+			using uint_t = unsigned_key_t<key_type>;
+			constexpr std::size_t passes = pass_count_v<uint_t>;
+			constexpr std::size_t buckets = bucket_count_v<uint_t>;
+
+			auto histograms = std::vector<std::array<std::size_t, buckets>>(
+			  passes, std::array<std::size_t, buckets>{ } );
+			for( std::size_t n = 0; n < size; ++n ) {
+				auto const key = ukey<key_type, Order>( proj, first[n] );
+				for( std::size_t p = 0; p < passes; ++p ) {
+					++histograms[p][digit( key, p )];
+				}
+			}
+
+			bool in_buffer = false;
+			for( std::size_t p = 0; p < passes; ++p ) {
+				auto &counts = histograms[p];
+				bool is_trivial = false;
+				for( std::size_t const c : counts ) {
+					if( c == size ) {
+						is_trivial = true;
+						break;
+					}
+					if( c != 0 ) {
+						break;
+					}
+				}
+				if( is_trivial ) {
+					continue;
+				}
+				std::size_t total = 0;
+				for( auto &c : counts ) {
+					auto const tmp = c;
+					c = total;
+					total += tmp;
+				}
+				auto scatter = [&]( auto src, auto dst ) {
+					for( std::size_t n = 0; n < size; ++n ) {
+						auto const d =
+						  digit( ukey<key_type, Order>( proj, src[n] ), p );
+						dst[counts[d]++] = daw::move( src[n] );
+					}
+				};
+				if( in_buffer ) {
+					scatter( buffer, first );
+				} else {
+					scatter( first, buffer );
+				}
+				in_buffer = not in_buffer;
+			}
+			if( in_buffer ) {
+				for( std::size_t n = 0; n < size; ++n ) {
+					first[n] = daw::move( buffer[n] );
+				}
+			}
+		}
+
+		struct identity_projection {
+			template<typename T>
+			[[nodiscard]] constexpr T const &operator( )( T const &value ) const
+			  noexcept {
+				return value;
+			}
+		};
+	} // namespace radix_sort_impl
+
+	/***
+	 * Can the key produced by Projection from the values of Iterator be radix
+	 * sorted
+	 */
+	template<typename RandomIterator,
+	         typename Projection = radix_sort_impl::identity_projection>
+	inline constexpr bool is_radix_sortable_v = radix_sort_impl::is_radix_key_v<
+	  radix_sort_impl::key_t<RandomIterator, Projection>>;
+
+	/***
+	 * Sort [first, last) by the integral or floating point key returned from
+	 * proj.  The sort is stable and uses a temporary buffer of last - first
+	 * elements.
+	 * @param first start of range to sort
+	 * @param last end of range to sort
+	 * @param proj callable returning the key of an element
+	 */
+	template<radix_order Order = radix_order::ascending, typename RandomIterator,
+	         typename Projection = radix_sort_impl::identity_projection>
+	void radix_sort( RandomIterator first, RandomIterator last,
+	                 Projection proj = Projection{ } ) {
+		static_assert( is_radix_sortable_v<RandomIterator, Projection>,
+		               "Projection must return a 1, 2, 4, or 8 byte integral or "
+		               "IEEE floating point key" );
+		using value_type =
+		  typename std::iterator_traits<RandomIterator>::value_type;
+		auto const size = static_cast<std::size_t>( std::distance( first, last ) );
+		if( size < 2 ) {
+			return;
+		}
+		auto buffer = std::vector<value_type>( size );
+		radix_sort_impl::lsd_sort<Order>( first, size, buffer.data( ), proj );
+	}
+
+	/***
+	 * Copy [first_in, last_in) to first_out and radix sort it there
+	 * @return end of output range
+	 */
+	template<radix_order Order = radix_order::ascending, typename InputIterator,
+	         typename RandomOutputIterator,
+	         typename Projection = radix_sort_impl::identity_projection>
+	RandomOutputIterator radix_sort_to( InputIterator first_in,
+	                                    InputIterator last_in,
+	                                    RandomOutputIterator first_out,
+	                                    Projection proj = Projection{ } ) {
+		auto last_out = first_out;
+		while( first_in != last_in ) {
+			*last_out = *first_in;
+			++first_in;
+			++last_out;
+		}
+		daw::radix_sort<Order>( first_out, last_out, daw::move( proj ) );
+		return last_out;
+	}
+} // namespace daw
@@ -10,6 +10,7 @@
 
 #include "daw_algorithm.h"
 #include "daw_range_common.h"
+#include "daw_range_pipeline.h"
 #include "daw_range_reference.h"
 #include "daw_reference.h"
 #include "daw_traits.h"
@@ -55,6 +56,9 @@ namespace daw {
 			CollectionRange( IteratorF first, IteratorL last )
 			  : m_values( impl::to_vector( first, last ) ) {}
 
+			explicit CollectionRange( values_type &&values )
+			  : m_values( daw::move( values ) ) {}
+
 			CollectionRange( CollectionRange const & ) = default;
 			CollectionRange( CollectionRange && ) = default;
 			~CollectionRange( ) = default;
@@ -322,6 +326,20 @@ namespace daw {
 				return as<values_type>( );
 			}
 
+			/***
+			 * @return a LazyRange over the values.  Its clauses are not applied
+			 * until it is evaluated and filters and transforms are fused into one
+			 * pass, e.g. rng.lazy( ).where( pred ).sort( ).as_vector( )
+			 */
+			[[nodiscard]] auto lazy( ) const & {
+				return lazy_from( begin( ), end( ) );
+			}
+
+			// The values are moved into the LazyRange and reused as its buffer
+			[[nodiscard]] auto lazy( ) && {
+				return lazy_from( daw::move( m_values ) );
+			}
+
 			template<typename Function>
 			CollectionRange &for_each( Function function ) const {
 				for( auto const &v : m_values ) {
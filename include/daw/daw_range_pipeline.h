@@ -0,0 +1,491 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_move.h"
+#include "daw_range_common.h"
+#include "daw_traits.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	namespace range {
+		namespace pipeline_impl {
+			// Stages are chained with each holding the stage before it.  Calling
+			// a stage with a value passes what comes out of the chain to sink
+			struct identity_stage {
+				template<typename T>
+				using result_t = T;
+
+				template<typename T, typename Sink>
+				void operator( )( T &&value, Sink &sink ) {
+					sink( std::forward<T>( value ) );
+				}
+			};
+
+			template<typename Prev, typename UnaryPredicate>
+			struct filter_stage {
+				Prev prev;
+				UnaryPredicate predicate;
+
+				template<typename T>
+				using result_t = typename Prev::template result_t<T>;
+
+				template<typename T, typename Sink>
+				void operator( )( T &&value, Sink &sink ) {
+					auto next = [&]( auto &&v ) {
+						if( predicate( std::as_const( v ) ) ) {
+							sink( std::forward<decltype( v )>( v ) );
+						}
+					};
+					prev( std::forward<T>( value ), next );
+				}
+			};
+
+			template<typename Prev, typename UnaryOperator>
+			struct map_stage {
+				Prev prev;
+				UnaryOperator oper;
+
+				template<typename T>
+				using result_t = daw::traits::root_type_t<std::invoke_result_t<
+				  UnaryOperator &, typename Prev::template result_t<T> const &>>;
+
+				template<typename T, typename Sink>
+				void operator( )( T &&value, Sink &sink ) {
+					auto next = [&]( auto &&v ) {
+						sink( oper( std::forward<decltype( v )>( v ) ) );
+					};
+					prev( std::forward<T>( value ), next );
+				}
+			};
+
+			/***
+			 * Elements of [first, last) in place.  The size hint is only known
+			 * for forward iterators
+			 */
+			template<typename IteratorF, typename IteratorL>
+			struct iterator_source {
+				using value_type = impl::cleanup_t<
+				  typename std::iterator_traits<IteratorF>::value_type>;
+				static constexpr bool is_buffer_source = false;
+
+				IteratorF first;
+				IteratorL last;
+
+				[[nodiscard]] std::size_t size_hint( ) const {
+					if constexpr( std::is_same_v<IteratorF, IteratorL> and
+					              std::is_base_of_v<std::forward_iterator_tag,
+					                                typename std::iterator_traits<
+					                                  IteratorF>::iterator_category> ) {
+						return static_cast<std::size_t>( std::distance( first, last ) );
+					} else {
+						return 0;
+					}
+				}
+
+				template<typename Function>
+				void for_each( Function &&func ) {
+					for( auto it = first; it != last; ++it ) {
+						func( *it );
+					}
+				}
+			};
+
+			// Elements owned by the pipeline.  The buffer is handed on rather than
+			// copied
+			template<typename T>
+			struct owned_source {
+				using value_type = T;
+				static constexpr bool is_buffer_source = true;
+
+				std::vector<T> values;
+
+				[[nodiscard]] std::size_t size_hint( ) const {
+					return values.size( );
+				}
+
+				void materialize_into( std::vector<T> &buffer ) {
+					buffer = daw::move( values );
+				}
+
+				template<typename Function>
+				void for_each( Function &&func ) {
+					for( auto &v : values ) {
+						func( daw::move( v ) );
+					}
+				}
+			};
+
+			/***
+			 * A stage that needs all the elements, such as sort.  The pipeline
+			 * before it is evaluated into a buffer that operation is applied to in
+			 * place.  Consecutive barriers share the buffer
+			 */
+			template<typename Inner, typename Operation>
+			struct barrier_source {
+				using value_type = typename Inner::value_type;
+				static constexpr bool is_buffer_source = true;
+
+				Inner inner;
+				Operation operation;
+
+				[[nodiscard]] std::size_t size_hint( ) const {
+					return inner.size_hint( );
+				}
+
+				void materialize_into( std::vector<value_type> &buffer ) {
+					inner.materialize_into( buffer );
+					operation( buffer );
+				}
+
+				template<typename Function>
+				void for_each( Function &&func ) {
+					auto buffer = std::vector<value_type>( );
+					materialize_into( buffer );
+					for( auto &v : buffer ) {
+						func( daw::move( v ) );
+					}
+				}
+			};
+
+			template<typename Compare>
+			struct sort_op {
+				Compare compare;
+
+				template<typename T>
+				void operator( )( std::vector<T> &buffer ) {
+					std::sort( buffer.begin( ), buffer.end( ), compare );
+				}
+			};
+
+			template<typename Compare>
+			struct stable_sort_op {
+				Compare compare;
+
+				template<typename T>
+				void operator( )( std::vector<T> &buffer ) {
+					std::stable_sort( buffer.begin( ), buffer.end( ), compare );
+				}
+			};
+
+			template<typename BinaryPredicate>
+			struct unique_op {
+				BinaryPredicate predicate;
+
+				template<typename T>
+				void operator( )( std::vector<T> &buffer ) {
+					buffer.erase(
+					  std::unique( buffer.begin( ), buffer.end( ), predicate ),
+					  buffer.end( ) );
+				}
+			};
+
+			template<typename UnaryPredicate>
+			struct partition_op {
+				UnaryPredicate predicate;
+
+				template<typename T>
+				void operator( )( std::vector<T> &buffer ) {
+					std::partition( buffer.begin( ), buffer.end( ), predicate );
+				}
+			};
+
+			template<typename UnaryPredicate>
+			struct stable_partition_op {
+				UnaryPredicate predicate;
+
+				template<typename T>
+				void operator( )( std::vector<T> &buffer ) {
+					std::stable_partition( buffer.begin( ), buffer.end( ), predicate );
+				}
+			};
+
+			template<typename UniformRandomNumberGenerator>
+			struct shuffle_op {
+				UniformRandomNumberGenerator *urng;
+
+				template<typename T>
+				void operator( )( std::vector<T> &buffer ) {
+					std::shuffle( buffer.begin( ), buffer.end( ), *urng );
+				}
+			};
+		} // namespace pipeline_impl
+
+		/***
+		 * A lazily evaluated chain of range operations.  Filter and transform
+		 * clauses are fused into a single pass over the source.  Barrier clauses
+		 * such as sort and unique evaluate what comes before them into one
+		 * buffer, that later barriers reuse.  Nothing runs until a terminal
+		 * operation such as as_vector, as, for_each or accumulate.
+		 *
+		 * Each clause consumes the LazyRange it is called on, so they are
+		 * chained on temporaries or called on std::move'd values.  A LazyRange
+		 * made from iterators refers to the elements and must not outlive them
+		 */
+		template<typename Source, typename Stages = pipeline_impl::identity_stage>
+		class LazyRange {
+			template<typename, typename>
+			friend class LazyRange;
+
+			template<typename, typename>
+			friend struct pipeline_impl::barrier_source;
+
+			Source m_source;
+			Stages m_stages;
+			std::size_t m_reserve;
+
+		public:
+			using value_type = typename Stages::template result_t<
+			  typename Source::value_type>;
+
+			explicit LazyRange( Source source, Stages stages = Stages{ },
+			                    std::size_t reserve_hint = 0 )
+			  : m_source( daw::move( source ) )
+			  , m_stages( daw::move( stages ) )
+			  , m_reserve( reserve_hint ) {}
+
+			/***
+			 * @return the capacity reserved for buffers.  This is the size of the
+			 * source unless a hint was given with reserve
+			 */
+			[[nodiscard]] std::size_t size_hint( ) const {
+				return m_reserve != 0 ? m_reserve : m_source.size_hint( );
+			}
+
+			/***
+			 * Reserve count elements for the buffers that barriers and as_vector
+			 * evaluate into, instead of the size of the source
+			 */
+			LazyRange reserve( std::size_t count ) && {
+				m_reserve = count;
+				return daw::move( *this );
+			}
+
+			template<typename UnaryPredicate>
+			auto where( UnaryPredicate predicate ) && {
+				using stage_t = pipeline_impl::filter_stage<Stages, UnaryPredicate>;
+				return LazyRange<Source, stage_t>(
+				  daw::move( m_source ),
+				  stage_t{ daw::move( m_stages ), daw::move( predicate ) },
+				  m_reserve );
+			}
+
+			template<typename Value>
+			auto where_equal_to( Value const &value ) && {
+				return daw::move( *this ).where(
+				  [value]( auto const &current_value ) {
+					  return value == current_value;
+				  } );
+			}
+
+			template<typename UnaryPredicate>
+			auto erase( UnaryPredicate predicate ) && {
+				return daw::move( *this ).where(
+				  [predicate = daw::move( predicate )]( auto const &v ) {
+					  return not predicate( v );
+				  } );
+			}
+
+			template<typename Value>
+			auto erase_where_equal_to( Value const &value ) && {
+				return daw::move( *this ).where(
+				  [value]( auto const &current_value ) {
+					  return not( value == current_value );
+				  } );
+			}
+
+			template<typename UnaryOperator>
+			auto transform( UnaryOperator oper ) && {
+				using stage_t = pipeline_impl::map_stage<Stages, UnaryOperator>;
+				return LazyRange<Source, stage_t>(
+				  daw::move( m_source ),
+				  stage_t{ daw::move( m_stages ), daw::move( oper ) }, m_reserve );
+			}
+
+			template<typename Compare = std::less<>>
+			auto sort( Compare compare = Compare{ } ) && {
+				return daw::move( *this ).barrier(
+				  pipeline_impl::sort_op<Compare>{ daw::move( compare ) } );
+			}
+
+			template<typename Compare = std::less<>>
+			auto stable_sort( Compare compare = Compare{ } ) && {
+				return daw::move( *this ).barrier(
+				  pipeline_impl::stable_sort_op<Compare>{ daw::move( compare ) } );
+			}
+
+			template<typename BinaryPredicate = std::equal_to<>>
+			auto unique( BinaryPredicate predicate = BinaryPredicate{ } ) && {
+				return daw::move( *this ).barrier(
+				  pipeline_impl::unique_op<BinaryPredicate>{ daw::move( predicate ) } );
+			}
+
+			template<typename UnaryPredicate>
+			auto partition( UnaryPredicate predicate ) && {
+				return daw::move( *this ).barrier(
+				  pipeline_impl::partition_op<UnaryPredicate>{
+				    daw::move( predicate ) } );
+			}
+
+			template<typename UnaryPredicate>
+			auto stable_partition( UnaryPredicate predicate ) && {
+				return daw::move( *this ).barrier(
+				  pipeline_impl::stable_partition_op<UnaryPredicate>{
+				    daw::move( predicate ) } );
+			}
+
+			// urng must outlive the evaluation of the LazyRange
+			template<typename UniformRandomNumberGenerator>
+			auto shuffle( UniformRandomNumberGenerator &urng ) && {
+				return daw::move( *this ).barrier(
+				  pipeline_impl::shuffle_op<UniformRandomNumberGenerator>{ &urng } );
+			}
+
+			auto shuffle( ) && {
+				static std::random_device rd;
+				static std::mt19937 g( rd( ) );
+				return daw::move( *this ).shuffle( g );
+			}
+
+			/***
+			 * Evaluate into buffer.  When the source already holds its elements in
+			 * a buffer of value_type, that buffer is taken over and the stages are
+			 * applied in place
+			 */
+			void materialize_into( std::vector<value_type> &buffer ) {
+				if constexpr( Source::is_buffer_source and
+				              std::is_same_v<typename Source::value_type,
+				                             value_type> ) {
+					m_source.materialize_into( buffer );
+					if constexpr( not std::is_same_v<Stages,
+					                                 pipeline_impl::identity_stage> ) {
+						std::size_t out = 0;
+						auto sink = [&]( auto &&v ) {
+							if( std::addressof( v ) != std::addressof( buffer[out] ) ) {
+								buffer[out] = std::forward<decltype( v )>( v );
+							}
+							++out;
+						};
+						auto const size = buffer.size( );
+						for( std::size_t n = 0; n < size; ++n ) {
+							m_stages( daw::move( buffer[n] ), sink );
+						}
+						buffer.erase(
+						  std::next( buffer.begin( ), static_cast<std::ptrdiff_t>( out ) ),
+						  buffer.end( ) );
+					}
+				} else {
+					buffer.clear( );
+					buffer.reserve( size_hint( ) );
+					auto sink = [&]( auto &&v ) {
+						buffer.push_back( std::forward<decltype( v )>( v ) );
+					};
+					m_source.for_each( [&]( auto &&v ) {
+						m_stages( std::forward<decltype( v )>( v ), sink );
+					} );
+				}
+			}
+
+			/***
+			 * Call func with each element that comes out of the pipeline
+			 */
+			template<typename Function>
+			void for_each( Function func ) && {
+				m_source.for_each( [&]( auto &&v ) {
+					m_stages( std::forward<decltype( v )>( v ), func );
+				} );
+			}
+
+			[[nodiscard]] std::vector<value_type> as_vector( ) && {
+				auto result = std::vector<value_type>( );
+				materialize_into( result );
+				return result;
+			}
+
+			/***
+			 * Evaluate into a Container.  One that can be constructed from a
+			 * std::vector<value_type> is given the evaluated buffer, otherwise
+			 * elements are inserted at the end
+			 */
+			template<typename Container>
+			[[nodiscard]] Container as( ) && {
+				if constexpr( std::is_constructible_v<Container,
+				                                      std::vector<value_type> &&> ) {
+					return Container( daw::move( *this ).as_vector( ) );
+				} else {
+					auto result = Container( );
+					daw::move( *this ).for_each( [&]( auto &&v ) {
+						result.insert( result.end( ), std::forward<decltype( v )>( v ) );
+					} );
+					return result;
+				}
+			}
+
+			template<typename T, typename BinaryOperator = std::plus<>>
+			[[nodiscard]] T accumulate( T init,
+			                            BinaryOperator oper = BinaryOperator{ } ) && {
+				daw::move( *this ).for_each( [&]( auto &&v ) {
+					init = oper( daw::move( init ), std::forward<decltype( v )>( v ) );
+				} );
+				return init;
+			}
+
+			// The number of elements that come out of the pipeline
+			[[nodiscard]] std::size_t count( ) && {
+				std::size_t result = 0;
+				daw::move( *this ).for_each( [&]( auto && ) { ++result; } );
+				return result;
+			}
+
+		private:
+			template<typename Operation>
+			auto barrier( Operation operation ) && {
+				using source_t = pipeline_impl::barrier_source<LazyRange, Operation>;
+				return LazyRange<source_t>(
+				  source_t{ daw::move( *this ), daw::move( operation ) } );
+			}
+		};
+
+		/***
+		 * @return a LazyRange over the elements of [first, last)
+		 */
+		template<typename IteratorF, typename IteratorL>
+		[[nodiscard]] auto lazy_from( IteratorF first, IteratorL last ) {
+			using source_t = pipeline_impl::iterator_source<IteratorF, IteratorL>;
+			return LazyRange<source_t>( source_t{ first, last } );
+		}
+
+		/***
+		 * @return a LazyRange over the elements of container.  An rvalue
+		 * std::vector is moved into the LazyRange, anything else is referred to
+		 */
+		template<typename Container>
+		[[nodiscard]] auto lazy_from( Container &&container ) {
+			using container_t = daw::remove_cvref_t<Container>;
+			using value_t = typename container_t::value_type;
+			if constexpr( not std::is_lvalue_reference_v<Container> and
+			              std::is_same_v<container_t, std::vector<value_t>> ) {
+				using source_t = pipeline_impl::owned_source<value_t>;
+				return LazyRange<source_t>(
+				  source_t{ std::forward<Container>( container ) } );
+			} else {
+				return lazy_from( std::begin( container ), std::end( container ) );
+			}
+		}
+	} // namespace range
+} // namespace daw
@@ -8,21 +8,196 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <ciso646>
+#include <cstddef>
 #include <fstream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if not defined( _MSC_VER )
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
 
 namespace daw {
+	namespace read_file_impl {
+		// Largest single read request.  Some kernels cap a read at just under 2GB
+		inline constexpr std::size_t max_read_size = std::size_t{ 1 } << 30U;
+
+#if not defined( _MSC_VER )
+		class file_handle {
+			int m_fd = -1;
+
+		public:
+			explicit file_handle( char const *path ) noexcept
+			  : m_fd( ::open( path, O_RDONLY | O_CLOEXEC ) ) {}
+
+			file_handle( file_handle const & ) = delete;
+			file_handle &operator=( file_handle const & ) = delete;
+
+			~file_handle( ) {
+				if( m_fd >= 0 ) {
+					::close( m_fd );
+				}
+			}
+
+			explicit operator bool( ) const noexcept {
+				return m_fd >= 0;
+			}
+
+			[[nodiscard]] int get( ) const noexcept {
+				return m_fd;
+			}
+
+			// Returns the size of a regular file, or nullopt for things like pipes
+			// where the size is not known up front
+			[[nodiscard]] std::optional<std::size_t> size( ) const noexcept {
+				struct stat st { };
+				if( ::fstat( m_fd, &st ) != 0 or not S_ISREG( st.st_mode ) ) {
+					return std::nullopt;
+				}
+				return static_cast<std::size_t>( st.st_size );
+			}
+
+			/***
+			 * Read up to count bytes at offset into dest
+			 * @return bytes read or nullopt on error
+			 */
+			[[nodiscard]] std::optional<std::size_t>
+			read_at( char *dest, std::size_t count, std::size_t offset ) const {
+				std::size_t total = 0;
+				while( total < count ) {
+					auto const want = std::min( count - total, max_read_size );
+					auto const n = ::pread( m_fd, dest + total, want,
+					                        static_cast<off_t>( offset + total ) );
+					if( n < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						return std::nullopt;
+					}
+					if( n == 0 ) {
+						break;
+					}
+					total += static_cast<std::size_t>( n );
+				}
+				return total;
+			}
+
+			// Read until end of file starting at result.size( ), used when the size
+			// is unknown or may have changed
+			[[nodiscard]] bool read_rest( std::string &result ) const {
+				std::size_t pos = result.size( );
+				bool const can_seek = ::lseek( m_fd, static_cast<off_t>( pos ),
+				                               SEEK_SET ) >= 0;
+				if( not can_seek and pos != 0 ) {
+					return false;
+				}
+				while( true ) {
+					if( pos == result.size( ) ) {
+						result.resize(
+						  std::max( result.size( ) * 2, std::size_t{ 4096 } ) );
+					}
+					auto const n =
+					  ::read( m_fd, result.data( ) + pos, result.size( ) - pos );
+					if( n < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						return false;
+					}
+					if( n == 0 ) {
+						result.resize( pos );
+						return true;
+					}
+					pos += static_cast<std::size_t>( n );
+				}
+			}
+		};
+
+		[[nodiscard]] inline std::optional<std::string>
+		read_file_posix( char const *path ) {
+			auto const file = file_handle( path );
+			if( not file ) {
+				return std::nullopt;
+			}
+			auto result = std::string( );
+			if( auto const sz = file.size( ); sz ) {
+				result.resize( *sz );
+				auto const count = file.read_at( result.data( ), *sz, 0 );
+				if( not count ) {
+					return std::nullopt;
+				}
+				// The file may have shrunk or grown since the fstat
+				result.resize( *count );
+				if( *count < *sz ) {
+					return result;
+				}
+				// Probe past the end rather than growing the string, only a file
+				// that grew since the fstat needs read_rest
+				char probe[256];
+				auto const extra = file.read_at( probe, sizeof( probe ), *count );
+				if( not extra ) {
+					return std::nullopt;
+				}
+				if( *extra == 0 ) {
+					return result;
+				}
+				result.append( probe, *extra );
+			}
+			if( not file.read_rest( result ) ) {
+				return std::nullopt;
+			}
+			return result;
+		}
+#endif
+
+		template<typename Char>
+		[[nodiscard]] std::optional<std::basic_string<Char>>
+		read_stream( std::basic_ifstream<Char> &in_file ) {
+			auto result = std::basic_string<Char>( );
+			in_file.seekg( 0, std::ios::end );
+			if( auto const sz = in_file.tellg( ); sz > 0 ) {
+				result.reserve( static_cast<std::size_t>( sz ) );
+			}
+			in_file.seekg( 0, std::ios::beg );
+			result.assign( std::istreambuf_iterator<Char>( in_file ),
+			               std::istreambuf_iterator<Char>( ) );
+			return result;
+		}
+	} // namespace read_file_impl
+
+	/***
+	 * Read the entire file into a string.  On POSIX systems the file size is
+	 * taken from fstat and the data read with a single allocation and large
+	 * pread calls
+	 * @return the file data or nullopt if it could not be read
+	 */
 	template<typename CharT>
 	std::optional<std::basic_string<char>> read_file( CharT const *str ) {
-		auto in_file = std::basic_ifstream<char>( str );
-		if( not in_file ) {
-			return { };
+#if not defined( _MSC_VER )
+		if constexpr( std::is_same_v<CharT, char> ) {
+			return read_file_impl::read_file_posix( str );
+		} else {
+#endif
+			auto in_file = std::basic_ifstream<char>( str, std::ios::binary );
+			if( not in_file ) {
+				return { };
+			}
+			return read_file_impl::read_stream( in_file );
+#if not defined( _MSC_VER )
 		}
-
-		return std::basic_string<char>( std::istreambuf_iterator<char>( in_file ),
-		                                { } );
+#endif
 	}
 
 	template<typename CharT>
@@ -37,9 +212,7 @@ namespace daw {
 		if( not in_file ) {
 			return { };
 		}
-
-		return std::basic_string<wchar_t>(
-		  std::istreambuf_iterator<wchar_t>( in_file ), { } );
+		return read_file_impl::read_stream( in_file );
 	}
 
 	template<typename CharT>
@@ -47,4 +220,134 @@ namespace daw {
 	read_wfile( std::basic_string<CharT> str ) {
 		return read_wfile( str.c_str( ) );
 	}
+
+	/***
+	 * The result of read_files.  All file contents live in one arena owned by
+	 * this object, the views returned are valid for its lifetime
+	 */
+	class file_batch {
+		std::unique_ptr<char[]> m_arena = nullptr;
+		std::vector<std::size_t> m_offsets{ };
+		std::vector<std::size_t> m_sizes{ };
+		std::vector<char> m_valid{ };
+
+		friend file_batch read_files( std::vector<std::string> const &,
+		                              std::size_t );
+
+	public:
+		file_batch( ) = default;
+
+		[[nodiscard]] std::size_t size( ) const noexcept {
+			return m_sizes.size( );
+		}
+
+		/***
+		 * @return contents of the file at index pos in the requested paths or
+		 * nullopt if it could not be read
+		 */
+		[[nodiscard]] std::optional<std::string_view>
+		operator[]( std::size_t pos ) const {
+			if( not m_valid[pos] ) {
+				return std::nullopt;
+			}
+			return std::string_view( m_arena.get( ) + m_offsets[pos], m_sizes[pos] );
+		}
+	};
+
+	/***
+	 * Load many files concurrently into a single arena.  Sizes are gathered
+	 * first so that one allocation is made for all the file data, then the
+	 * reads are spread over a set of worker threads.  Only regular files are
+	 * loaded, others are reported as nullopt.  A file that grows after being
+	 * sized is truncated to that size.
+	 * @param paths files to read
+	 * @param thread_count number of workers, 0 means hardware concurrency
+	 */
+	inline file_batch read_files( std::vector<std::string> const &paths,
+	                              std::size_t thread_count = 0 ) {
+		file_batch result{ };
+		auto const count = paths.size( );
+		result.m_offsets.resize( count, 0 );
+		result.m_sizes.resize( count, 0 );
+		result.m_valid.resize( count, 0 );
+		if( count == 0 ) {
+			return result;
+		}
+		if( thread_count == 0 ) {
+			thread_count = std::max( std::thread::hardware_concurrency( ), 1U );
+		}
+		thread_count = std::min( thread_count, count );
+
+		auto run_workers = [&]( auto const &job ) {
+			auto next = std::atomic<std::size_t>( 0 );
+			auto worker = [&]( ) {
+				for( std::size_t n = next++; n < count; n = next++ ) {
+					job( n );
+				}
+			};
+			auto threads = std::vector<std::thread>( );
+			threads.reserve( thread_count - 1 );
+			for( std::size_t t = 1; t < thread_count; ++t ) {
+				threads.emplace_back( worker );
+			}
+			worker( );
+			for( auto &th : threads ) {
+				th.join( );
+			}
+		};
+
+#if not defined( _MSC_VER )
+		run_workers( [&]( std::size_t n ) {
+			struct stat st { };
+			if( ::stat( paths[n].c_str( ), &st ) == 0 and S_ISREG( st.st_mode ) ) {
+				result.m_sizes[n] = static_cast<std::size_t>( st.st_size );
+				result.m_valid[n] = 1;
+			}
+		} );
+#else
+		for( std::size_t n = 0; n < count; ++n ) {
+			auto in_file =
+			  std::ifstream( paths[n], std::ios::binary | std::ios::ate );
+			if( in_file ) {
+				result.m_sizes[n] = static_cast<std::size_t>( in_file.tellg( ) );
+				result.m_valid[n] = 1;
+			}
+		}
+#endif
+		std::size_t total = 0;
+		for( std::size_t n = 0; n < count; ++n ) {
+			result.m_offsets[n] = total;
+			total += result.m_sizes[n];
+		}
+		result.m_arena = std::unique_ptr<char[]>(
+		  new char[std::max( total, std::size_t{ 1 } )] );
+
+		run_workers( [&]( std::size_t n ) {
+			if( not result.m_valid[n] ) {
+				return;
+			}
+			result.m_valid[n] = 0;
+			char *const dest = result.m_arena.get( ) + result.m_offsets[n];
+#if not defined( _MSC_VER )
+			auto const file = read_file_impl::file_handle( paths[n].c_str( ) );
+			if( not file ) {
+				return;
+			}
+			auto const sz = file.read_at( dest, result.m_sizes[n], 0 );
+			if( not sz ) {
+				return;
+			}
+			result.m_sizes[n] = *sz;
+#else
+			auto in_file = std::ifstream( paths[n], std::ios::binary );
+			if( not in_file ) {
+				return;
+			}
+			in_file.read( dest, static_cast<std::streamsize>( result.m_sizes[n] ) );
+			result.m_sizes[n] = static_cast<std::size_t>( in_file.gcount( ) );
+#endif
+			result.m_valid[n] = 1;
+		} );
+		return result;
+	}
 } // namespace daw
@@ -0,0 +1,424 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "cpp_17.h"
+#include "daw_traits.h"
+#include "impl/daw_simd_dispatch.h"
+
+#include <array>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace daw {
+	/***
+	 * Bitonic sorting networks run as vector min/max over AVX2 registers for
+	 * 8 to 64 elements of 32 and 64 bit integers and IEEE floats.  Input is
+	 * padded with the largest value to a power of two number of registers.
+	 * Floats are ordered by their bits, so the result is always a permutation
+	 * of the input.  With NaN values in the input the order is unspecified, as
+	 * with the scalar sorts.
+	 */
+	namespace simd_sort_impl {
+		inline constexpr std::size_t min_simd_sort_size = 8;
+		inline constexpr std::size_t max_simd_sort_size = 64;
+
+		template<typename T>
+		inline constexpr bool is_simd_key_v =
+		  daw::traits::is_one_of_v<T, std::int32_t, std::uint32_t, float,
+		                           std::int64_t, std::uint64_t, double>;
+
+		template<typename Compare, typename T>
+		inline constexpr bool is_less_v =
+		  daw::traits::is_one_of_v<daw::remove_cvref_t<Compare>, std::less<>,
+		                           std::less<T>>;
+
+		template<typename Compare, typename T>
+		inline constexpr bool is_greater_v =
+		  daw::traits::is_one_of_v<daw::remove_cvref_t<Compare>, std::greater<>,
+		                           std::greater<T>>;
+
+		template<typename RandomIterator, typename Compare>
+		inline constexpr bool is_simd_sortable_v = [] {
+			using value_type =
+			  typename std::iterator_traits<RandomIterator>::value_type;
+			return is_simd_key_v<value_type> and
+			       simd_impl::is_contiguous_iterator_v<RandomIterator> and
+			       ( is_less_v<Compare, value_type> or
+			         is_greater_v<Compare, value_type> );
+		}( );
+
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		/***
+		 * Permutation and blend masks, as 32bit lanes, for a compare exchange of
+		 * lane l with lane l ^ X of the same register.  The higher lane of each
+		 * pair takes the max
+		 */
+		template<std::size_t Width>
+		struct lane_tables {
+			static constexpr std::size_t lane32 = 8U / Width;
+
+			struct table_t {
+				alignas( 32 ) std::int32_t idx[8][8];
+				alignas( 32 ) std::int32_t mask[8][8];
+			};
+
+			static constexpr table_t make( ) {
+				table_t result{ };
+				for( std::size_t x = 0; x < 8; ++x ) {
+					for( std::size_t l = 0; l < Width; ++l ) {
+						auto const partner = ( l ^ x ) % Width;
+						for( std::size_t h = 0; h < lane32; ++h ) {
+							result.idx[x][l * lane32 + h] =
+							  static_cast<std::int32_t>( partner * lane32 + h );
+							result.mask[x][l * lane32 + h] = l > partner ? -1 : 0;
+						}
+					}
+				}
+				return result;
+			}
+
+			static constexpr table_t table = make( );
+		};
+
+		struct ops_i32 {
+			using value_type = std::int32_t;
+			using reg_t = __m256i;
+			static constexpr std::size_t width = 8;
+
+			DAW_TARGET_AVX2 static reg_t load( value_type const *p ) {
+				return _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) );
+			}
+			DAW_TARGET_AVX2 static void store( value_type *p, reg_t v ) {
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), v );
+			}
+			DAW_TARGET_AVX2 static reg_t min( reg_t a, reg_t b ) {
+				return _mm256_min_epi32( a, b );
+			}
+			DAW_TARGET_AVX2 static reg_t max( reg_t a, reg_t b ) {
+				return _mm256_max_epi32( a, b );
+			}
+			DAW_TARGET_AVX2 static reg_t permute( reg_t v, __m256i idx ) {
+				return _mm256_permutevar8x32_epi32( v, idx );
+			}
+			DAW_TARGET_AVX2 static reg_t blend( reg_t a, reg_t b,
+			                                    __m256i mask ) {
+				return _mm256_blendv_epi8( a, b, mask );
+			}
+		};
+
+		struct ops_u32 : ops_i32 {
+			using value_type = std::uint32_t;
+
+			DAW_TARGET_AVX2 static reg_t load( value_type const *p ) {
+				return _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) );
+			}
+			DAW_TARGET_AVX2 static void store( value_type *p, reg_t v ) {
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), v );
+			}
+			DAW_TARGET_AVX2 static reg_t min( reg_t a, reg_t b ) {
+				return _mm256_min_epu32( a, b );
+			}
+			DAW_TARGET_AVX2 static reg_t max( reg_t a, reg_t b ) {
+				return _mm256_max_epu32( a, b );
+			}
+		};
+
+		/***
+		 * Floats are sorted as signed integer keys, negative values have every
+		 * bit but the sign flipped.  The float min/max instructions return
+		 * their second operand for -0.0 against 0.0 and for NaN, which would
+		 * duplicate or drop values.  The mapping is its own inverse
+		 */
+		struct ops_f32 : ops_i32 {
+			using value_type = float;
+
+			DAW_TARGET_AVX2 static reg_t to_key( reg_t v ) {
+				return _mm256_xor_si256(
+				  v, _mm256_and_si256( _mm256_srai_epi32( v, 31 ),
+				                       _mm256_set1_epi32( 0x7FFF'FFFF ) ) );
+			}
+			DAW_TARGET_AVX2 static reg_t load( value_type const *p ) {
+				return to_key(
+				  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) ) );
+			}
+			DAW_TARGET_AVX2 static void store( value_type *p, reg_t v ) {
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), to_key( v ) );
+			}
+		};
+
+		// AVX2 has no 64bit min/max, they are built from a signed compare
+		struct ops_i64 {
+			using value_type = std::int64_t;
+			using reg_t = __m256i;
+			static constexpr std::size_t width = 4;
+
+			DAW_TARGET_AVX2 static reg_t load( value_type const *p ) {
+				return _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) );
+			}
+			DAW_TARGET_AVX2 static void store( value_type *p, reg_t v ) {
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), v );
+			}
+			DAW_TARGET_AVX2 static reg_t min( reg_t a, reg_t b ) {
+				return _mm256_blendv_epi8( a, b, _mm256_cmpgt_epi64( a, b ) );
+			}
+			DAW_TARGET_AVX2 static reg_t max( reg_t a, reg_t b ) {
+				return _mm256_blendv_epi8( b, a, _mm256_cmpgt_epi64( a, b ) );
+			}
+			DAW_TARGET_AVX2 static reg_t permute( reg_t v, __m256i idx ) {
+				return _mm256_permutevar8x32_epi32( v, idx );
+			}
+			DAW_TARGET_AVX2 static reg_t blend( reg_t a, reg_t b,
+			                                    __m256i mask ) {
+				return _mm256_blendv_epi8( a, b, mask );
+			}
+		};
+
+		// Unsigned keys have the sign bit flipped while in registers so that the
+		// signed compare orders them
+		struct ops_u64 : ops_i64 {
+			using value_type = std::uint64_t;
+
+			DAW_TARGET_AVX2 static reg_t sign_bit( ) {
+				return _mm256_set1_epi64x(
+				  static_cast<long long>( std::uint64_t{ 1 } << 63U ) );
+			}
+			DAW_TARGET_AVX2 static reg_t load( value_type const *p ) {
+				return _mm256_xor_si256(
+				  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) ),
+				  sign_bit( ) );
+			}
+			DAW_TARGET_AVX2 static void store( value_type *p, reg_t v ) {
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( p ),
+				                     _mm256_xor_si256( v, sign_bit( ) ) );
+			}
+		};
+
+		// Doubles are sorted as signed integer keys, as with ops_f32
+		struct ops_f64 : ops_i64 {
+			using value_type = double;
+
+			DAW_TARGET_AVX2 static reg_t to_key( reg_t v ) {
+				auto const negative =
+				  _mm256_cmpgt_epi64( _mm256_setzero_si256( ), v );
+				return _mm256_xor_si256(
+				  v, _mm256_and_si256( negative, _mm256_set1_epi64x(
+				                                   0x7FFF'FFFF'FFFF'FFFFLL ) ) );
+			}
+			DAW_TARGET_AVX2 static reg_t load( value_type const *p ) {
+				return to_key(
+				  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) ) );
+			}
+			DAW_TARGET_AVX2 static void store( value_type *p, reg_t v ) {
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( p ), to_key( v ) );
+			}
+		};
+
+		template<typename T>
+		struct ops_for;
+		template<>
+		struct ops_for<std::int32_t> {
+			using type = ops_i32;
+		};
+		template<>
+		struct ops_for<std::uint32_t> {
+			using type = ops_u32;
+		};
+		template<>
+		struct ops_for<float> {
+			using type = ops_f32;
+		};
+		template<>
+		struct ops_for<std::int64_t> {
+			using type = ops_i64;
+		};
+		template<>
+		struct ops_for<std::uint64_t> {
+			using type = ops_u64;
+		};
+		template<>
+		struct ops_for<double> {
+			using type = ops_f64;
+		};
+
+		template<typename Ops>
+		DAW_TARGET_AVX2 inline typename Ops::reg_t
+		in_register_step( typename Ops::reg_t v, std::size_t x ) {
+			auto const &table = lane_tables<Ops::width>::table;
+			auto const idx = _mm256_load_si256(
+			  reinterpret_cast<__m256i const *>( table.idx[x] ) );
+			auto const mask = _mm256_load_si256(
+			  reinterpret_cast<__m256i const *>( table.mask[x] ) );
+			auto const partner = Ops::permute( v, idx );
+			return Ops::blend( Ops::min( v, partner ), Ops::max( v, partner ),
+			                   mask );
+		}
+
+		/***
+		 * Bitonic sort of Regs registers in ascending order.  Each merge starts
+		 * by comparing element i with i ^ ( k - 1 ) so that no step needs a
+		 * descending direction
+		 */
+		template<typename Ops, std::size_t Regs>
+		DAW_TARGET_AVX2 inline void bitonic_sort( typename Ops::reg_t *r ) {
+			constexpr std::size_t width = Ops::width;
+			constexpr std::size_t total = Regs * width;
+			auto const &table = lane_tables<width>::table;
+			auto const reverse = _mm256_load_si256(
+			  reinterpret_cast<__m256i const *>( table.idx[width - 1U] ) );
+
+			for( std::size_t k = 2; k <= total; k *= 2U ) {
+				if( k <= width ) {
+					for( std::size_t b = 0; b < Regs; ++b ) {
+						r[b] = in_register_step<Ops>( r[b], k - 1U );
+					}
+				} else {
+					std::size_t const group = k / width;
+					for( std::size_t g = 0; g < Regs; g += group ) {
+						for( std::size_t i = 0; i < group / 2U; ++i ) {
+							auto const lo = g + i;
+							auto const hi = g + group - 1U - i;
+							auto const rev = Ops::permute( r[hi], reverse );
+							auto const mx = Ops::max( r[lo], rev );
+							r[lo] = Ops::min( r[lo], rev );
+							r[hi] = Ops::permute( mx, reverse );
+						}
+					}
+				}
+				for( std::size_t j = k / 4U; j >= 1; j /= 2U ) {
+					if( j >= width ) {
+						std::size_t const jr = j / width;
+						for( std::size_t b = 0; b < Regs; ++b ) {
+							if( ( b & jr ) == 0 ) {
+								auto const mx = Ops::max( r[b], r[b + jr] );
+								r[b] = Ops::min( r[b], r[b + jr] );
+								r[b + jr] = mx;
+							}
+						}
+					} else {
+						for( std::size_t b = 0; b < Regs; ++b ) {
+							r[b] = in_register_step<Ops>( r[b], j );
+						}
+					}
+				}
+			}
+		}
+
+		template<typename Ops, std::size_t Regs>
+		DAW_TARGET_AVX2 inline void
+		sort_padded( typename Ops::value_type *buffer ) {
+			typename Ops::reg_t r[Regs];
+			for( std::size_t b = 0; b < Regs; ++b ) {
+				r[b] = Ops::load( buffer + b * Ops::width );
+			}
+			bitonic_sort<Ops, Regs>( r );
+			for( std::size_t b = 0; b < Regs; ++b ) {
+				Ops::store( buffer + b * Ops::width, r[b] );
+			}
+		}
+
+		/***
+		 * The value with the largest key.  For floats that is the positive NaN
+		 * with every other bit set, it sorts after infinity and any other NaN
+		 */
+		template<typename T>
+		[[nodiscard]] inline T padding_value( ) {
+			if constexpr( std::is_floating_point_v<T> ) {
+				using int_t = std::conditional_t<sizeof( T ) == 4, std::int32_t,
+				                                 std::int64_t>;
+				auto const bits = std::numeric_limits<int_t>::max( );
+				T result;
+				std::memcpy( &result, &bits, sizeof( T ) );
+				return result;
+			} else {
+				return std::numeric_limits<T>::max( );
+			}
+		}
+
+		template<typename T>
+		DAW_TARGET_AVX2 void sort_avx2( T *first, std::size_t size,
+		                                bool descending ) {
+			using ops_t = typename ops_for<T>::type;
+			constexpr std::size_t width = ops_t::width;
+			alignas( 32 ) T buffer[max_simd_sort_size];
+			auto regs = ( size + width - 1U ) / width;
+			std::size_t pow2 = 1;
+			while( pow2 < regs ) {
+				pow2 *= 2U;
+			}
+			regs = pow2;
+			std::memcpy( buffer, first, size * sizeof( T ) );
+			for( std::size_t n = size; n < regs * width; ++n ) {
+				buffer[n] = padding_value<T>( );
+			}
+			switch( regs ) {
+			case 1:
+				sort_padded<ops_t, 1>( buffer );
+				break;
+			case 2:
+				sort_padded<ops_t, 2>( buffer );
+				break;
+			case 4:
+				sort_padded<ops_t, 4>( buffer );
+				break;
+			case 8:
+				sort_padded<ops_t, 8>( buffer );
+				break;
+			default:
+				if constexpr( max_simd_sort_size / width >= 16 ) {
+					sort_padded<ops_t, max_simd_sort_size / width>( buffer );
+				}
+				break;
+			}
+			if( descending ) {
+				for( std::size_t n = 0; n < size; ++n ) {
+					first[n] = buffer[size - 1U - n];
+				}
+			} else {
+				std::memcpy( first, buffer, size * sizeof( T ) );
+			}
+		}
+#endif
+
+		/***
+		 * Sort [first, last) with a vector sorting network when the elements,
+		 * comparison and CPU support it
+		 * @return true if the range was sorted
+		 */
+		template<typename RandomIterator, typename Compare>
+		[[nodiscard]] inline bool try_sort( RandomIterator first,
+		                                    RandomIterator last, Compare const & ) {
+			static_assert( is_simd_sortable_v<RandomIterator, Compare> );
+			using value_type =
+			  typename std::iterator_traits<RandomIterator>::value_type;
+			auto const size = static_cast<std::size_t>( last - first );
+#if defined( DAW_HAS_SIMD_DISPATCH )
+			if( size < min_simd_sort_size or size > max_simd_sort_size or
+			    not simd_impl::has_avx2( ) ) {
+				return false;
+			}
+			sort_avx2<value_type>( std::addressof( *first ), size,
+			                       is_greater_v<Compare, value_type> );
+			return true;
+#else
+			(void)size;
+			(void)first;
+			return false;
+#endif
+		}
+	} // namespace simd_sort_impl
+} // namespace daw
@@ -0,0 +1,599 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_enable_if.h"
+#include "daw_exception.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace daw {
+	/***
+	 * A T can be moved to new storage by copying its bytes and forgetting the
+	 * original, without running its move constructor or destructor.  This is
+	 * true of trivially copyable types and can be specialized for types such as
+	 * std::unique_ptr that do not refer to their own address
+	 */
+	template<typename T>
+	struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+	template<typename T>
+	inline constexpr bool is_trivially_relocatable_v =
+	  is_trivially_relocatable<T>::value;
+
+	/***
+	 * A vector that holds up to N elements inside the object and moves them
+	 * to memory from Allocator when it grows past that.  Unlike
+	 * bounded_vector_t it has no size limit and T may be any move or copy
+	 * constructible type.  Elements are relocated with memcpy when
+	 * is_trivially_relocatable_v<T>
+	 */
+	template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+	struct small_vector {
+		using value_type = T;
+		using allocator_type = Allocator;
+		using reference = value_type &;
+		using const_reference = value_type const &;
+		using iterator = value_type *;
+		using const_iterator = value_type const *;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using pointer = value_type *;
+		using const_pointer = value_type const *;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		// The number of elements that fit without allocating
+		static constexpr size_type inline_capacity = N;
+
+	private:
+		using alloc_traits = std::allocator_traits<allocator_type>;
+		static_assert( std::is_same_v<typename alloc_traits::value_type, T>,
+		               "Allocator must allocate T" );
+
+		// Move assignment can take rhs's memory without comparing allocators
+		static constexpr bool steals_on_move =
+		  alloc_traits::propagate_on_container_move_assignment::value or
+		  alloc_traits::is_always_equal::value;
+
+		static constexpr bool nothrow_relocate =
+		  is_trivially_relocatable_v<T> or
+		  std::is_nothrow_move_constructible_v<T>;
+
+		pointer m_data = inline_data( );
+		size_type m_size = 0;
+		size_type m_capacity = N;
+		allocator_type m_alloc{ };
+		alignas( T ) unsigned char m_inline[N > 0 ? N * sizeof( T ) : 1];
+
+		[[nodiscard]] pointer inline_data( ) noexcept {
+			return reinterpret_cast<pointer>( m_inline );
+		}
+
+		[[nodiscard]] const_pointer inline_data( ) const noexcept {
+			return reinterpret_cast<const_pointer>( m_inline );
+		}
+
+		void destroy_values( pointer values, size_type count ) noexcept {
+			if constexpr( not std::is_trivially_destructible_v<T> ) {
+				while( count-- > 0 ) {
+					alloc_traits::destroy( m_alloc, values + count );
+				}
+			}
+		}
+
+		/***
+		 * Move count values from src to the uninitialized dst, ending their
+		 * lifetimes in src.  If a copy throws src is left as it was
+		 */
+		void relocate_values( pointer src, size_type count, pointer dst ) {
+			if constexpr( is_trivially_relocatable_v<T> ) {
+				if( count > 0 ) {
+					std::memcpy( static_cast<void *>( dst ),
+					             static_cast<void const *>( src ), count * sizeof( T ) );
+				}
+			} else {
+				size_type done = 0;
+				try {
+					for( ; done < count; ++done ) {
+						alloc_traits::construct( m_alloc, dst + done,
+						                         std::move_if_noexcept( src[done] ) );
+					}
+				} catch( ... ) {
+					destroy_values( dst, done );
+					throw;
+				}
+				destroy_values( src, count );
+			}
+		}
+
+		void release_heap( ) noexcept {
+			if( m_data != inline_data( ) ) {
+				alloc_traits::deallocate( m_alloc, m_data, m_capacity );
+				m_data = inline_data( );
+				m_capacity = N;
+			}
+		}
+
+		[[nodiscard]] size_type next_capacity( size_type needed ) const {
+			daw::exception::precondition_check<std::length_error>(
+			  needed <= max_size( ), "Attempt to grow small_vector past max_size" );
+			return std::max( needed, std::min( max_size( ), m_capacity * 2U ) );
+		}
+
+		// Move the elements to a buffer of new_capacity, which fits them
+		void reallocate( size_type new_capacity ) {
+			pointer const buffer =
+			  new_capacity > N ? alloc_traits::allocate( m_alloc, new_capacity )
+			                   : inline_data( );
+			if( buffer == m_data ) {
+				return;
+			}
+			try {
+				relocate_values( m_data, m_size, buffer );
+			} catch( ... ) {
+				if( buffer != inline_data( ) ) {
+					alloc_traits::deallocate( m_alloc, buffer, new_capacity );
+				}
+				throw;
+			}
+			release_heap( );
+			m_data = buffer;
+			m_capacity = new_capacity > N ? new_capacity : N;
+		}
+
+		/***
+		 * Append when full.  The new element is constructed before the old ones
+		 * move so that args may refer to an element
+		 */
+		template<typename... Args>
+		reference emplace_back_grow( Args &&...args ) {
+			size_type const new_capacity = next_capacity( m_size + 1U );
+			pointer const buffer = alloc_traits::allocate( m_alloc, new_capacity );
+			try {
+				alloc_traits::construct( m_alloc, buffer + m_size,
+				                         std::forward<Args>( args )... );
+			} catch( ... ) {
+				alloc_traits::deallocate( m_alloc, buffer, new_capacity );
+				throw;
+			}
+			try {
+				relocate_values( m_data, m_size, buffer );
+			} catch( ... ) {
+				alloc_traits::destroy( m_alloc, buffer + m_size );
+				alloc_traits::deallocate( m_alloc, buffer, new_capacity );
+				throw;
+			}
+			release_heap( );
+			m_data = buffer;
+			m_capacity = new_capacity;
+			return m_data[m_size++];
+		}
+
+		// Take rhs's elements, leaving it empty.  Its buffer is reused when it
+		// is on the heap and the allocators allow it
+		void take_from( small_vector &rhs ) {
+			if( rhs.m_data != rhs.inline_data( ) and
+			    ( steals_on_move or m_alloc == rhs.m_alloc ) ) {
+				m_data = std::exchange( rhs.m_data, rhs.inline_data( ) );
+				m_size = std::exchange( rhs.m_size, 0U );
+				m_capacity = std::exchange( rhs.m_capacity, N );
+				return;
+			}
+			reserve( rhs.m_size );
+			relocate_values( rhs.m_data, rhs.m_size, m_data );
+			m_size = std::exchange( rhs.m_size, 0U );
+		}
+
+		template<typename Iterator>
+		void append( Iterator first, Iterator last ) {
+			using category =
+			  typename std::iterator_traits<Iterator>::iterator_category;
+			if constexpr( std::is_base_of_v<std::forward_iterator_tag, category> ) {
+				reserve( m_size +
+				         static_cast<size_type>( std::distance( first, last ) ) );
+			}
+			for( ; first != last; ++first ) {
+				emplace_back( *first );
+			}
+		}
+
+	public:
+		small_vector( ) noexcept(
+		  std::is_nothrow_default_constructible_v<allocator_type> ) {}
+
+		explicit small_vector( allocator_type const &alloc ) noexcept
+		  : m_alloc( alloc ) {}
+
+		explicit small_vector( size_type count,
+		                       allocator_type const &alloc = allocator_type( ) )
+		  : m_alloc( alloc ) {
+			resize( count );
+		}
+
+		small_vector( size_type count, const_reference value,
+		              allocator_type const &alloc = allocator_type( ) )
+		  : m_alloc( alloc ) {
+			assign( count, value );
+		}
+
+		small_vector( const_pointer ptr, size_type count,
+		              allocator_type const &alloc = allocator_type( ) )
+		  : m_alloc( alloc ) {
+			append( ptr, ptr + count );
+		}
+
+		template<typename Iterator,
+		         daw::enable_when_t<not std::is_integral_v<Iterator>> = nullptr>
+		small_vector( Iterator first, Iterator last,
+		              allocator_type const &alloc = allocator_type( ) )
+		  : m_alloc( alloc ) {
+			append( first, last );
+		}
+
+		small_vector( std::initializer_list<value_type> values,
+		              allocator_type const &alloc = allocator_type( ) )
+		  : m_alloc( alloc ) {
+			append( values.begin( ), values.end( ) );
+		}
+
+		small_vector( small_vector const &other )
+		  : m_alloc( alloc_traits::select_on_container_copy_construction(
+		      other.m_alloc ) ) {
+			append( other.begin( ), other.end( ) );
+		}
+
+		small_vector( small_vector const &other, allocator_type const &alloc )
+		  : m_alloc( alloc ) {
+			append( other.begin( ), other.end( ) );
+		}
+
+		small_vector( small_vector &&other ) noexcept( nothrow_relocate )
+		  : m_alloc( std::move( other.m_alloc ) ) {
+			take_from( other );
+		}
+
+		small_vector( small_vector &&other, allocator_type const &alloc )
+		  : m_alloc( alloc ) {
+			take_from( other );
+		}
+
+		small_vector &operator=( small_vector const &rhs ) {
+			if( this != &rhs ) {
+				clear( );
+				if constexpr( alloc_traits::propagate_on_container_copy_assignment::
+				                value ) {
+					if( m_alloc != rhs.m_alloc ) {
+						release_heap( );
+					}
+					m_alloc = rhs.m_alloc;
+				}
+				append( rhs.begin( ), rhs.end( ) );
+			}
+			return *this;
+		}
+
+		small_vector &operator=( small_vector &&rhs ) noexcept(
+		  steals_on_move and nothrow_relocate ) {
+			if( this != &rhs ) {
+				clear( );
+				if constexpr( alloc_traits::propagate_on_container_move_assignment::
+				                value ) {
+					release_heap( );
+					m_alloc = std::move( rhs.m_alloc );
+				} else if( rhs.m_data != rhs.inline_data( ) and
+				           ( steals_on_move or m_alloc == rhs.m_alloc ) ) {
+					release_heap( );
+				}
+				take_from( rhs );
+			}
+			return *this;
+		}
+
+		small_vector &operator=( std::initializer_list<value_type> values ) {
+			clear( );
+			append( values.begin( ), values.end( ) );
+			return *this;
+		}
+
+		~small_vector( ) {
+			clear( );
+			release_heap( );
+		}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return m_alloc;
+		}
+
+		[[nodiscard]] bool empty( ) const noexcept {
+			return m_size == 0;
+		}
+
+		[[nodiscard]] bool full( ) const noexcept {
+			return m_size == m_capacity;
+		}
+
+		[[nodiscard]] size_type size( ) const noexcept {
+			return m_size;
+		}
+
+		[[nodiscard]] size_type capacity( ) const noexcept {
+			return m_capacity;
+		}
+
+		[[nodiscard]] size_type max_size( ) const noexcept {
+			constexpr auto max_difference =
+			  static_cast<size_type>( std::numeric_limits<difference_type>::max( ) );
+			return std::min(
+			  static_cast<size_type>( alloc_traits::max_size( m_alloc ) ),
+			  max_difference );
+		}
+
+		// Whether count more elements fit without allocating
+		[[nodiscard]] bool has_room( size_type count ) const noexcept {
+			return count <= available( );
+		}
+
+		[[nodiscard]] size_type available( ) const noexcept {
+			return m_capacity - m_size;
+		}
+
+		// Whether the elements are inside the object rather than on the heap
+		[[nodiscard]] bool is_inline( ) const noexcept {
+			return m_data == inline_data( );
+		}
+
+		void reserve( size_type count ) {
+			if( count > m_capacity ) {
+				reallocate( next_capacity( count ) );
+			}
+		}
+
+		// Release unused heap memory, moving back inside when the elements fit
+		void shrink_to_fit( ) {
+			if( not is_inline( ) and m_size < m_capacity ) {
+				reallocate( m_size );
+			}
+		}
+
+		void clear( ) noexcept {
+			destroy_values( m_data, m_size );
+			m_size = 0;
+		}
+
+		[[nodiscard]] reference front( ) noexcept {
+			return m_data[0];
+		}
+
+		[[nodiscard]] const_reference front( ) const noexcept {
+			return m_data[0];
+		}
+
+		[[nodiscard]] reference back( ) noexcept {
+			return m_data[m_size - 1U];
+		}
+
+		[[nodiscard]] const_reference back( ) const noexcept {
+			return m_data[m_size - 1U];
+		}
+
+		[[nodiscard]] reference operator[]( size_type pos ) noexcept {
+			return m_data[pos];
+		}
+
+		[[nodiscard]] const_reference operator[]( size_type pos ) const noexcept {
+			return m_data[pos];
+		}
+
+		[[nodiscard]] reference at( size_type pos ) {
+			daw::exception::precondition_check<std::out_of_range>(
+			  pos < m_size, "Attempt to access past end of small_vector" );
+			return m_data[pos];
+		}
+
+		[[nodiscard]] const_reference at( size_type pos ) const {
+			daw::exception::precondition_check<std::out_of_range>(
+			  pos < m_size, "Attempt to access past end of small_vector" );
+			return m_data[pos];
+		}
+
+		[[nodiscard]] pointer data( ) noexcept {
+			return m_data;
+		}
+
+		[[nodiscard]] const_pointer data( ) const noexcept {
+			return m_data;
+		}
+
+		[[nodiscard]] iterator begin( ) noexcept {
+			return m_data;
+		}
+
+		[[nodiscard]] const_iterator begin( ) const noexcept {
+			return m_data;
+		}
+
+		[[nodiscard]] const_iterator cbegin( ) const noexcept {
+			return m_data;
+		}
+
+		[[nodiscard]] reverse_iterator rbegin( ) noexcept {
+			return reverse_iterator( end( ) );
+		}
+
+		[[nodiscard]] const_reverse_iterator rbegin( ) const noexcept {
+			return const_reverse_iterator( end( ) );
+		}
+
+		[[nodiscard]] const_reverse_iterator crbegin( ) const noexcept {
+			return const_reverse_iterator( cend( ) );
+		}
+
+		[[nodiscard]] iterator end( ) noexcept {
+			return m_data + m_size;
+		}
+
+		[[nodiscard]] const_iterator end( ) const noexcept {
+			return m_data + m_size;
+		}
+
+		[[nodiscard]] const_iterator cend( ) const noexcept {
+			return m_data + m_size;
+		}
+
+		[[nodiscard]] reverse_iterator rend( ) noexcept {
+			return reverse_iterator( begin( ) );
+		}
+
+		[[nodiscard]] const_reverse_iterator rend( ) const noexcept {
+			return const_reverse_iterator( begin( ) );
+		}
+
+		[[nodiscard]] const_reverse_iterator crend( ) const noexcept {
+			return const_reverse_iterator( cbegin( ) );
+		}
+
+		template<typename... Args>
+		reference emplace_back( Args &&...args ) {
+			if( m_size == m_capacity ) {
+				return emplace_back_grow( std::forward<Args>( args )... );
+			}
+			alloc_traits::construct( m_alloc, m_data + m_size,
+			                         std::forward<Args>( args )... );
+			return m_data[m_size++];
+		}
+
+		void push_back( const_reference value ) {
+			emplace_back( value );
+		}
+
+		void push_back( value_type &&value ) {
+			emplace_back( std::move( value ) );
+		}
+
+		void push_back( const_pointer ptr, size_type count ) {
+			append( ptr, ptr + count );
+		}
+
+		template<typename Ptr>
+		void push_back( Ptr const *ptr, size_type count ) {
+			reserve( m_size + count );
+			for( size_type n = 0; n < count; ++n ) {
+				emplace_back( static_cast<value_type>( ptr[n] ) );
+			}
+		}
+
+		void assign( size_type count, const_reference value ) {
+			// value may be an element, copy it before the old ones go
+			value_type const tmp = value;
+			clear( );
+			reserve( count );
+			for( ; m_size < count; ++m_size ) {
+				alloc_traits::construct( m_alloc, m_data + m_size, tmp );
+			}
+		}
+
+		template<typename Iterator,
+		         daw::enable_when_t<not std::is_integral_v<Iterator>> = nullptr>
+		void assign( Iterator first, Iterator last ) {
+			clear( );
+			append( first, last );
+		}
+
+		value_type pop_back( ) {
+			value_type result = std::move( back( ) );
+			alloc_traits::destroy( m_alloc, m_data + --m_size );
+			return result;
+		}
+
+		void resize( size_type count ) {
+			if( count <= m_size ) {
+				destroy_values( m_data + count, m_size - count );
+				m_size = count;
+				return;
+			}
+			reserve( count );
+			for( ; m_size < count; ++m_size ) {
+				alloc_traits::construct( m_alloc, m_data + m_size );
+			}
+		}
+
+		void resize( size_type count, const_reference value ) {
+			if( count <= m_size ) {
+				destroy_values( m_data + count, m_size - count );
+				m_size = count;
+				return;
+			}
+			if( count > m_capacity ) {
+				value_type const tmp = value;
+				reserve( count );
+				for( ; m_size < count; ++m_size ) {
+					alloc_traits::construct( m_alloc, m_data + m_size, tmp );
+				}
+				return;
+			}
+			for( ; m_size < count; ++m_size ) {
+				alloc_traits::construct( m_alloc, m_data + m_size, value );
+			}
+		}
+
+		/***
+		 * Remove [first, last), moving the following elements down
+		 * @return an iterator to the element that followed the last removed one
+		 */
+		iterator erase( const_iterator first, const_iterator last ) {
+			auto const pos = static_cast<size_type>( first - cbegin( ) );
+			auto const count = static_cast<size_type>( last - first );
+			if( count > 0 ) {
+				iterator const out = std::move( begin( ) + pos + count, end( ),
+				                                begin( ) + pos );
+				destroy_values( out, count );
+				m_size -= count;
+			}
+			return begin( ) + pos;
+		}
+
+		iterator erase( const_iterator pos ) {
+			return erase( pos, pos + 1 );
+		}
+
+		void swap( small_vector &rhs ) {
+			small_vector tmp( std::move( rhs ) );
+			rhs = std::move( *this );
+			*this = std::move( tmp );
+		}
+
+		[[nodiscard]] friend bool operator==( small_vector const &lhs,
+		                                      small_vector const &rhs ) {
+			return std::equal( lhs.begin( ), lhs.end( ), rhs.begin( ), rhs.end( ) );
+		}
+
+		[[nodiscard]] friend bool operator!=( small_vector const &lhs,
+		                                      small_vector const &rhs ) {
+			return not( lhs == rhs );
+		}
+	};
+
+	template<typename T, std::size_t N, typename Allocator>
+	void swap( small_vector<T, N, Allocator> &lhs,
+	           small_vector<T, N, Allocator> &rhs ) {
+		lhs.swap( rhs );
+	}
+} // namespace daw
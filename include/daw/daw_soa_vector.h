@@ -0,0 +1,567 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_exception.h"
+#include "daw_span.h"
+#include "daw_zipcontainer.h"
+#include "iterator/daw_zipiter.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace daw {
+	namespace soa_vector_details {
+		// Columns start on a cache line so each can be loaded with aligned SIMD
+		inline constexpr std::size_t column_alignment = 64;
+
+		template<typename T>
+		inline constexpr std::size_t column_align_v =
+		  std::max( column_alignment, alignof( T ) );
+
+		constexpr std::size_t align_up( std::size_t value,
+		                                std::size_t alignment ) noexcept {
+			return ( value + alignment - 1U ) & ~( alignment - 1U );
+		}
+
+		// Moves when that cannot throw or T cannot be copied, as vector does
+		template<typename T>
+		void uninitialized_move_if_noexcept_n( T *src, std::size_t count,
+		                                       T *dst ) {
+			if constexpr( std::is_nothrow_move_constructible_v<T> or
+			              not std::is_copy_constructible_v<T> ) {
+				std::uninitialized_copy_n( std::make_move_iterator( src ), count,
+				                           dst );
+			} else {
+				std::uninitialized_copy_n( src, count, dst );
+			}
+		}
+
+		/***
+		 * When a column is relocated.  Copies go first and moves that cannot
+		 * throw last, so a throw leaves every source column whole unless a
+		 * column can neither be copied nor moved without throwing
+		 */
+		template<typename T>
+		inline constexpr int relocate_pass_v =
+		  std::is_nothrow_move_constructible_v<T> ? 2
+		  : std::is_copy_constructible_v<T>       ? 0
+		                                          : 1;
+	} // namespace soa_vector_details
+
+	/***
+	 * A vector of records stored as a struct of arrays.  Each field has its own
+	 * contiguous array, all in one allocation and each aligned to a cache line.
+	 * Loops over a few fields only touch those arrays.  Rows are accessed as a
+	 * tuple of references, the same as dereferencing a zip_iterator
+	 */
+	template<typename Allocator, typename... Fields>
+	class basic_soa_vector {
+		static_assert( sizeof...( Fields ) > 0, "At least one field is required" );
+
+	public:
+		using allocator_type = Allocator;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using value_type = std::tuple<Fields...>;
+		using reference = std::tuple<Fields &...>;
+		using const_reference = std::tuple<Fields const &...>;
+		using iterator = daw::zip_iterator<Fields *...>;
+		using const_iterator = daw::zip_iterator<Fields const *...>;
+
+		template<std::size_t I>
+		using field_t = std::tuple_element_t<I, value_type>;
+
+		static constexpr std::size_t column_count = sizeof...( Fields );
+
+	private:
+		using byte_allocator = typename std::allocator_traits<
+		  Allocator>::template rebind_alloc<std::byte>;
+		using byte_traits = std::allocator_traits<byte_allocator>;
+		using indices = std::index_sequence_for<Fields...>;
+
+		static constexpr std::size_t max_align =
+		  std::max( { soa_vector_details::column_align_v<Fields>... } );
+
+		// Allocation bytes are only aligned to max_align after rounding
+		struct block {
+			std::byte *raw = nullptr;
+			std::size_t raw_size = 0;
+			std::tuple<Fields *...> columns{ };
+		};
+
+		byte_allocator m_alloc{ };
+		block m_block{ };
+		size_type m_size = 0;
+		size_type m_capacity = 0;
+
+		template<std::size_t... Is>
+		[[nodiscard]] block allocate( size_type capacity,
+		                              std::index_sequence<Is...> ) {
+			if( capacity == 0 ) {
+				return { };
+			}
+			daw::exception::precondition_check<std::length_error>(
+			  capacity <= max_size( ), "soa_vector capacity is too large" );
+			constexpr std::size_t sizes[] = { sizeof( Fields )... };
+			constexpr std::size_t aligns[] = {
+			  soa_vector_details::column_align_v<Fields>... };
+			std::size_t offsets[column_count]{ };
+			std::size_t bytes = 0;
+			for( std::size_t n = 0; n < column_count; ++n ) {
+				bytes = soa_vector_details::align_up( bytes, aligns[n] );
+				offsets[n] = bytes;
+				bytes += capacity * sizes[n];
+			}
+			auto result = block{ };
+			result.raw_size = bytes + max_align - 1U;
+			result.raw = byte_traits::allocate( m_alloc, result.raw_size );
+			auto const address = reinterpret_cast<std::uintptr_t>( result.raw );
+			std::byte *const base =
+			  result.raw +
+			  ( soa_vector_details::align_up( address, max_align ) - address );
+			result.columns = std::tuple<Fields *...>(
+			  reinterpret_cast<Fields *>( base + offsets[Is] )... );
+			return result;
+		}
+
+		void deallocate( block &b ) noexcept {
+			if( b.raw != nullptr ) {
+				byte_traits::deallocate( m_alloc, b.raw, b.raw_size );
+				b = block{ };
+			}
+		}
+
+		template<std::size_t... Is>
+		void destroy_rows( size_type first, size_type last,
+		                   std::index_sequence<Is...> ) noexcept {
+			( std::destroy( column_data<Is>( ) + first, column_data<Is>( ) + last ),
+			  ... );
+		}
+
+		/***
+		 * Move count rows from one block to another.  Every column is built
+		 * before any source is destroyed and the columns that are copied are
+		 * built before any is moved, so a throw leaves from whole
+		 */
+		template<std::size_t... Is>
+		static void relocate_rows( block const &from, size_type count,
+		                           block const &to, std::index_sequence<Is...> ) {
+			bool built[column_count]{ };
+			auto const relocate_pass = [&]( int pass ) {
+				( ( soa_vector_details::relocate_pass_v<Fields> == pass
+				      ? (void)( soa_vector_details::uninitialized_move_if_noexcept_n(
+				                  std::get<Is>( from.columns ), count,
+				                  std::get<Is>( to.columns ) ),
+				                built[Is] = true )
+				      : void( ) ),
+				  ... );
+			};
+			try {
+				relocate_pass( 0 );
+				relocate_pass( 1 );
+				relocate_pass( 2 );
+			} catch( ... ) {
+				( ( built[Is]
+				      ? (void)std::destroy_n( std::get<Is>( to.columns ), count )
+				      : void( ) ),
+				  ... );
+				throw;
+			}
+			( std::destroy_n( std::get<Is>( from.columns ), count ), ... );
+		}
+
+		void reallocate( size_type capacity ) {
+			block next = allocate( capacity, indices{ } );
+			try {
+				relocate_rows( m_block, m_size, next, indices{ } );
+			} catch( ... ) {
+				deallocate( next );
+				throw;
+			}
+			deallocate( m_block );
+			m_block = next;
+			m_capacity = capacity;
+		}
+
+		// Construct row in b from one argument per column
+		template<std::size_t... Is, typename... Args>
+		static void construct_row( block const &b, size_type row,
+		                           std::index_sequence<Is...>, Args &&...args ) {
+			std::size_t done = 0;
+			try {
+				( ( ::new( static_cast<void *>( std::get<Is>( b.columns ) + row ) )
+				      Fields( std::forward<Args>( args ) ),
+				    ++done ),
+				  ... );
+			} catch( ... ) {
+				( ( Is < done ? std::destroy_at( std::get<Is>( b.columns ) + row )
+				              : void( ) ),
+				  ... );
+				throw;
+			}
+		}
+
+		template<std::size_t... Is>
+		static void destroy_row( block const &b, size_type row,
+		                         std::index_sequence<Is...> ) noexcept {
+			( std::destroy_at( std::get<Is>( b.columns ) + row ), ... );
+		}
+
+		/***
+		 * Append when full.  The new row is built in the new block before the
+		 * old rows move, so args may refer to an existing row
+		 */
+		template<typename... Args>
+		void emplace_back_grow( Args &&...args ) {
+			size_type const capacity = std::max( m_size + 1U, m_capacity * 2U );
+			block next = allocate( capacity, indices{ } );
+			try {
+				construct_row( next, m_size, indices{ },
+				               std::forward<Args>( args )... );
+			} catch( ... ) {
+				deallocate( next );
+				throw;
+			}
+			try {
+				relocate_rows( m_block, m_size, next, indices{ } );
+			} catch( ... ) {
+				destroy_row( next, m_size, indices{ } );
+				deallocate( next );
+				throw;
+			}
+			deallocate( m_block );
+			m_block = next;
+			m_capacity = capacity;
+		}
+
+		template<std::size_t... Is>
+		void copy_rows( basic_soa_vector const &other,
+		                std::index_sequence<Is...> ) {
+			std::size_t done = 0;
+			try {
+				( ( std::uninitialized_copy_n( other.column_data<Is>( ), other.m_size,
+				                               column_data<Is>( ) ),
+				    ++done ),
+				  ... );
+			} catch( ... ) {
+				( ( Is < done ? (void)std::destroy_n( column_data<Is>( ), other.m_size )
+				              : void( ) ),
+				  ... );
+				throw;
+			}
+			m_size = other.m_size;
+		}
+
+		template<std::size_t... Is>
+		[[nodiscard]] reference row( size_type index,
+		                             std::index_sequence<Is...> ) noexcept {
+			return reference( column_data<Is>( )[index]... );
+		}
+
+		template<std::size_t... Is>
+		[[nodiscard]] const_reference
+		row( size_type index, std::index_sequence<Is...> ) const noexcept {
+			return const_reference( column_data<Is>( )[index]... );
+		}
+
+		template<std::size_t... Is>
+		[[nodiscard]] iterator
+		make_iterator( size_type index, std::index_sequence<Is...> ) noexcept {
+			return iterator( column_data<Is>( ) + index... );
+		}
+
+		template<std::size_t... Is>
+		[[nodiscard]] const_iterator
+		make_iterator( size_type index,
+		               std::index_sequence<Is...> ) const noexcept {
+			return const_iterator( column_data<Is>( ) + index... );
+		}
+
+	public:
+		basic_soa_vector( ) = default;
+
+		explicit basic_soa_vector( allocator_type const &alloc )
+		  : m_alloc( alloc ) {}
+
+		basic_soa_vector( basic_soa_vector const &other )
+		  : basic_soa_vector( other,
+		                      allocator_type(
+		                        byte_traits::select_on_container_copy_construction(
+		                          other.m_alloc ) ) ) {}
+
+		basic_soa_vector( basic_soa_vector const &other,
+		                  allocator_type const &alloc )
+		  : m_alloc( alloc ) {
+			if( other.m_size > 0 ) {
+				m_block = allocate( other.m_size, indices{ } );
+				m_capacity = other.m_size;
+				try {
+					copy_rows( other, indices{ } );
+				} catch( ... ) {
+					deallocate( m_block );
+					throw;
+				}
+			}
+		}
+
+		basic_soa_vector( basic_soa_vector &&other ) noexcept
+		  : m_alloc( std::move( other.m_alloc ) )
+		  , m_block( std::exchange( other.m_block, block{ } ) )
+		  , m_size( std::exchange( other.m_size, 0 ) )
+		  , m_capacity( std::exchange( other.m_capacity, 0 ) ) {}
+
+		basic_soa_vector &operator=( basic_soa_vector const &rhs ) {
+			if( this != &rhs ) {
+				auto alloc = get_allocator( );
+				if constexpr( byte_traits::propagate_on_container_copy_assignment::
+				                value ) {
+					alloc = rhs.get_allocator( );
+				}
+				auto tmp = basic_soa_vector( rhs, alloc );
+				swap( tmp );
+			}
+			return *this;
+		}
+
+		basic_soa_vector &operator=( basic_soa_vector &&rhs ) noexcept(
+		  byte_traits::propagate_on_container_move_assignment::value or
+		  byte_traits::is_always_equal::value ) {
+			if( this == &rhs ) {
+				return *this;
+			}
+			if( byte_traits::propagate_on_container_move_assignment::value or
+			    m_alloc == rhs.m_alloc ) {
+				auto tmp = basic_soa_vector( std::move( rhs ) );
+				swap( tmp );
+			} else {
+				clear( );
+				reserve( rhs.m_size );
+				relocate_rows( rhs.m_block, rhs.m_size, m_block, indices{ } );
+				m_size = std::exchange( rhs.m_size, 0 );
+			}
+			return *this;
+		}
+
+		~basic_soa_vector( ) {
+			clear( );
+			deallocate( m_block );
+		}
+
+		void swap( basic_soa_vector &other ) noexcept {
+			using std::swap;
+			swap( m_alloc, other.m_alloc );
+			swap( m_block, other.m_block );
+			swap( m_size, other.m_size );
+			swap( m_capacity, other.m_capacity );
+		}
+
+		friend void swap( basic_soa_vector &lhs, basic_soa_vector &rhs ) noexcept {
+			lhs.swap( rhs );
+		}
+
+		[[nodiscard]] allocator_type get_allocator( ) const {
+			return allocator_type( m_alloc );
+		}
+
+		[[nodiscard]] size_type size( ) const noexcept {
+			return m_size;
+		}
+
+		[[nodiscard]] size_type capacity( ) const noexcept {
+			return m_capacity;
+		}
+
+		[[nodiscard]] bool empty( ) const noexcept {
+			return m_size == 0;
+		}
+
+		[[nodiscard]] static constexpr size_type max_size( ) noexcept {
+			constexpr std::size_t row_bytes = ( sizeof( Fields ) + ... );
+			constexpr std::size_t padding = ( column_count + 1U ) * max_align;
+			return ( static_cast<size_type>( -1 ) - padding ) / row_bytes;
+		}
+
+		// Make room for count rows in every column
+		void reserve( size_type count ) {
+			if( count > m_capacity ) {
+				reallocate( count );
+			}
+		}
+
+		void shrink_to_fit( ) {
+			if( m_size < m_capacity ) {
+				reallocate( m_size );
+			}
+		}
+
+		void clear( ) noexcept {
+			destroy_rows( 0, m_size, indices{ } );
+			m_size = 0;
+		}
+
+		/***
+		 * Add a row, constructing each column from the matching argument
+		 */
+		template<typename... Args>
+		reference emplace_back( Args &&...args ) {
+			static_assert( sizeof...( Args ) == column_count,
+			               "One argument is needed for each column" );
+			if( m_size == m_capacity ) {
+				emplace_back_grow( std::forward<Args>( args )... );
+			} else {
+				construct_row( m_block, m_size, indices{ },
+				               std::forward<Args>( args )... );
+			}
+			++m_size;
+			return back( );
+		}
+
+		void push_back( Fields const &...fields ) {
+			(void)emplace_back( fields... );
+		}
+
+		void push_back( Fields &&...fields ) {
+			(void)emplace_back( std::move( fields )... );
+		}
+
+		void push_back( value_type const &value ) {
+			(void)std::apply(
+			  [&]( auto const &...fields ) { return emplace_back( fields... ); },
+			  value );
+		}
+
+		void pop_back( ) noexcept {
+			destroy_rows( m_size - 1U, m_size, indices{ } );
+			--m_size;
+		}
+
+		// Value initialize any new rows
+		void resize( size_type count ) {
+			if( count < m_size ) {
+				destroy_rows( count, m_size, indices{ } );
+				m_size = count;
+				return;
+			}
+			reserve( count );
+			while( m_size < count ) {
+				(void)emplace_back( Fields{ }... );
+			}
+		}
+
+		[[nodiscard]] reference operator[]( size_type index ) noexcept {
+			return row( index, indices{ } );
+		}
+
+		[[nodiscard]] const_reference
+		operator[]( size_type index ) const noexcept {
+			return row( index, indices{ } );
+		}
+
+		[[nodiscard]] reference at( size_type index ) {
+			daw::exception::precondition_check<std::out_of_range>(
+			  index < m_size, "Attempt to access past end of soa_vector" );
+			return row( index, indices{ } );
+		}
+
+		[[nodiscard]] const_reference at( size_type index ) const {
+			daw::exception::precondition_check<std::out_of_range>(
+			  index < m_size, "Attempt to access past end of soa_vector" );
+			return row( index, indices{ } );
+		}
+
+		[[nodiscard]] reference front( ) noexcept {
+			return row( 0, indices{ } );
+		}
+
+		[[nodiscard]] const_reference front( ) const noexcept {
+			return row( 0, indices{ } );
+		}
+
+		[[nodiscard]] reference back( ) noexcept {
+			return row( m_size - 1U, indices{ } );
+		}
+
+		[[nodiscard]] const_reference back( ) const noexcept {
+			return row( m_size - 1U, indices{ } );
+		}
+
+		/***
+		 * The array for column I, aligned to at least 64 bytes
+		 */
+		template<std::size_t I>
+		[[nodiscard]] field_t<I> *column_data( ) noexcept {
+			return std::get<I>( m_block.columns );
+		}
+
+		template<std::size_t I>
+		[[nodiscard]] field_t<I> const *column_data( ) const noexcept {
+			return std::get<I>( m_block.columns );
+		}
+
+		template<std::size_t I>
+		[[nodiscard]] daw::span<field_t<I>> column( ) noexcept {
+			return daw::span<field_t<I>>( column_data<I>( ), m_size );
+		}
+
+		template<std::size_t I>
+		[[nodiscard]] daw::span<field_t<I> const> column( ) const noexcept {
+			return daw::span<field_t<I> const>( column_data<I>( ), m_size );
+		}
+
+		/***
+		 * Iterate just the columns Is, e.g. for( auto [x, y] : v.columns<0, 2>( ) )
+		 */
+		template<std::size_t... Is>
+		[[nodiscard]] auto columns( ) noexcept {
+			return daw::make_zipcontainer( column<Is>( )... );
+		}
+
+		template<std::size_t... Is>
+		[[nodiscard]] auto columns( ) const noexcept {
+			return daw::make_zipcontainer( column<Is>( )... );
+		}
+
+		[[nodiscard]] iterator begin( ) noexcept {
+			return make_iterator( 0, indices{ } );
+		}
+
+		[[nodiscard]] const_iterator begin( ) const noexcept {
+			return make_iterator( 0, indices{ } );
+		}
+
+		[[nodiscard]] const_iterator cbegin( ) const noexcept {
+			return begin( );
+		}
+
+		[[nodiscard]] iterator end( ) noexcept {
+			return make_iterator( m_size, indices{ } );
+		}
+
+		[[nodiscard]] const_iterator end( ) const noexcept {
+			return make_iterator( m_size, indices{ } );
+		}
+
+		[[nodiscard]] const_iterator cend( ) const noexcept {
+			return end( );
+		}
+	};
+
+	template<typename... Fields>
+	using soa_vector =
+	  basic_soa_vector<std::allocator<std::tuple<Fields...>>, Fields...>;
+} // namespace daw
@@ -9,6 +9,9 @@
 #pragma once
 
 #include "daw_algorithm.h"
+#include "daw_is_constant_evaluated.h"
+#include "daw_pdq_sort.h"
+#include "daw_radix_sort.h"
 #include "daw_swap.h"
 #include "daw_traits.h"
 #include "iterator/daw_random_iterator.h"
@@ -33,15 +36,6 @@ namespace daw {
 				//				daw::iter_swap( f, l );
 			}
 		}
-		template<typename ForwardIterator, typename Compare>
-		constexpr size_t swap_if2( ForwardIterator lhs, ForwardIterator rhs,
-		                           Compare &&comp ) noexcept {
-			if( comp( *rhs, *lhs ) ) {
-				daw::cswap( *rhs, *lhs );
-				return 1U;
-			}
-			return 0U;
-		}
 	} // namespace sort_n_details
 
 	template<typename RandomIterator, typename Compare = std::less<>>
@@ -423,120 +417,6 @@ namespace daw {
 		  and std::is_nothrow_invocable_v<
 		    Compare, typename std::iterator_traits<ForwardIterator>::value_type,
 		    typename std::iterator_traits<ForwardIterator>::value_type>;
-
-		template<typename ForwardIterator, typename Compare>
-		constexpr size_t sort_3_impl( ForwardIterator it0, ForwardIterator it1,
-		                              ForwardIterator it2,
-		                              Compare &&comp ) noexcept {
-
-			auto result = sort_n_details::swap_if2( it1, it2, comp );
-			result += sort_n_details::swap_if2( it0, it2, comp );
-			result += sort_n_details::swap_if2( it0, it1, comp );
-			return result;
-		}
-		template<typename ForwardIterator, typename Compare>
-		constexpr size_t sort_5_impl( ForwardIterator it0, ForwardIterator it1,
-		                              ForwardIterator it2, ForwardIterator it3,
-		                              ForwardIterator it4,
-		                              Compare &&comp ) noexcept {
-			auto result = sort_n_details::swap_if2( it0, it1, comp );
-			result += sort_n_details::swap_if2( it3, it4, comp );
-			result += sort_n_details::swap_if2( it2, it4, comp );
-			result += sort_n_details::swap_if2( it2, it3, comp );
-			result += sort_n_details::swap_if2( it0, it3, comp );
-			result += sort_n_details::swap_if2( it0, it2, comp );
-			result += sort_n_details::swap_if2( it1, it4, comp );
-			result += sort_n_details::swap_if2( it1, it3, comp );
-			result += sort_n_details::swap_if2( it1, it2, comp );
-			return result;
-		}
-
-		template<typename RandomIterator, typename Compare = std::less<>>
-		constexpr bool insertion_sort_incomplete(
-		  RandomIterator first, RandomIterator last,
-		  Compare
-		    &&comp ) noexcept( is_nothrow_sortable_v<RandomIterator, Compare> ) {
-
-			switch( last - first ) {
-			case 0:
-			case 1:
-				return true;
-			case 2:
-				if( comp( *( --last ), *first ) ) {
-					daw::cswap( *last, *first );
-				}
-				return true;
-			case 3:
-				sort_3( first, comp );
-				return true;
-			case 4:
-				sort_4( first, comp );
-				return true;
-			case 5:
-				sort_5( first, comp );
-				return true;
-			case 6:
-				sort_6( first, comp );
-				return true;
-			case 7:
-				sort_7( first, comp );
-				return true;
-			case 8:
-				sort_8( first, comp );
-				return true;
-			case 16:
-				sort_16( first, comp );
-				return true;
-			case 32:
-				sort_32( first, comp );
-				return true;
-			}
-			auto j = std::next( first, 2 );
-			sort_3_impl( first, std::next( first ), j, comp );
-
-			uint_fast8_t const limit = 8;
-			uint_fast8_t count = 0;
-			for( auto i = std::next( j ); i != last; ++i ) {
-				if( comp( *i, *j ) ) {
-					auto t = daw::move( *i );
-					auto k = j;
-					j = i;
-					do {
-						*j = daw::move( *k );
-						j = k;
-					} while( j != first and comp( t, *--k ) );
-					*j = daw::move( t );
-					if( ++count == limit ) {
-						return std::next( i ) == last;
-					}
-				}
-				j = i;
-			}
-			return true;
-		}
-
-		template<typename RandomIterator, typename Compare = std::less<>>
-		constexpr void insertion_sort_3(
-		  RandomIterator first, RandomIterator last,
-		  Compare
-		    &&comp ) noexcept( is_nothrow_sortable_v<RandomIterator, Compare> ) {
-
-			auto j = std::next( first, 2 );
-			daw::sort_3( first, comp );
-			for( auto i = std::next( j ); i != last; ++i ) {
-				if( comp( *i, *j ) ) {
-					auto t = daw::move( *i );
-					auto k = j;
-					j = i;
-					do {
-						*j = daw::move( *k );
-						j = k;
-					} while( j != first and comp( t, *--k ) );
-					*j = daw::move( t );
-				}
-				j = i;
-			}
-		}
 	} // namespace sort_n_details
 
 	template<typename RandomIterator, typename Compare = std::less<>>
@@ -550,170 +430,54 @@ namespace daw {
 	constexpr void
 	sort( RandomIterator first, RandomIterator last, Compare &&comp ) noexcept(
 	  sort_n_details::is_nothrow_sortable_v<RandomIterator, Compare> ) {
-		using difference_type =
-		  typename std::iterator_traits<RandomIterator>::difference_type;
-		using value_type =
-		  typename std::iterator_traits<RandomIterator>::value_type;
-
-		difference_type const limit =
-		  std::is_trivially_copy_constructible_v<value_type> and
-		      std::is_trivially_copy_assignable_v<value_type>
-		    ? 30
-		    : 6;
-
-		while( true ) {
-			bool should_restart = false;
-			auto const len = std::distance( first, last );
-			switch( len ) {
-			case 0:
-			case 1:
-				return;
-			case 2:
-				if( comp( *( --last ), *first ) ) {
-					daw::cswap( *last, *first );
-				}
-				return;
-			case 3:
-				sort_3( first, comp );
-				return;
-			case 4:
-				sort_4( first, comp );
-				return;
-			case 5:
-				sort_5( first, comp );
-				return;
-			case 6:
-				sort_6( first, comp );
-				return;
-			case 7:
-				sort_7( first, comp );
+		if constexpr( simd_sort_impl::is_simd_sortable_v<RandomIterator,
+		                                                 Compare> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) and
+			    simd_sort_impl::try_sort( first, last, comp ) ) {
 				return;
-			case 8:
-				sort_8( first, comp );
-				return;
-			case 16:
-				sort_16( first, comp );
-				return;
-			case 32:
-				sort_32( first, comp );
-				return;
-			}
-			if( len < limit ) {
-				sort_n_details::insertion_sort_3( first, last, comp );
-				return;
-			}
-			auto m = first;
-			auto lm1 = std::prev( last );
-			auto swap_count = [&] {
-				difference_type delta = len / 2;
-				m += delta;
-				if( len >= 1000 ) {
-					delta /= 2;
-					return sort_n_details::sort_5_impl( first, std::next( first, delta ),
-					                                    m, std::next( m, delta ), lm1,
-					                                    comp );
-				}
-				return sort_n_details::sort_3_impl( first, m, lm1, comp );
-			}( );
-
-			auto i = first;
-			auto j = lm1;
-			if( not comp( *i, *m ) ) {
-				while( not should_restart ) {
-					if( i == --j ) {
-						++i;
-						j = last;
-						if( not comp( *first, *( --j ) ) ) {
-							while( true ) {
-								if( i == j ) {
-									return;
-								}
-								if( comp( *first, *i ) ) {
-									daw::cswap( *i, *j );
-									++swap_count;
-									++i;
-									break;
-								}
-								++i;
-							}
-						}
-						if( i == j ) {
-							return;
-						}
-						while( true ) {
-							while( not comp( *first, *i ) ) {
-								++i;
-							}
-							while( comp( *first, *--j ) ) {}
-							if( i >= j ) {
-								break;
-							}
-							daw::cswap( *i, *j );
-							++swap_count;
-							++i;
-						}
-						first = i;
-						should_restart = true;
-						continue;
-					}
-					if( comp( *j, *m ) ) {
-						daw::cswap( *i, *j );
-						++swap_count;
-						break;
-					}
-				}
-				if( should_restart ) {
-					continue;
-				}
-			}
-			++i;
-			if( i < j ) {
-				while( true ) {
-					while( comp( *i, *m ) ) {
-						++i;
-					}
-					while( not comp( *( --j ), *m ) ) {}
-					if( i > j ) {
-						break;
-					}
-					daw::cswap( *i, *j );
-					++swap_count;
-
-					if( m == i ) {
-						m = j;
-					}
-					++i;
-				}
-			}
-			if( i != m and comp( *m, *i ) ) {
-				daw::cswap( *i, *m );
-				++swap_count;
-			}
-			if( swap_count == 0 ) {
-				bool const fs =
-				  sort_n_details::insertion_sort_incomplete( first, i, comp );
-				if( sort_n_details::insertion_sort_incomplete( std::next( i ), last,
-				                                               comp ) ) {
-					if( fs ) {
-						return;
-					}
-					last = i;
-					continue;
-				} else {
-					if( fs ) {
-						first = ++i;
-						continue;
-					}
-				}
 			}
-			if( i - first < last - i ) {
-				daw::sort( first, i, comp );
-				first = ++i;
-			} else {
-				daw::sort( std::next( i ), last, comp );
-				last = i;
+		}
+		switch( std::distance( first, last ) ) {
+		case 0:
+		case 1:
+			return;
+		case 2:
+			if( comp( *( --last ), *first ) ) {
+				daw::cswap( *last, *first );
 			}
+			return;
+		case 3:
+			sort_3( first, comp );
+			return;
+		case 4:
+			sort_4( first, comp );
+			return;
+		case 5:
+			sort_5( first, comp );
+			return;
+		case 6:
+			sort_6( first, comp );
+			return;
+		case 7:
+			sort_7( first, comp );
+			return;
+		case 8:
+			sort_8( first, comp );
+			return;
+		case 16:
+			sort_16( first, comp );
+			return;
+		case 32:
+			sort_32( first, comp );
+			return;
 		}
+		if( pdq_sort_impl::sort_if_monotonic( first, last, comp ) ) {
+			return;
+		}
+		pdq_sort_impl::pdq_loop<
+		  pdq_sort_impl::use_branchless_v<RandomIterator, Compare>>(
+		  first, last, comp, pdq_sort_impl::log2( std::distance( first, last ) ),
+		  true );
 	}
 
 	template<
@@ -732,46 +496,21 @@ namespace daw {
 	}
 
 	namespace sort_n_details {
-		template<typename ForwardIterator, typename RandomOutputIterator,
-		         typename Compare>
-		constexpr RandomOutputIterator
-		counting_sort( ForwardIterator first_in, ForwardIterator const last_in,
-		               RandomOutputIterator first_out, Compare &&comp ) {
-			using value_t =
-			  typename std::iterator_traits<ForwardIterator>::value_type;
-			bool const is_ascend =
-			  comp( static_cast<value_t>( 0 ), static_cast<value_t>( 1 ) );
+		template<typename Compare, typename T>
+		inline constexpr bool is_less_compare_v =
+		  daw::traits::is_one_of_v<daw::remove_cvref_t<Compare>, std::less<>,
+		                           std::less<T>>;
 
-			std::array<size_t, 10> counts{ };
-			size_t d = 0;
-			for( auto it = first_in; it != last_in; ++it ) {
-				++counts[static_cast<size_t>( ( *it ) % 10 )];
-				++d;
-			}
-			daw::algorithm::partial_sum( std::cbegin( counts ), std::cend( counts ),
-			                             std::begin( counts ) );
-
-			if( is_ascend ) {
-				while( first_in != last_in ) {
-					auto const pos = static_cast<size_t>( *first_in % 10 );
-					first_out[counts[pos] - 1U] = *first_in;
-					--counts[pos];
-					++first_in;
-				}
-			} else {
-				auto rf = daw::make_reverse_iterator( first_out + d );
-				auto const rl = daw::make_reverse_iterator( first_out );
-				while( rf != rl ) {
-					auto const pos = static_cast<size_t>( *first_in % 10 );
-					rf[counts[pos] - 1U] = *first_in;
-					--counts[pos];
-					++rf;
-				}
-			}
-			return first_out + d;
-		}
+		template<typename Compare, typename T>
+		inline constexpr bool is_greater_compare_v =
+		  daw::traits::is_one_of_v<daw::remove_cvref_t<Compare>,
+		                           std::greater<>, std::greater<T>>;
 	} // namespace sort_n_details
 
+	/***
+	 * Copy and sort integral values.  At runtime, when comp is std::less or
+	 * std::greater, the values are radix sorted
+	 */
 	template<typename ForwardIterator, typename RandomOutputIterator,
 	         typename Compare = std::less<>,
 	         std::enable_if_t<std::is_integral_v<typename std::iterator_traits<
@@ -780,9 +519,19 @@ namespace daw {
 	constexpr RandomOutputIterator
 	sort_to( ForwardIterator first_in, ForwardIterator last_in,
 	         RandomOutputIterator first_out, Compare &&comp = Compare{ } ) {
-
-		auto last_out =
-		  sort_n_details::counting_sort( first_in, last_in, first_out, comp );
+		using value_t = typename std::iterator_traits<ForwardIterator>::value_type;
+		if constexpr( is_radix_sortable_v<RandomOutputIterator> ) {
+			if( not DAW_IS_CONSTANT_EVALUATED( ) ) {
+				if constexpr( sort_n_details::is_less_compare_v<Compare, value_t> ) {
+					return daw::radix_sort_to( first_in, last_in, first_out );
+				} else if constexpr( sort_n_details::is_greater_compare_v<Compare,
+				                                                          value_t> ) {
+					return daw::radix_sort_to<radix_order::descending>(
+					  first_in, last_in, first_out );
+				}
+			}
+		}
+		auto last_out = daw::algorithm::copy( first_in, last_in, first_out );
 		daw::sort( first_out, last_out, std::forward<Compare>( comp ) );
 		return last_out;
 	}
@@ -9,17 +9,17 @@
 #pragma once
 
 #include "daw_exception.h"
-#include "daw_move.h"
+#include "daw_function_view.h"
 #include "daw_traits.h"
-#include "daw_utility.h"
-#include "daw_virtual_base.h"
 
 #include <ciso646>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <new>
 #include <type_traits>
+#include <utility>
 
 namespace daw {
 	namespace func_impl {
@@ -38,229 +38,203 @@ namespace daw {
 		inline constexpr bool has_empty_member_v =
 		  daw::is_detected_v<has_empty_member_detect, T>;
 
-		template<size_t StorageSize, typename Base>
-		struct function_storage {
-			std::aligned_storage_t<StorageSize> m_data;
-
-			function_storage( function_storage const & ) noexcept = default;
-			function_storage( function_storage && ) noexcept = default;
-
-			function_storage &operator=( function_storage const &rhs ) {
-				if( this == &rhs ) {
-					return *this;
-				}
-				clean( );
-				m_data = rhs.m_data;
-				return *this;
-			}
-
-			function_storage &operator=( function_storage &&rhs ) noexcept {
-				if( this == &rhs ) {
-					return *this;
-				}
-				clean( );
-				m_data = std::move( rhs.m_data );
-				return *this;
-			}
-
-			template<
-			  typename Func,
-			  std::enable_if_t<!std::is_same_v<std::decay_t<Func>, function_storage>,
-			                   std::nullptr_t> = nullptr>
-			function_storage( Func &&f ) {
-				static_assert( sizeof( std::decay_t<Func> ) <= StorageSize );
-				store( std::forward<Func>( f ) );
+		template<typename Func>
+		[[nodiscard]] bool is_empty_callable( Func const &f ) {
+			if constexpr( func_impl::has_empty_member_v<Func> ) {
+				return f.empty( );
+			} else if constexpr( func_impl::is_boolable_v<Func> ) {
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnonnull-compare"
+#pragma GCC diagnostic ignored "-Waddress"
+#endif
+				return not static_cast<bool>( f );
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+			} else {
+				return false;
 			}
+		}
 
-			[[nodiscard]] Base *ptr( ) noexcept {
-				return reinterpret_cast<Base *>( &m_data );
-			}
+		enum class manage_op { copy, move, destroy };
 
-			[[nodiscard]] Base const *ptr( ) const noexcept {
-				return reinterpret_cast<Base const *>( &m_data );
+		/***
+		 * Copy the Func at src to dst, move it to dst and destroy src, or destroy
+		 * src.  Only needed when Func is not trivially copyable
+		 */
+		template<typename Func>
+		void manage( manage_op op, void *dst, void *src ) {
+			Func *const f = std::launder( static_cast<Func *>( src ) );
+			switch( op ) {
+			case manage_op::copy:
+				::new( dst ) Func( std::as_const( *f ) );
+				return;
+			case manage_op::move:
+				::new( dst ) Func( std::move( *f ) );
+				std::destroy_at( f );
+				return;
+			case manage_op::destroy:
+				std::destroy_at( f );
+				return;
 			}
+		}
 
-			void clean( ) {
-				std::destroy_at( ptr( ) );
-			}
+		using manage_t = void ( * )( manage_op, void *, void * );
 
-			~function_storage( ) {
-				clean( );
-			}
+		template<typename Result, typename... FuncArgs>
+		struct invoker {
+			using invoke_t = Result ( * )( void *, FuncArgs &&... );
 
 			template<typename Func>
-			void store( Func &&f ) {
-				static_assert( sizeof( std::decay_t<Func> ) <= StorageSize );
-				static_assert( std::is_base_of_v<Base, Func>,
-				               "Can only store children of func_base" );
-				new( &m_data )
-				  daw::remove_cvref_t<std::decay_t<Func>>( std::forward<Func>( f ) );
+			static Result invoke( void *data, FuncArgs &&...args ) {
+				Func &f = *std::launder( static_cast<Func *>( data ) );
+				if constexpr( std::is_void_v<Result> ) {
+					std::invoke( f, std::forward<FuncArgs>( args )... );
+				} else {
+					return std::invoke( f, std::forward<FuncArgs>( args )... );
+				}
 			}
 
-			[[nodiscard]] Base &operator*( ) noexcept {
-				return *ptr( );
+			[[noreturn]] static Result invoke_empty( void *, FuncArgs &&... ) {
+				daw::exception::daw_throw<std::bad_function_call>( );
 			}
+		};
 
-			[[nodiscard]] Base const &operator*( ) const noexcept {
-				return *ptr( );
-			}
+		template<size_t Sz, size_t MaxSz>
+		constexpr void validate_size( ) {
+			static_assert( Sz <= MaxSz,
+			               "Size of function is larger than allocated space" );
+		}
 
-			[[nodiscard]] Base *operator->( ) noexcept {
-				return ptr( );
-			}
+	} // namespace func_impl
 
-			[[nodiscard]] Base const *operator->( ) const noexcept {
-				return ptr( );
-			}
-		};
+	template<size_t, typename>
+	class function;
 
-		template<typename Result, typename... FuncArgs>
-		struct function_base
-		  : daw::virtual_base<function_base<Result, FuncArgs...>> {
-			virtual Result operator( )( FuncArgs... ) const = 0;
-			virtual Result operator( )( FuncArgs... ) = 0;
-			virtual bool empty( ) const = 0;
+	namespace func_impl {
+		template<typename T>
+		struct is_daw_function : std::false_type {};
 
-			function_base( ) noexcept = default;
-		};
+		template<size_t N, typename Signature>
+		struct is_daw_function<function<N, Signature>> : std::true_type {};
 
-		template<typename Result, typename... FuncArgs>
-		struct empty_child final : function_base<Result, FuncArgs...> {
-			[[noreturn]] Result operator( )( FuncArgs... ) const override {
-				daw::exception::daw_throw<std::bad_function_call>( );
-			}
+		// Any daw::function converts through its own overloads, not by being
+		// stored as an opaque callable
+		template<typename Func>
+		inline constexpr bool is_storable_v =
+		  not is_daw_function<daw::remove_cvref_t<Func>>::value and
+		  not std::is_function_v<Func>;
+	} // namespace func_impl
 
-			[[noreturn]] Result operator( )( FuncArgs... ) override {
-				daw::exception::daw_throw<std::bad_function_call>( );
-			}
+	/***
+	 * A copyable callable stored in MaxSize bytes inline, never on the heap.
+	 * The invoke and manager pointers live in the object, so a call is one
+	 * indirect call.  Trivially copyable callables have no manager and are
+	 * copied and moved with memcpy
+	 */
+	template<size_t MaxSize, typename Result, typename... FuncArgs>
+	class function<MaxSize, Result( FuncArgs... )> {
+		template<size_t, typename>
+		friend class function;
 
-			[[nodiscard]] bool empty( ) const override {
-				return true;
-			}
-		};
+		using invoker = func_impl::invoker<Result, FuncArgs...>;
+		using invoke_t = typename invoker::invoke_t;
 
-		template<typename...>
-		struct function_child;
-
-		template<typename Func, typename Result, typename... FuncArgs>
-		struct function_child<Func, Result, FuncArgs...> final
-		  : function_base<Result, FuncArgs...>,
-		    enable_copy_constructor<Func>,
-		    enable_move_constructor<Func>,
-		    enable_copy_assignment<Func>,
-		    enable_move_assignment<Func> {
-
-			Func m_func;
-
-			template<typename F, std::enable_if_t<
-			                       !std::is_same_v<std::decay_t<F>, function_child>,
-			                       std::nullptr_t> = nullptr>
-			function_child( F &&func ) noexcept(
-			  std::is_nothrow_constructible_v<Func, F> )
-			  : m_func( std::forward<F>( func ) ) {}
-
-			Result operator( )( FuncArgs... args ) override {
-				daw::exception::precondition_check<std::bad_function_call>( !empty( ) );
-				if constexpr( std::is_same_v<std::decay_t<Result>, void> ) {
-					// daw::invoke( m_func, daw::move( args )... );
-					m_func( args... );
-				} else {
-					// return daw::invoke( m_func, daw::move( args )... );
-					return m_func( args... );
-				}
-			}
+		alignas( std::max_align_t ) mutable std::byte m_data[MaxSize];
+		invoke_t m_invoke = &invoker::invoke_empty;
+		func_impl::manage_t m_manage = nullptr;
 
-			Result operator( )( FuncArgs... args ) const override {
-				daw::exception::precondition_check<std::bad_function_call>( !empty( ) );
-				if constexpr( std::is_same_v<std::decay_t<Result>, void> ) {
-					// daw::invoke( m_func, daw::move( args )... );
-					m_func( args... );
-				} else {
-					// return daw::invoke( m_func, daw::move( args )... );
-					return m_func( args... );
-				}
+		template<typename Func>
+		void store( Func &&f ) {
+			using func_t = std::decay_t<Func>;
+			func_impl::validate_size<sizeof( func_t ), MaxSize>( );
+			static_assert( alignof( func_t ) <= alignof( std::max_align_t ),
+			               "Function is over aligned" );
+			static_assert( std::is_copy_constructible_v<func_t>,
+			               "Function must be copy constructible" );
+			static_assert( std::is_invocable_r_v<Result, func_t &, FuncArgs...>,
+			               "Function isn't callable with FuncArgs" );
+			if( func_impl::is_empty_callable( f ) ) {
+				return;
 			}
-
-			[[nodiscard]] bool empty( ) const override {
-				if constexpr( func_impl::has_empty_member_v<Func> ) {
-					return m_func.empty( );
-				} else if constexpr( func_impl::is_boolable_v<Func> ) {
-					return !static_cast<bool>( m_func );
-				}
-				return false;
+			::new( static_cast<void *>( m_data ) ) func_t( std::forward<Func>( f ) );
+			m_invoke = &invoker::template invoke<func_t>;
+			if constexpr( not std::is_trivially_copyable_v<func_t> ) {
+				m_manage = &func_impl::manage<func_t>;
 			}
-		};
+		}
 
-		template<size_t MaxSize, typename function_base, typename function_child,
-		         typename empty_child, typename Func>
-		function_storage<MaxSize, function_base> store_if_not_empty( Func &&f ) {
-			static_assert( sizeof( std::decay_t<Func> ) <= MaxSize );
-			if constexpr( func_impl::has_empty_member_v<Func> ) {
-				if( f.empty( ) ) {
-					return { empty_child( ) };
-				}
-			} else if constexpr( func_impl::is_boolable_v<Func> ) {
-#if defined( __GNUC__ ) && !defined( __clang__ )
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wnonnull-compare"
-#pragma GCC diagnostic ignored "-Waddress"
-#endif
-				if( not static_cast<bool>( f ) ) {
-					return { empty_child( ) };
-				}
-#if defined( __GNUC__ ) && !defined( __clang__ )
-#pragma GCC diagnostic pop
-#endif
+		template<size_t N>
+		void copy_from( function<N, Result( FuncArgs... )> const &other ) {
+			if( other.m_manage != nullptr ) {
+				other.m_manage( func_impl::manage_op::copy, m_data, other.m_data );
+			} else {
+				std::memcpy( m_data, other.m_data, N );
 			}
-			return { function_child( std::forward<Func>( f ) ) };
+			m_invoke = other.m_invoke;
+			m_manage = other.m_manage;
 		}
 
-		template<size_t Sz, size_t MaxSz>
-		constexpr void validate_size( ) {
-			static_assert( Sz <= MaxSz,
-			               "Size of function is larger than allocated space" );
+		template<size_t N>
+		void move_from( function<N, Result( FuncArgs... )> &other ) noexcept {
+			if( other.m_manage != nullptr ) {
+				other.m_manage( func_impl::manage_op::move, m_data, other.m_data );
+			} else {
+				std::memcpy( m_data, other.m_data, N );
+			}
+			m_invoke = std::exchange( other.m_invoke, &invoker::invoke_empty );
+			m_manage = std::exchange( other.m_manage, nullptr );
 		}
 
-	} // namespace func_impl
+	public:
+		function( ) noexcept = default;
 
-	template<size_t, typename>
-	class function;
+		function( std::nullptr_t ) noexcept {}
 
-	template<size_t MaxSize, typename Result, typename... FuncArgs>
-	class function<MaxSize, Result( FuncArgs... )> {
-		using function_base = func_impl::function_base<Result, FuncArgs...>;
-		using empty_child = func_impl::empty_child<Result, FuncArgs...>;
+		function( function const &other ) {
+			copy_from( other );
+		}
 
-		template<typename Func>
-		using function_child = func_impl::function_child<Func, Result, FuncArgs...>;
+		function( function &&other ) noexcept {
+			move_from( other );
+		}
 
-		func_impl::function_storage<MaxSize, function_base> m_storage;
+		function &operator=( function const &rhs ) {
+			if( this != &rhs ) {
+				*this = function( rhs );
+			}
+			return *this;
+		}
 
-		template<typename Func>
-		decltype( auto ) store_if_not_empty( Func &&f ) {
-			func_impl::validate_size<sizeof( std::decay_t<Func> ), MaxSize>( );
-			return func_impl::store_if_not_empty<MaxSize, function_base,
-			                                     function_child<Func>, empty_child>(
-			  std::forward<Func>( f ) );
+		function &operator=( function &&rhs ) noexcept {
+			if( this != &rhs ) {
+				reset( );
+				move_from( rhs );
+			}
+			return *this;
 		}
 
-	public:
-		function( ) noexcept
-		  : m_storage( empty_child{ } ) {}
+		function &operator=( std::nullptr_t ) noexcept {
+			reset( );
+			return *this;
+		}
 
-		function( std::nullptr_t )
-		  : m_storage( empty_child{ } ) {}
+		~function( ) {
+			reset( );
+		}
 
-		function( function const & ) = default;
-		function( function && ) noexcept = default;
-		function &operator=( function const & ) = default;
-		function &operator=( function && ) noexcept = default;
-		~function( ) = default;
+		template<size_t N,
+		         std::enable_if_t<( N <= MaxSize ), std::nullptr_t> = nullptr>
+		function( function<N, Result( FuncArgs... )> const &other ) {
+			copy_from( other );
+		}
 
 		template<size_t N,
 		         std::enable_if_t<( N <= MaxSize ), std::nullptr_t> = nullptr>
-		function( function<N, Result( FuncArgs... )> const &other )
-		  : m_storage( *other.m_storage ) {}
+		function( function<N, Result( FuncArgs... )> &&other ) noexcept {
+			move_from( other );
+		}
 
 		template<size_t N,
 		         std::enable_if_t<( N > MaxSize ), std::nullptr_t> = nullptr>
@@ -269,7 +243,15 @@ namespace daw {
 		template<size_t N,
 		         std::enable_if_t<( N <= MaxSize ), std::nullptr_t> = nullptr>
 		function &operator=( function<N, Result( FuncArgs... )> const &other ) {
-			m_storage = *other.m_storage;
+			return *this = function( other );
+		}
+
+		template<size_t N,
+		         std::enable_if_t<( N <= MaxSize ), std::nullptr_t> = nullptr>
+		function &
+		operator=( function<N, Result( FuncArgs... )> &&other ) noexcept {
+			reset( );
+			move_from( other );
 			return *this;
 		}
 
@@ -279,59 +261,47 @@ namespace daw {
 		operator=( function<N, Result( FuncArgs... )> const &other ) = delete;
 
 		template<typename Func,
-		         std::enable_if_t<
-		           daw::all_true_v<!std::is_same_v<std::decay_t<Func>, function>,
-		                           !std::is_function_v<Func>>,
-		           std::nullptr_t> = nullptr>
-		function( Func &&f )
-		  : m_storage( store_if_not_empty( std::forward<Func>( f ) ) ) {
-
-			func_impl::validate_size<sizeof( std::decay_t<Func> ), MaxSize>( );
-			static_assert( std::is_invocable_r_v<Result, Func, FuncArgs...>,
-			               "Function isn't callable with FuncArgs" );
+		         std::enable_if_t<func_impl::is_storable_v<Func>, std::nullptr_t> =
+		           nullptr>
+		function( Func &&f ) {
+			store( std::forward<Func>( f ) );
 		}
 
 		template<typename Func,
-		         std::enable_if_t<
-		           daw::all_true_v<!std::is_same_v<std::decay_t<Func>, function>,
-		                           !std::is_function_v<Func>>,
-		           std::nullptr_t> = nullptr>
+		         std::enable_if_t<func_impl::is_storable_v<Func>, std::nullptr_t> =
+		           nullptr>
 		function &operator=( Func &&f ) {
-			func_impl::validate_size<sizeof( std::decay_t<Func> ), MaxSize>( );
-			static_assert( std::is_invocable_r_v<Result, Func, FuncArgs...>,
-			               "Function isn't callable with FuncArgs" );
-			m_storage = store_if_not_empty( std::forward<Func>( f ) );
+			reset( );
+			store( std::forward<Func>( f ) );
 			return *this;
 		}
 
-		template<typename... Args>
-		Result operator( )( Args &&...args ) {
-			daw::exception::precondition_check<std::bad_function_call>( !empty( ) );
-			function_base &f = *m_storage;
-			if constexpr( std::is_same_v<std::decay_t<Result>, void> ) {
-				f( std::forward<Args>( args )... );
-			} else {
-				return f( std::forward<Args>( args )... );
-			}
+		// Calling an empty function throws std::bad_function_call
+		Result operator( )( FuncArgs... args ) const {
+			return m_invoke( m_data, std::forward<FuncArgs>( args )... );
 		}
 
-		template<typename... Args>
-		Result operator( )( Args &&...args ) const {
-			daw::exception::precondition_check<std::bad_function_call>( !empty( ) );
-			function_base const &f = *m_storage;
-			if constexpr( std::is_same_v<std::decay_t<Result>, void> ) {
-				f( std::forward<Args>( args )... );
-			} else {
-				return f( std::forward<Args>( args )... );
+		void reset( ) noexcept {
+			if( m_manage != nullptr ) {
+				m_manage( func_impl::manage_op::destroy, nullptr, m_data );
 			}
+			m_invoke = &invoker::invoke_empty;
+			m_manage = nullptr;
 		}
 
-		[[nodiscard]] bool empty( ) const {
-			return m_storage->empty( );
+		[[nodiscard]] bool empty( ) const noexcept {
+			return m_invoke == &invoker::invoke_empty;
 		}
 
-		explicit operator bool( ) const {
-			return !empty( );
+		explicit operator bool( ) const noexcept {
+			return not empty( );
 		}
 	};
+
+	/***
+	 * A non-owning reference to a callable.  It is two pointers and never
+	 * allocates, the callable must outlive it
+	 */
+	template<typename Signature>
+	using function_ref = function_view<Signature>;
 } // namespace daw
@@ -8,13 +8,17 @@
 
 #pragma once
 
-#include <algorithm>
+#include "daw_pdq_sort.h"
+
 #include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <utility>
 
 namespace daw {
 	namespace quick_sort_impl {
-		template<typename T, size_t N, typename Idx = uint16_t>
+		template<typename T, std::size_t N, typename Idx = std::uint16_t>
 		struct bounded_stack {
 			T values[N];
 			Idx idx = 0;
@@ -37,50 +41,61 @@ namespace daw {
 			}
 		};
 
-		template<typename T, typename Compare>
-		constexpr T median( T const &a, T const &b, T const &c, Compare cmp ) {
-			if( cmp( a, b ) != cmp( a, c ) ) {
-				return a;
-			} else if( cmp( a, b ) != cmp( c, b ) ) {
-				return b;
-			}
-			return c;
-		}
-
+		template<typename RandomIterator>
+		struct sort_range {
+			RandomIterator first;
+			RandomIterator last;
+			int bad_allowed;
+			bool leftmost;
+		};
 	} // namespace quick_sort_impl
 
+	/***
+	 * Sort [first, last) without recursion.  Uses the pattern defeating
+	 * partitioning of daw::pdq_sort with an explicit stack.  The smaller side
+	 * of each partition is sorted first so the stack stays within
+	 * O(log n) entries
+	 */
 	template<typename RandomIterator, typename Compare = std::less<>>
 	constexpr void quick_sort( RandomIterator f, RandomIterator l,
 	                           Compare cmp = Compare{ } ) {
+		if( pdq_sort_impl::sort_if_monotonic( f, l, cmp ) ) {
+			return;
+		}
+		constexpr bool branchless =
+		  pdq_sort_impl::use_branchless_v<RandomIterator, Compare>;
+		constexpr std::size_t tree_size = sizeof( std::size_t ) * 8U * 2U;
+		using range_t = quick_sort_impl::sort_range<RandomIterator>;
 
-		constexpr size_t tree_size = sizeof( size_t ) * 8U * 2U;
-
-		quick_sort_impl::bounded_stack<std::pair<RandomIterator, RandomIterator>,
-		                               tree_size * 2U>
-		  sort_stack;
-		sort_stack.push_back( f, l );
+		quick_sort_impl::bounded_stack<range_t, tree_size * 2U> sort_stack;
+		sort_stack.push_back( f, l, pdq_sort_impl::log2( l - f ), true );
 
 		while( sort_stack.has_more( ) ) {
-			auto [first, last] = sort_stack.back( );
+			auto [first, last, bad_allowed, leftmost] = sort_stack.back( );
 			sort_stack.pop_back( );
 
-			auto const dist = std::distance( first, last );
-			if( dist <= 1 ) {
-				return;
+			while( true ) {
+				auto const step = pdq_sort_impl::pdq_step<branchless>(
+				  first, last, cmp, bad_allowed, leftmost );
+				if( step.done ) {
+					break;
+				}
+				if( not step.split ) {
+					first = step.next;
+					leftmost = false;
+					continue;
+				}
+				// Defer the larger side and keep working on the smaller
+				if( step.pivot_pos - first < last - step.next ) {
+					sort_stack.push_back( step.next, last, bad_allowed, false );
+					last = step.pivot_pos;
+				} else {
+					sort_stack.push_back( first, step.pivot_pos, bad_allowed,
+					                      leftmost );
+					first = step.next;
+					leftmost = false;
+				}
 			}
-			auto const mid = std::next( first, dist / 2 );
-			auto const pivot =
-			  quick_sort_impl::median( *first, *mid, *std::prev( last ), cmp );
-
-			auto const less_pivot = std::partition(
-			  first, last, [=]( auto const &v ) { return cmp( v, pivot ); } );
-
-			auto const split2 =
-			  std::partition( less_pivot, last,
-			                  [=]( auto const &v ) { return not cmp( pivot, v ); } );
-
-			sort_stack.push_back( split2, last );
-			sort_stack.push_back( first, less_pivot );
 		}
 	}
 } // namespace daw
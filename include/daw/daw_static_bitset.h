@@ -8,17 +8,24 @@
 
 #pragma once
 
+#include "daw_algorithm.h"
 #include "daw_bit.h"
 #include "daw_bounded_array.h"
+#include "daw_is_constant_evaluated.h"
 #include "daw_string_view.h"
 #include "daw_traits.h"
 #include "daw_utility.h"
+#include "impl/daw_bitset_simd.h"
 
+#include <algorithm>
 #include <array>
 #include <ciso646>
 #include <cstdint>
 #include <iosfwd>
 #include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace daw {
@@ -83,18 +90,14 @@ namespace daw {
 			return result;
 		}
 
+		// The bits of the last element that are within BitWidth
 		template<size_t BitWidth, typename value_t>
 		constexpr value_t get_diff_mask( ) noexcept {
-			size_t bw = BitWidth;
-			if( bw > bsizeof<value_t> ) {
-				bw %= bsizeof<value_t>;
-			} else if( bw < bsizeof<value_t> ) {
-				bw = bsizeof<value_t> - bw;
-			}
-			if( bw == 0 ) {
+			size_t const used = BitWidth % bsizeof<value_t>;
+			if( used == 0 ) {
 				return std::numeric_limits<value_t>::max( );
 			}
-			return daw::mask_msb<value_t>( bw );
+			return daw::mask_msb<value_t>( bsizeof<value_t> - used );
 		}
 	} // namespace bitset_impl
 	inline constexpr bitset_impl::fmt_binary_t const fmt_binary{ };
@@ -104,76 +107,67 @@ namespace daw {
 	template<size_t BitWidth>
 	class static_bitset {
 		static_assert( BitWidth > 0 );
-		using value_t = uintmax_t;
+		using value_t = std::uint64_t;
+
+		template<size_t>
+		friend class static_bitset;
 
 		static constexpr size_t const m_element_capacity =
 		  bitset_impl::get_elements_needed<BitWidth, value_t>( );
 
+		// Large enough that the runtime dispatch pays for itself
+		static constexpr bool use_simd = m_element_capacity >= 4U;
+
+		// Bits past BitWidth in the last element are always zero
 		bounded_array_t<value_t, m_element_capacity> m_data{ };
 
 		struct bit_address_t {
-			value_t index;
-			value_t bit;
+			size_t index;
+			value_t mask;
 		};
 
-		constexpr bit_address_t get_address( size_t index ) noexcept {
-			bit_address_t result{ };
-			result.index = static_cast<value_t>( index / daw::bsizeof<value_t> );
-
-			result.bit =
-			  static_cast<value_t>( index - result.index * daw::bsizeof<value_t> );
-
-			return result;
-		}
-
-		static constexpr void set_bit( value_t &value, value_t bit ) noexcept {
-			value |= static_cast<value_t>( bit << 1U );
-		}
-
-		static constexpr void clear_bit( value_t &value, value_t bit ) noexcept {
-			value &= static_cast<value_t>( ~static_cast<value_t>( bit << 1U ) );
+		static constexpr bit_address_t get_address( size_t index ) noexcept {
+			return { index / daw::bsizeof<value_t>,
+			         static_cast<value_t>( value_t{ 1U }
+			                               << ( index % daw::bsizeof<value_t> ) ) };
 		}
 
-		static constexpr bool get_bit( value_t &value, value_t bit ) noexcept {
-			return ( value & static_cast<value_t>( bit << 1U ) ) != 0U;
+		constexpr void clear_unused_bits( ) noexcept {
+			m_data.back( ) &= bitset_impl::get_diff_mask<BitWidth, value_t>( );
 		}
 
-		static constexpr size_t count_ones( value_t value ) noexcept {
-			size_t count = 0;
-			while( value ) {
-				value &= value - 1U;
-				++count;
+		template<bitset_simd_impl::bit_op Op>
+		constexpr void bitwise( value_t const *rhs, size_t size ) noexcept {
+			if constexpr( use_simd ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) ) {
+					bitset_simd_impl::bitwise<Op>( m_data.data( ), rhs, size );
+					return;
+				}
 			}
-			return count;
-		}
-
-		static constexpr size_t count_zeros( value_t value ) noexcept {
-			return bsizeof<value_t> - count_ones( value );
+			bitset_simd_impl::bitwise_scalar<Op>( m_data.data( ), rhs, size );
 		}
 
-		template<size_t N>
-		static constexpr size_t
-		count_ones( std::array<value_t, N> const &values ) noexcept {
-			size_t count = 0;
-			for( size_t n = 0; n < N; ++n ) {
-				count += count_ones( values[n] );
+		// The index of the first non-zero element at or after first, or
+		// m_element_capacity
+		constexpr size_t find_nonzero( size_t first ) const noexcept {
+			if constexpr( use_simd ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) ) {
+					return bitset_simd_impl::find_nonzero( m_data.data( ), first,
+					                                       m_element_capacity );
+				}
 			}
-			return count;
+			return bitset_simd_impl::find_nonzero_scalar( m_data.data( ), first,
+			                                              m_element_capacity );
 		}
 
-		template<size_t N>
-		static constexpr size_t
-		count_zeros( std::array<value_t, N> const &values ) noexcept {
-			size_t count = 0;
-			for( size_t n = 0; n < N; ++n ) {
-				count += count_zeros( values[n] );
-			}
-			return count;
-		}
+		template<bool IsConst>
+		class bit_iterator;
 
 	public:
-		struct static_bitset_iterator;
-		struct static_bitset_const_iterator;
+		class reference;
+		using const_reference = bool;
+		using static_bitset_iterator = bit_iterator<false>;
+		using static_bitset_const_iterator = bit_iterator<true>;
 		using value_type = bool;
 		using iterator = static_bitset_iterator;
 		using const_iterator = static_bitset_const_iterator;
@@ -193,12 +187,14 @@ namespace daw {
 		/// \param value lowest bytes in bitset
 		/// \param values bytes in bitset from lowest(left) to highest(right)
 		template<typename... Unsigned>
-		explicit static_bitset( uintmax_t value, Unsigned... values ) noexcept
-		  : m_data{ value, values... } {
+		explicit constexpr static_bitset( uintmax_t value,
+		                                  Unsigned... values ) noexcept
+		  : m_data{ static_cast<value_t>( value ),
+		            static_cast<value_t>( values )... } {
 
 			// Ensure that we do not have any data on the high bits that should not
 			// be there
-			m_data.back( ) &= bitset_impl::get_diff_mask<BitWidth, value_t>( );
+			clear_unused_bits( );
 		}
 
 		/// Construct a bitset from a string of zeros and ones
@@ -234,28 +230,35 @@ namespace daw {
 		  size_t BitWidthOther,
 		  std::enable_if_t<( BitWidth > BitWidthOther ), std::nullptr_t> = nullptr>
 		constexpr static_bitset(
-		  static_bitset<BitWidthOther> const &other ) noexcept
-		  : m_data{ other.m_data } {}
+		  static_bitset<BitWidthOther> const &other ) noexcept {
+			for( size_t n = 0; n < other.m_data.size( ); ++n ) {
+				m_data[n] = other.m_data[n];
+			}
+		}
+
+		[[nodiscard]] static constexpr size_t size( ) noexcept {
+			return BitWidth;
+		}
 
 		/// Enable a specific bit in the bitset
 		/// \param index bit position in set
 		constexpr void set_bit( size_t index ) noexcept {
 			auto const loc = get_address( index );
-			set_bit( m_data[loc.index], loc.bit );
+			m_data[loc.index] |= loc.mask;
 		}
 
 		/// Disable a specific bit in the bitset
 		/// \param index bit position in set
 		constexpr void clear_bit( size_t index ) noexcept {
 			auto const loc = get_address( index );
-			clear_bit( m_data[loc.index], loc.bit );
+			m_data[loc.index] &= static_cast<value_t>( ~loc.mask );
 		}
 
 		/// Get a specific bit from the bitset
 		/// \param index bit position in set
-		constexpr bool get_bit( size_t index ) noexcept {
+		[[nodiscard]] constexpr bool get_bit( size_t index ) const noexcept {
 			auto const loc = get_address( index );
-			return get_bit( m_data[loc.index], loc.bit );
+			return ( m_data[loc.index] & loc.mask ) != 0U;
 		}
 
 		/// Set all bits to zero
@@ -265,36 +268,331 @@ namespace daw {
 			}
 		}
 
-		struct static_bitset_iterator {};
-		struct static_bitset_const_iterator {};
-		struct reference {};
-		struct const_reference {};
+		/// Proxy for a single bit, returned by operator[] and iterators
+		class reference {
+			value_t *m_word;
+			value_t m_mask;
+
+		public:
+			constexpr reference( value_t *word, value_t mask ) noexcept
+			  : m_word( word )
+			  , m_mask( mask ) {}
+
+			constexpr reference &operator=( bool b ) noexcept {
+				if( b ) {
+					*m_word |= m_mask;
+				} else {
+					*m_word &= static_cast<value_t>( ~m_mask );
+				}
+				return *this;
+			}
 
-		constexpr size_t one_count( ) const noexcept {
-			return count_ones( m_data );
+			constexpr reference &operator=( reference const &other ) noexcept {
+				return *this = static_cast<bool>( other );
+			}
+
+			constexpr reference( reference const & ) noexcept = default;
+
+			[[nodiscard]] constexpr operator bool( ) const noexcept {
+				return ( *m_word & m_mask ) != 0U;
+			}
+
+			[[nodiscard]] constexpr bool operator~( ) const noexcept {
+				return not static_cast<bool>( *this );
+			}
+
+			constexpr reference &flip( ) noexcept {
+				*m_word ^= m_mask;
+				return *this;
+			}
+		};
+
+	private:
+		/***
+		 * Random access over every bit, in order from bit 0.  Dereferencing
+		 * gives a reference proxy, or bool when IsConst
+		 */
+		template<bool IsConst>
+		class bit_iterator {
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = bool;
+			using difference_type = intmax_t;
+			using reference =
+			  std::conditional_t<IsConst, bool, typename static_bitset::reference>;
+			using pointer = void;
+
+		private:
+			using words_t = std::conditional_t<IsConst, value_t const, value_t>;
+			words_t *m_words = nullptr;
+			difference_type m_index = 0;
+
+		public:
+
+			constexpr bit_iterator( ) noexcept = default;
+
+			constexpr bit_iterator( words_t *words, difference_type index ) noexcept
+			  : m_words( words )
+			  , m_index( index ) {}
+
+			template<bool B = IsConst, std::enable_if_t<B, std::nullptr_t> = nullptr>
+			constexpr bit_iterator( bit_iterator<false> const &other ) noexcept
+			  : m_words( other.m_words )
+			  , m_index( other.m_index ) {}
+
+			[[nodiscard]] constexpr reference operator*( ) const noexcept {
+				auto const loc = get_address( static_cast<size_t>( m_index ) );
+				if constexpr( IsConst ) {
+					return ( m_words[loc.index] & loc.mask ) != 0U;
+				} else {
+					return reference( m_words + loc.index, loc.mask );
+				}
+			}
+
+			[[nodiscard]] constexpr reference
+			operator[]( difference_type n ) const noexcept {
+				return *( *this + n );
+			}
+
+			constexpr bit_iterator &operator++( ) noexcept {
+				++m_index;
+				return *this;
+			}
+
+			constexpr bit_iterator operator++( int ) noexcept {
+				auto result = *this;
+				++m_index;
+				return result;
+			}
+
+			constexpr bit_iterator &operator--( ) noexcept {
+				--m_index;
+				return *this;
+			}
+
+			constexpr bit_iterator operator--( int ) noexcept {
+				auto result = *this;
+				--m_index;
+				return result;
+			}
+
+			constexpr bit_iterator &operator+=( difference_type n ) noexcept {
+				m_index += n;
+				return *this;
+			}
+
+			constexpr bit_iterator &operator-=( difference_type n ) noexcept {
+				m_index -= n;
+				return *this;
+			}
+
+			[[nodiscard]] friend constexpr bit_iterator
+			operator+( bit_iterator it, difference_type n ) noexcept {
+				return it += n;
+			}
+
+			[[nodiscard]] friend constexpr bit_iterator
+			operator+( difference_type n, bit_iterator it ) noexcept {
+				return it += n;
+			}
+
+			[[nodiscard]] friend constexpr bit_iterator
+			operator-( bit_iterator it, difference_type n ) noexcept {
+				return it -= n;
+			}
+
+			[[nodiscard]] friend constexpr difference_type
+			operator-( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index - rhs.m_index;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator==( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index == rhs.m_index;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator!=( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index != rhs.m_index;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator<( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index < rhs.m_index;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator<=( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index <= rhs.m_index;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator>( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index > rhs.m_index;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator>=( bit_iterator const &lhs, bit_iterator const &rhs ) noexcept {
+				return lhs.m_index >= rhs.m_index;
+			}
+
+			template<bool>
+			friend class bit_iterator;
+		};
+
+	public:
+		/***
+		 * Forward iteration over the positions of the set bits, in ascending
+		 * order.  Each step clears the lowest bit of a copy of the current
+		 * element and zero elements are skipped a vector at a time
+		 */
+		class set_bit_iterator {
+			static_bitset const *m_bitset = nullptr;
+			size_t m_index = m_element_capacity;
+			value_t m_bits = 0U;
+
+			constexpr void next_element( ) noexcept {
+				m_index = m_bitset->find_nonzero( m_index + 1U );
+				m_bits = m_index < m_element_capacity ? m_bitset->m_data[m_index] : 0U;
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = size_t;
+			using difference_type = intmax_t;
+			using reference = size_t;
+			using pointer = void;
+
+			constexpr set_bit_iterator( ) noexcept = default;
+
+			constexpr set_bit_iterator( static_bitset const &bs, size_t index,
+			                            value_t bits ) noexcept
+			  : m_bitset( &bs )
+			  , m_index( index )
+			  , m_bits( bits ) {}
+
+			[[nodiscard]] constexpr size_t operator*( ) const noexcept {
+				return m_index * daw::bsizeof<value_t> +
+				       bitset_simd_impl::countr_zero( m_bits );
+			}
+
+			constexpr set_bit_iterator &operator++( ) noexcept {
+				m_bits &= m_bits - 1U;
+				if( m_bits == 0U ) {
+					next_element( );
+				}
+				return *this;
+			}
+
+			constexpr set_bit_iterator operator++( int ) noexcept {
+				auto result = *this;
+				operator++( );
+				return result;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator==( set_bit_iterator const &lhs,
+			            set_bit_iterator const &rhs ) noexcept {
+				return lhs.m_index == rhs.m_index and lhs.m_bits == rhs.m_bits;
+			}
+
+			[[nodiscard]] friend constexpr bool
+			operator!=( set_bit_iterator const &lhs,
+			            set_bit_iterator const &rhs ) noexcept {
+				return not( lhs == rhs );
+			}
+		};
+
+		struct set_bit_range {
+			set_bit_iterator first;
+			set_bit_iterator last;
+
+			[[nodiscard]] constexpr set_bit_iterator begin( ) const noexcept {
+				return first;
+			}
+
+			[[nodiscard]] constexpr set_bit_iterator end( ) const noexcept {
+				return last;
+			}
+		};
+
+		/// @return a range of the positions of the set bits, e.g.
+		/// for( size_t pos: bs.set_bits( ) )
+		[[nodiscard]] constexpr set_bit_range set_bits( ) const noexcept {
+			auto const index = find_nonzero( 0 );
+			auto const bits =
+			  index < m_element_capacity ? m_data[index] : value_t{ 0U };
+			return { set_bit_iterator( *this, index, bits ),
+			         set_bit_iterator( *this, m_element_capacity, 0U ) };
 		}
 
-		constexpr size_t zero_count( ) const noexcept {
-			return count_zeros( m_data );
+		/// @return the position of the lowest set bit, or size( ) when none are
+		[[nodiscard]] constexpr size_t find_first( ) const noexcept {
+			auto const index = find_nonzero( 0 );
+			if( index == m_element_capacity ) {
+				return BitWidth;
+			}
+			return index * daw::bsizeof<value_t> +
+			       bitset_simd_impl::countr_zero( m_data[index] );
+		}
+
+		/// @return the position of the lowest set bit after pos, or size( ) when
+		/// none are
+		[[nodiscard]] constexpr size_t find_next( size_t pos ) const noexcept {
+			++pos;
+			if( pos >= BitWidth ) {
+				return BitWidth;
+			}
+			auto const loc = get_address( pos );
+			// Keep the bits at or above pos
+			auto const bits = m_data[loc.index] & static_cast<value_t>( -loc.mask );
+			if( bits != 0U ) {
+				return loc.index * daw::bsizeof<value_t> +
+				       bitset_simd_impl::countr_zero( bits );
+			}
+			auto const index = find_nonzero( loc.index + 1U );
+			if( index == m_element_capacity ) {
+				return BitWidth;
+			}
+			return index * daw::bsizeof<value_t> +
+			       bitset_simd_impl::countr_zero( m_data[index] );
+		}
+
+		[[nodiscard]] constexpr bool any( ) const noexcept {
+			return find_nonzero( 0 ) != m_element_capacity;
+		}
+
+		[[nodiscard]] constexpr bool none( ) const noexcept {
+			return not any( );
+		}
+
+		[[nodiscard]] constexpr bool all( ) const noexcept {
+			return count( ) == BitWidth;
+		}
+
+		/// @return the number of set bits
+		[[nodiscard]] constexpr size_t count( ) const noexcept {
+			if constexpr( use_simd ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) ) {
+					return bitset_simd_impl::count( m_data.data( ), m_element_capacity );
+				}
+			}
+			return bitset_simd_impl::count_scalar( m_data.data( ),
+			                                       m_element_capacity );
+		}
+
+		[[nodiscard]] constexpr size_t one_count( ) const noexcept {
+			return count( );
+		}
+
+		[[nodiscard]] constexpr size_t zero_count( ) const noexcept {
+			return BitWidth - count( );
 		}
 
 		std::string to_string( bitset_impl::fmt_binary_t = fmt_binary ) const {
 			std::string result( BitWidth, '0' );
-			size_t pos = m_element_capacity - 1;
-			for( size_t index = 0; index < m_data.size( ); ++index ) {
-				auto value = m_data[index];
-				if( !value ) {
-					pos -= daw::bsizeof<value_t>;
-					continue;
-				}
-				while( value ) {
-					auto tmp = value & 1U;
-					if( tmp == 1 ) {
-						result[pos] = '1';
-					}
-					value >>= 1U;
-					--pos;
-				}
+			for( size_t pos : set_bits( ) ) {
+				result[BitWidth - 1U - pos] = '1';
 			}
 			return result;
 		}
@@ -318,34 +616,74 @@ namespace daw {
 			return result;
 		}
 
-		constexpr iterator begin( ) noexcept;
-		constexpr const_iterator begin( ) const noexcept;
-		constexpr const_iterator cbegin( ) const noexcept;
+		[[nodiscard]] constexpr iterator begin( ) noexcept {
+			return iterator( m_data.data( ), 0 );
+		}
+
+		[[nodiscard]] constexpr const_iterator begin( ) const noexcept {
+			return const_iterator( m_data.data( ), 0 );
+		}
+
+		[[nodiscard]] constexpr const_iterator cbegin( ) const noexcept {
+			return begin( );
+		}
+
+		[[nodiscard]] constexpr iterator end( ) noexcept {
+			return iterator( m_data.data( ),
+			                 static_cast<difference_type>( BitWidth ) );
+		}
+
+		[[nodiscard]] constexpr const_iterator end( ) const noexcept {
+			return const_iterator( m_data.data( ),
+			                       static_cast<difference_type>( BitWidth ) );
+		}
+
+		[[nodiscard]] constexpr const_iterator cend( ) const noexcept {
+			return end( );
+		}
+
+		[[nodiscard]] constexpr reverse_iterator rbegin( ) noexcept {
+			return reverse_iterator( end( ) );
+		}
+
+		[[nodiscard]] constexpr const_reverse_iterator rbegin( ) const noexcept {
+			return const_reverse_iterator( end( ) );
+		}
 
-		constexpr iterator end( ) noexcept;
-		constexpr const_iterator end( ) const noexcept;
-		constexpr const_iterator cend( ) const noexcept;
+		[[nodiscard]] constexpr const_reverse_iterator crbegin( ) const noexcept {
+			return rbegin( );
+		}
 
-		constexpr reverse_iterator rbegin( ) noexcept;
-		constexpr const_reverse_iterator rbegin( ) const noexcept;
-		constexpr const_reverse_iterator crbegin( ) const noexcept;
+		[[nodiscard]] constexpr reverse_iterator rend( ) noexcept {
+			return reverse_iterator( begin( ) );
+		}
 
-		constexpr reverse_iterator rend( ) noexcept;
-		constexpr const_reverse_iterator rend( ) const noexcept;
-		constexpr const_reverse_iterator crend( ) const noexcept;
+		[[nodiscard]] constexpr const_reverse_iterator rend( ) const noexcept {
+			return const_reverse_iterator( begin( ) );
+		}
 
-		constexpr reference operator[]( size_t index ) noexcept;
-		constexpr const_reference operator[]( size_t index ) const noexcept;
+		[[nodiscard]] constexpr const_reverse_iterator crend( ) const noexcept {
+			return rend( );
+		}
+
+		[[nodiscard]] constexpr reference operator[]( size_t index ) noexcept {
+			auto const loc = get_address( index );
+			return reference( m_data.data( ) + loc.index, loc.mask );
+		}
+
+		[[nodiscard]] constexpr const_reference
+		operator[]( size_t index ) const noexcept {
+			return get_bit( index );
+		}
 
 		// Bitwise operations
 
 		template<size_t BitWidthRhs>
-		constexpr static_bitset
+		constexpr static_bitset &
 		operator|=( static_bitset<BitWidthRhs> const &rhs ) noexcept {
-			size_t const SZ = std::min( m_data.size( ), rhs.m_data.size( ) );
-			for( size_t n = 0; n < SZ; ++n ) {
-				m_data[n] |= rhs.m_data[n];
-			}
+			bitwise<bitset_simd_impl::bit_op::or_op>(
+			  rhs.m_data.data( ), std::min( m_data.size( ), rhs.m_data.size( ) ) );
+			clear_unused_bits( );
 			return *this;
 		}
 
@@ -367,11 +705,8 @@ namespace daw {
 		constexpr static_bitset &
 		operator&=( static_bitset<BitWidthRhs> const &rhs ) noexcept {
 			size_t const SZ = std::min( m_data.size( ), rhs.m_data.size( ) );
-			size_t n = 0;
-			for( ; n < SZ; ++n ) {
-				m_data[n] &= rhs.m_data[n];
-			}
-			for( ; n < m_data.size( ); ++n ) {
+			bitwise<bitset_simd_impl::bit_op::and_op>( rhs.m_data.data( ), SZ );
+			for( size_t n = SZ; n < m_data.size( ); ++n ) {
 				m_data[n] = 0U;
 			}
 			return *this;
@@ -385,29 +720,55 @@ namespace daw {
 			return result;
 		}
 
+		template<size_t BitWidthRhs>
+		constexpr static_bitset &
+		operator^=( static_bitset<BitWidthRhs> const &rhs ) noexcept {
+			bitwise<bitset_simd_impl::bit_op::xor_op>(
+			  rhs.m_data.data( ), std::min( m_data.size( ), rhs.m_data.size( ) ) );
+			clear_unused_bits( );
+			return *this;
+		}
+
 		template<size_t BitWidthRhs>
 		constexpr static_bitset<std::max( BitWidth, BitWidthRhs )>
 		operator^( static_bitset<BitWidthRhs> const &rhs ) const noexcept {
-			static_bitset<std::max( BitWidth, BitWidthRhs )> result{ };
-			size_t n = 0;
-			for( ; n < m_data.size( ) and n < rhs.m_data.size( ); ++n ) {
-				result.m_data[n] = m_data[n] ^ rhs.m_data[n];
-			}
-			// A xor 0
-			for( ; n < m_data.size( ); ++n ) {
-				result.m_data[n] = m_data[n] ^ 0U;
+			if constexpr( BitWidth >= BitWidthRhs ) {
+				static_bitset result( *this );
+				result ^= rhs;
+				return result;
+			} else {
+				static_bitset<BitWidthRhs> result( rhs );
+				result ^= *this;
+				return result;
 			}
-			for( ; n < rhs.m_data.size( ); ++n ) {
-				result.m_data[n] = 0U ^ rhs.m_data[n];
+		}
+
+		/// Clear the bits that are set in rhs, *this & ~rhs without the
+		/// temporary
+		template<size_t BitWidthRhs>
+		constexpr static_bitset &
+		and_not( static_bitset<BitWidthRhs> const &rhs ) noexcept {
+			bitwise<bitset_simd_impl::bit_op::and_not_op>(
+			  rhs.m_data.data( ), std::min( m_data.size( ), rhs.m_data.size( ) ) );
+			return *this;
+		}
+
+		constexpr static_bitset &flip( ) noexcept {
+			if constexpr( use_simd ) {
+				if( not DAW_IS_CONSTANT_EVALUATED( ) ) {
+					bitset_simd_impl::flip( m_data.data( ), m_element_capacity );
+					clear_unused_bits( );
+					return *this;
+				}
 			}
-			return result;
+			bitset_simd_impl::flip_scalar( m_data.data( ), m_element_capacity );
+			clear_unused_bits( );
+			return *this;
 		}
 
 		constexpr static_bitset operator~( ) const noexcept {
-			static_bitset result{ };
-			for( size_t n = 0; n < m_data.size( ); ++n ) {
-				result.m_data[n] = ~m_data[n];
-			}
+			static_bitset result( *this );
+			result.flip( );
 			return result;
 		}
 
@@ -415,46 +776,24 @@ namespace daw {
 		constexpr bool
 		operator==( static_bitset<BitWidthRhs> const &rhs ) const noexcept {
 			size_t const last = std::min( m_data.size( ), rhs.m_data.size( ) );
-			size_t n = 0;
-			for( ; n < last; ++n ) {
-				if( m_data[n] != rhs.m_data[n] ) {
-					return false;
-				}
-			}
-			for( ; n < m_data.size( ); ++n ) {
-				if( m_data[n] != 0U ) {
-					return false;
-				}
-			}
-			for( ; n < rhs.m_data.size( ); ++n ) {
-				if( 0U != rhs.m_data[n] ) {
-					return false;
-				}
+			if( not daw::algorithm::equal( m_data.data( ), m_data.data( ) + last,
+			                               rhs.m_data.data( ) ) ) {
+				return false;
+			}
+			// Elements only one side has must be zero
+			if constexpr( BitWidth > BitWidthRhs ) {
+				return find_nonzero( last ) == m_element_capacity;
+			} else if constexpr( BitWidth < BitWidthRhs ) {
+				return rhs.find_nonzero( last ) == rhs.m_data.size( );
+			} else {
+				return true;
 			}
-			return true;
 		}
 
 		template<size_t BitWidthRhs>
 		constexpr bool
 		operator!=( static_bitset<BitWidthRhs> const &rhs ) const noexcept {
-			size_t const last = std::min( m_data.size( ), rhs.m_data.size( ) );
-			size_t n = 0;
-			for( ; n < last; ++n ) {
-				if( m_data[n] != rhs.m_data[n] ) {
-					return true;
-				}
-			}
-			for( ; n < m_data.size( ); ++n ) {
-				if( m_data[n] != 0U ) {
-					return true;
-				}
-			}
-			for( ; n < rhs.m_data.size( ); ++n ) {
-				if( 0U != rhs.m_data[n] ) {
-					return true;
-				}
-			}
-			return false;
+			return not( *this == rhs );
 		}
 
 		constexpr static_bitset &operator<<=( size_t bits ) noexcept {
@@ -462,30 +801,20 @@ namespace daw {
 				clear( );
 				return *this;
 			}
-			if( bits < bsizeof<value_t> ) {
-				value_t carry = 0U;
-				for( size_t n = 0; n < m_data.size( ); ++n ) {
-					value_t next_carry = ( m_data[n] & daw::mask_lsb<value_t>( bits ) ) >>
-					                     ( bsizeof<value_t> - bits );
-					m_data[n] <<= bits;
-					m_data[n] |= carry;
-					carry = next_carry;
-				}
-				return *this;
-			}
-			if( bits == bsizeof<value_t> ) {
-				for( size_t n = m_data.size( ); n > 0; --n ) {
-					auto pos = n - 1;
-					m_data[pos] = m_data[pos - 1];
+			size_t const elements = bits / bsizeof<value_t>;
+			size_t const shift = bits % bsizeof<value_t>;
+			for( size_t n = m_element_capacity; n-- > elements; ) {
+				value_t value = m_data[n - elements] << shift;
+				if( shift != 0 and n > elements ) {
+					value |= m_data[n - elements - 1U] >> ( bsizeof<value_t> - shift );
 				}
-				m_data[0] = 0U;
-				return *this;
+				m_data[n] = value;
 			}
-			while( bits >= bsizeof<value_t> ) {
-				operator<<=( bsizeof<value_t> );
-				bits -= bsizeof<value_t>;
+			for( size_t n = 0; n < elements; ++n ) {
+				m_data[n] = 0U;
 			}
-			return operator<<=( bits );
+			clear_unused_bits( );
+			return *this;
 		}
 
 		constexpr static_bitset &operator>>=( size_t bits ) noexcept {
@@ -493,33 +822,20 @@ namespace daw {
 				clear( );
 				return *this;
 			}
-			if( bits == 0U ) {
-				return *this;
-			}
-			if( bits < bsizeof<value_t> ) {
-				value_t carry = 0U;
-				for( size_t n = m_data.size( ); n > 0; --n ) {
-					auto const pos = n - 1;
-					value_t next_carry = ( m_data[pos] & daw::mask_msb<value_t>( bits ) )
-					                     << ( bsizeof<value_t> - bits );
-					m_data[pos] >>= bits;
-					m_data[pos] |= carry;
-					carry = next_carry;
+			size_t const elements = bits / bsizeof<value_t>;
+			size_t const shift = bits % bsizeof<value_t>;
+			size_t const kept = m_element_capacity - elements;
+			for( size_t n = 0; n < kept; ++n ) {
+				value_t value = m_data[n + elements] >> shift;
+				if( shift != 0 and n + elements + 1U < m_element_capacity ) {
+					value |= m_data[n + elements + 1U] << ( bsizeof<value_t> - shift );
 				}
-				return *this;
-			}
-			if( bits == bsizeof<value_t> ) {
-				for( size_t n = 0; n < m_data.size( ); ++n ) {
-					m_data[n] = m_data[n + 1];
-				}
-				m_data.back( ) = 0U;
-				return *this;
+				m_data[n] = value;
 			}
-			while( bits >= bsizeof<value_t> ) {
-				operator>>=( bsizeof<value_t> );
-				bits -= bsizeof<value_t>;
+			for( size_t n = kept; n < m_element_capacity; ++n ) {
+				m_data[n] = 0U;
 			}
-			return operator>>=( bits );
+			return *this;
 		}
 	};
 
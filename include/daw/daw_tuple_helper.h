@@ -18,7 +18,7 @@
 #include <ciso646>
 #include <cstddef>
 #include <functional>
-#include <iosfwd>
+#include <ostream>
 #include <string>
 #include <tuple>
 #include <utility>
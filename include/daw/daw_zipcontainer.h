@@ -11,51 +11,64 @@
 #include "iterator/daw_zipiter.h"
 
 #include <ciso646>
+#include <iterator>
+#include <tuple>
+#include <utility>
 
 namespace daw {
+	/***
+	 * Iterate several containers in step.  The containers are held by value,
+	 * pass views such as span to zip existing storage
+	 */
 	template<typename... Containers>
 	struct zip_container {
-		using iterator =
-		  zip_iterator<decltype( std::declval<Containers...>( ).begin( ) )>;
+		using iterator = zip_iterator<decltype(
+		  std::begin( std::declval<Containers &>( ) ) )...>;
 		using const_iterator = zip_iterator<decltype(
-		  std::declval<std::add_const_t<Containers>>( ).begin( ) )...>;
+		  std::begin( std::declval<Containers const &>( ) ) )...>;
 
 	private:
-		iterator m_begin;
-		iterator m_end;
+		std::tuple<Containers...> m_containers;
 
 	public:
 		zip_container( Containers... containers )
-		  : m_begin( make_zipiter( std::begin( containers )... ) )
-		  , m_end( make_zipiter( std::end( containers )... ) ) {}
+		  : m_containers( std::move( containers )... ) {}
 
 		iterator begin( ) {
-			return m_begin;
+			return std::apply(
+			  []( auto &...c ) { return iterator( std::begin( c )... ); },
+			  m_containers );
 		}
 
 		const_iterator begin( ) const {
-			return m_begin;
+			return std::apply(
+			  []( auto const &...c ) { return const_iterator( std::begin( c )... ); },
+			  m_containers );
 		}
 
 		const_iterator cbegin( ) const {
-			return m_begin;
+			return begin( );
 		}
 
 		iterator end( ) {
-			return m_end;
+			return std::apply(
+			  []( auto &...c ) { return iterator( std::end( c )... ); },
+			  m_containers );
 		}
 
 		const_iterator end( ) const {
-			return m_end;
+			return std::apply(
+			  []( auto const &...c ) { return const_iterator( std::end( c )... ); },
+			  m_containers );
 		}
 
 		const_iterator cend( ) const {
-			return m_end;
+			return end( );
 		}
 	}; // struct zip_container
 
 	template<typename... Containers>
 	zip_container<Containers...> make_zipcontainer( Containers... args ) {
-		return zip_container<Containers...>( args... );
+		return zip_container<Containers...>( std::move( args )... );
 	}
 } // namespace daw
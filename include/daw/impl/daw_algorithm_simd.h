@@ -0,0 +1,492 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_simd_dispatch.h"
+
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/***
+ * Runtime fast paths for the daw::algorithm primitives over contiguous ranges
+ * of arithmetic values.  The AVX2 kernels are chosen when the CPU supports
+ * them, callers fall back to their constexpr loops otherwise
+ */
+namespace daw::algorithm_simd_impl {
+	template<typename T>
+	inline constexpr bool is_simd_value_v =
+	  ( std::is_integral_v<T> and not std::is_same_v<T, bool> ) or
+	  ( std::is_floating_point_v<T> and std::numeric_limits<T>::is_iec559 and
+	    ( sizeof( T ) == 4 or sizeof( T ) == 8 ) );
+
+	template<typename Iterator>
+	inline constexpr bool is_simd_range_v =
+	  simd_impl::is_contiguous_iterator_v<Iterator> and
+	  is_simd_value_v<simd_impl::iter_value_t<Iterator>>;
+
+	// Summing with more than one accumulator reorders the additions, so only
+	// integers whose sum wraps the same either way qualify
+	template<typename Iterator, typename T>
+	inline constexpr bool is_simd_sum_v =
+	  is_simd_range_v<Iterator> and std::is_integral_v<T> and
+	  std::is_same_v<T, simd_impl::iter_value_t<Iterator>> and
+	  ( sizeof( T ) == 4 or sizeof( T ) == 8 );
+
+	template<typename Iterator>
+	inline constexpr bool is_simd_minmax_v =
+	  is_simd_range_v<Iterator> and
+	  std::is_integral_v<simd_impl::iter_value_t<Iterator>>;
+
+	// Two ranges of the same element type given by iterator pairs
+	template<typename Iterator1, typename Last1, typename Iterator2,
+	         typename Last2>
+	inline constexpr bool is_simd_pair_v =
+	  std::is_same_v<Iterator1, Last1> and std::is_same_v<Iterator2, Last2> and
+	  is_simd_range_v<Iterator1> and is_simd_range_v<Iterator2> and
+	  std::is_same_v<simd_impl::iter_value_t<Iterator1>,
+	                 simd_impl::iter_value_t<Iterator2>>;
+
+	template<typename InputIterator, typename OutputIterator>
+	inline constexpr bool is_simd_transform_v =
+	  is_simd_range_v<InputIterator> and is_simd_range_v<OutputIterator>;
+
+	template<typename Compare, typename T>
+	inline constexpr bool is_equal_to_v =
+	  std::is_same_v<Compare, std::equal_to<>> or
+	  std::is_same_v<Compare, std::equal_to<T>>;
+
+	template<typename Compare, typename T>
+	inline constexpr bool is_less_v = std::is_same_v<Compare, std::less<>> or
+	                                  std::is_same_v<Compare, std::less<T>>;
+
+	template<typename Op, typename T>
+	inline constexpr bool is_plus_v =
+	  std::is_same_v<Op, std::plus<>> or std::is_same_v<Op, std::plus<T>>;
+
+	/***
+	 * Sum with four independent accumulators so the additions are not one
+	 * long dependency chain.  This is also what the compiler vectorizes for
+	 * the baseline instruction set
+	 */
+	template<typename T>
+	[[nodiscard]] T sum_scalar( T const *ptr, std::size_t size, T init ) {
+		using uint_t = std::make_unsigned_t<T>;
+		uint_t acc[4] = { static_cast<uint_t>( init ), 0, 0, 0 };
+		std::size_t const unrolled = size - size % 4U;
+		std::size_t n = 0;
+		for( ; n < unrolled; n += 4U ) {
+			acc[0] += static_cast<uint_t>( ptr[n] );
+			acc[1] += static_cast<uint_t>( ptr[n + 1] );
+			acc[2] += static_cast<uint_t>( ptr[n + 2] );
+			acc[3] += static_cast<uint_t>( ptr[n + 3] );
+		}
+		for( ; n < size; ++n ) {
+			acc[0] += static_cast<uint_t>( ptr[n] );
+		}
+		return static_cast<T>( acc[0] + acc[1] + acc[2] + acc[3] );
+	}
+
+#if defined( DAW_HAS_SIMD_DISPATCH )
+	template<typename T>
+	DAW_TARGET_AVX2 inline __m256i load( T const *ptr ) {
+		return _mm256_loadu_si256( reinterpret_cast<__m256i const *>( ptr ) );
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 inline __m256i broadcast( T value ) {
+		if constexpr( std::is_same_v<T, float> ) {
+			return _mm256_castps_si256( _mm256_set1_ps( value ) );
+		} else if constexpr( std::is_same_v<T, double> ) {
+			return _mm256_castpd_si256( _mm256_set1_pd( value ) );
+		} else if constexpr( sizeof( T ) == 1 ) {
+			return _mm256_set1_epi8( static_cast<char>( value ) );
+		} else if constexpr( sizeof( T ) == 2 ) {
+			return _mm256_set1_epi16( static_cast<short>( value ) );
+		} else if constexpr( sizeof( T ) == 4 ) {
+			return _mm256_set1_epi32( static_cast<int>( value ) );
+		} else {
+			return _mm256_set1_epi64x( static_cast<long long>( value ) );
+		}
+	}
+
+	/***
+	 * @return a mask with the bytes of each lane where lhs == rhs set.  Floats
+	 * use an ordered compare so NaN is never equal and -0.0 equals 0.0
+	 */
+	template<typename T>
+	DAW_TARGET_AVX2 inline std::uint32_t eq_mask( __m256i lhs, __m256i rhs ) {
+		if constexpr( std::is_same_v<T, float> ) {
+			return static_cast<std::uint32_t>(
+			  _mm256_movemask_epi8( _mm256_castps_si256( _mm256_cmp_ps(
+			    _mm256_castsi256_ps( lhs ), _mm256_castsi256_ps( rhs ),
+			    _CMP_EQ_OQ ) ) ) );
+		} else if constexpr( std::is_same_v<T, double> ) {
+			return static_cast<std::uint32_t>(
+			  _mm256_movemask_epi8( _mm256_castpd_si256( _mm256_cmp_pd(
+			    _mm256_castsi256_pd( lhs ), _mm256_castsi256_pd( rhs ),
+			    _CMP_EQ_OQ ) ) ) );
+		} else if constexpr( sizeof( T ) == 1 ) {
+			return static_cast<std::uint32_t>(
+			  _mm256_movemask_epi8( _mm256_cmpeq_epi8( lhs, rhs ) ) );
+		} else if constexpr( sizeof( T ) == 2 ) {
+			return static_cast<std::uint32_t>(
+			  _mm256_movemask_epi8( _mm256_cmpeq_epi16( lhs, rhs ) ) );
+		} else if constexpr( sizeof( T ) == 4 ) {
+			return static_cast<std::uint32_t>(
+			  _mm256_movemask_epi8( _mm256_cmpeq_epi32( lhs, rhs ) ) );
+		} else {
+			return static_cast<std::uint32_t>(
+			  _mm256_movemask_epi8( _mm256_cmpeq_epi64( lhs, rhs ) ) );
+		}
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 std::size_t find_avx2( T const *ptr, std::size_t size,
+	                                       T value ) {
+		constexpr std::size_t width = 32U / sizeof( T );
+		auto const needle = broadcast( value );
+		std::size_t n = 0;
+		for( ; n + 2U * width <= size; n += 2U * width ) {
+			auto const m0 = eq_mask<T>( load( ptr + n ), needle );
+			auto const m1 = eq_mask<T>( load( ptr + n + width ), needle );
+			if( ( m0 | m1 ) != 0 ) {
+				if( m0 != 0 ) {
+					return n + static_cast<std::size_t>( __builtin_ctz( m0 ) ) /
+					             sizeof( T );
+				}
+				return n + width +
+				       static_cast<std::size_t>( __builtin_ctz( m1 ) ) / sizeof( T );
+			}
+		}
+		for( ; n < size; ++n ) {
+			if( ptr[n] == value ) {
+				return n;
+			}
+		}
+		return size;
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 std::size_t find_last_avx2( T const *ptr, std::size_t size,
+	                                            T value ) {
+		constexpr std::size_t width = 32U / sizeof( T );
+		auto const needle = broadcast( value );
+		std::size_t n = size;
+		for( ; n >= width; n -= width ) {
+			auto const m = eq_mask<T>( load( ptr + n - width ), needle );
+			if( m != 0 ) {
+				return n - width +
+				       static_cast<std::size_t>( 31 - __builtin_clz( m ) ) /
+				         sizeof( T );
+			}
+		}
+		while( n > 0 ) {
+			--n;
+			if( ptr[n] == value ) {
+				return n;
+			}
+		}
+		return size;
+	}
+
+	/***
+	 * @return the index of the first position where lhs and rhs differ, or
+	 * size
+	 */
+	template<typename T>
+	DAW_TARGET_AVX2 std::size_t mismatch_avx2( T const *lhs, T const *rhs,
+	                                           std::size_t size ) {
+		constexpr std::size_t width = 32U / sizeof( T );
+		std::size_t n = 0;
+		for( ; n + 2U * width <= size; n += 2U * width ) {
+			auto const m0 = ~eq_mask<T>( load( lhs + n ), load( rhs + n ) );
+			auto const m1 =
+			  ~eq_mask<T>( load( lhs + n + width ), load( rhs + n + width ) );
+			if( ( m0 | m1 ) != 0 ) {
+				if( m0 != 0 ) {
+					return n + static_cast<std::size_t>( __builtin_ctz( m0 ) ) /
+					             sizeof( T );
+				}
+				return n + width +
+				       static_cast<std::size_t>( __builtin_ctz( m1 ) ) / sizeof( T );
+			}
+		}
+		for( ; n < size; ++n ) {
+			if( not( lhs[n] == rhs[n] ) ) {
+				return n;
+			}
+		}
+		return size;
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 inline __m256i vmin( __m256i a, __m256i b ) {
+		if constexpr( sizeof( T ) == 1 ) {
+			return std::is_signed_v<T> ? _mm256_min_epi8( a, b )
+			                           : _mm256_min_epu8( a, b );
+		} else if constexpr( sizeof( T ) == 2 ) {
+			return std::is_signed_v<T> ? _mm256_min_epi16( a, b )
+			                           : _mm256_min_epu16( a, b );
+		} else if constexpr( sizeof( T ) == 4 ) {
+			return std::is_signed_v<T> ? _mm256_min_epi32( a, b )
+			                           : _mm256_min_epu32( a, b );
+		} else {
+			// 64bit values are kept with the sign bit flipped when unsigned
+			return _mm256_blendv_epi8( a, b, _mm256_cmpgt_epi64( a, b ) );
+		}
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 inline __m256i vmax( __m256i a, __m256i b ) {
+		if constexpr( sizeof( T ) == 1 ) {
+			return std::is_signed_v<T> ? _mm256_max_epi8( a, b )
+			                           : _mm256_max_epu8( a, b );
+		} else if constexpr( sizeof( T ) == 2 ) {
+			return std::is_signed_v<T> ? _mm256_max_epi16( a, b )
+			                           : _mm256_max_epu16( a, b );
+		} else if constexpr( sizeof( T ) == 4 ) {
+			return std::is_signed_v<T> ? _mm256_max_epi32( a, b )
+			                           : _mm256_max_epu32( a, b );
+		} else {
+			return _mm256_blendv_epi8( b, a, _mm256_cmpgt_epi64( a, b ) );
+		}
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 inline __m256i minmax_bias( ) {
+		if constexpr( sizeof( T ) == 8 and std::is_unsigned_v<T> ) {
+			return _mm256_set1_epi64x(
+			  static_cast<long long>( std::uint64_t{ 1 } << 63U ) );
+		} else {
+			return _mm256_setzero_si256( );
+		}
+	}
+
+	/***
+	 * The minimum and maximum values of a non-empty range.  Two pairs of
+	 * accumulators are used to hide the min/max latency
+	 */
+	template<typename T>
+	DAW_TARGET_AVX2 std::pair<T, T> minmax_value_avx2( T const *ptr,
+	                                                   std::size_t size ) {
+		constexpr std::size_t width = 32U / sizeof( T );
+		T lo = ptr[0];
+		T hi = ptr[0];
+		std::size_t n = 0;
+		if( size >= 2U * width ) {
+			auto const bias = minmax_bias<T>( );
+			auto min0 = _mm256_xor_si256( load( ptr ), bias );
+			auto min1 = _mm256_xor_si256( load( ptr + width ), bias );
+			auto max0 = min0;
+			auto max1 = min1;
+			for( n = 2U * width; n + 2U * width <= size; n += 2U * width ) {
+				auto const v0 = _mm256_xor_si256( load( ptr + n ), bias );
+				auto const v1 = _mm256_xor_si256( load( ptr + n + width ), bias );
+				min0 = vmin<T>( min0, v0 );
+				min1 = vmin<T>( min1, v1 );
+				max0 = vmax<T>( max0, v0 );
+				max1 = vmax<T>( max1, v1 );
+			}
+			alignas( 32 ) T mins[width];
+			alignas( 32 ) T maxs[width];
+			_mm256_store_si256( reinterpret_cast<__m256i *>( mins ),
+			                    _mm256_xor_si256( vmin<T>( min0, min1 ), bias ) );
+			_mm256_store_si256( reinterpret_cast<__m256i *>( maxs ),
+			                    _mm256_xor_si256( vmax<T>( max0, max1 ), bias ) );
+			lo = mins[0];
+			hi = maxs[0];
+			for( std::size_t l = 1; l < width; ++l ) {
+				lo = mins[l] < lo ? mins[l] : lo;
+				hi = hi < maxs[l] ? maxs[l] : hi;
+			}
+		}
+		for( ; n < size; ++n ) {
+			lo = ptr[n] < lo ? ptr[n] : lo;
+			hi = hi < ptr[n] ? ptr[n] : hi;
+		}
+		return { lo, hi };
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 inline __m256i vadd( __m256i a, __m256i b ) {
+		if constexpr( sizeof( T ) == 4 ) {
+			return _mm256_add_epi32( a, b );
+		} else {
+			return _mm256_add_epi64( a, b );
+		}
+	}
+
+	template<typename T>
+	DAW_TARGET_AVX2 T sum_avx2( T const *ptr, std::size_t size, T init ) {
+		constexpr std::size_t width = 32U / sizeof( T );
+		__m256i acc[4] = { _mm256_setzero_si256( ), _mm256_setzero_si256( ),
+		                   _mm256_setzero_si256( ), _mm256_setzero_si256( ) };
+		std::size_t n = 0;
+		for( ; n + 4U * width <= size; n += 4U * width ) {
+			acc[0] = vadd<T>( acc[0], load( ptr + n ) );
+			acc[1] = vadd<T>( acc[1], load( ptr + n + width ) );
+			acc[2] = vadd<T>( acc[2], load( ptr + n + 2U * width ) );
+			acc[3] = vadd<T>( acc[3], load( ptr + n + 3U * width ) );
+		}
+		alignas( 32 ) T lanes[width];
+		_mm256_store_si256(
+		  reinterpret_cast<__m256i *>( lanes ),
+		  vadd<T>( vadd<T>( acc[0], acc[1] ), vadd<T>( acc[2], acc[3] ) ) );
+		using uint_t = std::make_unsigned_t<T>;
+		auto total = static_cast<uint_t>( init );
+		for( auto v : lanes ) {
+			total += static_cast<uint_t>( v );
+		}
+		return sum_scalar( ptr + n, size - n, static_cast<T>( total ) );
+	}
+
+	/***
+	 * The same loop built for AVX2.  unary_op may keep state between calls,
+	 * so the compiler only vectorizes what it can prove is independent
+	 */
+	template<typename T, typename U, typename UnaryOperation>
+	DAW_TARGET_AVX2 void transform_avx2( T *first, U *first_out,
+	                                     std::size_t count,
+	                                     UnaryOperation &unary_op ) {
+		for( std::size_t n = 0; n < count; ++n ) {
+			first_out[n] = unary_op( first[n] );
+		}
+	}
+#endif
+
+	/***
+	 * @return index of the first element equal to value or size
+	 */
+	template<typename T>
+	[[nodiscard]] std::size_t find( T const *ptr, std::size_t size, T value ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			return find_avx2( ptr, size, value );
+		}
+#endif
+		for( std::size_t n = 0; n < size; ++n ) {
+			if( ptr[n] == value ) {
+				return n;
+			}
+		}
+		return size;
+	}
+
+	template<typename T>
+	[[nodiscard]] std::size_t mismatch( T const *lhs, T const *rhs,
+	                                    std::size_t size ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			return mismatch_avx2( lhs, rhs, size );
+		}
+#endif
+		for( std::size_t n = 0; n < size; ++n ) {
+			if( not( lhs[n] == rhs[n] ) ) {
+				return n;
+			}
+		}
+		return size;
+	}
+
+	/***
+	 * Like std::lexicographical_compare with std::less.  Elements that are
+	 * neither less nor greater, such as NaN, are skipped as the scalar loop
+	 * does
+	 */
+	template<typename T>
+	[[nodiscard]] bool lexicographical_compare( T const *lhs, std::size_t lsize,
+	                                            T const *rhs,
+	                                            std::size_t rsize ) {
+		if constexpr( sizeof( T ) == 1 and std::is_unsigned_v<T> ) {
+			auto const size = lsize < rsize ? lsize : rsize;
+			auto const cmp = size == 0 ? 0 : std::memcmp( lhs, rhs, size );
+			return cmp != 0 ? cmp < 0 : lsize < rsize;
+		} else {
+			auto const size = lsize < rsize ? lsize : rsize;
+			std::size_t pos = 0;
+			while( true ) {
+				pos += mismatch( lhs + pos, rhs + pos, size - pos );
+				if( pos == size ) {
+					return lsize < rsize;
+				}
+				if( lhs[pos] < rhs[pos] ) {
+					return true;
+				}
+				if( rhs[pos] < lhs[pos] ) {
+					return false;
+				}
+				++pos;
+			}
+		}
+	}
+
+	/***
+	 * @return indices of the first smallest and last largest elements of a
+	 * non-empty range, as std::minmax_element
+	 */
+	template<typename T>
+	[[nodiscard]] std::optional<std::pair<std::size_t, std::size_t>>
+	minmax_element( T const *ptr, std::size_t size ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			auto const [lo, hi] = minmax_value_avx2( ptr, size );
+			return std::pair<std::size_t, std::size_t>(
+			  find_avx2( ptr, size, lo ), find_last_avx2( ptr, size, hi ) );
+		}
+#endif
+		(void)ptr;
+		(void)size;
+		return std::nullopt;
+	}
+
+	template<typename T>
+	[[nodiscard]] T accumulate( T const *ptr, std::size_t size, T init ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			return sum_avx2( ptr, size, init );
+		}
+#endif
+		return sum_scalar( ptr, size, init );
+	}
+
+	/***
+	 * Transform between arrays that do not partially overlap.
+	 * @return false when the ranges overlap and nothing was done
+	 */
+	template<typename T, typename U, typename UnaryOperation>
+	[[nodiscard]] bool transform( T *first, U *first_out,
+	                              std::size_t count,
+	                              UnaryOperation &unary_op ) {
+		auto const in_first = reinterpret_cast<std::uintptr_t>( first );
+		auto const in_last = in_first + count * sizeof( T );
+		auto const out_first = reinterpret_cast<std::uintptr_t>( first_out );
+		auto const out_last = out_first + count * sizeof( U );
+		bool const same = in_first == out_first and sizeof( T ) == sizeof( U );
+		if( not same and in_first < out_last and out_first < in_last ) {
+			return false;
+		}
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			transform_avx2( first, first_out, count, unary_op );
+			return true;
+		}
+#endif
+		for( std::size_t n = 0; n < count; ++n ) {
+			first_out[n] = unary_op( first[n] );
+		}
+		return true;
+	}
+} // namespace daw::algorithm_simd_impl
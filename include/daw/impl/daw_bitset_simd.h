@@ -0,0 +1,246 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "daw_simd_dispatch.h"
+
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+
+/***
+ * Kernels over arrays of 64 bit words for daw::static_bitset.  The AVX2 ones
+ * are chosen at runtime when the CPU supports them, the constexpr loops are
+ * used otherwise and in constant evaluation
+ */
+namespace daw::bitset_simd_impl {
+	enum class bit_op { and_op, or_op, xor_op, and_not_op };
+
+	[[nodiscard]] constexpr std::size_t popcount( std::uint64_t value ) noexcept {
+#if defined( __GNUC__ ) or defined( __clang__ )
+		return static_cast<std::size_t>( __builtin_popcountll( value ) );
+#else
+		std::size_t count = 0;
+		while( value != 0U ) {
+			value &= value - 1U;
+			++count;
+		}
+		return count;
+#endif
+	}
+
+	// The index of the lowest set bit.  value must not be zero
+	[[nodiscard]] constexpr std::size_t
+	countr_zero( std::uint64_t value ) noexcept {
+#if defined( __GNUC__ ) or defined( __clang__ )
+		// Emitted as rep bsf, which runs as tzcnt on CPUs that have it
+		return static_cast<std::size_t>( __builtin_ctzll( value ) );
+#else
+		std::size_t count = 0;
+		while( ( value & 1U ) == 0U ) {
+			value >>= 1U;
+			++count;
+		}
+		return count;
+#endif
+	}
+
+	template<bit_op Op>
+	[[nodiscard]] constexpr std::uint64_t apply( std::uint64_t lhs,
+	                                             std::uint64_t rhs ) noexcept {
+		if constexpr( Op == bit_op::and_op ) {
+			return lhs & rhs;
+		} else if constexpr( Op == bit_op::or_op ) {
+			return lhs | rhs;
+		} else if constexpr( Op == bit_op::xor_op ) {
+			return lhs ^ rhs;
+		} else {
+			return lhs & ~rhs;
+		}
+	}
+
+	template<bit_op Op>
+	constexpr void bitwise_scalar( std::uint64_t *dst, std::uint64_t const *src,
+	                               std::size_t size ) noexcept {
+		for( std::size_t n = 0; n < size; ++n ) {
+			dst[n] = apply<Op>( dst[n], src[n] );
+		}
+	}
+
+	constexpr void flip_scalar( std::uint64_t *dst, std::size_t size ) noexcept {
+		for( std::size_t n = 0; n < size; ++n ) {
+			dst[n] = ~dst[n];
+		}
+	}
+
+	[[nodiscard]] constexpr std::size_t
+	count_scalar( std::uint64_t const *words, std::size_t size ) noexcept {
+		std::size_t count = 0;
+		for( std::size_t n = 0; n < size; ++n ) {
+			count += popcount( words[n] );
+		}
+		return count;
+	}
+
+	// The index of the first non-zero word in [first, size), or size
+	[[nodiscard]] constexpr std::size_t
+	find_nonzero_scalar( std::uint64_t const *words, std::size_t first,
+	                     std::size_t size ) noexcept {
+		while( first < size and words[first] == 0U ) {
+			++first;
+		}
+		return first;
+	}
+
+#if defined( DAW_HAS_SIMD_DISPATCH )
+// popcnt and tzcnt are on every CPU that has AVX2
+#define DAW_TARGET_AVX2_BITS __attribute__( ( target( "avx2,popcnt,bmi" ) ) )
+
+	DAW_TARGET_AVX2_BITS inline __m256i load_words( std::uint64_t const *p ) {
+		return _mm256_loadu_si256( reinterpret_cast<__m256i const *>( p ) );
+	}
+
+	template<bit_op Op>
+	DAW_TARGET_AVX2_BITS void bitwise_avx2( std::uint64_t *dst,
+	                                        std::uint64_t const *src,
+	                                        std::size_t size ) {
+		std::size_t const vector_last = size - size % 4U;
+		std::size_t n = 0;
+		for( ; n < vector_last; n += 4U ) {
+			__m256i const lhs = load_words( dst + n );
+			__m256i const rhs = load_words( src + n );
+			__m256i result;
+			if constexpr( Op == bit_op::and_op ) {
+				result = _mm256_and_si256( lhs, rhs );
+			} else if constexpr( Op == bit_op::or_op ) {
+				result = _mm256_or_si256( lhs, rhs );
+			} else if constexpr( Op == bit_op::xor_op ) {
+				result = _mm256_xor_si256( lhs, rhs );
+			} else {
+				result = _mm256_andnot_si256( rhs, lhs );
+			}
+			_mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + n ), result );
+		}
+		for( ; n < size; ++n ) {
+			dst[n] = apply<Op>( dst[n], src[n] );
+		}
+	}
+
+	DAW_TARGET_AVX2_BITS inline void flip_avx2( std::uint64_t *dst,
+	                                            std::size_t size ) {
+		__m256i const ones = _mm256_set1_epi64x( -1 );
+		std::size_t const vector_last = size - size % 4U;
+		std::size_t n = 0;
+		for( ; n < vector_last; n += 4U ) {
+			_mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + n ),
+			                     _mm256_xor_si256( load_words( dst + n ), ones ) );
+		}
+		for( ; n < size; ++n ) {
+			dst[n] = ~dst[n];
+		}
+	}
+
+	/***
+	 * Count with a nibble lookup table, summing the per byte counts with
+	 * vpsadbw before they can overflow
+	 */
+	DAW_TARGET_AVX2_BITS inline std::size_t
+	count_avx2( std::uint64_t const *words, std::size_t size ) {
+		__m256i const lookup =
+		  _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+		                    1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+		__m256i const low_mask = _mm256_set1_epi8( 0x0F );
+		__m256i total = _mm256_setzero_si256( );
+		std::size_t const vector_last = size - size % 4U;
+		std::size_t n = 0;
+		while( n < vector_last ) {
+			// Each iteration adds at most 8 to a byte
+			std::size_t const block_last =
+			  vector_last - n > 4U * 31U ? n + 4U * 31U : vector_last;
+			__m256i local = _mm256_setzero_si256( );
+			for( ; n < block_last; n += 4U ) {
+				__m256i const v = load_words( words + n );
+				__m256i const lo = _mm256_and_si256( v, low_mask );
+				__m256i const hi =
+				  _mm256_and_si256( _mm256_srli_epi16( v, 4 ), low_mask );
+				local = _mm256_add_epi8(
+				  local, _mm256_add_epi8( _mm256_shuffle_epi8( lookup, lo ),
+				                          _mm256_shuffle_epi8( lookup, hi ) ) );
+			}
+			total = _mm256_add_epi64(
+			  total, _mm256_sad_epu8( local, _mm256_setzero_si256( ) ) );
+		}
+		auto count = static_cast<std::size_t>(
+		  static_cast<std::uint64_t>( _mm256_extract_epi64( total, 0 ) ) +
+		  static_cast<std::uint64_t>( _mm256_extract_epi64( total, 1 ) ) +
+		  static_cast<std::uint64_t>( _mm256_extract_epi64( total, 2 ) ) +
+		  static_cast<std::uint64_t>( _mm256_extract_epi64( total, 3 ) ) );
+		for( ; n < size; ++n ) {
+			count += static_cast<std::size_t>( __builtin_popcountll( words[n] ) );
+		}
+		return count;
+	}
+
+	DAW_TARGET_AVX2_BITS inline std::size_t
+	find_nonzero_avx2( std::uint64_t const *words, std::size_t first,
+	                   std::size_t size ) {
+		std::size_t const vector_last = size - ( size - first ) % 4U;
+		for( ; first < vector_last; first += 4U ) {
+			__m256i const v = load_words( words + first );
+			if( not _mm256_testz_si256( v, v ) ) {
+				break;
+			}
+		}
+		return find_nonzero_scalar( words, first, size );
+	}
+#endif
+
+	template<bit_op Op>
+	void bitwise( std::uint64_t *dst, std::uint64_t const *src,
+	              std::size_t size ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			bitwise_avx2<Op>( dst, src, size );
+			return;
+		}
+#endif
+		bitwise_scalar<Op>( dst, src, size );
+	}
+
+	inline void flip( std::uint64_t *dst, std::size_t size ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			flip_avx2( dst, size );
+			return;
+		}
+#endif
+		flip_scalar( dst, size );
+	}
+
+	[[nodiscard]] inline std::size_t count( std::uint64_t const *words,
+	                                        std::size_t size ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			return count_avx2( words, size );
+		}
+#endif
+		return count_scalar( words, size );
+	}
+
+	[[nodiscard]] inline std::size_t find_nonzero( std::uint64_t const *words,
+	                                               std::size_t first,
+	                                               std::size_t size ) {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+		if( simd_impl::has_avx2( ) ) {
+			return find_nonzero_avx2( words, first, size );
+		}
+#endif
+		return find_nonzero_scalar( words, first, size );
+	}
+} // namespace daw::bitset_simd_impl
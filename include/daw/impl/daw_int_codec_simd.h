@@ -0,0 +1,445 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+// SSE2 is part of x86_64, so unlike the AVX2 kernels these need no dispatch
+#if defined( __SSE2__ )
+#define DAW_HAS_INT_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+#if defined( __BMI2__ )
+#include <immintrin.h>
+#endif
+
+// Fully unrolled, the shifts and word offsets of the block loops are constants
+#if defined( __GNUC__ ) or defined( __clang__ )
+#define DAW_UNROLL_BLOCK_LOOP _Pragma( "GCC unroll 64" )
+#else
+#define DAW_UNROLL_BLOCK_LOOP
+#endif
+
+/***
+ * Block kernels for daw_int_codec.h.  A block is 128 values split into
+ * 16 / sizeof( T ) lanes, value n going to lane n % lanes.  Each lane packs
+ * its values into bits words of T and the words of the lanes are
+ * interleaved, so one 128 bit register holds a word of every lane and the
+ * SSE2 and scalar kernels produce the same bytes
+ */
+namespace daw::int_codec_impl {
+	inline constexpr std::size_t block_size = 128;
+
+	template<typename T>
+	inline constexpr std::size_t word_bits = sizeof( T ) * 8U;
+
+	template<typename T>
+	inline constexpr std::size_t lane_count = 16U / sizeof( T );
+
+	template<typename T>
+	[[nodiscard]] constexpr T low_mask( std::size_t bits ) noexcept {
+		if( bits >= word_bits<T> ) {
+			return std::numeric_limits<T>::max( );
+		}
+		return static_cast<T>( ( T{ 1 } << bits ) - 1U );
+	}
+
+	// The number of bits needed to hold value
+	template<typename T>
+	[[nodiscard]] constexpr unsigned bit_width( T value ) noexcept {
+#if defined( __GNUC__ ) or defined( __clang__ )
+		if( value == 0 ) {
+			return 0;
+		}
+		return static_cast<unsigned>(
+		  64 - __builtin_clzll( static_cast<unsigned long long>( value ) ) );
+#else
+		unsigned result = 0;
+		while( value != 0 ) {
+			value >>= 1U;
+			++result;
+		}
+		return result;
+#endif
+	}
+
+	// The index of the lowest set bit.  value must not be zero
+	[[nodiscard]] constexpr std::size_t
+	countr_zero( std::uint64_t value ) noexcept {
+#if defined( __GNUC__ ) or defined( __clang__ )
+		return static_cast<std::size_t>( __builtin_ctzll( value ) );
+#else
+		std::size_t count = 0;
+		while( ( value & 1U ) == 0U ) {
+			value >>= 1U;
+			++count;
+		}
+		return count;
+#endif
+	}
+
+	template<typename T>
+	[[nodiscard]] constexpr T zigzag_encode( T value ) noexcept {
+		T const sign = static_cast<T>( 0U - ( value >> ( word_bits<T> - 1U ) ) );
+		return static_cast<T>( static_cast<T>( value << 1U ) ^ sign );
+	}
+
+	template<typename T>
+	[[nodiscard]] constexpr T zigzag_decode( T value ) noexcept {
+		T const sign = static_cast<T>( 0U - ( value & 1U ) );
+		return static_cast<T>( ( value >> 1U ) ^ sign );
+	}
+
+	/***
+	 * One lane at a time in a general purpose register.  Words are copied
+	 * byte wise as the encoded buffer has no alignment
+	 */
+	template<typename T>
+	struct scalar_ops {
+		using vec = T;
+		static constexpr std::size_t lanes = lane_count<T>;
+
+		std::size_t lane;
+
+		static constexpr vec zero( ) noexcept {
+			return 0;
+		}
+
+		static constexpr vec broadcast( T value ) noexcept {
+			return value;
+		}
+
+		static constexpr vec bit_and( vec lhs, vec rhs ) noexcept {
+			return lhs & rhs;
+		}
+
+		static constexpr vec bit_or( vec lhs, vec rhs ) noexcept {
+			return lhs | rhs;
+		}
+
+		static constexpr vec shift_left( vec value, std::size_t n ) noexcept {
+			return static_cast<vec>( value << n );
+		}
+
+		static constexpr vec shift_right( vec value, std::size_t n ) noexcept {
+			return static_cast<vec>( value >> n );
+		}
+
+		vec load_value( T const *values, std::size_t n ) const noexcept {
+			return values[n * lanes + lane];
+		}
+
+		void store_value( T *values, std::size_t n, vec value ) const noexcept {
+			values[n * lanes + lane] = value;
+		}
+
+		vec load_word( unsigned char const *words, std::size_t n ) const noexcept {
+			vec result;
+			std::memcpy( &result, words + ( n * lanes + lane ) * sizeof( T ),
+			             sizeof( T ) );
+			return result;
+		}
+
+		void store_word( unsigned char *words, std::size_t n,
+		                 vec value ) const noexcept {
+			std::memcpy( words + ( n * lanes + lane ) * sizeof( T ), &value,
+			             sizeof( T ) );
+		}
+	};
+
+#if defined( DAW_HAS_INT_CODEC_SSE2 )
+	// Every lane at once
+	template<typename T>
+	struct sse2_ops {
+		using vec = __m128i;
+		static constexpr std::size_t lanes = lane_count<T>;
+
+		static vec zero( ) noexcept {
+			return _mm_setzero_si128( );
+		}
+
+		static vec broadcast( T value ) noexcept {
+			if constexpr( sizeof( T ) == 4 ) {
+				return _mm_set1_epi32( static_cast<int>( value ) );
+			} else {
+				return _mm_set1_epi64x( static_cast<long long>( value ) );
+			}
+		}
+
+		static vec bit_and( vec lhs, vec rhs ) noexcept {
+			return _mm_and_si128( lhs, rhs );
+		}
+
+		static vec bit_or( vec lhs, vec rhs ) noexcept {
+			return _mm_or_si128( lhs, rhs );
+		}
+
+		static vec shift_left( vec value, std::size_t n ) noexcept {
+			if constexpr( sizeof( T ) == 4 ) {
+				return _mm_slli_epi32( value, static_cast<int>( n ) );
+			} else {
+				return _mm_slli_epi64( value, static_cast<int>( n ) );
+			}
+		}
+
+		static vec shift_right( vec value, std::size_t n ) noexcept {
+			if constexpr( sizeof( T ) == 4 ) {
+				return _mm_srli_epi32( value, static_cast<int>( n ) );
+			} else {
+				return _mm_srli_epi64( value, static_cast<int>( n ) );
+			}
+		}
+
+		static vec load_value( T const *values, std::size_t n ) noexcept {
+			return _mm_loadu_si128(
+			  reinterpret_cast<__m128i const *>( values + n * lanes ) );
+		}
+
+		static void store_value( T *values, std::size_t n, vec value ) noexcept {
+			_mm_storeu_si128( reinterpret_cast<__m128i *>( values + n * lanes ),
+			                  value );
+		}
+
+		static vec load_word( unsigned char const *words, std::size_t n ) noexcept {
+			return _mm_loadu_si128(
+			  reinterpret_cast<__m128i const *>( words + n * 16U ) );
+		}
+
+		static void store_word( unsigned char *words, std::size_t n,
+		                        vec value ) noexcept {
+			_mm_storeu_si128( reinterpret_cast<__m128i *>( words + n * 16U ),
+			                  value );
+		}
+	};
+#endif
+
+	/***
+	 * Pack the low Bits bits of a block into Bits * 16 bytes.  Each lane has
+	 * word_bits values, so a lane always fills exactly Bits words
+	 */
+	template<typename T, std::size_t Bits, typename Ops>
+	inline void pack_lanes( Ops const &ops, T const *values,
+	                        unsigned char *words ) {
+		constexpr std::size_t width = word_bits<T>;
+		using vec = typename Ops::vec;
+		vec const mask = Ops::broadcast( low_mask<T>( Bits ) );
+		vec acc = Ops::zero( );
+		DAW_UNROLL_BLOCK_LOOP
+		for( std::size_t n = 0; n < width; ++n ) {
+			std::size_t const position = n * Bits;
+			std::size_t const word = position / width;
+			std::size_t const shift = position % width;
+			vec const value = Ops::bit_and( ops.load_value( values, n ), mask );
+			if( shift == 0 ) {
+				acc = value;
+			} else {
+				acc = Ops::bit_or( acc, Ops::shift_left( value, shift ) );
+			}
+			if( shift + Bits >= width ) {
+				ops.store_word( words, word, acc );
+				if( shift + Bits > width ) {
+					acc = Ops::shift_right( value, width - shift );
+				}
+			}
+		}
+	}
+
+	template<typename T, std::size_t Bits, typename Ops>
+	inline void unpack_lanes( Ops const &ops, unsigned char const *words,
+	                          T *values ) {
+		constexpr std::size_t width = word_bits<T>;
+		using vec = typename Ops::vec;
+		vec const mask = Ops::broadcast( low_mask<T>( Bits ) );
+		vec current = Ops::zero( );
+		DAW_UNROLL_BLOCK_LOOP
+		for( std::size_t n = 0; n < width; ++n ) {
+			std::size_t const position = n * Bits;
+			std::size_t const word = position / width;
+			std::size_t const shift = position % width;
+			if( shift == 0 ) {
+				current = ops.load_word( words, word );
+			}
+			vec value = Ops::shift_right( current, shift );
+			if( shift + Bits > width ) {
+				current = ops.load_word( words, word + 1U );
+				value = Ops::bit_or( value, Ops::shift_left( current, width - shift ) );
+			}
+			if( Bits != width ) {
+				value = Ops::bit_and( value, mask );
+			}
+			ops.store_value( values, n, value );
+		}
+	}
+
+	template<typename T, std::size_t Bits>
+	void pack_block( T const *values, unsigned char *words ) {
+		if constexpr( Bits != 0 ) {
+#if defined( DAW_HAS_INT_CODEC_SSE2 )
+			pack_lanes<T, Bits>( sse2_ops<T>{ }, values, words );
+#else
+			for( std::size_t lane = 0; lane < lane_count<T>; ++lane ) {
+				pack_lanes<T, Bits>( scalar_ops<T>{ lane }, values, words );
+			}
+#endif
+		} else {
+			(void)values;
+			(void)words;
+		}
+	}
+
+	template<typename T, std::size_t Bits>
+	void unpack_block( unsigned char const *words, T *values ) {
+		if constexpr( Bits != 0 ) {
+#if defined( DAW_HAS_INT_CODEC_SSE2 )
+			unpack_lanes<T, Bits>( sse2_ops<T>{ }, words, values );
+#else
+			for( std::size_t lane = 0; lane < lane_count<T>; ++lane ) {
+				unpack_lanes<T, Bits>( scalar_ops<T>{ lane }, words, values );
+			}
+#endif
+		} else {
+			(void)words;
+			std::fill_n( values, block_size, T{ 0 } );
+		}
+	}
+
+	template<typename T>
+	using pack_fn = void ( * )( T const *, unsigned char * );
+
+	template<typename T>
+	using unpack_fn = void ( * )( unsigned char const *, T * );
+
+	template<typename T, std::size_t... Bits>
+	constexpr std::array<pack_fn<T>, sizeof...( Bits )>
+	make_pack_table( std::index_sequence<Bits...> ) {
+		return { &pack_block<T, Bits>... };
+	}
+
+	template<typename T, std::size_t... Bits>
+	constexpr std::array<unpack_fn<T>, sizeof...( Bits )>
+	make_unpack_table( std::index_sequence<Bits...> ) {
+		return { &unpack_block<T, Bits>... };
+	}
+
+	// Indexed by the bit width, 0 to word_bits<T>
+	template<typename T>
+	inline constexpr auto pack_table =
+	  make_pack_table<T>( std::make_index_sequence<word_bits<T> + 1U>{ } );
+
+	template<typename T>
+	inline constexpr auto unpack_table =
+	  make_unpack_table<T>( std::make_index_sequence<word_bits<T> + 1U>{ } );
+
+	// The OR of a block, whose bit width is the width needed to pack it
+	template<typename T>
+	[[nodiscard]] inline T block_or( T const *values, std::size_t size ) {
+		T result = 0;
+		for( std::size_t n = 0; n < size; ++n ) {
+			result |= values[n];
+		}
+		return result;
+	}
+
+	// values[n] = zigzag_decode( values[n] ) + values[n - 1], values[-1] = prev
+	template<typename T>
+	[[nodiscard]] inline T zigzag_prefix_sum( T *values, std::size_t size,
+	                                          T prev ) {
+		std::size_t n = 0;
+#if defined( DAW_HAS_INT_CODEC_SSE2 )
+		constexpr std::size_t lanes = lane_count<T>;
+		std::size_t const vector_last = size - size % lanes;
+		__m128i const one = sse2_ops<T>::broadcast( 1 );
+		__m128i carry = sse2_ops<T>::broadcast( prev );
+		for( ; n < vector_last; n += lanes ) {
+			auto *p = reinterpret_cast<__m128i *>( values + n );
+			__m128i v = _mm_loadu_si128( p );
+			if constexpr( sizeof( T ) == 4 ) {
+				v = _mm_xor_si128( _mm_srli_epi32( v, 1 ),
+				                   _mm_sub_epi32( _mm_setzero_si128( ),
+				                                  _mm_and_si128( v, one ) ) );
+				v = _mm_add_epi32( v, _mm_slli_si128( v, 4 ) );
+				v = _mm_add_epi32( v, _mm_slli_si128( v, 8 ) );
+				v = _mm_add_epi32( v, carry );
+				carry = _mm_shuffle_epi32( v, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+			} else {
+				v = _mm_xor_si128( _mm_srli_epi64( v, 1 ),
+				                   _mm_sub_epi64( _mm_setzero_si128( ),
+				                                  _mm_and_si128( v, one ) ) );
+				v = _mm_add_epi64( v, _mm_slli_si128( v, 8 ) );
+				v = _mm_add_epi64( v, carry );
+				carry = _mm_unpackhi_epi64( v, v );
+			}
+			_mm_storeu_si128( p, v );
+		}
+		if( n > 0 ) {
+			prev = values[n - 1U];
+		}
+#endif
+		for( ; n < size; ++n ) {
+			prev = static_cast<T>( prev + zigzag_decode( values[n] ) );
+			values[n] = prev;
+		}
+		return prev;
+	}
+
+	template<typename T>
+	inline void add_base( T *values, std::size_t size, T base ) {
+		for( std::size_t n = 0; n < size; ++n ) {
+			values[n] = static_cast<T>( values[n] + base );
+		}
+	}
+
+	// Drop the continuation bits of an up to eight byte varint
+	[[nodiscard]] inline std::uint64_t gather_varint( std::uint64_t bytes ) {
+#if defined( __BMI2__ )
+		return _pext_u64( bytes, 0x7F7F'7F7F'7F7F'7F7FULL );
+#else
+		std::uint64_t result = 0;
+		DAW_UNROLL_BLOCK_LOOP
+		for( std::size_t n = 0; n < 8U; ++n ) {
+			result |= ( bytes >> n ) & ( 0x7FULL << ( 7U * n ) );
+		}
+		return result;
+#endif
+	}
+
+	// Store the eight bytes of word, low byte first, as values
+	template<typename T>
+	inline void widen_bytes( std::uint64_t word, T *values ) {
+#if defined( DAW_HAS_INT_CODEC_SSE2 )
+		__m128i const zero = _mm_setzero_si128( );
+		__m128i const wide = _mm_unpacklo_epi8(
+		  _mm_loadl_epi64( reinterpret_cast<__m128i const *>( &word ) ), zero );
+		__m128i const lo = _mm_unpacklo_epi16( wide, zero );
+		__m128i const hi = _mm_unpackhi_epi16( wide, zero );
+		auto *dst = reinterpret_cast<__m128i *>( values );
+		if constexpr( sizeof( T ) == 4 ) {
+			_mm_storeu_si128( dst, lo );
+			_mm_storeu_si128( dst + 1, hi );
+		} else {
+			_mm_storeu_si128( dst, _mm_unpacklo_epi32( lo, zero ) );
+			_mm_storeu_si128( dst + 1, _mm_unpackhi_epi32( lo, zero ) );
+			_mm_storeu_si128( dst + 2, _mm_unpacklo_epi32( hi, zero ) );
+			_mm_storeu_si128( dst + 3, _mm_unpackhi_epi32( hi, zero ) );
+		}
+#else
+		for( std::size_t n = 0; n < 8U; ++n ) {
+			values[n] = static_cast<T>( ( word >> ( 8U * n ) ) & 0xFFU );
+		}
+#endif
+	}
+} // namespace daw::int_codec_impl
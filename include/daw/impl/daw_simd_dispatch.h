@@ -0,0 +1,65 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include <ciso646>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Vector kernels are compiled with a target attribute and selected at
+// runtime, so the rest of the program does not need to be built for AVX2
+#if( defined( __x86_64__ ) or defined( __i386__ ) ) and                        \
+  ( defined( __GNUC__ ) or defined( __clang__ ) )
+#define DAW_HAS_SIMD_DISPATCH
+#define DAW_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#include <immintrin.h>
+#endif
+
+namespace daw::simd_impl {
+#if defined( DAW_HAS_SIMD_DISPATCH )
+	[[nodiscard]] inline bool has_avx2( ) {
+		static bool const result = [] {
+			__builtin_cpu_init( );
+			return __builtin_cpu_supports( "avx2" ) != 0;
+		}( );
+		return result;
+	}
+#else
+	[[nodiscard]] constexpr bool has_avx2( ) {
+		return false;
+	}
+#endif
+
+	/***
+	 * Iterators known to refer to contiguous storage.  C++17 has no way to
+	 * ask, so this covers pointers and the standard containers' iterators
+	 */
+	template<typename Iterator,
+	         typename T = typename std::iterator_traits<Iterator>::value_type>
+	inline constexpr bool is_contiguous_iterator_v =
+	  std::is_pointer_v<Iterator> or
+	  std::is_same_v<Iterator, typename std::vector<T>::iterator> or
+	  std::is_same_v<Iterator, typename std::vector<T>::const_iterator> or
+	  ( std::is_integral_v<T> and
+	    ( std::is_same_v<Iterator, typename std::basic_string<T>::iterator> or
+	      std::is_same_v<Iterator,
+	                     typename std::basic_string<T>::const_iterator> ) );
+
+	template<typename Iterator>
+	using iter_value_t = typename std::iterator_traits<Iterator>::value_type;
+
+	// Only valid when first is dereferenceable
+	template<typename Iterator>
+	[[nodiscard]] auto to_pointer( Iterator it ) {
+		return std::addressof( *it );
+	}
+} // namespace daw::simd_impl
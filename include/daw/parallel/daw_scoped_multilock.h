@@ -8,9 +8,21 @@
 
 #pragma once
 
+#include "../cpp_17.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
 #include <ciso646>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace daw {
 	namespace details {
@@ -71,4 +83,319 @@ namespace daw {
 	[[nodiscard]] auto make_scoped_multilock( Lockables &...lockables ) {
 		return scoped_multilock<Lockables...>{ lockables... };
 	}
+
+	/***
+	 * Marks a SharedLockable(e.g. std::shared_mutex) to be locked in shared mode
+	 * by ordered_multilock
+	 */
+	template<typename SharedMutex>
+	class shared_lockable {
+		SharedMutex *m_mutex;
+
+	public:
+		explicit constexpr shared_lockable( SharedMutex &mut ) noexcept
+		  : m_mutex( &mut ) {}
+
+		void lock( ) {
+			m_mutex->lock_shared( );
+		}
+
+		[[nodiscard]] bool try_lock( ) {
+			return m_mutex->try_lock_shared( );
+		}
+
+		void unlock( ) {
+			m_mutex->unlock_shared( );
+		}
+
+		[[nodiscard]] constexpr SharedMutex &get( ) const noexcept {
+			return *m_mutex;
+		}
+	};
+
+	template<typename SharedMutex>
+	[[nodiscard]] constexpr shared_lockable<SharedMutex>
+	as_shared( SharedMutex &mut ) noexcept {
+		return shared_lockable<SharedMutex>( mut );
+	}
+
+	/***
+	 * A lock taken by ordered_multilock, the address is that of the underlying
+	 * mutex and is what the set is ordered by
+	 */
+	struct multilock_entry {
+		void const *address = nullptr;
+		bool is_shared = false;
+		void *lockable = nullptr;
+		void ( *lock_fn )( void * ) = nullptr;
+		bool ( *try_lock_fn )( void * ) = nullptr;
+		void ( *unlock_fn )( void * ) = nullptr;
+
+		void lock( ) const {
+			lock_fn( lockable );
+		}
+
+		[[nodiscard]] bool try_lock( ) const {
+			return try_lock_fn( lockable );
+		}
+
+		void unlock( ) const {
+			unlock_fn( lockable );
+		}
+	};
+
+	/***
+	 * Default instrumentation for ordered_multilock.  When used no timing is
+	 * done.  A user supplied hook must provide
+	 * on_acquire( Entries const & locks, std::chrono::nanoseconds wait_time,
+	 *             size_t attempts )
+	 * on_release( Entries const & locks, std::chrono::nanoseconds hold_time )
+	 * where Entries is a sorted std::array<multilock_entry, N>
+	 */
+	struct multilock_null_hook {
+		template<typename Entries>
+		constexpr void on_acquire( Entries const &, std::chrono::nanoseconds,
+		                           size_t ) const noexcept {}
+
+		template<typename Entries>
+		constexpr void on_release( Entries const &,
+		                           std::chrono::nanoseconds ) const noexcept {}
+	};
+
+	namespace multilock_impl {
+		template<typename T>
+		struct is_shared_lockable : std::false_type {};
+
+		template<typename SharedMutex>
+		struct is_shared_lockable<shared_lockable<SharedMutex>> : std::true_type {};
+
+		// A shared_lockable binds here too when passed as a non-const lvalue,
+		// exclude it so the entry refers to the mutex and not the wrapper
+		template<
+		  typename Mutex,
+		  std::enable_if_t<not is_shared_lockable<std::remove_cv_t<Mutex>>::value,
+		                   std::nullptr_t> = nullptr>
+		[[nodiscard]] multilock_entry make_entry( Mutex &mut ) noexcept {
+			multilock_entry result{ };
+			result.address = static_cast<void const *>( std::addressof( mut ) );
+			result.lockable = static_cast<void *>( std::addressof( mut ) );
+			result.lock_fn = []( void *m ) { static_cast<Mutex *>( m )->lock( ); };
+			result.try_lock_fn = []( void *m ) -> bool {
+				return static_cast<Mutex *>( m )->try_lock( );
+			};
+			result.unlock_fn = []( void *m ) {
+				static_cast<Mutex *>( m )->unlock( );
+			};
+			return result;
+		}
+
+		template<typename SharedMutex>
+		[[nodiscard]] multilock_entry
+		make_entry( shared_lockable<SharedMutex> const &sl ) noexcept {
+			multilock_entry result{ };
+			result.address = static_cast<void const *>( std::addressof( sl.get( ) ) );
+			result.is_shared = true;
+			result.lockable = static_cast<void *>( std::addressof( sl.get( ) ) );
+			result.lock_fn = []( void *m ) {
+				static_cast<SharedMutex *>( m )->lock_shared( );
+			};
+			result.try_lock_fn = []( void *m ) -> bool {
+				return static_cast<SharedMutex *>( m )->try_lock_shared( );
+			};
+			result.unlock_fn = []( void *m ) {
+				static_cast<SharedMutex *>( m )->unlock_shared( );
+			};
+			return result;
+		}
+
+		// Requires locks to be sorted by address
+		template<size_t N>
+		[[nodiscard]] bool
+		all_distinct( std::array<multilock_entry, N> const &locks ) noexcept {
+			return std::adjacent_find( locks.begin( ), locks.end( ),
+			                           []( multilock_entry const &lhs,
+			                               multilock_entry const &rhs ) {
+				                           return lhs.address == rhs.address;
+			                           } ) == locks.end( );
+		}
+
+		// Spin a little, then give up the time slice.  The amount of spinning
+		// grows with each failed attempt so that contending threads spread out
+		inline void backoff( size_t attempt ) {
+			if( attempt < 4 ) {
+				return;
+			}
+			if( attempt < 16 ) {
+				for( size_t n = 0; n < ( size_t{ 1 } << ( attempt - 4 ) ); ++n ) {
+					std::this_thread::yield( );
+				}
+				return;
+			}
+			std::this_thread::sleep_for( std::chrono::microseconds( 1 ) );
+		}
+	} // namespace multilock_impl
+
+	/***
+	 * Lock a set of lockables without deadlock.  The locks are sorted by the
+	 * address of the underlying mutex and acquired with a blocking lock on the
+	 * first followed by try_lock on the rest.  When one is unavailable all held
+	 * locks are released and the set is retried after a backoff, starting with
+	 * the lock that failed.  Lockables wrapped with daw::as_shared are taken in
+	 * shared mode.  Passing the same mutex more than once is not supported and
+	 * is asserted against.
+	 * @tparam Hook Instrumentation called with the wait and hold times
+	 * @tparam N Number of lockables
+	 */
+	template<size_t N, typename Hook = multilock_null_hook>
+	class ordered_multilock {
+		static_assert( N > 0, "Must specify at least 1 lockable" );
+		static inline constexpr bool has_hook =
+		  not std::is_same_v<Hook, multilock_null_hook>;
+
+		using clock_t = std::chrono::steady_clock;
+
+		std::array<multilock_entry, N> m_locks;
+		Hook m_hook;
+		clock_t::time_point m_acquired_at{ };
+		bool m_owns = false;
+
+		// Release, in reverse acquisition order, the count locks taken starting
+		// at first
+		void release( size_t first, size_t count ) {
+			for( size_t n = count; n > 0; --n ) {
+				m_locks[( first + n - 1 ) % N].unlock( );
+			}
+		}
+
+		void release( ) {
+			release( 0, N );
+		}
+
+		// Returns the number of attempts made before the full set was held.  If
+		// a lock throws, the locks already held are released before rethrowing
+		size_t acquire( ) {
+			size_t first = 0;
+			size_t held = 0;
+			size_t attempt = 0;
+			try {
+				while( true ) {
+					m_locks[first].lock( );
+					held = 1;
+					size_t failed = N;
+					for( size_t n = 1; n < N; ++n ) {
+						size_t const idx = ( first + n ) % N;
+						if( not m_locks[idx].try_lock( ) ) {
+							failed = idx;
+							break;
+						}
+						++held;
+					}
+					++attempt;
+					if( failed == N ) {
+						return attempt;
+					}
+					release( first, std::exchange( held, 0 ) );
+					multilock_impl::backoff( attempt );
+					first = failed;
+				}
+			} catch( ... ) {
+				release( first, held );
+				throw;
+			}
+		}
+
+	public:
+		template<typename... Lockables,
+		         std::enable_if_t<( sizeof...( Lockables ) == N ), std::nullptr_t> =
+		           nullptr>
+		explicit ordered_multilock( Hook hook, Lockables &&...lockables )
+		  : m_locks{ multilock_impl::make_entry( lockables )... }
+		  , m_hook( std::move( hook ) ) {
+
+			std::sort( m_locks.begin( ), m_locks.end( ),
+			           []( multilock_entry const &lhs, multilock_entry const &rhs ) {
+				           return std::less<void const *>{ }( lhs.address,
+				                                              rhs.address );
+			           } );
+			// The same mutex twice would never be acquired
+			assert( multilock_impl::all_distinct( m_locks ) );
+			if constexpr( has_hook ) {
+				auto const start = clock_t::now( );
+				size_t const attempts = acquire( );
+				m_acquired_at = clock_t::now( );
+				try {
+					m_hook.on_acquire( std::as_const( m_locks ), m_acquired_at - start,
+					                   attempts );
+				} catch( ... ) {
+					// The destructor will not run
+					release( );
+					throw;
+				}
+				m_owns = true;
+			} else {
+				(void)acquire( );
+				m_owns = true;
+			}
+		}
+
+		~ordered_multilock( ) {
+			unlock( );
+		}
+
+		ordered_multilock( ordered_multilock &&other ) noexcept(
+		  std::is_nothrow_move_constructible_v<Hook> )
+		  : m_locks( other.m_locks )
+		  , m_hook( std::move( other.m_hook ) )
+		  , m_acquired_at( other.m_acquired_at )
+		  , m_owns( std::exchange( other.m_owns, false ) ) {}
+
+		ordered_multilock &operator=( ordered_multilock && ) = delete;
+		ordered_multilock( ordered_multilock const & ) = delete;
+		ordered_multilock &operator=( ordered_multilock const & ) = delete;
+
+		/***
+		 * Release all the locks early.  Safe to call more than once
+		 */
+		void unlock( ) {
+			if( not m_owns ) {
+				return;
+			}
+			m_owns = false;
+			release( );
+			if constexpr( has_hook ) {
+				m_hook.on_release( std::as_const( m_locks ),
+				                   clock_t::now( ) - m_acquired_at );
+			}
+		}
+
+		[[nodiscard]] bool owns_lock( ) const noexcept {
+			return m_owns;
+		}
+
+		/***
+		 * @return the lock set in address order
+		 */
+		[[nodiscard]] std::array<multilock_entry, N> const &
+		locks( ) const noexcept {
+			return m_locks;
+		}
+
+		[[nodiscard]] Hook const &hook( ) const noexcept {
+			return m_hook;
+		}
+	};
+
+	template<typename... Lockables>
+	[[nodiscard]] auto make_ordered_multilock( Lockables &&...lockables ) {
+		return ordered_multilock<sizeof...( Lockables )>(
+		  multilock_null_hook{ }, std::forward<Lockables>( lockables )... );
+	}
+
+	template<typename Hook, typename... Lockables>
+	[[nodiscard]] auto make_instrumented_multilock( Hook &&hook,
+	                                                Lockables &&...lockables ) {
+		return ordered_multilock<sizeof...( Lockables ),
+		                         daw::remove_cvref_t<Hook>>(
+		  std::forward<Hook>( hook ), std::forward<Lockables>( lockables )... );
+	}
 } // namespace daw
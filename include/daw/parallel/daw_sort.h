@@ -0,0 +1,413 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "../daw_sort_n.h"
+#include "daw_thread_pool.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw::parallel {
+	namespace sort_impl {
+		// Below this many elements the sequential sorts are used
+		inline constexpr std::size_t min_parallel_size = 1U << 14U;
+		inline constexpr std::size_t oversampling = 16;
+
+		/***
+		 * Uninitialized storage for size T's.  The user constructs the elements
+		 * and reports them with set_constructed, the first constructed elements
+		 * are destroyed with the buffer so that an exception does not leak them
+		 */
+		template<typename T>
+		class raw_buffer {
+			std::allocator<T> m_alloc{ };
+			T *m_ptr;
+			std::size_t m_size;
+			std::size_t m_constructed = 0;
+
+		public:
+			explicit raw_buffer( std::size_t size )
+			  : m_ptr( m_alloc.allocate( size ) )
+			  , m_size( size ) {}
+
+			raw_buffer( raw_buffer const & ) = delete;
+			raw_buffer &operator=( raw_buffer const & ) = delete;
+
+			~raw_buffer( ) {
+				std::destroy_n( m_ptr, m_constructed );
+				m_alloc.deallocate( m_ptr, m_size );
+			}
+
+			[[nodiscard]] T *data( ) const noexcept {
+				return m_ptr;
+			}
+
+			void set_constructed( std::size_t count ) noexcept {
+				m_constructed = count;
+			}
+
+			// Destroy the constructed elements using the threads of pool
+			void destroy( thread_pool &pool, std::size_t min_chunk ) {
+				if constexpr( not std::is_trivially_destructible_v<T> ) {
+					pool.for_each_chunk(
+					  m_constructed, min_chunk,
+					  [&]( std::size_t chunk_first, std::size_t chunk_last ) {
+						  std::destroy( m_ptr + chunk_first, m_ptr + chunk_last );
+					  } );
+				}
+				m_constructed = 0;
+			}
+		};
+
+		template<typename RandomIterator, typename Compare>
+		void sample_sort( thread_pool &pool, RandomIterator first,
+		                  std::size_t size, Compare &comp ) {
+			using value_type =
+			  typename std::iterator_traits<RandomIterator>::value_type;
+			using bucket_id_t = std::uint16_t;
+
+			// Twice as many buckets as threads evens out the bucket sorts
+			std::size_t const splitter_count =
+			  std::min( pool.size( ) * 2U, std::size_t{ 1024 } ) - 1U;
+
+			// Evenly spaced sample to choose the bucket boundaries from.  Equal
+			// adjacent splitters are merged and marked as repeated, keys equal to
+			// a repeated splitter are common enough to get a bucket of their own
+			auto splitters = std::vector<value_type>( );
+			auto repeated = std::vector<char>( );
+			{
+				auto const sample_size = ( splitter_count + 1U ) * oversampling;
+				auto sample = std::vector<value_type>( );
+				sample.reserve( sample_size );
+				// Take one element from each stride, at a varying position so that
+				// periodic input does not skew the sample
+				auto const stride = size / sample_size;
+				for( std::size_t n = 0; n < sample_size; ++n ) {
+					auto const pos = stride * n + ( n * 7919U ) % stride;
+					sample.push_back( first[static_cast<std::ptrdiff_t>( pos )] );
+				}
+				daw::sort( sample.begin( ), sample.end( ), comp );
+				splitters.reserve( splitter_count );
+				for( std::size_t n = 1; n <= splitter_count; ++n ) {
+					auto &splitter = sample[n * oversampling];
+					if( not splitters.empty( ) and
+					    not comp( splitters.back( ), splitter ) ) {
+						repeated.back( ) = true;
+						continue;
+					}
+					splitters.push_back( std::move( splitter ) );
+					repeated.push_back( false );
+				}
+			}
+			// Bucket 2i holds the keys after splitter i - 1 up to splitter i and
+			// bucket 2i + 1 the keys equal to splitter i when it is repeated.  The
+			// equality buckets need no sort, so duplicate heavy input does not
+			// leave one thread sorting most of it
+			std::size_t const bucket_count = splitters.size( ) * 2U + 1U;
+			auto const classify = [&]( value_type const &value ) {
+				auto const i = static_cast<std::size_t>(
+				  std::lower_bound( splitters.begin( ), splitters.end( ), value,
+				                    comp ) -
+				  splitters.begin( ) );
+				if( i < splitters.size( ) and repeated[i] and
+				    not comp( value, splitters[i] ) ) {
+					return static_cast<bucket_id_t>( 2U * i + 1U );
+				}
+				return static_cast<bucket_id_t>( 2U * i );
+			};
+
+			// Count the bucket sizes of each contiguous block of input
+			std::size_t const block_count = pool.size( ) * 4U;
+			auto const block_first = [&]( std::size_t block ) {
+				return ( size * block ) / block_count;
+			};
+			auto ids = std::unique_ptr<bucket_id_t[]>( new bucket_id_t[size] );
+			auto counts = std::vector<std::size_t>( block_count * bucket_count, 0 );
+			pool.for_each_index( block_count, [&]( std::size_t block ) {
+				auto *const block_counts = counts.data( ) + block * bucket_count;
+				auto const last = block_first( block + 1U );
+				for( std::size_t n = block_first( block ); n < last; ++n ) {
+					auto const id = classify( first[static_cast<std::ptrdiff_t>( n )] );
+					ids[n] = id;
+					++block_counts[id];
+				}
+			} );
+
+			// Turn the counts into where each block writes each bucket, blocks are
+			// laid out in order within a bucket
+			auto bucket_starts = std::vector<std::size_t>( bucket_count + 1U, 0 );
+			{
+				std::size_t total = 0;
+				for( std::size_t b = 0; b < bucket_count; ++b ) {
+					bucket_starts[b] = total;
+					for( std::size_t block = 0; block < block_count; ++block ) {
+						auto &c = counts[block * bucket_count + b];
+						auto const tmp = c;
+						c = total;
+						total += tmp;
+					}
+				}
+				bucket_starts[bucket_count] = total;
+			}
+
+			auto buffer = raw_buffer<value_type>( size );
+			// The offsets only advance past constructed elements, so if a move
+			// throws the ranges from the starting offsets are what to destroy
+			auto const offsets_first = counts;
+			try {
+				pool.for_each_index( block_count, [&]( std::size_t block ) {
+					auto *const block_offsets = counts.data( ) + block * bucket_count;
+					auto const last = block_first( block + 1U );
+					for( std::size_t n = block_first( block ); n < last; ++n ) {
+						auto &pos = block_offsets[ids[n]];
+						::new( static_cast<void *>( buffer.data( ) + pos ) ) value_type(
+						  std::move( first[static_cast<std::ptrdiff_t>( n )] ) );
+						++pos;
+					}
+				} );
+			} catch( ... ) {
+				for( std::size_t n = 0; n < counts.size( ); ++n ) {
+					std::destroy( buffer.data( ) + offsets_first[n],
+					              buffer.data( ) + counts[n] );
+				}
+				throw;
+			}
+			buffer.set_constructed( size );
+			ids.reset( );
+
+			pool.for_each_index( splitters.size( ) + 1U, [&]( std::size_t i ) {
+				daw::sort( buffer.data( ) + bucket_starts[2U * i],
+				           buffer.data( ) + bucket_starts[2U * i + 1U], comp );
+			} );
+			std::size_t const chunk_size =
+			  std::max( size / ( pool.size( ) * 4U ), std::size_t{ 1024 } );
+			pool.for_each_chunk(
+			  size, chunk_size,
+			  [&]( std::size_t chunk_first, std::size_t chunk_last ) {
+				  std::move( buffer.data( ) + chunk_first,
+				             buffer.data( ) + chunk_last,
+				             first + static_cast<std::ptrdiff_t>( chunk_first ) );
+			  } );
+			buffer.destroy( pool, chunk_size );
+		}
+
+		/***
+		 * Find how many of the first k merged elements come from a, ties are
+		 * taken from a first
+		 */
+		template<typename IterA, typename IterB, typename Compare>
+		[[nodiscard]] std::size_t co_rank( std::size_t k, IterA a, std::size_t na,
+		                                   IterB b, std::size_t nb,
+		                                   Compare &comp ) {
+			std::size_t lo = k > nb ? k - nb : 0;
+			std::size_t hi = std::min( k, na );
+			while( lo < hi ) {
+				auto const i = lo + ( hi - lo ) / 2U;
+				auto const j = k - i;
+				if( j == 0 or comp( b[j - 1U], a[i] ) ) {
+					hi = i;
+				} else {
+					lo = i + 1U;
+				}
+			}
+			return lo;
+		}
+
+		template<typename IterA, typename IterB, typename Out, typename Compare,
+		         typename Put>
+		void merge_into( IterA a, std::size_t na, IterB b, std::size_t nb, Out out,
+		                 Compare &comp, Put put ) {
+			std::size_t i = 0;
+			std::size_t j = 0;
+			while( i < na and j < nb ) {
+				if( comp( b[j], a[i] ) ) {
+					put( out, b[j++] );
+				} else {
+					put( out, a[i++] );
+				}
+				++out;
+			}
+			for( ; i < na; ++i, ++out ) {
+				put( out, a[i] );
+			}
+			for( ; j < nb; ++j, ++out ) {
+				put( out, b[j] );
+			}
+		}
+
+		template<typename RandomIterator, typename Compare>
+		void merge_sort( thread_pool &pool, RandomIterator first, std::size_t size,
+		                 Compare &comp ) {
+			using value_type =
+			  typename std::iterator_traits<RandomIterator>::value_type;
+
+			auto const run_count = pool.size( );
+			auto runs = std::vector<std::size_t>( );
+			for( std::size_t n = 0; n <= run_count; ++n ) {
+				runs.push_back( ( size * n ) / run_count );
+			}
+			pool.for_each_index( run_count, [&]( std::size_t n ) {
+				std::stable_sort( first + static_cast<std::ptrdiff_t>( runs[n] ),
+				                  first + static_cast<std::ptrdiff_t>( runs[n + 1U] ),
+				                  comp );
+			} );
+
+			auto buffer = raw_buffer<value_type>( size );
+			bool buffer_constructed = false;
+			bool in_buffer = false;
+			// Each merge is split into pieces of roughly this size so that all
+			// threads take part even in the last rounds
+			std::size_t const piece_size =
+			  std::max( size / ( pool.size( ) * 4U ), std::size_t{ 1024 } );
+
+			while( runs.size( ) > 2U ) {
+				struct task_t {
+					std::size_t a;
+					std::size_t na;
+					std::size_t b;
+					std::size_t nb;
+					std::size_t k_first;
+					std::size_t k_last;
+				};
+				auto tasks = std::vector<task_t>( );
+				auto next_runs = std::vector<std::size_t>( );
+				for( std::size_t r = 0; r + 1U < runs.size( ); r += 2U ) {
+					next_runs.push_back( runs[r] );
+					auto const a = runs[r];
+					auto const b = runs[r + 1U];
+					auto const end = r + 2U < runs.size( ) ? runs[r + 2U] : b;
+					auto const total = end - a;
+					for( std::size_t k = 0; k < total; k += piece_size ) {
+						tasks.push_back( task_t{ a, b - a, b, end - b, k,
+						                         std::min( k + piece_size, total ) } );
+					}
+				}
+				next_runs.push_back( size );
+
+				// make_put( t ) gives how task t writes an element to dst
+				auto const run_tasks = [&]( auto src, auto dst, auto make_put ) {
+					pool.for_each_index( tasks.size( ), [&]( std::size_t t ) {
+						auto const &task = tasks[t];
+						auto const a = src + static_cast<std::ptrdiff_t>( task.a );
+						auto const b = src + static_cast<std::ptrdiff_t>( task.b );
+						auto const ia =
+						  co_rank( task.k_first, a, task.na, b, task.nb, comp );
+						auto const ea =
+						  co_rank( task.k_last, a, task.na, b, task.nb, comp );
+						auto const ib = task.k_first - ia;
+						auto const eb = task.k_last - ea;
+						merge_into( a + static_cast<std::ptrdiff_t>( ia ), ea - ia,
+						            b + static_cast<std::ptrdiff_t>( ib ), eb - ib,
+						            dst + static_cast<std::ptrdiff_t>( task.a +
+						                                               task.k_first ),
+						            comp, make_put( t ) );
+					} );
+				};
+				auto const move_assign = []( std::size_t ) {
+					return []( auto out, auto &value ) { *out = std::move( value ); };
+				};
+				if( in_buffer ) {
+					run_tasks( buffer.data( ), first, move_assign );
+				} else if( buffer_constructed ) {
+					run_tasks( first, buffer.data( ), move_assign );
+				} else {
+					// Each task constructs a contiguous piece, count how far each got
+					// so that a throwing move destroys only what was built
+					auto built = std::vector<std::size_t>( tasks.size( ), 0 );
+					try {
+						run_tasks( first, buffer.data( ), [&]( std::size_t t ) {
+							return [&built, t]( value_type *out, auto &value ) {
+								::new( static_cast<void *>( out ) )
+								  value_type( std::move( value ) );
+								++built[t];
+							};
+						} );
+					} catch( ... ) {
+						for( std::size_t t = 0; t < tasks.size( ); ++t ) {
+							std::destroy_n( buffer.data( ) + tasks[t].a + tasks[t].k_first,
+							                built[t] );
+						}
+						throw;
+					}
+					buffer.set_constructed( size );
+					buffer_constructed = true;
+				}
+				in_buffer = not in_buffer;
+				runs = std::move( next_runs );
+			}
+			if( in_buffer ) {
+				pool.for_each_chunk(
+				  size, piece_size,
+				  [&]( std::size_t chunk_first, std::size_t chunk_last ) {
+					  std::move( buffer.data( ) + chunk_first,
+					             buffer.data( ) + chunk_last,
+					             first + static_cast<std::ptrdiff_t>( chunk_first ) );
+				  } );
+			}
+			buffer.destroy( pool, piece_size );
+		}
+	} // namespace sort_impl
+
+	/***
+	 * Sort [first, last) using the threads of pool.  A sample of the input
+	 * picks bucket boundaries, the elements are distributed to the buckets in
+	 * parallel and each bucket is sorted with daw::sort.  Small inputs are
+	 * sorted sequentially.
+	 */
+	template<typename RandomIterator, typename Compare = std::less<>>
+	void sort( thread_pool &pool, RandomIterator first, RandomIterator last,
+	           Compare comp = Compare{ } ) {
+		auto const size = static_cast<std::size_t>( std::distance( first, last ) );
+		if( size < sort_impl::min_parallel_size or pool.size( ) < 2 ) {
+			daw::sort( first, last, comp );
+			return;
+		}
+		sort_impl::sample_sort( pool, first, size, comp );
+	}
+
+	template<typename RandomIterator, typename Compare = std::less<>>
+	void sort( RandomIterator first, RandomIterator last,
+	           Compare comp = Compare{ } ) {
+		daw::parallel::sort( daw::default_thread_pool( ), first, last,
+		                     std::move( comp ) );
+	}
+
+	/***
+	 * Stable sort [first, last) using the threads of pool.  The input is split
+	 * into one run per thread which are stable sorted in parallel and then
+	 * merged pairwise, with each merge split across the threads.
+	 */
+	template<typename RandomIterator, typename Compare = std::less<>>
+	void stable_sort( thread_pool &pool, RandomIterator first,
+	                  RandomIterator last, Compare comp = Compare{ } ) {
+		auto const size = static_cast<std::size_t>( std::distance( first, last ) );
+		if( size < sort_impl::min_parallel_size or pool.size( ) < 2 ) {
+			std::stable_sort( first, last, comp );
+			return;
+		}
+		sort_impl::merge_sort( pool, first, size, comp );
+	}
+
+	template<typename RandomIterator, typename Compare = std::less<>>
+	void stable_sort( RandomIterator first, RandomIterator last,
+	                  Compare comp = Compare{ } ) {
+		daw::parallel::stable_sort( daw::default_thread_pool( ), first, last,
+		                            std::move( comp ) );
+	}
+} // namespace daw::parallel
@@ -0,0 +1,191 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <ciso646>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace daw {
+	/***
+	 * A fixed set of worker threads for fork/join style parallel algorithms.
+	 * for_each_index blocks until all the work is done and the calling thread
+	 * takes part, so it is safe to call from within a task running on the
+	 * pool.
+	 */
+	class thread_pool {
+		std::vector<std::thread> m_threads{ };
+		std::mutex m_mutex{ };
+		std::condition_variable m_cv{ };
+		std::deque<std::function<void( )>> m_tasks{ };
+		bool m_stop = false;
+
+		void worker( ) {
+			auto lck = std::unique_lock<std::mutex>( m_mutex );
+			while( true ) {
+				m_cv.wait( lck, [&] { return m_stop or not m_tasks.empty( ); } );
+				if( m_tasks.empty( ) ) {
+					return;
+				}
+				auto task = std::move( m_tasks.front( ) );
+				m_tasks.pop_front( );
+				lck.unlock( );
+				task( );
+				lck.lock( );
+			}
+		}
+
+		template<typename Function>
+		struct job_state {
+			Function *func;
+			std::size_t count;
+			std::atomic<std::size_t> next = 0;
+			std::size_t done = 0;
+			std::mutex mutex{ };
+			std::condition_variable cv{ };
+			std::exception_ptr error = nullptr;
+
+			job_state( Function &f, std::size_t c )
+			  : func( &f )
+			  , count( c ) {}
+
+			// Claim and run indices until none are left
+			void run( ) {
+				std::size_t ran = 0;
+				std::exception_ptr err = nullptr;
+				for( std::size_t n = next++; n < count; n = next++ ) {
+					if( not err ) {
+						try {
+							( *func )( n );
+						} catch( ... ) { err = std::current_exception( ); }
+					}
+					++ran;
+				}
+				if( ran == 0 ) {
+					return;
+				}
+				auto const lck = std::lock_guard<std::mutex>( mutex );
+				if( err and not error ) {
+					error = err;
+				}
+				done += ran;
+				if( done == count ) {
+					cv.notify_all( );
+				}
+			}
+		};
+
+	public:
+		explicit thread_pool(
+		  std::size_t thread_count = std::thread::hardware_concurrency( ) ) {
+			// The caller of for_each_index is the last worker
+			thread_count = std::max( thread_count, std::size_t{ 1 } ) - 1U;
+			m_threads.reserve( thread_count );
+			for( std::size_t n = 0; n < thread_count; ++n ) {
+				m_threads.emplace_back( [this] { worker( ); } );
+			}
+		}
+
+		thread_pool( thread_pool const & ) = delete;
+		thread_pool &operator=( thread_pool const & ) = delete;
+		thread_pool( thread_pool && ) = delete;
+		thread_pool &operator=( thread_pool && ) = delete;
+
+		~thread_pool( ) {
+			{
+				auto const lck = std::lock_guard<std::mutex>( m_mutex );
+				m_stop = true;
+			}
+			m_cv.notify_all( );
+			for( auto &th : m_threads ) {
+				th.join( );
+			}
+		}
+
+		/***
+		 * @return number of threads that take part in for_each_index,
+		 * including the caller
+		 */
+		[[nodiscard]] std::size_t size( ) const noexcept {
+			return m_threads.size( ) + 1U;
+		}
+
+		/***
+		 * Call func( n ) for each n in [0, count) using the pool and the calling
+		 * thread.  The first exception thrown is rethrown once all indices have
+		 * been processed
+		 */
+		template<typename Function>
+		void for_each_index( std::size_t count, Function &&func ) {
+			if( count == 0 ) {
+				return;
+			}
+			if( count == 1 or m_threads.empty( ) ) {
+				for( std::size_t n = 0; n < count; ++n ) {
+					func( n );
+				}
+				return;
+			}
+			using state_t = job_state<std::remove_reference_t<Function>>;
+			auto state = std::make_shared<state_t>( func, count );
+			auto const helpers = std::min( count, size( ) ) - 1U;
+			{
+				auto const lck = std::lock_guard<std::mutex>( m_mutex );
+				for( std::size_t n = 0; n < helpers; ++n ) {
+					m_tasks.emplace_back( [state] { state->run( ); } );
+				}
+			}
+			m_cv.notify_all( );
+			state->run( );
+			auto lck = std::unique_lock<std::mutex>( state->mutex );
+			state->cv.wait( lck, [&] { return state->done == state->count; } );
+			if( state->error ) {
+				std::rethrow_exception( state->error );
+			}
+		}
+
+		/***
+		 * Split [0, item_count) into contiguous chunks of at least min_chunk
+		 * items and call func( first, last ) for each in parallel
+		 */
+		template<typename Function>
+		void for_each_chunk( std::size_t item_count, std::size_t min_chunk,
+		                     Function &&func ) {
+			if( item_count == 0 ) {
+				return;
+			}
+			min_chunk = std::max( min_chunk, std::size_t{ 1 } );
+			// A few chunks per thread evens out uneven work
+			auto const chunks = std::max(
+			  std::min( item_count / min_chunk, size( ) * 4U ), std::size_t{ 1 } );
+			for_each_index( chunks, [&]( std::size_t n ) {
+				func( ( item_count * n ) / chunks,
+				      ( item_count * ( n + 1U ) ) / chunks );
+			} );
+		}
+	};
+
+	/***
+	 * @return a process wide thread_pool sized to the hardware
+	 */
+	inline thread_pool &default_thread_pool( ) {
+		static thread_pool pool{ };
+		return pool;
+	}
+} // namespace daw
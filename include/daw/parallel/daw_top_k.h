@@ -0,0 +1,121 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#pragma once
+
+#include "../daw_keep_n.h"
+#include "../daw_move.h"
+#include "daw_thread_pool.h"
+
+#include <algorithm>
+#include <ciso646>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace daw::parallel {
+	namespace top_k_impl {
+		// Below this many elements per thread the work is not split
+		inline constexpr std::size_t min_chunk_size = 1U << 14U;
+
+		// Merge two sorted runs, keeping at most k values
+		template<typename T, typename Compare>
+		[[nodiscard]] std::vector<T> merge_k( std::vector<T> &lhs,
+		                                      std::vector<T> &rhs, std::size_t k,
+		                                      Compare &comp ) {
+			auto result = std::vector<T>( );
+			result.reserve( std::min( k, lhs.size( ) + rhs.size( ) ) );
+			auto l = lhs.begin( );
+			auto r = rhs.begin( );
+			while( result.size( ) < k and l != lhs.end( ) and r != rhs.end( ) ) {
+				if( comp( *r, *l ) ) {
+					result.push_back( daw::move( *r++ ) );
+				} else {
+					result.push_back( daw::move( *l++ ) );
+				}
+			}
+			for( ; result.size( ) < k and l != lhs.end( ); ++l ) {
+				result.push_back( daw::move( *l ) );
+			}
+			for( ; result.size( ) < k and r != rhs.end( ); ++r ) {
+				result.push_back( daw::move( *r ) );
+			}
+			return result;
+		}
+	} // namespace top_k_impl
+
+	/***
+	 * Merge runs sorted by comp into the first k values.  Pairs of runs are
+	 * merged in parallel, halving the number of runs each round, and each
+	 * merge stops after k values
+	 */
+	template<typename T, typename Compare = std::less<>>
+	[[nodiscard]] std::vector<T> merge_top_k( thread_pool &pool,
+	                                          std::vector<std::vector<T>> runs,
+	                                          std::size_t k,
+	                                          Compare comp = Compare{ } ) {
+		if( runs.empty( ) ) {
+			return { };
+		}
+		while( runs.size( ) > 1 ) {
+			auto const pairs = runs.size( ) / 2U;
+			auto next = std::vector<std::vector<T>>( ( runs.size( ) + 1U ) / 2U );
+			pool.for_each_index( pairs, [&]( std::size_t n ) {
+				next[n] =
+				  top_k_impl::merge_k( runs[2U * n], runs[2U * n + 1U], k, comp );
+			} );
+			if( runs.size( ) % 2U == 1U ) {
+				next.back( ) = daw::move( runs.back( ) );
+			}
+			runs = daw::move( next );
+		}
+		auto result = daw::move( runs.front( ) );
+		if( result.size( ) > k ) {
+			result.resize( k );
+		}
+		return result;
+	}
+
+	/***
+	 * Find the first k values of [first, last) in comp order, sorted.  Each
+	 * thread keeps the best k of its part of the input in a keep_n_heap and
+	 * the per thread results are combined with merge_top_k
+	 */
+	template<typename RandomIterator, typename Compare = std::less<>>
+	[[nodiscard]] auto top_k( thread_pool &pool, RandomIterator first,
+	                          RandomIterator last, std::size_t k,
+	                          Compare comp = Compare{ } ) {
+		using value_type =
+		  typename std::iterator_traits<RandomIterator>::value_type;
+		auto const size = static_cast<std::size_t>( std::distance( first, last ) );
+		auto const chunk_count = std::max(
+		  std::min( pool.size( ), size / top_k_impl::min_chunk_size ),
+		  std::size_t{ 1 } );
+
+		auto runs = std::vector<std::vector<value_type>>( chunk_count );
+		pool.for_each_index( chunk_count, [&]( std::size_t n ) {
+			auto const chunk_first = ( size * n ) / chunk_count;
+			auto const chunk_last = ( size * ( n + 1U ) ) / chunk_count;
+			auto kept = daw::keep_n_heap<value_type, Compare>( k, comp );
+			kept.reserve( chunk_last - chunk_first );
+			kept.insert(
+			  std::next( first, static_cast<std::ptrdiff_t>( chunk_first ) ),
+			  std::next( first, static_cast<std::ptrdiff_t>( chunk_last ) ) );
+			runs[n] = kept.take_sorted( );
+		} );
+		return merge_top_k( pool, daw::move( runs ), k, daw::move( comp ) );
+	}
+
+	template<typename RandomIterator, typename Compare = std::less<>>
+	[[nodiscard]] auto top_k( RandomIterator first, RandomIterator last,
+	                          std::size_t k, Compare comp = Compare{ } ) {
+		return daw::parallel::top_k( daw::default_thread_pool( ), first, last, k,
+		                             daw::move( comp ) );
+	}
+} // namespace daw::parallel
@@ -0,0 +1,367 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_algorithm.h"
+#include "daw/daw_benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+template<typename T>
+std::vector<T> make_values( std::size_t count, int lo, int hi ) {
+	static auto rng = std::mt19937_64( 0xDA'77'5EEDULL );
+	auto dist = std::uniform_int_distribution<int>( lo, hi );
+	auto result = std::vector<T>( count );
+	for( auto &v : result ) {
+		v = static_cast<T>( dist( rng ) );
+	}
+	return result;
+}
+
+template<typename T>
+void check_find( ) {
+	for( std::size_t size = 0; size < 150; ++size ) {
+		auto values = make_values<T>( size, 0, 9 );
+		daw::expecting(
+		  std::find( values.begin( ), values.end( ), T( 10 ) ) ==
+		  daw::algorithm::find( values.begin( ), values.end( ), T( 10 ) ) );
+		for( std::size_t pos = 0; pos < size; ++pos ) {
+			auto copy = values;
+			copy[pos] = T( 10 );
+			auto const it = daw::algorithm::find( copy.cbegin( ), copy.cend( ), T( 10 ) );
+			daw::expecting( pos, static_cast<std::size_t>( it - copy.cbegin( ) ) );
+		}
+	}
+}
+
+void daw_algorithm_simd_find_001( ) {
+	check_find<std::int8_t>( );
+	check_find<std::uint16_t>( );
+	check_find<std::int32_t>( );
+	check_find<std::uint64_t>( );
+	check_find<float>( );
+	check_find<double>( );
+}
+
+void daw_algorithm_simd_find_nan_001( ) {
+	auto values = std::vector<double>( 40, 1.0 );
+	values[7] = std::numeric_limits<double>::quiet_NaN( );
+	values[20] = -0.0;
+	daw::expecting( values.end( ) ==
+	                daw::algorithm::find( values.begin( ), values.end( ),
+	                                      values[7] ) );
+	daw::expecting( values.begin( ) + 20 ==
+	                daw::algorithm::find( values.begin( ), values.end( ), 0.0 ) );
+}
+
+template<typename T>
+void check_equal( ) {
+	for( std::size_t size = 0; size < 150; ++size ) {
+		auto const lhs = make_values<T>( size, -50, 50 );
+		daw::expecting( daw::algorithm::equal( lhs.begin( ), lhs.end( ),
+		                                       lhs.begin( ), lhs.end( ) ) );
+		daw::expecting(
+		  daw::algorithm::equal( lhs.begin( ), lhs.end( ), lhs.begin( ) ) );
+		for( std::size_t pos = 0; pos < size; ++pos ) {
+			auto rhs = lhs;
+			rhs[pos] = static_cast<T>( rhs[pos] + 1 );
+			daw::expecting( not daw::algorithm::equal( lhs.begin( ), lhs.end( ),
+			                                           rhs.begin( ), rhs.end( ) ) );
+			daw::expecting(
+			  not daw::algorithm::equal( lhs.begin( ), lhs.end( ), rhs.begin( ) ) );
+			bool const expected = std::lexicographical_compare(
+			  lhs.begin( ), lhs.end( ), rhs.begin( ), rhs.end( ) );
+			daw::expecting( expected, daw::algorithm::lexicographical_compare(
+			                            lhs.begin( ), lhs.end( ), rhs.begin( ),
+			                            rhs.end( ) ) );
+			daw::expecting( not expected, daw::algorithm::lexicographical_compare(
+			                                rhs.begin( ), rhs.end( ), lhs.begin( ),
+			                                lhs.end( ) ) );
+		}
+		if( size > 0 ) {
+			// A prefix compares less
+			daw::expecting( daw::algorithm::lexicographical_compare(
+			  lhs.begin( ), lhs.end( ) - 1, lhs.begin( ), lhs.end( ) ) );
+			daw::expecting( not daw::algorithm::equal( lhs.begin( ), lhs.end( ) - 1,
+			                                           lhs.begin( ), lhs.end( ) ) );
+		}
+	}
+}
+
+void daw_algorithm_simd_equal_001( ) {
+	check_equal<std::int8_t>( );
+	check_equal<std::uint8_t>( );
+	check_equal<std::int16_t>( );
+	check_equal<std::int32_t>( );
+	check_equal<std::int64_t>( );
+	check_equal<float>( );
+	check_equal<double>( );
+}
+
+void daw_algorithm_simd_equal_string_001( ) {
+	std::string const a = "The quick brown fox jumps over the lazy dog!";
+	std::string b = a;
+	daw::expecting(
+	  daw::algorithm::equal( a.begin( ), a.end( ), b.begin( ), b.end( ) ) );
+	b.back( ) = '?';
+	daw::expecting(
+	  not daw::algorithm::equal( a.begin( ), a.end( ), b.begin( ), b.end( ) ) );
+	daw::expecting( daw::algorithm::lexicographical_compare(
+	                  b.begin( ), b.end( ), a.begin( ), a.end( ) ) ==
+	                std::lexicographical_compare( b.begin( ), b.end( ),
+	                                              a.begin( ), a.end( ) ) );
+}
+
+template<typename T>
+void check_minmax( int lo, int hi ) {
+	for( std::size_t size = 1; size < 300; size += 7 ) {
+		auto const values = make_values<T>( size, lo, hi );
+		auto const expected = std::minmax_element( values.begin( ), values.end( ) );
+		auto const result =
+		  daw::algorithm::minmax_element( values.begin( ), values.end( ) );
+		daw::expecting( expected.first == result.min_element );
+		daw::expecting( expected.second == result.max_element );
+	}
+	auto const extremes = std::vector<T>{ std::numeric_limits<T>::max( ),
+	                                      std::numeric_limits<T>::min( ),
+	                                      T( 0 ),
+	                                      std::numeric_limits<T>::max( ) };
+	auto values = std::vector<T>( 100, T( 1 ) );
+	std::copy( extremes.begin( ), extremes.end( ), values.begin( ) + 50 );
+	auto const result =
+	  daw::algorithm::minmax_element( values.begin( ), values.end( ) );
+	daw::expecting( 51, result.min_element - values.begin( ) );
+	daw::expecting( 53, result.max_element - values.begin( ) );
+}
+
+void daw_algorithm_simd_minmax_001( ) {
+	check_minmax<std::int8_t>( -100, 100 );
+	check_minmax<std::uint8_t>( 0, 255 );
+	check_minmax<std::int16_t>( -1000, 1000 );
+	check_minmax<std::uint16_t>( 0, 60000 );
+	check_minmax<std::int32_t>( -5, 5 );
+	check_minmax<std::uint32_t>( 0, 1'000'000 );
+	check_minmax<std::int64_t>( -1'000'000, 1'000'000 );
+	check_minmax<std::uint64_t>( 0, 20 );
+}
+
+template<typename T>
+void check_accumulate( ) {
+	for( std::size_t size = 0; size < 300; size += 13 ) {
+		auto const values = make_values<T>( size, 0, 1'000'000 );
+		auto const expected = std::accumulate( values.begin( ), values.end( ), T( 3 ) );
+		daw::expecting( expected, daw::algorithm::accumulate( values.begin( ),
+		                                                      values.end( ), T( 3 ) ) );
+		daw::expecting( expected,
+		                daw::algorithm::accumulate( values.begin( ), values.end( ),
+		                                            T( 3 ), std::plus<>{ } ) );
+	}
+	// Unsigned sums wrap the same whatever order they are added in
+	auto const big = std::vector<std::uint32_t>( 1000, 0xFFFF'FFF0U );
+	daw::expecting(
+	  std::accumulate( big.begin( ), big.end( ), std::uint32_t{ 1 } ),
+	  daw::algorithm::accumulate( big.begin( ), big.end( ), std::uint32_t{ 1 } ) );
+}
+
+void daw_algorithm_simd_accumulate_001( ) {
+	check_accumulate<std::int32_t>( );
+	check_accumulate<std::uint32_t>( );
+	check_accumulate<std::int64_t>( );
+	check_accumulate<std::uint64_t>( );
+}
+
+void daw_algorithm_simd_transform_n_001( ) {
+	auto const values = make_values<std::int32_t>( 1000, -1000, 1000 );
+	auto out = std::vector<double>( values.size( ) );
+	auto const last = daw::algorithm::transform_n(
+	  values.data( ), out.data( ), values.size( ),
+	  []( std::int32_t v ) { return v * 0.5; } );
+	daw::expecting( values.data( ) + values.size( ) == last.input );
+	daw::expecting( out.data( ) + out.size( ) == last.output );
+	for( std::size_t n = 0; n < values.size( ); ++n ) {
+		daw::expecting( values[n] * 0.5, out[n] );
+	}
+
+	// In place
+	auto in_place = values;
+	daw::algorithm::transform_n( in_place.begin( ), in_place.begin( ),
+	                             in_place.size( ),
+	                             []( std::int32_t v ) { return v + 1; } );
+	for( std::size_t n = 0; n < values.size( ); ++n ) {
+		daw::expecting( values[n] + 1, in_place[n] );
+	}
+
+	// Partially overlapping ranges keep the element by element order
+	auto shifted = std::vector<std::int32_t>( 100 );
+	std::iota( shifted.begin( ), shifted.end( ), 0 );
+	daw::algorithm::transform_n( shifted.data( ), shifted.data( ) + 1, 99,
+	                             []( std::int32_t v ) { return v; } );
+	daw::expecting( std::all_of( shifted.begin( ), shifted.end( ),
+	                             []( std::int32_t v ) { return v == 0; } ) );
+}
+
+void daw_algorithm_simd_transform_n_002( ) {
+	// A functor carrying a running sum between calls must see them in order
+	auto const values = std::vector<std::int32_t>( 1000, 1 );
+	auto sums = std::vector<std::int32_t>( values.size( ) );
+	auto out = std::vector<std::int32_t>( values.size( ) );
+	std::size_t j = 0;
+	daw::algorithm::transform_n( values.data( ), out.data( ), values.size( ),
+	                             [&]( std::int32_t x ) {
+		                             sums[j] = x + ( j > 0 ? sums[j - 1] : 0 );
+		                             return sums[j++];
+	                             } );
+	daw::expecting( 1000, out.back( ) );
+	for( std::size_t n = 0; n < out.size( ); ++n ) {
+		daw::expecting( static_cast<std::int32_t>( n + 1U ), out[n] );
+	}
+}
+
+constexpr bool daw_algorithm_simd_constexpr_001( ) {
+	std::array<int, 64> a{ };
+	for( std::size_t n = 0; n < a.size( ); ++n ) {
+		a[n] = static_cast<int>( ( n * 37U ) % 61U );
+	}
+	auto const mm = daw::algorithm::minmax_element( a.begin( ), a.end( ) );
+	return *daw::algorithm::find( a.begin( ), a.end( ), 60 ) == 60 and
+	       daw::algorithm::equal( a.begin( ), a.end( ), a.begin( ) ) and
+	       not daw::algorithm::lexicographical_compare( a.begin( ), a.end( ),
+	                                                    a.begin( ), a.end( ) ) and
+	       daw::algorithm::accumulate( a.begin( ), a.end( ), 0 ) > 0 and
+	       *mm.min_element == 0 and *mm.max_element == 60;
+}
+static_assert( daw_algorithm_simd_constexpr_001( ) );
+
+template<typename T>
+void bench_type( char const *name ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 100'000;
+#else
+	constexpr std::size_t data_size = 10'000'000;
+#endif
+	auto const values = make_values<T>( data_size, 0, 100 );
+	auto const copy = values;
+	std::cout << name << ' ' << data_size << " values\n";
+	daw::bench_n_test_mbs<5>(
+	  "daw::algorithm::find", data_size * sizeof( T ),
+	  []( auto const &v ) {
+		  daw::do_not_optimize(
+		    daw::algorithm::find( v.begin( ), v.end( ), T( 101 ) ) );
+	  },
+	  values );
+	daw::bench_n_test_mbs<5>(
+	  "std::find", data_size * sizeof( T ),
+	  []( auto const &v ) {
+		  daw::do_not_optimize( std::find( v.begin( ), v.end( ), T( 101 ) ) );
+	  },
+	  values );
+	daw::bench_n_test_mbs<5>(
+	  "daw::algorithm::equal", data_size * sizeof( T ),
+	  [&]( auto const &v ) {
+		  daw::do_not_optimize( daw::algorithm::equal( v.begin( ), v.end( ),
+		                                               copy.begin( ), copy.end( ) ) );
+	  },
+	  values );
+	daw::bench_n_test_mbs<5>(
+	  "std::equal", data_size * sizeof( T ),
+	  [&]( auto const &v ) {
+		  daw::do_not_optimize(
+		    std::equal( v.begin( ), v.end( ), copy.begin( ), copy.end( ) ) );
+	  },
+	  values );
+	daw::bench_n_test_mbs<5>(
+	  "daw::algorithm::lexicographical_compare", data_size * sizeof( T ),
+	  [&]( auto const &v ) {
+		  daw::do_not_optimize( daw::algorithm::lexicographical_compare(
+		    v.begin( ), v.end( ), copy.begin( ), copy.end( ) ) );
+	  },
+	  values );
+	daw::bench_n_test_mbs<5>(
+	  "std::lexicographical_compare", data_size * sizeof( T ),
+	  [&]( auto const &v ) {
+		  daw::do_not_optimize( std::lexicographical_compare(
+		    v.begin( ), v.end( ), copy.begin( ), copy.end( ) ) );
+	  },
+	  values );
+	if constexpr( std::is_integral_v<T> ) {
+		daw::bench_n_test_mbs<5>(
+		  "daw::algorithm::minmax_element", data_size * sizeof( T ),
+		  []( auto const &v ) {
+			  auto const r = daw::algorithm::minmax_element( v.begin( ), v.end( ) );
+			  daw::do_not_optimize( r.min_element );
+			  daw::do_not_optimize( r.max_element );
+		  },
+		  values );
+		daw::bench_n_test_mbs<5>(
+		  "std::minmax_element", data_size * sizeof( T ),
+		  []( auto const &v ) {
+			  daw::do_not_optimize( std::minmax_element( v.begin( ), v.end( ) ) );
+		  },
+		  values );
+	}
+	if constexpr( std::is_integral_v<T> and sizeof( T ) >= 4 ) {
+		daw::bench_n_test_mbs<5>(
+		  "daw::algorithm::accumulate", data_size * sizeof( T ),
+		  []( auto const &v ) {
+			  daw::do_not_optimize(
+			    daw::algorithm::accumulate( v.begin( ), v.end( ), T( 0 ) ) );
+		  },
+		  values );
+		daw::bench_n_test_mbs<5>(
+		  "std::accumulate", data_size * sizeof( T ),
+		  []( auto const &v ) {
+			  daw::do_not_optimize( std::accumulate( v.begin( ), v.end( ), T( 0 ) ) );
+		  },
+		  values );
+	}
+	auto out = std::vector<T>( data_size );
+	daw::bench_n_test_mbs<5>(
+	  "daw::algorithm::transform_n", data_size * sizeof( T ),
+	  [&]( auto const &v ) {
+		  daw::algorithm::transform_n( v.data( ), out.data( ), v.size( ),
+		                               []( T x ) { return static_cast<T>( x * 3 ); } );
+		  daw::do_not_optimize( out );
+	  },
+	  values );
+	daw::bench_n_test_mbs<5>(
+	  "std::transform", data_size * sizeof( T ),
+	  [&]( auto const &v ) {
+		  std::transform( v.begin( ), v.end( ), out.begin( ),
+		                  []( T x ) { return static_cast<T>( x * 3 ); } );
+		  daw::do_not_optimize( out );
+	  },
+	  values );
+}
+
+void daw_algorithm_simd_bench_001( ) {
+	bench_type<std::uint8_t>( "uint8_t" );
+	bench_type<std::int32_t>( "int32_t" );
+	bench_type<std::uint64_t>( "uint64_t" );
+	bench_type<double>( "double" );
+}
+
+int main( ) {
+	daw_algorithm_simd_find_001( );
+	daw_algorithm_simd_find_nan_001( );
+	daw_algorithm_simd_equal_001( );
+	daw_algorithm_simd_equal_string_001( );
+	daw_algorithm_simd_minmax_001( );
+	daw_algorithm_simd_accumulate_001( );
+	daw_algorithm_simd_transform_n_001( );
+	daw_algorithm_simd_transform_n_002( );
+	daw_algorithm_simd_bench_001( );
+}
@@ -16,7 +16,10 @@
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <list>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 constexpr bool daw_safe_advance_test_001( ) {
@@ -769,6 +772,48 @@ constexpr bool cartesian_product_test_001( ) {
 }
 static_assert( cartesian_product_test_001( ) );
 
+constexpr bool cartesian_product_map_test_001( ) {
+	std::array<int, 5> a = { 1, 2, 3, 4, 5 };
+	std::array<int, 5> b = { 9, 8, 7, 6, 5 };
+	std::array<int, 5> out{ };
+	auto const last = daw::algorithm::cartesian_product_map(
+	  []( int l, int r ) { return l * r; }, a.begin( ), a.end( ), out.begin( ),
+	  b.begin( ) );
+	daw::expecting( last == out.end( ) );
+	daw::expecting( 9, out[0] );
+	daw::expecting( 25, out[4] );
+	return true;
+}
+static_assert( cartesian_product_map_test_001( ) );
+
+constexpr bool cartesian_product_map_soa_test_001( ) {
+	std::array<int, 4> a = { 1, 2, 3, 4 };
+	std::array<int, 4> b = { 4, 3, 2, 1 };
+	std::array<int, 4> sums{ };
+	std::array<int, 4> products{ };
+	auto const [sums_last, products_last] =
+	  daw::algorithm::cartesian_product_map_soa(
+	    []( int l, int r ) { return std::pair{ l + r, l * r }; }, a.begin( ),
+	    a.end( ), std::tuple{ sums.begin( ), products.begin( ) }, b.begin( ) );
+	daw::expecting( sums_last == sums.end( ) );
+	daw::expecting( products_last == products.end( ) );
+	daw::expecting( 5, sums[0] );
+	daw::expecting( 5, sums[3] );
+	daw::expecting( 6, products[1] );
+	return true;
+}
+static_assert( cartesian_product_map_soa_test_001( ) );
+
+void cartesian_product_map_list_test_001( ) {
+	// Iterators that are not random access are walked element by element
+	auto const a = std::list<int>{ 1, 2, 3 };
+	auto const b = std::vector<int>{ 3, 2, 1 };
+	auto out = std::vector<int>( );
+	daw::algorithm::cartesian_product_map( std::plus<>{ }, a.begin( ), a.end( ),
+	                                       std::back_inserter( out ), b.begin( ) );
+	daw::expecting( std::vector<int>{ 4, 4, 4 }, out );
+}
+
 void daw_extract_to_001( ) {
 #if defined( __cpp_lib_node_extract )
 	std::unordered_map<int, int> a = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
@@ -831,4 +876,5 @@ static_assert( adjacent_find_test( ) );
 
 int main( ) {
 	daw_extract_to_001( );
+	cartesian_product_map_list_test_001( );
 }
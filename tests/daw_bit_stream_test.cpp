@@ -0,0 +1,183 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_bit_stream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+void bit_stream_test_001( ) {
+	auto const data = std::vector<std::uint8_t>{ 0b1010'0000, 0b1111'0000 };
+	auto bs = daw::make_bit_stream( data.begin( ), data.end( ) );
+	// Bits come from the low end of each element
+	daw::expecting( 0U, bs.pop_bits( 3 ) );
+	daw::expecting( 0b10100U, bs.pop_bits( 5 ) );
+	daw::expecting( 0U, bs.pop_bits( 4 ) );
+}
+
+void bit_writer_layout_001( ) {
+	auto msb = daw::bit_writer<daw::bit_order::msb_first>( );
+	msb.write( 0b101U, 3 );
+	msb.write( 0b11111U, 5 );
+	msb.write( 0b1U, 1 );
+	daw::expecting( 9U, msb.size( ) );
+	daw::expecting( std::vector<unsigned char>{ 0b1011'1111, 0b1000'0000 },
+	                msb.release( ) );
+
+	auto lsb = daw::bit_writer<daw::bit_order::lsb_first>( );
+	lsb.write( 0b101U, 3 );
+	lsb.write( 0b11111U, 5 );
+	lsb.write( 0b1U, 1 );
+	daw::expecting( std::vector<unsigned char>{ 0b1111'1101, 0b0000'0001 },
+	                lsb.release( ) );
+}
+
+void bit_reader_peek_consume_001( ) {
+	auto const data = std::vector<unsigned char>{ 0xDE, 0xAD, 0xBE, 0xEF };
+	auto msb = daw::bit_reader<daw::bit_order::msb_first>( data.data( ),
+	                                                        data.size( ) );
+	daw::expecting( 32U, msb.size( ) );
+	msb.refill( );
+	daw::expecting( 0xDU, msb.peek( 4 ) );
+	daw::expecting( 0xDEADU, msb.peek( 16 ) );
+	msb.consume( 8 );
+	daw::expecting( 0xADBEEFU, msb.read( 24 ) );
+	daw::expecting( msb.empty( ) );
+
+	auto lsb = daw::bit_reader<daw::bit_order::lsb_first>( data.data( ),
+	                                                        data.size( ) );
+	daw::expecting( 0xEU, lsb.read( 4 ) );
+	daw::expecting( 0xDU, lsb.read( 4 ) );
+	lsb.skip( 8 );
+	daw::expecting( 0xEFBEU, lsb.read( 16 ) );
+	// Past the end reads as zero
+	lsb.refill( );
+	daw::expecting( 0U, lsb.peek( 8 ) );
+}
+
+// Random field widths from 0 to 64 bits written and read back
+template<daw::bit_order Order>
+void bit_round_trip_001( ) {
+	// A field of this width stands for aligning to a byte
+	constexpr std::size_t align_marker = 65;
+	auto rng = std::mt19937_64( 42 );
+	for( std::size_t field_count : { 0U, 1U, 7U, 100U, 10'000U } ) {
+		auto fields = std::vector<std::pair<std::uint64_t, std::size_t>>( );
+		auto writer = daw::bit_writer<Order>( );
+		std::size_t total_bits = 0;
+		for( std::size_t n = 0; n < field_count; ++n ) {
+			auto const bits = static_cast<std::size_t>( rng( ) % 65U );
+			auto const value = rng( ) & daw::bit_stream_impl::low_mask( bits );
+			fields.emplace_back( value, bits );
+			writer.write( value, bits );
+			total_bits += bits;
+			if( n % 97U == 0 ) {
+				writer.align_to_byte( );
+				total_bits = writer.size( );
+				fields.emplace_back( 0, align_marker );
+			}
+		}
+		daw::expecting( total_bits, writer.size( ) );
+		auto const bytes = writer.release( );
+		daw::expecting( ( total_bits + 7U ) / 8U, bytes.size( ) );
+
+		auto reader = daw::bit_reader<Order>( bytes.data( ), bytes.size( ) );
+		for( auto const &[value, bits] : fields ) {
+			if( bits == align_marker ) {
+				reader.align_to_byte( );
+				continue;
+			}
+			daw::expecting( value, reader.read( bits ) );
+		}
+		daw::expecting( reader.size( ) < 8U );
+	}
+}
+
+void bit_reader_bench_001( ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t field_count = 100'000;
+#else
+	constexpr std::size_t field_count = 10'000'000;
+#endif
+	auto rng = std::mt19937_64( 1 );
+	auto widths = std::vector<std::size_t>( field_count );
+	auto writer = daw::bit_writer<daw::bit_order::msb_first>( field_count );
+	for( auto &w : widths ) {
+		w = 1U + static_cast<std::size_t>( rng( ) % 8U );
+		writer.write( rng( ), w );
+	}
+	auto const bytes = writer.release( );
+	daw::bench_n_test_mbs<5>(
+	  "bit_stream pop_bits", bytes.size( ),
+	  [&]( auto const &buff ) {
+		  auto bs = daw::make_bit_stream( buff.begin( ), buff.end( ) );
+		  std::uint64_t sum = 0;
+		  for( auto w : widths ) {
+			  sum += bs.pop_bits( w );
+		  }
+		  return sum;
+	  },
+	  bytes );
+	daw::bench_n_test_mbs<5>(
+	  "bit_reader read", bytes.size( ),
+	  [&]( auto const &buff ) {
+		  auto reader = daw::bit_reader<daw::bit_order::msb_first>( buff.data( ),
+		                                                            buff.size( ) );
+		  std::uint64_t sum = 0;
+		  for( auto w : widths ) {
+			  sum += reader.read( w );
+		  }
+		  return sum;
+	  },
+	  bytes );
+	daw::bench_n_test_mbs<5>(
+	  "bit_reader refill/peek/consume", bytes.size( ),
+	  [&]( auto const &buff ) {
+		  auto reader = daw::bit_reader<daw::bit_order::msb_first>( buff.data( ),
+		                                                            buff.size( ) );
+		  std::uint64_t sum = 0;
+		  std::size_t n = 0;
+		  // Each refill is good for at least 7 fields of up to 8 bits
+		  for( ; n + 7U <= widths.size( ); n += 7U ) {
+			  reader.refill( );
+			  for( std::size_t m = n; m < n + 7U; ++m ) {
+				  sum += reader.peek( widths[m] );
+				  reader.consume( widths[m] );
+			  }
+		  }
+		  for( ; n < widths.size( ); ++n ) {
+			  sum += reader.read( widths[n] );
+		  }
+		  return sum;
+	  },
+	  bytes );
+	daw::bench_n_test_mbs<5>(
+	  "bit_writer write", bytes.size( ),
+	  [&]( auto const &w ) {
+		  auto out = daw::bit_writer<daw::bit_order::msb_first>( bytes.size( ) );
+		  for( auto bits : w ) {
+			  out.write( bits, bits );
+		  }
+		  return out.release( ).size( );
+	  },
+	  widths );
+}
+
+int main( ) {
+	bit_stream_test_001( );
+	bit_writer_layout_001( );
+	bit_reader_peek_consume_001( );
+	bit_round_trip_001<daw::bit_order::msb_first>( );
+	bit_round_trip_001<daw::bit_order::lsb_first>( );
+	bit_reader_bench_001( );
+}
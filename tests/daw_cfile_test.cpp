@@ -0,0 +1,106 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_cfile.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+std::vector<std::string> make_lines( ) {
+	std::vector<std::string> lines{ };
+	for( std::size_t n = 0; n < 100; ++n ) {
+		lines.push_back( std::string( n % 37, static_cast<char>( 'a' + n % 26 ) ) );
+	}
+	// Larger than the reader's buffer
+	lines.push_back( std::string( 200, 'z' ) );
+	lines.push_back( "last" );
+	return lines;
+}
+
+void write_lines( char const *file_name, std::vector<std::string> const &lines,
+                  char delimiter, bool trailing ) {
+	auto f = daw::CFile( std::fopen( file_name, "wb" ) );
+	daw::expecting_message( f.get( ) != nullptr, "Could not create test file" );
+	for( std::size_t n = 0; n < lines.size( ); ++n ) {
+		std::fwrite( lines[n].data( ), 1, lines[n].size( ), f.get( ) );
+		if( trailing or n + 1 < lines.size( ) ) {
+			std::fputc( delimiter, f.get( ) );
+		}
+	}
+}
+
+void daw_cfile_reader_001( ) {
+	auto const lines = make_lines( );
+	char const *file_name = "./daw_cfile_reader_001.txt";
+	for( bool trailing : { true, false } ) {
+		write_lines( file_name, lines, '\n', trailing );
+		auto reader = daw::cfile_reader(
+		  daw::CFile( std::fopen( file_name, "rb" ) ), 64 );
+		std::vector<std::string> result{ };
+		while( auto line = reader.next_line( ) ) {
+			result.emplace_back( line->data( ), line->size( ) );
+		}
+		daw::expecting( reader.eof( ) );
+		daw::expecting( not reader.has_error( ) );
+		daw::expecting( lines.size( ), result.size( ) );
+		for( std::size_t n = 0; n < lines.size( ); ++n ) {
+			daw::expecting( lines[n], result[n] );
+		}
+	}
+	std::remove( file_name );
+}
+
+void daw_cfile_reader_002( ) {
+	auto const lines = make_lines( );
+	char const *file_name = "./daw_cfile_reader_002.txt";
+	write_lines( file_name, lines, '\0', true );
+	auto reader =
+	  daw::cfile_reader( daw::CFile( std::fopen( file_name, "rb" ) ), 16 );
+	std::size_t pos = 0;
+	auto const count = reader.for_each_record(
+	  [&]( daw::string_view rec ) {
+		  daw::expecting( lines[pos++], std::string( rec.data( ), rec.size( ) ) );
+	  },
+	  '\0' );
+	daw::expecting( lines.size( ), count );
+	std::remove( file_name );
+}
+
+void daw_cfile_async_writer_001( daw::cfile_write_mode mode ) {
+	char const *file_name = "./daw_cfile_async_writer_001.txt";
+	std::string expected{ };
+	{
+		auto writer = daw::cfile_async_writer(
+		  daw::CFile( std::fopen( file_name, "wb" ) ), mode, 4096 );
+		for( std::size_t n = 0; n < 5000; ++n ) {
+			auto const line = std::to_string( n ) + '\n';
+			writer.write( line );
+			expected += line;
+			if( n == 1234 ) {
+				daw::expecting( writer.flush( ) );
+			}
+		}
+		daw::expecting( writer.close( ) );
+	}
+	auto reader = daw::cfile_reader( daw::CFile( std::fopen( file_name, "rb" ) ),
+	                                 1024U * 1024U );
+	auto const result = reader.next_record( '\0' );
+	daw::expecting( result );
+	daw::expecting( expected, std::string( result->data( ), result->size( ) ) );
+	std::remove( file_name );
+}
+
+int main( ) {
+	daw_cfile_reader_001( );
+	daw_cfile_reader_002( );
+	daw_cfile_async_writer_001( daw::cfile_write_mode::buffered );
+	daw_cfile_async_writer_001( daw::cfile_write_mode::direct );
+}
@@ -8,14 +8,183 @@
 
 #include "daw/daw_benchmark.h"
 #include "daw/daw_clumpy_sparsy.h"
+#include "daw/daw_memory_resource.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 void clumpy_sparsy_test_001( ) {
-	// TODO: Why are we not testing?
-	/*	daw::clumpy_sparsy<int> t;
-	    auto b = t.begin( );
-	    b == b;*/
+	daw::clumpy_sparsy<int> t;
+	daw::expecting( t.empty( ) );
+	daw::expecting( t.begin( ) == t.end( ) );
+	daw::expecting( t.find( 5 ) == nullptr );
+
+	t[10] = 1;
+	t[12] = 3;
+	daw::expecting( 2U, t.chunk_count( ) );
+	daw::expecting( 13U, t.size( ) );
+	daw::expecting( 2U, t.element_count( ) );
+	// Filling the gap joins the two chunks
+	t[11] = 2;
+	daw::expecting( 1U, t.chunk_count( ) );
+	// Prepending extends the chunk down
+	t[9] = 0;
+	daw::expecting( 1U, t.chunk_count( ) );
+	daw::expecting( 4U, t.element_count( ) );
+	for( std::size_t n = 9; n < 13; ++n ) {
+		daw::expecting( static_cast<int>( n ) - 9, *t.find( n ) );
+	}
+	daw::expecting( not t.contains( 8 ) );
+	daw::expecting( not t.contains( 13 ) );
+
+	t.insert_or_assign( 11, 42 );
+	daw::expecting( 42, t[11] );
+	daw::expecting( 4U, t.element_count( ) );
+}
+
+void clumpy_sparsy_erase_001( ) {
+	daw::clumpy_sparsy<std::string> t;
+	for( std::size_t n = 0; n < 10; ++n ) {
+		t.insert_or_assign( n, std::to_string( n ) );
+	}
+	daw::expecting( 1U, t.chunk_count( ) );
+	// Splits in two
+	daw::expecting( t.erase( 5 ) );
+	daw::expecting( not t.erase( 5 ) );
+	daw::expecting( 2U, t.chunk_count( ) );
+	daw::expecting( std::string( "6" ), *t.find( 6 ) );
+	daw::expecting( std::string( "4" ), *t.find( 4 ) );
+	// Front and back
+	daw::expecting( t.erase( 0 ) );
+	daw::expecting( t.erase( 9 ) );
+	daw::expecting( 9U, t.size( ) );
+	daw::expecting( std::string( "1" ), *t.find( 1 ) );
+	daw::expecting( 7U, t.element_count( ) );
+	// Putting it back merges again
+	t.insert_or_assign( 5, "five" );
+	daw::expecting( 1U, t.chunk_count( ) );
+
+	std::vector<std::size_t> positions;
+	for( auto it = t.begin( ); it != t.end( ); ++it ) {
+		positions.push_back( it.position( ) );
+	}
+	daw::expecting( std::vector<std::size_t>{ 1, 2, 3, 4, 5, 6, 7, 8 },
+	                positions );
+	auto last = t.end( );
+	--last;
+	daw::expecting( std::string( "8" ), *last );
+
+	t.clear( );
+	daw::expecting( t.empty( ) );
+	daw::expecting( 0U, t.size( ) );
+	t[3] = "again";
+	daw::expecting( 1U, t.chunk_count( ) );
+}
+
+void clumpy_sparsy_dense_001( ) {
+	daw::clumpy_sparsy<int> t;
+	for( std::size_t n = 0; n < 4; ++n ) {
+		t[n] = 1;
+		t[n + 100] = 2;
+		t[n + 200] = 3;
+	}
+	std::vector<std::pair<std::size_t, std::size_t>> runs;
+	int sum = 0;
+	t.for_each_dense( [&]( std::size_t start, daw::span<int> values ) {
+		runs.emplace_back( start, values.size( ) );
+		for( int &v : values ) {
+			sum += v;
+			++v;
+		}
+	} );
+	daw::expecting( 3U, runs.size( ) );
+	daw::expecting( 100U, runs[1].first );
+	daw::expecting( 4U, runs[1].second );
+	daw::expecting( 24, sum );
+
+	// Clipped to [102, 201)
+	runs.clear( );
+	std::vector<int> firsts;
+	auto const &ct = t;
+	ct.for_each_dense(
+	  [&]( std::size_t start, daw::span<int const> values ) {
+		  runs.emplace_back( start, values.size( ) );
+		  firsts.push_back( values[0] );
+	  },
+	  102, 201 );
+	daw::expecting( 2U, runs.size( ) );
+	daw::expecting( 102U, runs[0].first );
+	daw::expecting( 2U, runs[0].second );
+	daw::expecting( 200U, runs[1].first );
+	daw::expecting( 1U, runs[1].second );
+	daw::expecting( 3, firsts[0] );
+	daw::expecting( 4, firsts[1] );
+}
+
+void clumpy_sparsy_pool_001( ) {
+	auto pool = daw::pool_resource( );
+	using alloc_t = daw::pool_allocator<int>;
+	auto t = daw::clumpy_sparsy<int, alloc_t>( alloc_t( pool ) );
+	for( std::size_t n = 0; n < 1000; ++n ) {
+		t[( n / 10 ) * 20 + n % 10] = static_cast<int>( n );
+	}
+	daw::expecting( 100U, t.chunk_count( ) );
+	daw::expecting( 999, t[99 * 20 + 9] );
+	daw::expecting( t.get_allocator( ).resource( ) == &pool );
+}
+
+void clumpy_sparsy_bench_001( ) {
+	constexpr std::size_t runs = 1000;
+	constexpr std::size_t run_length = 64;
+	daw::clumpy_sparsy<std::uint64_t> t;
+	std::map<std::size_t, std::uint64_t> m;
+	for( std::size_t r = 0; r < runs; ++r ) {
+		for( std::size_t n = 0; n < run_length; ++n ) {
+			std::size_t const pos = r * run_length * 2 + n;
+			t[pos] = pos;
+			m[pos] = pos;
+		}
+	}
+	daw::expecting( runs, t.chunk_count( ) );
+	std::size_t const extent = t.size( );
+	daw::bench_n_test<10>( "clumpy_sparsy find", [&] {
+		std::uint64_t sum = 0;
+		for( std::size_t pos = 0; pos < extent; ++pos ) {
+			if( auto const *v = t.find( pos ); v ) {
+				sum += *v;
+			}
+		}
+		return sum;
+	} );
+	daw::bench_n_test<10>( "std::map find", [&] {
+		std::uint64_t sum = 0;
+		for( std::size_t pos = 0; pos < extent; ++pos ) {
+			if( auto it = m.find( pos ); it != m.end( ) ) {
+				sum += it->second;
+			}
+		}
+		return sum;
+	} );
+	daw::bench_n_test<10>( "clumpy_sparsy for_each_dense", [&] {
+		std::uint64_t sum = 0;
+		t.for_each_dense( [&]( std::size_t, daw::span<std::uint64_t> values ) {
+			for( auto v : values ) {
+				sum += v;
+			}
+		} );
+		return sum;
+	} );
 }
 
 int main( ) {
 	clumpy_sparsy_test_001( );
+	clumpy_sparsy_erase_001( );
+	clumpy_sparsy_dense_001( );
+	clumpy_sparsy_pool_001( );
+	clumpy_sparsy_bench_001( );
 }
@@ -0,0 +1,321 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_algorithm_execution.h"
+#include "daw/daw_benchmark.h"
+#include "daw/daw_random.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Sizes on either side of the point where work is split into chunks
+constexpr std::size_t test_sizes[] = { 0U, 1U, 100U, 5'000U, 100'000U,
+                                       1'000'003U };
+
+template<typename Policy>
+void check_transform( Policy const &policy ) {
+	for( auto size : test_sizes ) {
+		auto const values = daw::make_random_data<std::int32_t>( size );
+		auto out = std::vector<std::int64_t>( size );
+		auto const last = daw::algorithm::transform(
+		  policy, values.begin( ), values.end( ), out.begin( ),
+		  []( std::int32_t v ) { return std::int64_t{ v } * 3; } );
+		daw::expecting( out.end( ) == last );
+		for( std::size_t n = 0; n < size; ++n ) {
+			daw::expecting( std::int64_t{ values[n] } * 3, out[n] );
+		}
+	}
+}
+
+template<typename Policy>
+void check_copy_fill( Policy const &policy ) {
+	for( auto size : test_sizes ) {
+		auto const values = daw::make_random_data<std::uint64_t>( size );
+		auto out = std::vector<std::uint64_t>( size );
+		daw::expecting( out.end( ) == daw::algorithm::copy( policy, values.begin( ),
+		                                                    values.end( ),
+		                                                    out.begin( ) ) );
+		daw::expecting( values == out );
+		daw::algorithm::fill( policy, out.begin( ), out.end( ), 42U );
+		daw::expecting( std::all_of( out.begin( ), out.end( ),
+		                             []( auto v ) { return v == 42U; } ) );
+	}
+	auto const strings = std::vector<std::string>( 20'000, "a string" );
+	auto out = std::vector<std::string>( strings.size( ) );
+	daw::algorithm::copy( policy, strings.begin( ), strings.end( ),
+	                      out.begin( ) );
+	daw::expecting( strings == out );
+}
+
+template<typename Policy>
+void check_reduce( Policy const &policy ) {
+	for( auto size : test_sizes ) {
+		auto const values = daw::make_random_data<std::uint32_t>( size, 0, 1000 );
+		auto const expected = std::accumulate( values.begin( ), values.end( ),
+		                                       std::uint64_t{ 7 } );
+		daw::expecting( expected, daw::algorithm::reduce(
+		                            policy, values.begin( ), values.end( ),
+		                            std::uint64_t{ 7 }, std::plus<>{ } ) );
+		daw::expecting( expected, daw::container::reduce( policy, values,
+		                                                  std::uint64_t{ 7 } ) );
+	}
+}
+
+template<typename Policy>
+void check_partition( Policy const &policy ) {
+	auto const is_even = []( std::uint32_t v ) { return v % 2U == 0; };
+	for( auto size : test_sizes ) {
+		for( std::uint32_t modulus : { 2U, 7U, 1000U } ) {
+			// Vary how many values match so the split point moves around
+			auto values = daw::make_random_data<std::uint32_t>( size );
+			for( auto &v : values ) {
+				v = v % modulus == 0 ? v * 2U : v * 2U + 1U;
+			}
+			auto sorted_before = values;
+			std::sort( sorted_before.begin( ), sorted_before.end( ) );
+			auto const split = daw::algorithm::partition(
+			  policy, values.begin( ), values.end( ), is_even );
+			daw::expecting(
+			  std::count_if( values.begin( ), values.end( ), is_even ),
+			  split - values.begin( ) );
+			daw::expecting( std::all_of( values.begin( ), split, is_even ) );
+			daw::expecting( std::none_of( split, values.end( ), is_even ) );
+			std::sort( values.begin( ), values.end( ) );
+			daw::expecting( sorted_before == values );
+		}
+	}
+}
+
+template<typename Policy>
+void check_cartesian_product( Policy const &policy ) {
+	for( auto size : test_sizes ) {
+		auto const a = daw::make_random_data<std::int32_t>( size, -1000, 1000 );
+		auto const b = daw::make_random_data<std::int32_t>( size, -1000, 1000 );
+		auto out = std::vector<std::int64_t>( size );
+		auto const last = daw::algorithm::cartesian_product_map(
+		  policy,
+		  []( std::int32_t l, std::int32_t r ) {
+			  return std::int64_t{ l } * std::int64_t{ r };
+		  },
+		  a.begin( ), a.end( ), out.begin( ), b.begin( ) );
+		daw::expecting( out.end( ) == last );
+
+		auto sums = std::vector<std::int32_t>( size );
+		auto diffs = std::vector<std::int32_t>( size );
+		auto const [sums_last, diffs_last] =
+		  daw::algorithm::cartesian_product_map_soa(
+		    policy,
+		    []( std::int32_t l, std::int32_t r ) {
+			    return std::tuple{ l + r, l - r };
+		    },
+		    a.begin( ), a.end( ), std::tuple{ sums.begin( ), diffs.begin( ) },
+		    b.begin( ) );
+		daw::expecting( sums.end( ) == sums_last );
+		daw::expecting( diffs.end( ) == diffs_last );
+
+		auto visited = std::vector<std::int32_t>( size );
+		daw::algorithm::cartesian_product(
+		  policy,
+		  [&]( std::int32_t const &l, std::int32_t const &r ) {
+			  visited[static_cast<std::size_t>( &l - a.data( ) )] = l * r;
+		  },
+		  a.begin( ), a.end( ), b.begin( ) );
+		for( std::size_t n = 0; n < size; ++n ) {
+			daw::expecting( std::int64_t{ a[n] } * b[n], out[n] );
+			daw::expecting( a[n] + b[n], sums[n] );
+			daw::expecting( a[n] - b[n], diffs[n] );
+			daw::expecting( a[n] * b[n], visited[n] );
+		}
+	}
+}
+
+template<typename Policy>
+void check_container( Policy const &policy ) {
+	auto values = daw::make_random_data<std::int32_t>( 200'000 );
+	auto expected = values;
+	std::sort( expected.begin( ), expected.end( ) );
+	daw::container::sort( policy, values );
+	daw::expecting( expected == values );
+	daw::container::sort( policy, values, std::greater<>{ } );
+	daw::expecting( std::is_sorted( values.begin( ), values.end( ),
+	                                std::greater<>{ } ) );
+
+	auto positions = std::vector<std::size_t>( 100'000 );
+	std::iota( positions.begin( ), positions.end( ), std::size_t{ 0 } );
+	auto doubled = std::vector<std::size_t>( positions.size( ) );
+	daw::container::for_each_with_pos(
+	  policy, positions, [&]( std::size_t const &v, std::size_t n ) {
+		  doubled[n] = v + n;
+	  } );
+	for( std::size_t n = 0; n < positions.size( ); ++n ) {
+		daw::expecting( n * 2U, doubled[n] );
+	}
+	daw::container::for_each_with_pos(
+	  policy, positions, 10U, 20U,
+	  [&]( std::size_t const &, std::size_t n ) { doubled[n] = 0; } );
+	daw::expecting( 18U, doubled[9] );
+	daw::expecting( 0U, doubled[10] );
+	daw::expecting( 0U, doubled[19] );
+	daw::expecting( 40U, doubled[20] );
+	positions = doubled;
+
+	daw::container::transform( policy, positions,
+	                           []( std::size_t v ) { return v + 1U; } );
+	daw::expecting( 1U, positions[0] );
+	daw::expecting( 41U, positions[20] );
+
+	auto copied = std::vector<std::size_t>( positions.size( ) );
+	daw::container::copy( policy, positions, copied.begin( ) );
+	daw::expecting( positions == copied );
+
+	auto appended = std::vector<std::size_t>{ 1, 2, 3 };
+	daw::container::append( policy, positions, appended );
+	daw::expecting( positions.size( ) + 3U, appended.size( ) );
+	daw::expecting( std::equal( positions.begin( ), positions.end( ),
+	                            appended.begin( ) + 3 ) );
+
+	auto const split = daw::container::partition(
+	  policy, positions, []( std::size_t v ) { return v < 1000U; } );
+	daw::expecting( std::all_of( positions.begin( ), split,
+	                             []( std::size_t v ) { return v < 1000U; } ) );
+}
+
+template<typename Policy>
+void check_policy( Policy const &policy ) {
+	check_transform( policy );
+	check_copy_fill( policy );
+	check_reduce( policy );
+	check_partition( policy );
+	check_cartesian_product( policy );
+	check_container( policy );
+}
+
+void daw_execution_policy_seq_001( ) {
+	check_policy( daw::execution::seq );
+}
+
+void daw_execution_policy_par_001( ) {
+	check_policy( daw::execution::par );
+}
+
+void daw_execution_policy_par_unseq_001( ) {
+	check_policy( daw::execution::par_unseq );
+}
+
+void daw_execution_policy_pool_001( ) {
+	auto pool = daw::thread_pool( 3 );
+	check_policy( daw::execution::par.on( pool ) );
+}
+
+void daw_execution_policy_list_001( ) {
+	// Iterators that are not random access run sequentially
+	auto values = std::list<int>{ 1, 2, 3, 4, 5, 6 };
+	auto out = std::vector<int>( values.size( ) );
+	daw::algorithm::transform( daw::execution::par, values.begin( ),
+	                           values.end( ), out.begin( ),
+	                           []( int v ) { return v * v; } );
+	daw::expecting( 36, out.back( ) );
+	auto const split = daw::algorithm::partition(
+	  daw::execution::par, values.begin( ), values.end( ),
+	  []( int v ) { return v > 3; } );
+	daw::expecting( 3, std::distance( values.begin( ), split ) );
+}
+
+void daw_execution_policy_exception_001( ) {
+	auto values = std::vector<int>( 100'000, 1 );
+	values[77'777] = 0;
+	bool caught = false;
+	try {
+		daw::algorithm::transform( daw::execution::par, values.begin( ),
+		                           values.end( ), values.begin( ), []( int v ) {
+			                           if( v == 0 ) {
+				                           throw std::runtime_error( "zero" );
+			                           }
+			                           return v;
+		                           } );
+	} catch( std::runtime_error const & ) { caught = true; }
+	daw::expecting( caught );
+}
+
+void daw_execution_policy_bench_001( ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 1'000'000;
+#else
+	constexpr std::size_t data_size = 20'000'000;
+#endif
+	auto const values = daw::make_random_data<std::uint32_t>( data_size );
+	auto out = std::vector<std::uint32_t>( data_size );
+	std::cout << data_size << " uint32_t on "
+	          << daw::default_thread_pool( ).size( ) << " threads\n";
+	auto const bench = [&]( char const *name, auto const &policy ) {
+		std::cout << name << '\n';
+		daw::bench_n_test_mbs<5>(
+		  "transform", data_size * sizeof( std::uint32_t ),
+		  [&]( auto const &v ) {
+			  daw::algorithm::transform( policy, v.begin( ), v.end( ),
+			                             out.begin( ), []( std::uint32_t x ) {
+				                             return x * 7U + ( x >> 3U );
+			                             } );
+			  daw::do_not_optimize( out );
+		  },
+		  values );
+		daw::bench_n_test_mbs<5>(
+		  "reduce", data_size * sizeof( std::uint32_t ),
+		  [&]( auto const &v ) {
+			  daw::do_not_optimize(
+			    daw::algorithm::reduce( policy, v.begin( ), v.end( ),
+			                            std::uint64_t{ 0 }, std::plus<>{ } ) );
+		  },
+		  values );
+		daw::bench_n_test_mbs<5>(
+		  "partition", data_size * sizeof( std::uint32_t ),
+		  [&]( auto v ) {
+			  daw::do_not_optimize( daw::algorithm::partition(
+			    policy, v.begin( ), v.end( ),
+			    []( std::uint32_t x ) { return x % 3U == 0; } ) );
+		  },
+		  values );
+		auto sums = std::vector<std::uint32_t>( data_size );
+		daw::bench_n_test_mbs<5>(
+		  "cartesian_product_map_soa", data_size * sizeof( std::uint32_t ) * 2U,
+		  [&]( auto const &v ) {
+			  daw::algorithm::cartesian_product_map_soa(
+			    policy,
+			    []( std::uint32_t l, std::uint32_t r ) {
+				    return std::tuple{ l + r, l ^ r };
+			    },
+			    v.begin( ), v.end( ), std::tuple{ sums.begin( ), out.begin( ) },
+			    v.rbegin( ) );
+			  daw::do_not_optimize( sums );
+			  daw::do_not_optimize( out );
+		  },
+		  values );
+	};
+	bench( "seq", daw::execution::seq );
+	bench( "par", daw::execution::par );
+	bench( "par_unseq", daw::execution::par_unseq );
+}
+
+int main( ) {
+	daw_execution_policy_seq_001( );
+	daw_execution_policy_par_001( );
+	daw_execution_policy_par_unseq_001( );
+	daw_execution_policy_pool_001( );
+	daw_execution_policy_list_001( );
+	daw_execution_policy_exception_001( );
+	daw_execution_policy_bench_001( );
+}
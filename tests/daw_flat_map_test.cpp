@@ -0,0 +1,174 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_flat_map.h"
+#include "daw/daw_memory_resource.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+template<typename Map>
+void flat_map_test_001( ) {
+	Map m;
+	daw::expecting( m.empty( ) );
+	daw::expecting( m.find( "b" ) == m.end( ) );
+	daw::expecting( m.insert( { "b", 2 } ).second );
+	daw::expecting( m.try_emplace( "a", 1 ).second );
+	daw::expecting( not m.try_emplace( "a", 10 ).second );
+	m["c"] = 3;
+	daw::expecting( 3U, m.size( ) );
+	daw::expecting( 1, m.at( "a" ) );
+	daw::expecting( 3, m["c"] );
+	daw::expecting( m.contains( "b" ) );
+	daw::expecting( not m.contains( "bb" ) );
+	daw::expecting( 0U, m.count( "d" ) );
+	daw::expecting_exception<std::out_of_range>( [&] { (void)m.at( "d" ); } );
+
+	// lower_bound of a missing key is the next key up
+	daw::expecting( std::string( "c" ), std::get<0>( *m.lower_bound( "bb" ) ) );
+	daw::expecting( m.lower_bound( "d" ) == m.end( ) );
+
+	daw::expecting( not m.insert_or_assign( "b", 20 ).second );
+	daw::expecting( 20, m.at( "b" ) );
+
+	std::string keys;
+	int sum = 0;
+	for( auto [key, value] : m ) {
+		keys += key;
+		sum += value;
+	}
+	daw::expecting( std::string( "abc" ), keys );
+	daw::expecting( 24, sum );
+
+	daw::expecting( 1U, m.erase( "a" ) );
+	daw::expecting( 0U, m.erase( "a" ) );
+	daw::expecting( std::string( "b" ), m.keys( )[0] );
+	daw::expecting( 20, m.values( )[0] );
+	m.clear( );
+	daw::expecting( m.empty( ) );
+}
+
+template<typename Map>
+void flat_map_insert_range_001( ) {
+	Map m{ { 5, 50 }, { 1, 10 } };
+	std::vector<std::pair<int, int>> more{
+	  { 3, 30 }, { 5, 0 }, { 9, 90 }, { 3, 0 }, { 0, 0 } };
+	m.insert_range( more.begin( ), more.end( ) );
+	daw::expecting( 5U, m.size( ) );
+	// Present keys and later duplicates do not overwrite
+	daw::expecting( 50, m.at( 5 ) );
+	daw::expecting( 30, m.at( 3 ) );
+	std::vector<int> keys( m.keys( ).begin( ), m.keys( ).end( ) );
+	daw::expecting( std::vector<int>{ 0, 1, 3, 5, 9 }, keys );
+
+	// Every key and gap of a larger map
+	auto big = Map( );
+	std::vector<std::pair<int, int>> items;
+	for( int n = 0; n < 1000; ++n ) {
+		items.emplace_back( n * 2, n );
+	}
+	big.insert_range( items.rbegin( ), items.rend( ) );
+	for( int n = 0; n < 1000; ++n ) {
+		daw::expecting( n, big.at( n * 2 ) );
+		daw::expecting( not big.contains( n * 2 + 1 ) );
+		if( n < 999 ) {
+			daw::expecting( n * 2 + 2, std::get<0>( *big.lower_bound( n * 2 + 1 ) ) );
+		}
+	}
+	daw::expecting( big.lower_bound( 1999 ) == big.end( ) );
+	daw::expecting( not big.contains( -1 ) );
+}
+
+void flat_map_lower_bound_001( ) {
+	// Both searches against std::lower_bound for every size up to 70
+	for( int size = 0; size < 70; ++size ) {
+		auto m = daw::eytzinger_flat_map<int, int>( );
+		for( int n = 0; n < size; ++n ) {
+			m[n * 3] = n;
+		}
+		for( int key = -1; key < size * 3 + 2; ++key ) {
+			auto const expected = static_cast<std::size_t>(
+			  std::lower_bound( m.keys( ).begin( ), m.keys( ).end( ), key ) -
+			  m.keys( ).begin( ) );
+			auto const found = m.lower_bound( key );
+			daw::expecting( expected == m.keys( ).size( )
+			                  ? found == m.end( )
+			                  : std::get<0>( *found ) == m.keys( )[expected] );
+			daw::expecting( expected,
+			                daw::flat_map_impl::branchless_lower_bound(
+			                  m.keys( ).data( ), m.keys( ).size( ), key,
+			                  std::less<int>( ) ) );
+		}
+	}
+}
+
+void flat_map_allocator_001( ) {
+	auto pool = daw::pool_resource( );
+	using alloc_t = daw::pool_allocator<std::pair<int const, int>>;
+	auto m = daw::flat_map<int, int, std::less<int>, alloc_t>( alloc_t( pool ) );
+	for( int n = 0; n < 100; ++n ) {
+		m[n] = n;
+	}
+	daw::expecting( 99, m.at( 99 ) );
+	daw::expecting( m.get_allocator( ).resource( ) == &pool );
+}
+
+void flat_map_bench_001( ) {
+	for( std::size_t size : { 100U, 10'000U, 100'000U } ) {
+		std::cout << "\nmap size: " << size << '\n';
+		auto rng = std::mt19937_64( 42 );
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> items;
+		for( std::size_t n = 0; n < size; ++n ) {
+			items.emplace_back( rng( ), n );
+		}
+		std::vector<std::uint64_t> lookups;
+		for( std::size_t n = 0; n < 100'000; ++n ) {
+			lookups.push_back( items[rng( ) % size].first );
+		}
+		auto fm = daw::flat_map<std::uint64_t, std::uint64_t>( items.begin( ),
+		                                                       items.end( ) );
+		auto em = daw::eytzinger_flat_map<std::uint64_t, std::uint64_t>(
+		  items.begin( ), items.end( ) );
+		auto sm = std::map<std::uint64_t, std::uint64_t>( items.begin( ),
+		                                                 items.end( ) );
+		auto um = std::unordered_map<std::uint64_t, std::uint64_t>(
+		  items.begin( ), items.end( ) );
+		auto const run = [&]( auto const &m ) {
+			std::uint64_t sum = 0;
+			for( auto key : lookups ) {
+				sum += std::get<1>( *m.find( key ) );
+			}
+			return sum;
+		};
+		daw::bench_n_test<10>( "flat_map find", [&] { return run( fm ); } );
+		daw::bench_n_test<10>( "eytzinger_flat_map find",
+		                       [&] { return run( em ); } );
+		daw::bench_n_test<10>( "std::map find", [&] { return run( sm ); } );
+		daw::bench_n_test<10>( "std::unordered_map find",
+		                       [&] { return run( um ); } );
+	}
+}
+
+int main( ) {
+	flat_map_test_001<daw::flat_map<std::string, int>>( );
+	flat_map_test_001<daw::eytzinger_flat_map<std::string, int>>( );
+	flat_map_insert_range_001<daw::flat_map<int, int>>( );
+	flat_map_insert_range_001<daw::eytzinger_flat_map<int, int>>( );
+	flat_map_lower_bound_001( );
+	flat_map_allocator_001( );
+	flat_map_bench_001( );
+}
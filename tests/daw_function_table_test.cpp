@@ -6,11 +6,16 @@
 // Official repository: https://github.com/beached/header_libraries
 //
 
+#include "daw/daw_benchmark.h"
 #include "daw/daw_function_table.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <random>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 using parser_func_t = std::add_pointer_t<uintmax_t( uintmax_t, char const * )>;
 
@@ -130,6 +135,102 @@ inline constexpr daw::function_table_t<
 	          return ftable( static_cast<size_t>( *c ), n, c );
           } };
 
+// Every entry a different type, like an opcode table of lambdas
+template<std::size_t I>
+struct mix_op {
+	constexpr uintmax_t operator( )( uintmax_t n ) const {
+		return n * 31U + I;
+	}
+};
+
+template<std::size_t... Is>
+constexpr auto make_mix_table( std::index_sequence<Is...> ) {
+	return daw::make_function_table<uintmax_t>( mix_op<Is>{ }... );
+}
+
+inline constexpr auto mix_table =
+  make_mix_table( std::make_index_sequence<200>{ } );
+
+static_assert( not decltype( mix_table )::using_array_v );
+static_assert( mix_table( 199, 1U ) == 230U );
+
+void heterogeneous_table_test_001( ) {
+	for( std::size_t n = 0; n < mix_table.size( ); ++n ) {
+		daw::expecting( 62U + n, mix_table( n, 2U ) );
+	}
+	constexpr auto with_empty = daw::make_function_table<int>(
+	  []( int x ) { return x; }, [] { return 42; } );
+	daw::expecting( 5, with_empty.call<true>( 0, 5 ) );
+	daw::expecting( 42, with_empty.call<true>( 1, 5 ) );
+	daw::expecting( 42, with_empty.operator( )<true>( 1, 5 ) );
+}
+
+void heterogeneous_table_bench_001( ) {
+	auto rng = std::mt19937_64( 6 );
+	auto ops = std::vector<std::size_t>( 1'000'000 );
+	for( std::size_t &op : ops ) {
+		op = static_cast<std::size_t>( rng( ) % mix_table.size( ) );
+	}
+	daw::bench_n_test<10>( "200 entry heterogeneous dispatch", [&] {
+		uintmax_t result = 0;
+		for( std::size_t op : ops ) {
+			result = mix_table( op, result );
+		}
+		return result;
+	} );
+}
+
+// A tiny threaded interpreter, each handler jumps to the next
+namespace vm {
+	enum opcode : unsigned char { op_halt, op_add, op_sub, op_loop };
+
+	using handler_t = std::add_pointer_t<std::int64_t(
+	  unsigned char const *, std::int64_t, std::int64_t )>;
+
+	std::int64_t halt( unsigned char const *, std::int64_t, std::int64_t );
+	std::int64_t add( unsigned char const *, std::int64_t, std::int64_t );
+	std::int64_t sub( unsigned char const *, std::int64_t, std::int64_t );
+	std::int64_t loop( unsigned char const *, std::int64_t, std::int64_t );
+
+	inline constexpr daw::function_table_t<std::int64_t, handler_t, handler_t,
+	                                       handler_t, handler_t>
+	  handlers{ halt, add, sub, loop };
+
+	std::int64_t halt( unsigned char const *, std::int64_t acc, std::int64_t ) {
+		return acc;
+	}
+
+	std::int64_t add( unsigned char const *pc, std::int64_t acc,
+	                  std::int64_t count ) {
+		acc += pc[1];
+		pc += 2;
+		DAW_TAIL_DISPATCH( handlers, *pc, pc, acc, count );
+	}
+
+	std::int64_t sub( unsigned char const *pc, std::int64_t acc,
+	                  std::int64_t count ) {
+		acc -= pc[1];
+		pc += 2;
+		DAW_TAIL_DISPATCH( handlers, *pc, pc, acc, count );
+	}
+
+	// Jump back pc[1] bytes until count reaches 0
+	std::int64_t loop( unsigned char const *pc, std::int64_t acc,
+	                   std::int64_t count ) {
+		--count;
+		pc = count != 0 ? pc - pc[1] : pc + 2;
+		DAW_TAIL_DISPATCH( handlers, *pc, pc, acc, count );
+	}
+} // namespace vm
+
+void tail_dispatch_test_001( ) {
+	static constexpr unsigned char code[] = {
+	  vm::op_add, 5, vm::op_sub, 2, vm::op_loop, 4, vm::op_halt, 0 };
+	// Small enough to run without optimizations, where calls are not tail
+	// calls unless DAW_MUSTTAIL is supported
+	daw::expecting( 3000, vm::handlers( code[0], code, 0, 1000 ) );
+}
+
 int main( int argc, char **argv ) {
 	char const *ptr = "12345678";
 	if( argc > 1 ) {
@@ -137,4 +238,7 @@ int main( int argc, char **argv ) {
 	}
 	uintmax_t result = ftable( static_cast<size_t>( *ptr ), 0U, ptr );
 	printf( "%lu\n", result );
+	heterogeneous_table_test_001( );
+	heterogeneous_table_bench_001( );
+	tail_dispatch_test_001( );
 }
@@ -9,6 +9,8 @@
 #include "daw/daw_benchmark.h"
 #include "daw/daw_heap_array.h"
 
+#include <cstddef>
+#include <memory>
 #include <new>
 #include <string>
 
@@ -22,6 +24,57 @@ void daw_heap_array_testing( ) {
 	daw::expecting( 4, *pos );
 }
 
+// Counts the live allocations made through it
+template<typename T>
+struct counting_allocator {
+	using value_type = T;
+	std::ptrdiff_t *live;
+
+	explicit counting_allocator( std::ptrdiff_t &l )
+	  : live( &l ) {}
+
+	template<typename U>
+	counting_allocator( counting_allocator<U> const &other )
+	  : live( other.live ) {}
+
+	T *allocate( std::size_t n ) {
+		++*live;
+		return std::allocator<T>( ).allocate( n );
+	}
+
+	void deallocate( T *p, std::size_t n ) {
+		--*live;
+		std::allocator<T>( ).deallocate( p, n );
+	}
+
+	bool operator==( counting_allocator const &rhs ) const {
+		return live == rhs.live;
+	}
+
+	bool operator!=( counting_allocator const &rhs ) const {
+		return live != rhs.live;
+	}
+};
+
+void daw_heap_array_allocator_testing( ) {
+	std::ptrdiff_t live = 0;
+	{
+		using array_t =
+		  daw::heap_array<std::string, counting_allocator<std::string>>;
+		auto a = array_t( 3, "abc"s, counting_allocator<std::string>( live ) );
+		auto b = a;
+		daw::expecting( 2, live );
+		auto c = std::move( a );
+		daw::expecting( 3U, c.size( ) );
+		daw::expecting( c.end( ) == c.begin( ) + 3 );
+		b = std::move( c );
+		daw::expecting( 1, live );
+		daw::expecting( "abc"s, b[2] );
+	}
+	daw::expecting( 0, live );
+}
+
 int main( ) {
 	daw_heap_array_testing( );
+	daw_heap_array_allocator_testing( );
 }
@@ -0,0 +1,268 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_int_codec.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	constexpr std::size_t test_sizes[] = { 0, 1, 7, 127, 128, 129, 1000, 643 };
+
+	template<typename T>
+	std::vector<T> random_values( std::size_t size, unsigned bits,
+	                              std::mt19937_64 &rng ) {
+		auto result = std::vector<T>( size );
+		for( T &value : result ) {
+			value = static_cast<T>( rng( ) ) &
+			        daw::int_codec_impl::low_mask<T>( bits );
+		}
+		return result;
+	}
+
+	template<typename T>
+	std::vector<T> sorted_ids( std::size_t size, T id, std::mt19937_64 &rng ) {
+		auto result = std::vector<T>( size );
+		for( T &value : result ) {
+			id += static_cast<T>( rng( ) % 100U );
+			value = id;
+		}
+		return result;
+	}
+} // namespace
+
+template<typename T>
+void bitpack_round_trip_001( ) {
+	auto rng = std::mt19937_64( 42 );
+	for( unsigned bits = 0; bits <= 8U * sizeof( T ); ++bits ) {
+		for( std::size_t size : test_sizes ) {
+			auto const values = random_values<T>( size, bits, rng );
+			auto buff = std::vector<unsigned char>(
+			  daw::int_codec::bitpack_size<T>( size, bits ) );
+			auto const written =
+			  daw::int_codec::bitpack_encode<T>( values, buff, bits );
+			daw::expecting( buff.size( ), written );
+			auto result = std::vector<T>( size );
+			daw::expecting(
+			  written, daw::int_codec::bitpack_decode<T>( buff, result, bits ) );
+			daw::expecting( values == result );
+		}
+	}
+}
+
+// The SSE2 kernels must lay out blocks the same as the scalar ones
+template<typename T>
+void bitpack_layout_001( ) {
+	using namespace daw::int_codec_impl;
+	auto rng = std::mt19937_64( 7 );
+	auto const values = random_values<T>( block_size, 13, rng );
+	auto blocked = std::vector<unsigned char>( 16U * 13U );
+	pack_block<T, 13>( values.data( ), blocked.data( ) );
+	auto lanes = std::vector<unsigned char>( 16U * 13U );
+	for( std::size_t lane = 0; lane < lane_count<T>; ++lane ) {
+		pack_lanes<T, 13>( scalar_ops<T>{ lane }, values.data( ), lanes.data( ) );
+	}
+	daw::expecting( blocked == lanes );
+}
+
+template<typename T>
+void for_round_trip_001( ) {
+	auto rng = std::mt19937_64( 1 );
+	for( std::size_t size : test_sizes ) {
+		auto values = random_values<T>( size, 10, rng );
+		for( T &value : values ) {
+			value += std::numeric_limits<T>::max( ) - 2000U;
+		}
+		auto buff =
+		  std::vector<unsigned char>( daw::int_codec::for_max_size<T>( size ) );
+		auto const written = daw::int_codec::for_encode<T>( values, buff );
+		// 10 bits a value after taking the base away
+		daw::expecting( written <=
+		                ( size + 127U ) / 128U * ( 1U + sizeof( T ) + 160U ) );
+		auto result = std::vector<T>( size );
+		daw::expecting( written, daw::int_codec::for_decode<T>( buff, result ) );
+		daw::expecting( values == result );
+	}
+}
+
+template<typename T>
+void delta_round_trip_001( ) {
+	auto rng = std::mt19937_64( 2 );
+	for( std::size_t size : test_sizes ) {
+		auto const ids = sorted_ids<T>( size, 0, rng );
+		auto buff =
+		  std::vector<unsigned char>( daw::int_codec::delta_max_size<T>( size ) );
+		auto written = daw::int_codec::delta_encode<T>( ids, buff );
+		// Gaps below 100 zigzag to at most 8 bits
+		daw::expecting( written <= ( size + 127U ) / 128U * ( 1U + 128U ) );
+		auto result = std::vector<T>( size );
+		daw::expecting( written, daw::int_codec::delta_decode<T>( buff, result ) );
+		daw::expecting( ids == result );
+
+		// Unsorted values round trip too
+		auto const values = random_values<T>( size, 8U * sizeof( T ), rng );
+		written = daw::int_codec::delta_encode<T>( values, buff );
+		daw::expecting( written, daw::int_codec::delta_decode<T>( buff, result ) );
+		daw::expecting( values == result );
+	}
+}
+
+template<typename T>
+void varint_round_trip_001( ) {
+	auto rng = std::mt19937_64( 3 );
+	for( std::size_t size : test_sizes ) {
+		auto values = std::vector<T>( size );
+		for( T &value : values ) {
+			auto const bits =
+			  static_cast<unsigned>( rng( ) % ( 8U * sizeof( T ) + 1U ) );
+			value = static_cast<T>( rng( ) ) &
+			        daw::int_codec_impl::low_mask<T>( bits );
+		}
+		auto buff =
+		  std::vector<unsigned char>( daw::int_codec::varint_max_size<T>( size ) );
+		auto const written = daw::int_codec::varint_encode<T>( values, buff );
+		std::size_t expected_size = 0;
+		for( T value : values ) {
+			expected_size += daw::int_codec::varint_size( value );
+		}
+		daw::expecting( expected_size, written );
+		auto result = std::vector<T>( size );
+		daw::expecting( written, daw::int_codec::varint_decode<T>(
+		                           daw::span<unsigned char const>( buff.data( ),
+		                                                           written ),
+		                           result ) );
+		daw::expecting( values == result );
+	}
+}
+
+void varint_layout_001( ) {
+	auto const values = std::vector<std::uint32_t>{ 1, 300, 0, 127, 128 };
+	auto buff = std::vector<unsigned char>( 16 );
+	auto const written =
+	  daw::int_codec::varint_encode<std::uint32_t>( values, buff );
+	buff.resize( written );
+	daw::expecting( std::vector<unsigned char>{ 0x01, 0xAC, 0x02, 0x00, 0x7F,
+	                                            0x80, 0x01 },
+	                buff );
+}
+
+void codec_errors_001( ) {
+	auto const values = std::vector<std::uint32_t>( 200, 0xFFFF'FFFFU );
+	auto buff = std::vector<unsigned char>( 10 );
+	daw::expecting_exception<std::out_of_range>( [&] {
+		(void)daw::int_codec::delta_encode<std::uint32_t>( values, buff );
+	} );
+	daw::expecting_exception<std::out_of_range>( [&] {
+		(void)daw::int_codec::varint_encode<std::uint32_t>( values, buff );
+	} );
+
+	buff.resize( daw::int_codec::varint_max_size<std::uint32_t>( 200 ) );
+	auto const written =
+	  daw::int_codec::varint_encode<std::uint32_t>( values, buff );
+	auto result = std::vector<std::uint32_t>( 200 );
+	daw::expecting_exception<std::invalid_argument>( [&] {
+		(void)daw::int_codec::varint_decode<std::uint32_t>(
+		  daw::span<unsigned char const>( buff.data( ), written - 1U ), result );
+	} );
+	// A sixth byte is too long for 32 bits
+	auto const too_long =
+	  std::vector<unsigned char>{ 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+	auto one = std::vector<std::uint32_t>( 1 );
+	daw::expecting_exception<std::invalid_argument>( [&] {
+		(void)daw::int_codec::varint_decode<std::uint32_t>( too_long, one );
+	} );
+}
+
+void codec_bench_001( ) {
+	constexpr std::size_t count = 1U << 22U;
+	auto rng = std::mt19937_64( 4 );
+	auto const ids = sorted_ids<std::uint32_t>( count, 1'000'000'000U, rng );
+	auto result = std::vector<std::uint32_t>( count );
+	std::size_t const decoded_bytes = count * sizeof( std::uint32_t );
+
+	auto delta = std::vector<unsigned char>(
+	  daw::int_codec::delta_max_size<std::uint32_t>( count ) );
+	delta.resize( daw::int_codec::delta_encode<std::uint32_t>( ids, delta ) );
+	auto forr = std::vector<unsigned char>(
+	  daw::int_codec::for_max_size<std::uint32_t>( count ) );
+	forr.resize( daw::int_codec::for_encode<std::uint32_t>( ids, forr ) );
+	auto const bits = daw::int_codec::required_bits<std::uint32_t>( ids );
+	auto packed = std::vector<unsigned char>(
+	  daw::int_codec::bitpack_size<std::uint32_t>( count, bits ) );
+	daw::int_codec::bitpack_encode<std::uint32_t>( ids, packed, bits );
+	auto gaps = std::vector<std::uint32_t>( count );
+	std::adjacent_difference( ids.begin( ), ids.end( ), gaps.begin( ) );
+	auto varint = std::vector<unsigned char>(
+	  daw::int_codec::varint_max_size<std::uint32_t>( count ) );
+	varint.resize( daw::int_codec::varint_encode<std::uint32_t>( gaps, varint ) );
+
+	std::cout << "sorted ids: " << count * 4U << " bytes, delta " << delta.size( )
+	          << ", for " << forr.size( ) << ", bitpack " << packed.size( )
+	          << ", varint gaps " << varint.size( ) << '\n';
+
+	daw::bench_n_test_mbs<10>(
+	  "delta_decode", decoded_bytes,
+	  [&]( auto const &buff ) {
+		  daw::int_codec::delta_decode<std::uint32_t>( buff, result );
+		  return result.back( );
+	  },
+	  delta );
+	daw::expecting( ids == result );
+	daw::bench_n_test_mbs<10>(
+	  "for_decode", decoded_bytes,
+	  [&]( auto const &buff ) {
+		  daw::int_codec::for_decode<std::uint32_t>( buff, result );
+		  return result.back( );
+	  },
+	  forr );
+	daw::bench_n_test_mbs<10>(
+	  "bitpack_decode", decoded_bytes,
+	  [&]( auto const &buff ) {
+		  daw::int_codec::bitpack_decode<std::uint32_t>( buff, result, bits );
+		  return result.back( );
+	  },
+	  packed );
+	daw::bench_n_test_mbs<10>(
+	  "varint_decode", decoded_bytes,
+	  [&]( auto const &buff ) {
+		  daw::int_codec::varint_decode<std::uint32_t>( buff, result );
+		  return result.back( );
+	  },
+	  varint );
+	daw::expecting( gaps == result );
+	daw::bench_n_test_mbs<10>(
+	  "delta_encode", decoded_bytes,
+	  [&]( auto const &values ) {
+		  return daw::int_codec::delta_encode<std::uint32_t>( values, delta );
+	  },
+	  ids );
+}
+
+int main( ) {
+	bitpack_round_trip_001<std::uint32_t>( );
+	bitpack_round_trip_001<std::uint64_t>( );
+	bitpack_layout_001<std::uint32_t>( );
+	bitpack_layout_001<std::uint64_t>( );
+	for_round_trip_001<std::uint32_t>( );
+	for_round_trip_001<std::uint64_t>( );
+	delta_round_trip_001<std::uint32_t>( );
+	delta_round_trip_001<std::uint64_t>( );
+	varint_round_trip_001<std::uint32_t>( );
+	varint_round_trip_001<std::uint64_t>( );
+	varint_layout_001( );
+	codec_errors_001( );
+	codec_bench_001( );
+}
@@ -9,7 +9,13 @@
 #include "daw/daw_benchmark.h"
 #include "daw/daw_keep_n.h"
 
+#include "daw/daw_random.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <vector>
 
 constexpr bool keep_n_test_001( ) {
 	daw::keep_n<int, 3> top3( std::numeric_limits<int>::max( ) );
@@ -26,4 +32,36 @@ constexpr bool keep_n_test_001( ) {
 }
 static_assert( keep_n_test_001( ) );
 
-int main( ) {}
+void keep_n_batch_insert_001( ) {
+	auto const values = daw::make_random_data<std::int32_t>( 1000 );
+	auto expected = values;
+	std::sort( expected.begin( ), expected.end( ) );
+
+	daw::keep_n<std::int32_t, 16> smallest(
+	  std::numeric_limits<std::int32_t>::max( ) );
+	smallest.insert( values.begin( ), values.end( ) );
+	daw::expecting(
+	  std::equal( smallest.begin( ), smallest.end( ), expected.begin( ) ) );
+
+	daw::keep_n<std::int32_t, 16, daw::keep_n_order::descending> largest(
+	  std::numeric_limits<std::int32_t>::min( ) );
+	largest.insert( values.begin( ), values.end( ) );
+	daw::expecting(
+	  std::equal( largest.begin( ), largest.end( ), expected.rbegin( ) ) );
+}
+
+constexpr bool keep_n_batch_insert_002( ) {
+	daw::keep_n<int, 3, daw::keep_n_order::ascending, std::greater<>> top3(
+	  std::numeric_limits<int>::min( ) );
+	int const values[] = { 5, 0, 1, 50, -50, 7 };
+	top3.insert( std::begin( values ), std::end( values ) );
+	daw::expecting( 50, top3[0] );
+	daw::expecting( 7, top3[1] );
+	daw::expecting( 5, top3[2] );
+	return true;
+}
+static_assert( keep_n_batch_insert_002( ) );
+
+int main( ) {
+	keep_n_batch_insert_001( );
+}
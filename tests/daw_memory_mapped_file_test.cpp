@@ -6,9 +6,12 @@
 // Official repository: https://github.com/beached/header_libraries
 //
 
+#include "daw/daw_benchmark.h"
 #include "daw/daw_memory_mapped_file.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <fstream>
 #include <string>
 #include <string_view>
@@ -29,6 +32,50 @@ void daw_memory_mapped_file_001( std::string const &file_name ) {
 	  static_cast<std::string_view>( file_name ) );
 }
 
+void daw_memory_mapped_file_002( std::string const &file_name ) {
+	std::remove( file_name.c_str( ) );
+	{
+		daw::filesystem::memory_mapped_file_t<std::uint64_t> out{ };
+		daw::expecting( out.create( file_name, 1000 ) );
+		daw::expecting( 1000U * sizeof( std::uint64_t ), out.size( ) );
+		auto values = out.as_span( );
+		for( std::size_t n = 0; n < values.size( ); ++n ) {
+			values[n] = n;
+		}
+		daw::expecting( out.flush( 10, 100, daw::filesystem::flush_mode::async ) );
+		daw::expecting( out.reserve( 100'000 ) );
+		daw::expecting( 1000U * sizeof( std::uint64_t ), out.size( ) );
+		daw::expecting( out.capacity( ) >= 100'000U * sizeof( std::uint64_t ) );
+		daw::expecting( out.resize( 50'000 ) );
+		values = out.as_span( );
+		daw::expecting( 0U, values[1000] );
+		for( std::size_t n = 1000; n < values.size( ); ++n ) {
+			values[n] = n;
+		}
+		// Appending one at a time grows the capacity geometrically
+		daw::expecting( out.resize( 10 ) );
+		for( std::size_t n = 10; n < 60'000; ++n ) {
+			daw::expecting( out.resize( n + 1 ) );
+			out.as_span( )[n] = n;
+		}
+		daw::expecting( out.resize( 50'000 ) );
+		daw::expecting( out.flush( ) );
+	}
+	daw::filesystem::memory_mapped_file_t<std::uint64_t> in(
+	  static_cast<std::string_view>( file_name ) );
+	daw::expecting( static_cast<bool>( in ) );
+	// The unused capacity is not left on disk
+	daw::expecting( 50'000U * sizeof( std::uint64_t ), in.size( ) );
+	auto const values = in.as_span( );
+	for( std::size_t n = 0; n < values.size( ); ++n ) {
+		daw::expecting( n, values[n] );
+	}
+	std::remove( file_name.c_str( ) );
+}
+
 int main( ) {
 	(void)daw_memory_mapped_file_001( "./blah.txt" );
+#if not defined( _MSC_VER )
+	daw_memory_mapped_file_002( "./daw_memory_mapped_file_002.bin" );
+#endif
 }
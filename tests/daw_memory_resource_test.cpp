@@ -0,0 +1,236 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_clumpy_sparsy.h"
+#include "daw/daw_hash_table.h"
+#include "daw/daw_heap_array.h"
+#include "daw/daw_heap_value.h"
+#include "daw/daw_memory_resource.h"
+#include "daw/daw_poly_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+	// Counts what goes upstream
+	struct counting_resource final : std::pmr::memory_resource {
+		std::size_t allocations = 0;
+		std::size_t deallocations = 0;
+
+	private:
+		void *do_allocate( std::size_t bytes, std::size_t alignment ) override {
+			++allocations;
+			return std::pmr::new_delete_resource( )->allocate( bytes, alignment );
+		}
+
+		void do_deallocate( void *ptr, std::size_t bytes,
+		                    std::size_t alignment ) override {
+			++deallocations;
+			std::pmr::new_delete_resource( )->deallocate( ptr, bytes, alignment );
+		}
+
+		bool do_is_equal(
+		  std::pmr::memory_resource const &other ) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	bool is_aligned( void const *ptr, std::size_t alignment ) {
+		return reinterpret_cast<std::uintptr_t>( ptr ) % alignment == 0;
+	}
+} // namespace
+
+void arena_resource_test_001( ) {
+	auto upstream = counting_resource( );
+	auto arena = daw::arena_resource( 1024, &upstream );
+	void *const a = arena.allocate( 3, 1 );
+	void *const b = arena.allocate( 8, 8 );
+	void *const c = arena.allocate( 64, 64 );
+	daw::expecting( 1U, upstream.allocations );
+	daw::expecting( is_aligned( b, 8 ) );
+	daw::expecting( is_aligned( c, 64 ) );
+	daw::expecting( static_cast<unsigned char *>( a ) + 3 <=
+	                static_cast<unsigned char *>( b ) );
+	// Larger than a block gets a block of its own size
+	(void)arena.allocate( 5000, 16 );
+	daw::expecting( 2U, upstream.allocations );
+
+	// reset keeps only the newest block and starts over in it
+	arena.reset( );
+	daw::expecting( 1U, upstream.deallocations );
+	for( int n = 0; n < 100; ++n ) {
+		(void)arena.allocate( 32, 8 );
+	}
+	daw::expecting( 2U, upstream.allocations );
+
+	arena.release( );
+	daw::expecting( 2U, upstream.deallocations );
+}
+
+void arena_resource_buffer_001( ) {
+	auto upstream = counting_resource( );
+	alignas( 16 ) unsigned char buffer[256];
+	auto arena = daw::arena_resource( buffer, sizeof( buffer ), &upstream );
+	void *const a = arena.allocate( 100, 16 );
+	daw::expecting( static_cast<void *>( buffer ), a );
+	daw::expecting( 0U, upstream.allocations );
+	(void)arena.allocate( 200, 16 );
+	daw::expecting( 1U, upstream.allocations );
+	arena.release( );
+	daw::expecting( static_cast<void *>( buffer ), arena.allocate( 1, 1 ) );
+}
+
+void arena_resource_overflow_001( ) {
+	auto upstream = counting_resource( );
+	auto arena = daw::arena_resource( 1024, &upstream );
+	(void)arena.allocate( 8, 8 );
+	// Sizes near the top of size_t would wrap the bump pointer
+	constexpr auto max_size = std::numeric_limits<std::size_t>::max( );
+	for( std::size_t const bytes :
+	     { max_size, max_size - 8U, max_size - 31U } ) {
+		daw::expecting_exception<std::bad_alloc>(
+		  [&] { (void)arena.allocate( bytes, 16 ); } );
+	}
+	daw::expecting( 1U, upstream.allocations );
+	daw::expecting( is_aligned( arena.allocate( 32, 16 ), 16 ) );
+}
+
+void pool_resource_test_001( ) {
+	auto upstream = counting_resource( );
+	auto pool = daw::pool_resource( &upstream );
+	void *const a = pool.allocate( 24, 8 );
+	void *const b = pool.allocate( 24, 8 );
+	daw::expecting( 1U, upstream.allocations );
+	daw::expecting( a != b );
+	pool.deallocate( a, 24, 8 );
+	// The freed block is the next one out of its size class
+	daw::expecting( a, pool.allocate( 32, 8 ) );
+	// Over aligned requests come from a class at least as large
+	void *const c = pool.allocate( 8, 256 );
+	daw::expecting( is_aligned( c, 256 ) );
+	// Too large to pool
+	std::size_t const before = upstream.allocations;
+	void *const big = pool.allocate( 10000, 16 );
+	daw::expecting( before + 1U, upstream.allocations );
+	pool.deallocate( big, 10000, 16 );
+	pool.release( );
+	daw::expecting( upstream.allocations, upstream.deallocations );
+}
+
+void resource_allocator_test_001( ) {
+	auto arena = daw::arena_resource( );
+	auto values = std::vector<int, daw::arena_allocator<int>>( arena );
+	for( int n = 0; n < 1000; ++n ) {
+		values.push_back( n );
+	}
+	daw::expecting( 999, values.back( ) );
+	daw::expecting( values.get_allocator( ).resource( ) == &arena );
+
+	auto pool = daw::pool_resource( &arena );
+	auto strings = std::pmr::vector<std::pmr::string>( &pool );
+	strings.emplace_back( "a string too long for the small string buffer" );
+	daw::expecting( strings.back( ).get_allocator( ).resource( ) == &pool );
+}
+
+void containers_test_001( ) {
+	auto upstream = counting_resource( );
+	auto arena = daw::arena_resource( 4096, &upstream );
+	{
+		auto a = daw::heap_array<int, daw::arena_allocator<int>>( 10, 5, arena );
+		auto b = a;
+		daw::expecting( b.get_allocator( ) == a.get_allocator( ) );
+		auto c = std::move( b );
+		daw::expecting( 10U, c.size( ) );
+		daw::expecting( 5, c[9] );
+
+		using hv_alloc = daw::arena_allocator<std::string>;
+		auto hv = daw::heap_value<std::string, hv_alloc>(
+		  std::allocator_arg, hv_alloc( arena ), "value" );
+		daw::expecting( std::string( "value" ), *hv );
+		daw::expecting( hv.get_allocator( ).resource( ) == &arena );
+
+		auto pv = daw::poly_vector_t<int, daw::arena_allocator<int>>( arena );
+		pv.emplace_back( 1 );
+		pv.emplace_back( 2 );
+		daw::expecting( 2U, pv.size( ) );
+		daw::expecting( pv[1].get_allocator( ).resource( ) == &arena );
+
+		auto ht = daw::hash_table<int, daw::arena_allocator<int>>( arena );
+		ht["one"] = 1;
+		ht["two"] = 2;
+		daw::expecting( 2U, ht.occupied( ) );
+		daw::expecting( 1, ht["one"] );
+		daw::expecting( 2, ht.at( "two" ) );
+
+		auto cs = daw::clumpy_sparsy<int, daw::arena_allocator<int>>( arena );
+		daw::expecting( 0U, cs.size( ) );
+		daw::expecting( cs.get_allocator( ).resource( ) == &arena );
+	}
+	// Everything above came from one block
+	daw::expecting( 1U, upstream.allocations );
+	arena.reset( );
+	daw::expecting( 0U, upstream.deallocations );
+}
+
+void arena_bench_001( ) {
+	constexpr std::size_t count = 100'000;
+	struct node {
+		node *next;
+		std::uint64_t value;
+	};
+	auto const build = []( auto alloc ) {
+		using alloc_t = typename std::allocator_traits<
+		  decltype( alloc )>::template rebind_alloc<node>;
+		auto a = alloc_t( alloc );
+		node *head = nullptr;
+		for( std::size_t n = 0; n < count; ++n ) {
+			node *const p = std::allocator_traits<alloc_t>::allocate( a, 1 );
+			p->next = head;
+			p->value = n;
+			head = p;
+		}
+		std::uint64_t sum = 0;
+		while( head != nullptr ) {
+			sum += head->value;
+			node *const next = head->next;
+			std::allocator_traits<alloc_t>::deallocate( a, head, 1 );
+			head = next;
+		}
+		return sum;
+	};
+	daw::bench_n_test<10>(
+	  "std::allocator nodes", [&] { return build( std::allocator<node>( ) ); } );
+	auto arena = daw::arena_resource( );
+	daw::bench_n_test<10>( "arena_allocator nodes", [&] {
+		auto result = build( daw::arena_allocator<node>( arena ) );
+		arena.reset( );
+		return result;
+	} );
+	auto pool = daw::pool_resource( );
+	daw::bench_n_test<10>( "pool_allocator nodes", [&] {
+		return build( daw::pool_allocator<node>( pool ) );
+	} );
+}
+
+int main( ) {
+	arena_resource_test_001( );
+	arena_resource_buffer_001( );
+	arena_resource_overflow_001( );
+	pool_resource_test_001( );
+	resource_allocator_test_001( );
+	containers_test_001( );
+	arena_bench_001( );
+}
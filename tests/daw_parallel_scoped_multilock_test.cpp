@@ -9,8 +9,13 @@
 #include "daw/daw_benchmark.h"
 #include "daw/parallel/daw_scoped_multilock.h"
 
+#include <atomic>
+#include <cstddef>
 #include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 void daw_scoped_multilock_001( ) {
 	std::mutex m1;
@@ -34,6 +39,179 @@ void daw_scoped_multilock_001( ) {
 	daw::expecting_message( result2, "m2 wasn't locked" );
 }
 
+void daw_ordered_multilock_001( ) {
+	std::mutex m1;
+	std::mutex m2;
+	bool result1 = false;
+	bool result2 = false;
+	auto lck = daw::make_ordered_multilock( m2, m1 );
+	daw::expecting( lck.locks( )[0].address < lck.locks( )[1].address );
+	std::thread th{ [&]( ) {
+		result1 = !m1.try_lock( );
+		result2 = !m2.try_lock( );
+		if( !result1 ) {
+			m1.unlock( );
+		}
+		if( !result2 ) {
+			m2.unlock( );
+		}
+	} };
+
+	th.join( );
+	daw::expecting_message( result1, "m1 wasn't locked" );
+	daw::expecting_message( result2, "m2 wasn't locked" );
+	lck.unlock( );
+	daw::expecting( not lck.owns_lock( ) );
+	daw::expecting( m1.try_lock( ) );
+	m1.unlock( );
+}
+
+void daw_ordered_multilock_shared_001( ) {
+	std::shared_mutex sm;
+	std::mutex m;
+	auto lck = daw::make_ordered_multilock( daw::as_shared( sm ), m );
+	bool shared_ok = false;
+	bool unique_ok = true;
+	std::thread th{ [&]( ) {
+		shared_ok = sm.try_lock_shared( );
+		if( shared_ok ) {
+			sm.unlock_shared( );
+		}
+		unique_ok = sm.try_lock( );
+		if( unique_ok ) {
+			sm.unlock( );
+		}
+	} };
+	th.join( );
+	daw::expecting_message( shared_ok, "sm should allow other readers" );
+	daw::expecting_message( not unique_ok, "sm should not allow a writer" );
+}
+
+void daw_ordered_multilock_shared_002( ) {
+	std::shared_mutex sm;
+	std::mutex m;
+	auto shared = daw::as_shared( sm );
+	{
+		// Both as a temporary and as a named wrapper the entry is the mutex
+		auto lck = daw::make_ordered_multilock( daw::as_shared( sm ), m );
+		auto lck2 = daw::make_ordered_multilock( shared );
+		for( auto const &entry : lck.locks( ) ) {
+			void const *const addr = entry.address;
+			bool const is_sm = addr == static_cast<void const *>( &sm );
+			daw::expecting( is_sm or addr == static_cast<void const *>( &m ) );
+			daw::expecting( is_sm, entry.is_shared );
+		}
+		daw::expecting( static_cast<void const *>( &sm ),
+		                lck2.locks( )[0].address );
+		daw::expecting( lck2.locks( )[0].is_shared );
+	}
+	// Every shared hold was released
+	daw::expecting( sm.try_lock( ) );
+	sm.unlock( );
+}
+
+struct counting_hook {
+	std::atomic<size_t> *acquires;
+	std::atomic<size_t> *releases;
+
+	template<typename Entries>
+	void on_acquire( Entries const &, std::chrono::nanoseconds, size_t ) const {
+		++*acquires;
+	}
+
+	template<typename Entries>
+	void on_release( Entries const &, std::chrono::nanoseconds ) const {
+		++*releases;
+	}
+};
+
+// Threads taking overlapping sets in conflicting orders must not deadlock
+void daw_ordered_multilock_contention_001( ) {
+	std::mutex m1;
+	std::mutex m2;
+	std::shared_mutex m3;
+	std::atomic<size_t> acquires = 0;
+	std::atomic<size_t> releases = 0;
+	size_t counter = 0;
+	constexpr size_t iterations = 10'000;
+
+	auto const hook = counting_hook{ &acquires, &releases };
+	std::vector<std::thread> threads{ };
+	threads.emplace_back( [&]( ) {
+		for( size_t n = 0; n < iterations; ++n ) {
+			auto lck = daw::make_instrumented_multilock( hook, m1, m2 );
+			++counter;
+		}
+	} );
+	threads.emplace_back( [&]( ) {
+		for( size_t n = 0; n < iterations; ++n ) {
+			auto lck = daw::make_instrumented_multilock( hook, m2, m3, m1 );
+			++counter;
+		}
+	} );
+	threads.emplace_back( [&]( ) {
+		for( size_t n = 0; n < iterations; ++n ) {
+			auto lck =
+			  daw::make_instrumented_multilock( hook, daw::as_shared( m3 ), m2 );
+			++counter;
+		}
+	} );
+	for( auto &th : threads ) {
+		th.join( );
+	}
+	daw::expecting( 3 * iterations, counter );
+	daw::expecting( 3 * iterations, acquires.load( ) );
+	daw::expecting( 3 * iterations, releases.load( ) );
+}
+
+struct throwing_mutex {
+	void lock( ) {
+		throw std::runtime_error( "lock" );
+	}
+
+	bool try_lock( ) {
+		throw std::runtime_error( "try_lock" );
+	}
+
+	void unlock( ) {}
+};
+
+struct throwing_hook {
+	template<typename Entries>
+	void on_acquire( Entries const &, std::chrono::nanoseconds, size_t ) const {
+		throw std::runtime_error( "on_acquire" );
+	}
+
+	template<typename Entries>
+	constexpr void on_release( Entries const &,
+	                           std::chrono::nanoseconds ) const noexcept {}
+};
+
+// The locks already held are released when acquiring throws
+void daw_ordered_multilock_throw_001( ) {
+	std::mutex m1;
+	std::mutex m2;
+	std::shared_mutex m3;
+	throwing_mutex t;
+	daw::expecting_exception<std::runtime_error>(
+	  [&] { auto lck = daw::make_ordered_multilock( m1, t, m2 ); } );
+	daw::expecting_exception<std::runtime_error>( [&] {
+		auto lck = daw::make_instrumented_multilock( throwing_hook{ }, m1, m2,
+		                                             daw::as_shared( m3 ) );
+	} );
+	daw::expecting( m1.try_lock( ) );
+	daw::expecting( m2.try_lock( ) );
+	daw::expecting( m3.try_lock( ) );
+	m1.unlock( );
+	m2.unlock( );
+	m3.unlock( );
+}
+
 int main( ) {
 	daw_scoped_multilock_001( );
+	daw_ordered_multilock_001( );
+	daw_ordered_multilock_shared_001( );
+	daw_ordered_multilock_shared_002( );
+	daw_ordered_multilock_contention_001( );
+	daw_ordered_multilock_throw_001( );
 }
@@ -0,0 +1,251 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_random.h"
+#include "daw/parallel/daw_sort.h"
+#include "daw/parallel/daw_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void daw_parallel_sort_001( ) {
+	daw::thread_pool pool( 4 );
+	for( std::size_t const count : { 10U, 20'000U, 100'003U } ) {
+		auto data = daw::make_random_data<std::int32_t>( count );
+		auto expected = data;
+		std::sort( expected.begin( ), expected.end( ) );
+		daw::parallel::sort( pool, data.begin( ), data.end( ) );
+		daw::expecting( expected == data );
+
+		std::sort( expected.begin( ), expected.end( ), std::greater<>{ } );
+		daw::parallel::sort( pool, data.begin( ), data.end( ),
+		                     std::greater<>{ } );
+		daw::expecting( expected == data );
+	}
+}
+
+void daw_parallel_sort_duplicates_001( ) {
+	daw::thread_pool pool( 4 );
+	// Few distinct keys put many equal splitters in the sample
+	auto data = daw::make_random_data<std::int32_t>( 50'000, 0, 3 );
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	daw::parallel::sort( pool, data.begin( ), data.end( ) );
+	daw::expecting( expected == data );
+}
+
+void daw_parallel_sort_duplicates_002( ) {
+	daw::thread_pool pool( 4 );
+	// Every splitter is the same key
+	auto same = std::vector<std::string>( 40'000, std::string( 20, 'x' ) );
+	auto const expected_same = same;
+	daw::parallel::sort( pool, same.begin( ), same.end( ) );
+	daw::expecting( expected_same == same );
+
+	// One key is most of the input and the rest are spread around it
+	auto data = daw::make_random_data<std::int32_t>( 60'000, -1000, 1000 );
+	for( std::size_t n = 0; n < data.size( ); n += 4U ) {
+		data[n] = data[n + 1U] = data[n + 2U] = 17;
+	}
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	daw::parallel::sort( pool, data.begin( ), data.end( ) );
+	daw::expecting( expected == data );
+}
+
+void daw_parallel_sort_strings_001( ) {
+	daw::thread_pool pool( 3 );
+	auto const keys = daw::make_random_data<std::uint32_t>( 30'000 );
+	auto data = std::vector<std::string>( );
+	for( auto k : keys ) {
+		data.push_back( std::to_string( k ) );
+	}
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	daw::parallel::sort( pool, data.begin( ), data.end( ) );
+	daw::expecting( expected == data );
+}
+
+struct record_t {
+	std::int32_t key;
+	std::size_t position;
+
+	friend bool operator==( record_t const &lhs, record_t const &rhs ) {
+		return lhs.key == rhs.key and lhs.position == rhs.position;
+	}
+};
+
+void daw_parallel_stable_sort_001( ) {
+	daw::thread_pool pool( 4 );
+	for( std::size_t const count : { 100U, 20'000U, 100'003U } ) {
+		auto const keys = daw::make_random_data<std::int32_t>( count, -50, 50 );
+		auto data = std::vector<record_t>( );
+		for( std::size_t n = 0; n < keys.size( ); ++n ) {
+			data.push_back( record_t{ keys[n], n } );
+		}
+		auto const by_key = []( record_t const &lhs, record_t const &rhs ) {
+			return lhs.key < rhs.key;
+		};
+		auto expected = data;
+		std::stable_sort( expected.begin( ), expected.end( ), by_key );
+		daw::parallel::stable_sort( pool, data.begin( ), data.end( ), by_key );
+		daw::expecting( expected == data );
+	}
+}
+
+void daw_parallel_stable_sort_strings_001( ) {
+	daw::thread_pool pool( 3 );
+	auto const keys = daw::make_random_data<std::uint32_t>( 30'000, 0, 1000 );
+	auto data = std::vector<std::string>( );
+	for( auto k : keys ) {
+		data.push_back( std::to_string( k ) );
+	}
+	auto expected = data;
+	std::stable_sort( expected.begin( ), expected.end( ) );
+	daw::parallel::stable_sort( pool, data.begin( ), data.end( ) );
+	daw::expecting( expected == data );
+}
+
+// Counts live objects and throws from a move or compare once a countdown
+// reaches zero
+struct fragile_t {
+	static inline std::atomic<int> live = 0;
+	static inline std::atomic<long> moves_left = -1;
+	static inline std::atomic<long> compares_left = -1;
+	std::int32_t key;
+
+	explicit fragile_t( std::int32_t k )
+	  : key( k ) {
+		++live;
+	}
+
+	fragile_t( fragile_t const &other )
+	  : key( other.key ) {
+		++live;
+	}
+
+	fragile_t( fragile_t &&other )
+	  : key( other.key ) {
+		if( --moves_left == 0 ) {
+			throw std::runtime_error( "move" );
+		}
+		++live;
+	}
+
+	fragile_t &operator=( fragile_t const & ) = default;
+	fragile_t &operator=( fragile_t && ) = default;
+
+	~fragile_t( ) {
+		--live;
+	}
+
+	friend bool operator<( fragile_t const &lhs, fragile_t const &rhs ) {
+		if( --compares_left == 0 ) {
+			throw std::runtime_error( "compare" );
+		}
+		return lhs.key < rhs.key;
+	}
+};
+
+// Throw after each count of moves and then of compares, nothing may leak
+template<typename Sort>
+void check_fragile( Sort sort, std::initializer_list<long> moves,
+                    std::initializer_list<long> compares ) {
+	constexpr std::size_t count = 20'000;
+	auto const run = [&]( std::atomic<long> &countdown, long after ) {
+		{
+			auto const keys = daw::make_random_data<std::int32_t>( count, 0, 50 );
+			auto data = std::vector<fragile_t>( );
+			data.reserve( count );
+			for( auto k : keys ) {
+				data.emplace_back( k );
+			}
+			countdown = after;
+			try {
+				sort( data );
+			} catch( std::runtime_error const & ) {}
+			countdown = -1;
+			daw::expecting( static_cast<int>( count ), fragile_t::live.load( ) );
+		}
+		daw::expecting( 0, fragile_t::live.load( ) );
+	};
+	for( auto after : moves ) {
+		run( fragile_t::moves_left, after );
+	}
+	for( auto after : compares ) {
+		run( fragile_t::compares_left, after );
+	}
+}
+
+void daw_parallel_sort_exception_001( ) {
+	daw::thread_pool pool( 4 );
+	// The small fixed size sorts in daw::sort are noexcept, so only throw
+	// while the sample sort classifies and distributes the input
+	check_fragile(
+	  [&]( auto &data ) {
+		  daw::parallel::sort( pool, data.begin( ), data.end( ) );
+	  },
+	  { 8'000L, 15'000L }, { 5'000L } );
+	check_fragile(
+	  [&]( auto &data ) {
+		  daw::parallel::stable_sort( pool, data.begin( ), data.end( ) );
+	  },
+	  { 1L, 30'000L, 45'000L }, { 1L, 245'000L, 265'000L } );
+}
+
+void daw_parallel_sort_bench_001( ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 100'000;
+#else
+	constexpr std::size_t data_size = 10'000'000;
+#endif
+	auto const data = daw::make_random_data<std::uint64_t>( data_size );
+	std::cout << "Sorting " << data_size << " uint64_t with "
+	          << daw::default_thread_pool( ).size( ) << " threads\n";
+	daw::bench_n_test<3>(
+	  "daw::parallel::sort",
+	  []( auto values ) {
+		  daw::parallel::sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "daw::parallel::stable_sort",
+	  []( auto values ) {
+		  daw::parallel::stable_sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "std::sort",
+	  []( auto values ) {
+		  std::sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+}
+
+int main( ) {
+	daw_parallel_sort_001( );
+	daw_parallel_sort_duplicates_001( );
+	daw_parallel_sort_duplicates_002( );
+	daw_parallel_sort_strings_001( );
+	daw_parallel_stable_sort_001( );
+	daw_parallel_stable_sort_strings_001( );
+	daw_parallel_sort_exception_001( );
+	daw_parallel_sort_bench_001( );
+}
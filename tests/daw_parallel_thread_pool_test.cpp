@@ -0,0 +1,68 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/parallel/daw_thread_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+void daw_thread_pool_for_each_index_001( ) {
+	daw::thread_pool pool( 4 );
+	daw::expecting( pool.size( ), std::size_t{ 4 } );
+	auto hits = std::vector<std::atomic<int>>( 1000 );
+	pool.for_each_index( hits.size( ), [&]( std::size_t n ) { ++hits[n]; } );
+	for( auto const &h : hits ) {
+		daw::expecting( h.load( ), 1 );
+	}
+}
+
+void daw_thread_pool_nested_001( ) {
+	daw::thread_pool pool( 3 );
+	std::atomic<std::size_t> total = 0;
+	pool.for_each_index( 8, [&]( std::size_t ) {
+		pool.for_each_index( 8, [&]( std::size_t n ) { total += n; } );
+	} );
+	daw::expecting( total.load( ), std::size_t{ 8 * 28 } );
+}
+
+void daw_thread_pool_for_each_chunk_001( ) {
+	daw::thread_pool pool( 4 );
+	auto hits = std::vector<std::atomic<int>>( 10'007 );
+	pool.for_each_chunk( hits.size( ), 100,
+	                     [&]( std::size_t first, std::size_t last ) {
+		                     for( ; first < last; ++first ) {
+			                     ++hits[first];
+		                     }
+	                     } );
+	for( auto const &h : hits ) {
+		daw::expecting( h.load( ), 1 );
+	}
+}
+
+void daw_thread_pool_exception_001( ) {
+	daw::thread_pool pool( 4 );
+	bool caught = false;
+	try {
+		pool.for_each_index( 100, []( std::size_t n ) {
+			if( n == 50 ) {
+				throw std::runtime_error( "failed" );
+			}
+		} );
+	} catch( std::runtime_error const & ) { caught = true; }
+	daw::expecting_message( caught, "Exception not propagated" );
+}
+
+int main( ) {
+	daw_thread_pool_for_each_index_001( );
+	daw_thread_pool_nested_001( );
+	daw_thread_pool_for_each_chunk_001( );
+	daw_thread_pool_exception_001( );
+}
@@ -0,0 +1,143 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_keep_n.h"
+#include "daw/daw_random.h"
+#include "daw/parallel/daw_thread_pool.h"
+#include "daw/parallel/daw_top_k.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+template<typename T, typename Compare = std::less<>>
+std::vector<T> expected_top_k( std::vector<T> values, std::size_t k,
+                               Compare comp = Compare{ } ) {
+	std::sort( values.begin( ), values.end( ), comp );
+	values.resize( std::min( k, values.size( ) ) );
+	return values;
+}
+
+void daw_keep_n_heap_001( ) {
+	auto const values = daw::make_random_data<std::int32_t>( 10'000 );
+	for( std::size_t const k : { 0U, 1U, 7U, 100U, 20'000U } ) {
+		auto kept = daw::keep_n_heap<std::int32_t>( k );
+		for( auto v : values ) {
+			kept.insert( v );
+		}
+		daw::expecting( expected_top_k( values, k ) == kept.take_sorted( ) );
+		daw::expecting( kept.empty( ) );
+
+		auto batch = daw::keep_n_heap<std::int32_t, std::greater<>>( k );
+		batch.insert( values.begin( ), values.end( ) );
+		daw::expecting( expected_top_k( values, k, std::greater<>{ } ) ==
+		                batch.take_sorted( ) );
+	}
+}
+
+template<typename T>
+void test_batch_type( ) {
+	auto const values = daw::make_random_data<T>( 5'000 );
+	auto kept = daw::keep_n_heap<T>( 50 );
+	kept.insert( values.data( ), values.data( ) + values.size( ) );
+	daw::expecting( expected_top_k( values, 50 ) == kept.take_sorted( ) );
+
+	auto largest = daw::keep_n_heap<T, std::greater<T>>( 50 );
+	largest.insert( values.begin( ), values.end( ) );
+	daw::expecting( expected_top_k( values, 50, std::greater<>{ } ) ==
+	                largest.take_sorted( ) );
+}
+
+void daw_keep_n_heap_batch_001( ) {
+	test_batch_type<std::int32_t>( );
+	test_batch_type<std::uint32_t>( );
+	test_batch_type<std::int64_t>( );
+	test_batch_type<std::uint64_t>( );
+
+	auto strings = std::vector<std::string>( );
+	for( auto v : daw::make_random_data<std::uint32_t>( 2'000 ) ) {
+		strings.push_back( std::to_string( v ) );
+	}
+	auto kept = daw::keep_n_heap<std::string>( 10 );
+	kept.insert( strings.begin( ), strings.end( ) );
+	daw::expecting( expected_top_k( strings, 10 ) == kept.take_sorted( ) );
+}
+
+void daw_keep_n_heap_merge_001( ) {
+	auto const a = daw::make_random_data<std::int32_t>( 1'000 );
+	auto const b = daw::make_random_data<std::int32_t>( 1'000 );
+	auto ka = daw::keep_n_heap<std::int32_t>( 20 );
+	auto kb = daw::keep_n_heap<std::int32_t>( 20 );
+	ka.insert( a.begin( ), a.end( ) );
+	kb.insert( b.begin( ), b.end( ) );
+	ka.merge( kb );
+	auto all = a;
+	all.insert( all.end( ), b.begin( ), b.end( ) );
+	daw::expecting( expected_top_k( all, 20 ) == ka.take_sorted( ) );
+}
+
+void daw_parallel_top_k_001( ) {
+	daw::thread_pool pool( 4 );
+	auto const values = daw::make_random_data<std::int64_t>( 200'003 );
+	// k may be larger than the input, storage is bounded by the input
+	auto const ks = std::vector<std::size_t>{
+	  0U, 1U, 10U, 1'000U, values.size( ) + 1U,
+	  std::numeric_limits<std::size_t>::max( ) };
+	for( std::size_t const k : ks ) {
+		daw::expecting( expected_top_k( values, k ) ==
+		                daw::parallel::top_k( pool, values.begin( ), values.end( ),
+		                                      k ) );
+		daw::expecting( expected_top_k( values, k, std::greater<>{ } ) ==
+		                daw::parallel::top_k( pool, values.begin( ), values.end( ),
+		                                      k, std::greater<>{ } ) );
+	}
+	auto const few = std::vector<std::int64_t>{ 5, 3, 9 };
+	daw::expecting( expected_top_k( few, 10 ) ==
+	                daw::parallel::top_k( pool, few.begin( ), few.end( ), 10 ) );
+}
+
+void daw_parallel_top_k_bench_001( ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 1'000'000;
+#else
+	constexpr std::size_t data_size = 50'000'000;
+#endif
+	constexpr std::size_t k = 100;
+	auto const data = daw::make_random_data<std::int32_t>( data_size );
+	std::cout << "top " << k << " of " << data_size << " int32_t\n";
+	daw::bench_n_test<3>(
+	  "daw::parallel::top_k",
+	  []( auto const &values ) {
+		  auto result = daw::parallel::top_k( values.begin( ), values.end( ), k );
+		  daw::do_not_optimize( result );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "std::partial_sort_copy",
+	  []( auto const &values ) {
+		  auto result = std::vector<std::int32_t>( k );
+		  std::partial_sort_copy( values.begin( ), values.end( ), result.begin( ),
+		                          result.end( ) );
+		  daw::do_not_optimize( result );
+	  },
+	  data );
+}
+
+int main( ) {
+	daw_keep_n_heap_001( );
+	daw_keep_n_heap_batch_001( );
+	daw_keep_n_heap_merge_001( );
+	daw_parallel_top_k_001( );
+	daw_parallel_top_k_bench_001( );
+}
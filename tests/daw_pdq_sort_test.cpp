@@ -0,0 +1,184 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_pdq_sort.h"
+#include "daw/daw_random.h"
+#include "daw/daw_sort_n.h"
+#include "daw/daw_stack_quick_sort.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template<typename T>
+std::vector<T> make_sorted( std::size_t count ) {
+	auto result = std::vector<T>( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		result[n] = static_cast<T>( n );
+	}
+	return result;
+}
+
+template<typename T>
+std::vector<T> make_reversed( std::size_t count ) {
+	auto result = make_sorted<T>( count );
+	std::reverse( result.begin( ), result.end( ) );
+	return result;
+}
+
+template<typename T>
+std::vector<T> make_organ_pipe( std::size_t count ) {
+	auto result = std::vector<T>( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		result[n] = static_cast<T>( n < count / 2 ? n : count - n );
+	}
+	return result;
+}
+
+template<typename T>
+std::vector<T> make_random( std::size_t count ) {
+	return daw::make_random_data<T>( count );
+}
+
+template<typename T>
+std::vector<T> make_few_unique( std::size_t count ) {
+	return daw::make_random_data<T>( count, 0, 7 );
+}
+
+template<typename Container, typename Sorter>
+void check_sort( Container data, Sorter sorter ) {
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	sorter( data.begin( ), data.end( ), std::less<>{ } );
+	daw::expecting( expected == data );
+
+	std::sort( expected.begin( ), expected.end( ), std::greater<>{ } );
+	sorter( data.begin( ), data.end( ), std::greater<>{ } );
+	daw::expecting( expected == data );
+
+	// A comparator that is not default uses the branching partition
+	std::sort( expected.begin( ), expected.end( ) );
+	sorter( data.begin( ), data.end( ),
+	        []( auto const &lhs, auto const &rhs ) { return lhs < rhs; } );
+	daw::expecting( expected == data );
+}
+
+template<typename Sorter>
+void check_distributions( Sorter sorter ) {
+	for( std::size_t const count :
+	     { 0U, 1U, 2U, 3U, 17U, 23U, 24U, 25U, 100U, 129U, 1000U, 100'000U } ) {
+		check_sort( make_sorted<std::int32_t>( count ), sorter );
+		check_sort( make_reversed<std::int32_t>( count ), sorter );
+		check_sort( make_organ_pipe<std::int32_t>( count ), sorter );
+		check_sort( make_random<std::int32_t>( count ), sorter );
+		check_sort( make_few_unique<std::int32_t>( count ), sorter );
+		check_sort( make_random<std::uint64_t>( count ), sorter );
+	}
+	auto strings = std::vector<std::string>( );
+	for( auto v : make_random<std::uint32_t>( 10'000 ) ) {
+		strings.push_back( std::to_string( v % 5000U ) );
+	}
+	check_sort( strings, sorter );
+}
+
+void daw_pdq_sort_001( ) {
+	check_distributions( []( auto first, auto last, auto comp ) {
+		daw::pdq_sort( first, last, comp );
+	} );
+}
+
+void daw_sort_pdq_001( ) {
+	check_distributions( []( auto first, auto last, auto comp ) {
+		daw::sort( first, last, comp );
+	} );
+}
+
+void daw_quick_sort_001( ) {
+	check_distributions( []( auto first, auto last, auto comp ) {
+		daw::quick_sort( first, last, comp );
+	} );
+}
+
+void daw_pdq_sort_heap_fallback_001( ) {
+	// Allowing no unbalanced partitions forces the heap sort path
+	auto data = make_organ_pipe<std::int32_t>( 10'000 );
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	auto comp = std::less<>{ };
+	daw::pdq_sort_impl::pdq_loop<true>( data.begin( ), data.end( ), comp, 1,
+	                                    true );
+	daw::expecting( expected == data );
+}
+
+constexpr bool daw_pdq_sort_constexpr_001( ) {
+	std::array<int, 200> a{ };
+	for( std::size_t n = 0; n < a.size( ); ++n ) {
+		a[n] = static_cast<int>( ( n * 7919U ) % 211U );
+	}
+	daw::pdq_sort( a.begin( ), a.end( ) );
+	for( std::size_t n = 1; n < a.size( ); ++n ) {
+		if( a[n] < a[n - 1] ) {
+			return false;
+		}
+	}
+	return true;
+}
+static_assert( daw_pdq_sort_constexpr_001( ) );
+
+template<typename Generator>
+void bench_distribution( char const *name, Generator gen ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 100'000;
+#else
+	constexpr std::size_t data_size = 1'000'000;
+#endif
+	auto const data = gen( data_size );
+	std::cout << name << ' ' << data_size << " uint64_t\n";
+	daw::bench_n_test<3>(
+	  "daw::sort",
+	  []( auto values ) {
+		  daw::sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "daw::quick_sort",
+	  []( auto values ) {
+		  daw::quick_sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "std::sort",
+	  []( auto values ) {
+		  std::sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+}
+
+void daw_pdq_sort_bench_001( ) {
+	bench_distribution( "sorted", make_sorted<std::uint64_t> );
+	bench_distribution( "reversed", make_reversed<std::uint64_t> );
+	bench_distribution( "organ pipe", make_organ_pipe<std::uint64_t> );
+	bench_distribution( "random", make_random<std::uint64_t> );
+}
+
+int main( ) {
+	daw_pdq_sort_001( );
+	daw_sort_pdq_001( );
+	daw_quick_sort_001( );
+	daw_pdq_sort_heap_fallback_001( );
+	daw_pdq_sort_bench_001( );
+}
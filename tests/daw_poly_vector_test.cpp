@@ -6,8 +6,20 @@
 // Official repository: https://github.com/beached/header_libraries
 //
 
+#include "daw/daw_benchmark.h"
+#include "daw/daw_memory_resource.h"
 #include "daw/daw_poly_vector.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 struct A {
 	int a{ };
 	constexpr A( ) = default;
@@ -35,6 +47,240 @@ void daw_poly_vector_01( ) {
 	test.push_back( B{ } );
 }
 
+namespace {
+	int live_shapes = 0;
+
+	struct Shape {
+		Shape( ) {
+			++live_shapes;
+		}
+		Shape( Shape const & ) {
+			++live_shapes;
+		}
+		Shape( Shape && ) noexcept {
+			++live_shapes;
+		}
+		Shape &operator=( Shape const & ) = default;
+		Shape &operator=( Shape && ) = default;
+		virtual ~Shape( ) {
+			--live_shapes;
+		}
+		[[nodiscard]] virtual double area( ) const = 0;
+	};
+
+	struct Square final : Shape {
+		double side;
+		explicit Square( double s )
+		  : side( s ) {}
+		[[nodiscard]] double area( ) const override {
+			return side * side;
+		}
+	};
+
+	struct Circle final : Shape {
+		double radius;
+		explicit Circle( double r )
+		  : radius( r ) {}
+		[[nodiscard]] double area( ) const override {
+			return 3.0 * radius * radius;
+		}
+	};
+
+	// Not the first base, so its Shape subobject is not at its address
+	struct Label {
+		std::string text;
+	};
+
+	struct Named final : Label, Shape {
+		explicit Named( std::string name )
+		  : Label{ std::move( name ) } {}
+		[[nodiscard]] double area( ) const override {
+			return static_cast<double>( text.size( ) );
+		}
+	};
+
+	struct alignas( 64 ) Wide final : Shape {
+		double value;
+		explicit Wide( double v )
+		  : value( v ) {}
+		[[nodiscard]] double area( ) const override {
+			return value;
+		}
+	};
+
+	struct Unique final : Shape {
+		std::unique_ptr<int> value;
+		explicit Unique( int v )
+		  : value( std::make_unique<int>( v ) ) {}
+		[[nodiscard]] double area( ) const override {
+			return *value;
+		}
+	};
+
+	template<typename Container>
+	double total_area( Container const &shapes ) {
+		double result = 0.0;
+		for( Shape const &s : shapes ) {
+			result += s.area( );
+		}
+		return result;
+	}
+} // namespace
+
+void packed_poly_vector_test_001( ) {
+	{
+		auto shapes = daw::packed_poly_vector<Shape>( );
+		// Enough of each to grow and relocate every segment a few times
+		for( int n = 0; n < 100; ++n ) {
+			shapes.emplace_back<Square>( 2.0 );
+			shapes.emplace_back<Named>( "a name long enough to allocate" );
+			shapes.push_back( Circle( 1.0 ) );
+			shapes.emplace_back<Wide>( 0.5 );
+		}
+		daw::expecting( 400U, shapes.size( ) );
+		daw::expecting( 400, live_shapes );
+		daw::expecting( 4U, shapes.type_count( ) );
+		daw::expecting( 100U, shapes.count_of<Named>( ) );
+		// Insertion order is kept
+		daw::expecting( 4.0, shapes[0].area( ) );
+		daw::expecting( 30.0, shapes[1].area( ) );
+		daw::expecting( 3.0, shapes[2].area( ) );
+		daw::expecting( 0.5, shapes.back( ).area( ) );
+		daw::expecting( 100.0 * ( 4.0 + 30.0 + 3.0 + 0.5 ), total_area( shapes ) );
+		for( std::size_t n = 3; n < shapes.size( ); n += 4 ) {
+			daw::expecting( reinterpret_cast<std::uintptr_t>( &shapes[n] ) % 64U ==
+			                0U );
+		}
+
+		// Grouped iteration sees each type in one run
+		auto areas = std::vector<double>( );
+		shapes.for_each_by_type(
+		  [&]( Shape const &s ) { areas.push_back( s.area( ) ); } );
+		daw::expecting( 400U, areas.size( ) );
+		daw::expecting( 4.0, areas[99] );
+		daw::expecting( 30.0, areas[100] );
+		double names = 0.0;
+		shapes.for_each_of<Named>( [&]( Named const &s ) {
+			names += static_cast<double>( s.text.size( ) );
+		} );
+		daw::expecting( 3000.0, names );
+
+		auto copy = shapes;
+		daw::expecting( 800, live_shapes );
+		daw::expecting( total_area( shapes ), total_area( copy ) );
+		copy.pop_back( );
+		copy.pop_back( );
+		daw::expecting( 398U, copy.size( ) );
+		daw::expecting( 30.0, copy.back( ).area( ) );
+		copy.emplace_back<Square>( 3.0 );
+		daw::expecting( 9.0, copy.back( ).area( ) );
+
+		auto moved = std::move( copy );
+		daw::expecting( 399U, moved.size( ) );
+		moved = shapes;
+		daw::expecting( 800, live_shapes );
+		moved.clear( );
+		daw::expecting( 400, live_shapes );
+		daw::expecting( moved.empty( ) );
+		daw::expecting_exception<std::out_of_range>(
+		  [&] { (void)moved.at( 0 ); } );
+	}
+	daw::expecting( 0, live_shapes );
+}
+
+void packed_poly_vector_test_002( ) {
+	{
+		auto shapes = daw::packed_poly_vector<Shape>( );
+		shapes.reserve_for<Unique>( 2 );
+		shapes.emplace_back<Unique>( 5 );
+		shapes.emplace_back<Unique>( 6 );
+		daw::expecting( 11.0, total_area( shapes ) );
+		daw::expecting_exception<std::logic_error>( [&] {
+			auto copy = shapes;
+			(void)copy;
+		} );
+		auto moved = std::move( shapes );
+		daw::expecting( 11.0, total_area( moved ) );
+	}
+	daw::expecting( 0, live_shapes );
+
+	auto arena = daw::arena_resource( );
+	{
+		using alloc_t = daw::arena_allocator<Shape>;
+		auto shapes = daw::packed_poly_vector<Shape, alloc_t>( alloc_t( arena ) );
+		for( int n = 0; n < 50; ++n ) {
+			shapes.emplace_back<Wide>( 1.0 );
+			shapes.emplace_back<Square>( 1.0 );
+		}
+		daw::expecting( 100.0, total_area( shapes ) );
+		daw::expecting( shapes.get_allocator( ).resource( ) == &arena );
+	}
+	daw::expecting( 0, live_shapes );
+}
+
+void packed_poly_vector_test_003( ) {
+	// Allocators that do not propagate and differ, so move assignment has to
+	// relocate each segment
+	auto res_a = std::pmr::monotonic_buffer_resource( );
+	auto res_b = std::pmr::monotonic_buffer_resource( );
+	using alloc_t = std::pmr::polymorphic_allocator<Shape>;
+	{
+		auto a = daw::packed_poly_vector<Shape, alloc_t>( alloc_t( &res_a ) );
+		auto b = daw::packed_poly_vector<Shape, alloc_t>( alloc_t( &res_b ) );
+		for( int n = 0; n < 10; ++n ) {
+			a.emplace_back<Named>( "a name long enough to allocate" );
+			a.emplace_back<Square>( 2.0 );
+		}
+		b = std::move( a );
+		daw::expecting( 20, live_shapes );
+		daw::expecting( 10U, b.count_of<Named>( ) );
+		daw::expecting( 10U, b.count_of<Square>( ) );
+		b.emplace_back<Square>( 3.0 );
+		daw::expecting( 30.0, b[0].area( ) );
+		daw::expecting( 9.0, b.back( ).area( ) );
+		daw::expecting( 10.0 * ( 30.0 + 4.0 ) + 9.0, total_area( b ) );
+	}
+	daw::expecting( 0, live_shapes );
+}
+
+void packed_poly_vector_bench_001( ) {
+	constexpr std::size_t count = 1'000'000;
+	auto rng = std::mt19937_64( 5 );
+	auto boxed = std::vector<std::unique_ptr<Shape>>( );
+	auto packed = daw::packed_poly_vector<Shape>( );
+	boxed.reserve( count );
+	packed.reserve( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		auto const size = static_cast<double>( rng( ) % 16U );
+		if( rng( ) % 2U == 0 ) {
+			boxed.push_back( std::make_unique<Square>( size ) );
+			packed.emplace_back<Square>( size );
+		} else {
+			boxed.push_back( std::make_unique<Circle>( size ) );
+			packed.emplace_back<Circle>( size );
+		}
+	}
+	daw::bench_n_test<10>( "vector<unique_ptr<Shape>>", [&] {
+		double result = 0.0;
+		for( auto const &s : boxed ) {
+			result += s->area( );
+		}
+		return result;
+	} );
+	daw::bench_n_test<10>( "packed_poly_vector in order",
+	                       [&] { return total_area( packed ); } );
+	daw::bench_n_test<10>( "packed_poly_vector by type", [&] {
+		double result = 0.0;
+		packed.for_each_by_type(
+		  [&]( Shape const &s ) { result += s.area( ); } );
+		return result;
+	} );
+}
+
 int main( ) {
 	daw_poly_vector_01( );
+	packed_poly_vector_test_001( );
+	packed_poly_vector_test_002( );
+	packed_poly_vector_test_003( );
+	packed_poly_vector_bench_001( );
 }
@@ -0,0 +1,135 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_radix_sort.h"
+#include "daw/daw_random.h"
+#include "daw/daw_sort_n.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+template<typename T>
+void test_integral( std::size_t count ) {
+	auto data = daw::make_random_data<T>( count );
+	data.push_back( std::numeric_limits<T>::min( ) );
+	data.push_back( std::numeric_limits<T>::max( ) );
+	data.push_back( 0 );
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	auto result = data;
+	daw::radix_sort( result.begin( ), result.end( ) );
+	daw::expecting( expected == result );
+
+	std::sort( expected.begin( ), expected.end( ), std::greater<>{ } );
+	result = data;
+	daw::radix_sort<daw::radix_order::descending>( result.begin( ),
+	                                               result.end( ) );
+	daw::expecting( expected == result );
+}
+
+void daw_radix_sort_integral_001( ) {
+	test_integral<std::uint8_t>( 1000 );
+	test_integral<std::int16_t>( 1000 );
+	test_integral<std::int32_t>( 10'000 );
+	test_integral<std::uint32_t>( 10'000 );
+	test_integral<std::int64_t>( 10'000 );
+	test_integral<std::uint64_t>( 10'000 );
+}
+
+void daw_radix_sort_float_001( ) {
+	std::vector<double> data{ 3.5,  -2.25, 0.0,   -0.0, 1e300, -1e300,
+	                          42.0, -42.0, 1e-10, -1e-10 };
+	auto values = daw::make_random_data<std::int32_t>( 1000 );
+	for( auto v : values ) {
+		data.push_back( static_cast<double>( v ) / 7.0 );
+	}
+	auto expected = data;
+	std::stable_sort( expected.begin( ), expected.end( ) );
+	daw::radix_sort( data.begin( ), data.end( ) );
+	daw::expecting( std::is_sorted( data.begin( ), data.end( ) ) );
+	daw::expecting( expected.size( ), data.size( ) );
+
+	std::vector<float> fdata{ 1.5f, -1.5f, 0.25f, -100.0f, 100.0f };
+	daw::radix_sort<daw::radix_order::descending>( fdata.begin( ), fdata.end( ) );
+	daw::expecting( std::is_sorted( fdata.begin( ), fdata.end( ),
+	                                std::greater<>{ } ) );
+}
+
+struct record_t {
+	std::int32_t key;
+	std::size_t position;
+};
+
+void daw_radix_sort_projection_001( ) {
+	auto keys = daw::make_random_data<std::int32_t>( 10'000, -50, 50 );
+	std::vector<record_t> data{ };
+	for( std::size_t n = 0; n < keys.size( ); ++n ) {
+		data.push_back( record_t{ keys[n], n } );
+	}
+	daw::radix_sort( data.begin( ), data.end( ), &record_t::key );
+	// Sorted by key and stable
+	daw::expecting( std::is_sorted( data.begin( ), data.end( ),
+	                                []( record_t const &lhs, record_t const &rhs ) {
+		                                if( lhs.key == rhs.key ) {
+			                                return lhs.position < rhs.position;
+		                                }
+		                                return lhs.key < rhs.key;
+	                                } ) );
+}
+
+void daw_sort_to_001( ) {
+	auto const data = daw::make_random_data<std::int64_t>( 10'000 );
+	std::vector<std::int64_t> result( data.size( ) );
+	daw::sort_to( data.begin( ), data.end( ), result.begin( ) );
+	daw::expecting( std::is_sorted( result.begin( ), result.end( ) ) );
+	daw::sort_to( data.begin( ), data.end( ), result.begin( ),
+	              std::greater<>{ } );
+	daw::expecting(
+	  std::is_sorted( result.begin( ), result.end( ), std::greater<>{ } ) );
+	daw::sort_to( data.begin( ), data.end( ), result.begin( ),
+	              []( auto lhs, auto rhs ) { return lhs < rhs; } );
+	daw::expecting( std::is_sorted( result.begin( ), result.end( ) ) );
+}
+
+void daw_radix_sort_bench_001( ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 100'000;
+#else
+	constexpr std::size_t data_size = 10'000'000;
+#endif
+	auto const data = daw::make_random_data<std::uint64_t>( data_size );
+	std::cout << "Sorting " << data_size << " uint64_t\n";
+	daw::bench_n_test<3>(
+	  "daw::radix_sort",
+	  []( auto values ) {
+		  daw::radix_sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "std::sort",
+	  []( auto values ) {
+		  std::sort( values.begin( ), values.end( ) );
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+}
+
+int main( ) {
+	daw_radix_sort_integral_001( );
+	daw_radix_sort_float_001( );
+	daw_radix_sort_projection_001( );
+	daw_sort_to_001( );
+	daw_radix_sort_bench_001( );
+}
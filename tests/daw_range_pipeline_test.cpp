@@ -0,0 +1,179 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_random.h"
+#include "daw/daw_range_collection.h"
+#include "daw/daw_range_pipeline.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+void daw_range_pipeline_fused_001( ) {
+	auto const values = std::vector<int>{ 5, 1, 4, 2, 3, 6, 8, 7 };
+	std::size_t calls = 0;
+	auto result = daw::range::lazy_from( values )
+	                .where( [&]( int v ) {
+		                ++calls;
+		                return v % 2 == 0;
+	                } )
+	                .transform( []( int v ) { return v * 10; } )
+	                .as_vector( );
+	daw::expecting( std::vector<int>{ 40, 20, 60, 80 }, result );
+	// A single pass over the source
+	daw::expecting( values.size( ), calls );
+}
+
+void daw_range_pipeline_lazy_001( ) {
+	auto const values = std::vector<int>{ 1, 2, 3 };
+	std::size_t calls = 0;
+	auto rng = daw::range::lazy_from( values ).where( [&]( int ) {
+		++calls;
+		return true;
+	} );
+	daw::expecting( 0U, calls );
+	daw::expecting( 3U, std::move( rng ).count( ) );
+	daw::expecting( 3U, calls );
+}
+
+void daw_range_pipeline_barrier_001( ) {
+	auto const values = std::vector<int>{ 5, 3, 5, 1, 9, 3, 2, 2, 8 };
+	auto result = daw::range::lazy_from( values )
+	                .erase( []( int v ) { return v == 9; } )
+	                .sort( )
+	                .unique( )
+	                .transform( []( int v ) { return v + 1; } )
+	                .where( []( int v ) { return v != 4; } )
+	                .sort( std::greater<>{ } )
+	                .as_vector( );
+	daw::expecting( std::vector<int>{ 9, 6, 3, 2 }, result );
+}
+
+void daw_range_pipeline_type_change_001( ) {
+	auto const values = std::vector<int>{ 3, 1, 2 };
+	auto result = daw::range::lazy_from( values )
+	                .sort( )
+	                .transform( []( int v ) { return std::to_string( v ); } )
+	                .transform( []( std::string const &s ) { return s + s; } )
+	                .as_vector( );
+	daw::expecting( std::vector<std::string>{ "11", "22", "33" }, result );
+}
+
+void daw_range_pipeline_owned_001( ) {
+	// Strings are moved along the pipeline, not copied
+	auto values = std::vector<std::string>{ "ccc", "a", "bb", "a", "dddd" };
+	auto result = daw::range::lazy_from( std::move( values ) )
+	                .where( []( std::string const &s ) { return s.size( ) < 4; } )
+	                .stable_sort( []( auto const &l, auto const &r ) {
+		                return l.size( ) < r.size( );
+	                } )
+	                .unique( )
+	                .as_vector( );
+	daw::expecting( std::vector<std::string>{ "a", "bb", "ccc" }, result );
+}
+
+void daw_range_pipeline_collection_001( ) {
+	auto const values = std::vector<int>{ 4, 3, 2, 1 };
+	auto rng = daw::range::from_mutable( values );
+	auto const sorted = rng.lazy( ).sort( ).as_vector( );
+	daw::expecting( std::vector<int>{ 1, 2, 3, 4 }, sorted );
+	daw::expecting( 4, *rng.begin( ) );
+
+	auto odd = std::move( rng )
+	             .lazy( )
+	             .where( []( int v ) { return v % 2 != 0; } )
+	             .as<daw::range::CollectionRange<int>>( );
+	daw::expecting( 2U, odd.size( ) );
+}
+
+void daw_range_pipeline_terminals_001( ) {
+	auto const values = std::list<int>{ 1, 2, 3, 4, 5 };
+	auto const sum = daw::range::lazy_from( values )
+	                   .transform( []( int v ) { return v * v; } )
+	                   .accumulate( 0 );
+	daw::expecting( 55, sum );
+
+	auto const set = daw::range::lazy_from( values.begin( ), values.end( ) )
+	                   .where( []( int v ) { return v > 2; } )
+	                   .as<std::set<int>>( );
+	daw::expecting( 3U, set.size( ) );
+
+	int last = 0;
+	daw::range::lazy_from( values )
+	  .partition( []( int v ) { return v % 2 == 0; } )
+	  .reserve( 5 )
+	  .for_each( [&]( int v ) { last = v; } );
+	daw::expecting( last % 2 != 0 );
+
+	auto g = std::mt19937( 42 );
+	auto shuffled =
+	  daw::range::lazy_from( values ).shuffle( g ).sort( ).as_vector( );
+	daw::expecting( std::vector<int>{ 1, 2, 3, 4, 5 }, shuffled );
+}
+
+void daw_range_pipeline_bench_001( ) {
+#if defined( DEBUG ) or not defined( NDEBUG )
+	constexpr std::size_t data_size = 100'000;
+#else
+	constexpr std::size_t data_size = 2'000'000;
+#endif
+	auto const values = daw::make_random_data<std::int32_t>( data_size, 0, 1000 );
+	auto const is_even = []( std::int32_t v ) { return v % 2 == 0; };
+	auto const add_one = []( std::int32_t v ) { return v + 1; };
+	auto const is_small = []( std::int32_t v ) { return v < 500; };
+
+	auto const eager = daw::bench_n_test_mbs<5>(
+	  "eager where/transform/where/sort/unique",
+	  data_size * sizeof( std::int32_t ),
+	  [&]( auto const &v ) {
+		  auto tmp = std::vector<std::int32_t>( );
+		  std::copy_if( v.begin( ), v.end( ), std::back_inserter( tmp ), is_even );
+		  std::transform( tmp.begin( ), tmp.end( ), tmp.begin( ), add_one );
+		  auto tmp2 = std::vector<std::int32_t>( );
+		  std::copy_if( tmp.begin( ), tmp.end( ), std::back_inserter( tmp2 ),
+		                is_small );
+		  std::sort( tmp2.begin( ), tmp2.end( ) );
+		  tmp2.erase( std::unique( tmp2.begin( ), tmp2.end( ) ), tmp2.end( ) );
+		  return tmp2;
+	  },
+	  values );
+	auto const lazy = daw::bench_n_test_mbs<5>(
+	  "lazy where/transform/where/sort/unique",
+	  data_size * sizeof( std::int32_t ),
+	  [&]( auto const &v ) {
+		  return daw::range::lazy_from( v )
+		    .where( is_even )
+		    .transform( add_one )
+		    .where( is_small )
+		    .sort( )
+		    .unique( )
+		    .as_vector( );
+	  },
+	  values );
+	daw::expecting( eager.get( ), lazy.get( ) );
+}
+
+int main( ) {
+	daw_range_pipeline_fused_001( );
+	daw_range_pipeline_lazy_001( );
+	daw_range_pipeline_barrier_001( );
+	daw_range_pipeline_type_change_001( );
+	daw_range_pipeline_owned_001( );
+	daw_range_pipeline_collection_001( );
+	daw_range_pipeline_terminals_001( );
+	daw_range_pipeline_bench_001( );
+}
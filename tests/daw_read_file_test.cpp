@@ -15,6 +15,7 @@
 #include <optional>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 void daw_read_file_001( std::string s ) {
 	auto f = daw::read_file( s );
@@ -22,6 +23,45 @@ void daw_read_file_001( std::string s ) {
 	std::cout << f->size( ) << '\n';
 }
 
+void daw_read_file_002( ) {
+	std::string const file_name = "./daw_read_file_test_002.txt";
+	std::string const expected( 100'000, 'a' );
+	{
+		std::ofstream out( file_name, std::ios::binary );
+		out << expected;
+	}
+	auto f = daw::read_file( file_name );
+	daw::expecting_message( f, "Could not read test file" );
+	daw::expecting( expected, *f );
+	// Sized once from fstat, not grown while looking for the end
+	daw::expecting( f->capacity( ) < 2U * expected.size( ) );
+	daw::expecting( not daw::read_file( "./file_does_not_exist.txt" ) );
+}
+
+void daw_read_files_001( std::string const &self ) {
+	std::vector<std::string> file_names{ };
+	for( std::size_t n = 0; n < 16; ++n ) {
+		file_names.push_back( "./daw_read_files_test_" + std::to_string( n ) +
+		                      ".txt" );
+		std::ofstream out( file_names.back( ), std::ios::binary );
+		out << std::string( n * 1000, static_cast<char>( 'a' + n ) );
+	}
+	file_names.push_back( "./file_does_not_exist.txt" );
+	file_names.push_back( self );
+
+	auto const batch = daw::read_files( file_names, 4 );
+	daw::expecting( file_names.size( ), batch.size( ) );
+	for( std::size_t n = 0; n < 16; ++n ) {
+		daw::expecting( batch[n] );
+		daw::expecting( std::string( n * 1000, static_cast<char>( 'a' + n ) ),
+		                std::string( *batch[n] ) );
+	}
+	daw::expecting( not batch[16] );
+	daw::expecting( *daw::read_file( self ), std::string( *batch[17] ) );
+}
+
 int main( int, char **argv ) {
 	daw_read_file_001( argv[0] );
+	daw_read_file_002( );
+	daw_read_files_001( argv[0] );
 }
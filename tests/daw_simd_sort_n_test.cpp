@@ -0,0 +1,178 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_random.h"
+#include "daw/daw_simd_sort_n.h"
+#include "daw/daw_sort_n.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+template<typename T>
+std::vector<T> make_values( std::size_t count ) {
+	if constexpr( std::is_floating_point_v<T> ) {
+		auto const ints = daw::make_random_data<std::int32_t>( count );
+		auto result = std::vector<T>( );
+		for( auto i : ints ) {
+			result.push_back( static_cast<T>( i ) / T{ 3 } );
+		}
+		return result;
+	} else {
+		auto result = daw::make_random_data<T>( count );
+		if( count > 2 ) {
+			// The extremes must sort correctly against the padding
+			result[0] = std::numeric_limits<T>::max( );
+			result[1] = std::numeric_limits<T>::min( );
+		}
+		return result;
+	}
+}
+
+template<typename T>
+void test_type( ) {
+	for( std::size_t count = 0; count <= 70; ++count ) {
+		auto data = make_values<T>( count );
+		auto expected = data;
+		std::sort( expected.begin( ), expected.end( ) );
+		daw::sort( data.begin( ), data.end( ) );
+		daw::expecting( expected == data );
+
+		data = make_values<T>( count );
+		expected = data;
+		std::sort( expected.begin( ), expected.end( ), std::greater<>{ } );
+		daw::sort( data.data( ), data.data( ) + data.size( ), std::greater<T>{ } );
+		daw::expecting( expected == data );
+	}
+	// Larger sorts use the network for their leaves
+	auto data = make_values<T>( 10'000 );
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	daw::sort( data.begin( ), data.end( ) );
+	daw::expecting( expected == data );
+}
+
+void daw_simd_sort_n_001( ) {
+	test_type<std::int32_t>( );
+	test_type<std::uint32_t>( );
+	test_type<float>( );
+	test_type<std::int64_t>( );
+	test_type<std::uint64_t>( );
+	test_type<double>( );
+}
+
+void daw_simd_sort_n_duplicates_001( ) {
+	auto data = daw::make_random_data<std::int32_t>( 64, 0, 3 );
+	auto expected = data;
+	std::sort( expected.begin( ), expected.end( ) );
+	daw::sort( data.begin( ), data.end( ) );
+	daw::expecting( expected == data );
+}
+
+// The bit patterns of values, sorted, to compare as a multiset
+template<typename T>
+std::vector<std::uint64_t> sorted_bits( std::vector<T> const &values ) {
+	auto result = std::vector<std::uint64_t>( );
+	for( auto v : values ) {
+		std::uint64_t bits = 0;
+		std::memcpy( &bits, &v, sizeof( T ) );
+		result.push_back( bits );
+	}
+	std::sort( result.begin( ), result.end( ) );
+	return result;
+}
+
+template<typename T>
+void test_float_specials( ) {
+	using limits = std::numeric_limits<T>;
+	T const specials[] = { T{ -0.0 },         T{ 0.0 },
+	                       limits::quiet_NaN( ), -limits::quiet_NaN( ),
+	                       limits::infinity( ),  -limits::infinity( ) };
+	for( std::size_t count = 8; count <= 64; ++count ) {
+		auto data = make_values<T>( count );
+		for( std::size_t n = 0; n < count; n += 2U ) {
+			data[n] = specials[( n / 2U ) % std::size( specials )];
+		}
+		auto const bits = sorted_bits( data );
+		auto const count_if = []( auto const &values, auto pred ) {
+			return std::count_if( values.begin( ), values.end( ), pred );
+		};
+		auto const neg_zero = []( T v ) { return v == 0 and std::signbit( v ); };
+		auto const pos_zero = []( T v ) {
+			return v == 0 and not std::signbit( v );
+		};
+		auto const is_nan = []( T v ) { return std::isnan( v ); };
+		auto const neg_zeros = count_if( data, neg_zero );
+		auto const pos_zeros = count_if( data, pos_zero );
+		auto const nans = count_if( data, is_nan );
+
+		auto ascending = data;
+		daw::sort( ascending.begin( ), ascending.end( ) );
+		auto descending = data;
+		daw::sort( descending.begin( ), descending.end( ), std::greater<>{ } );
+		for( auto const &sorted : { ascending, descending } ) {
+			daw::expecting( neg_zeros, count_if( sorted, neg_zero ) );
+			daw::expecting( pos_zeros, count_if( sorted, pos_zero ) );
+			daw::expecting( nans, count_if( sorted, is_nan ) );
+			daw::expecting( bits == sorted_bits( sorted ) );
+		}
+	}
+}
+
+void daw_simd_sort_n_float_specials_001( ) {
+	test_float_specials<float>( );
+	test_float_specials<double>( );
+}
+
+template<std::size_t N, typename T>
+void bench_size( ) {
+	constexpr std::size_t batches = 10'000;
+	auto const data = daw::make_random_data<T>( N * batches );
+	std::cout << N << " " << sizeof( T ) * 8U << "bit integers\n";
+	daw::bench_n_test<3>(
+	  "daw::sort",
+	  []( auto values ) {
+		  for( std::size_t n = 0; n < batches; ++n ) {
+			  daw::sort( values.data( ) + n * N, values.data( ) + ( n + 1U ) * N );
+		  }
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+	daw::bench_n_test<3>(
+	  "std::sort",
+	  []( auto values ) {
+		  for( std::size_t n = 0; n < batches; ++n ) {
+			  std::sort( values.data( ) + n * N, values.data( ) + ( n + 1U ) * N );
+		  }
+		  daw::do_not_optimize( values );
+	  },
+	  data );
+}
+
+void daw_simd_sort_n_bench_001( ) {
+	bench_size<16, std::int32_t>( );
+	bench_size<32, std::int32_t>( );
+	bench_size<64, std::int32_t>( );
+	bench_size<16, std::uint64_t>( );
+	bench_size<64, std::uint64_t>( );
+}
+
+int main( ) {
+	daw_simd_sort_n_001( );
+	daw_simd_sort_n_duplicates_001( );
+	daw_simd_sort_n_float_specials_001( );
+	daw_simd_sort_n_bench_001( );
+}
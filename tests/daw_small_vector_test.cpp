@@ -0,0 +1,188 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_memory_resource.h"
+#include "daw/daw_small_vector.h"
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Tracks how many are alive to catch leaks and double destroys
+	struct counted {
+		static inline int live = 0;
+		std::string value;
+
+		counted( std::string v )
+		  : value( std::move( v ) ) {
+			++live;
+		}
+
+		counted( counted const &other )
+		  : value( other.value ) {
+			++live;
+		}
+
+		counted( counted &&other ) noexcept
+		  : value( std::move( other.value ) ) {
+			++live;
+		}
+
+		counted &operator=( counted const & ) = default;
+		counted &operator=( counted && ) = default;
+
+		~counted( ) {
+			--live;
+		}
+	};
+} // namespace
+
+namespace daw {
+	template<typename T>
+	struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+} // namespace daw
+
+void daw_small_vector_test_001( ) {
+	daw::small_vector<int, 4> a{ };
+	a.push_back( 1 );
+	a.push_back( 2 );
+	a.push_back( 4 );
+	a.emplace_back( 8 );
+	daw::expecting( a.is_inline( ) );
+	daw::expecting( a.full( ) );
+	a.push_back( 16 );
+	daw::expecting( not a.is_inline( ) );
+	daw::expecting( 5U, a.size( ) );
+	int sum = 0;
+	for( auto c : a ) {
+		sum += c;
+	}
+	daw::expecting( 31, sum );
+	daw::expecting( 16, a.pop_back( ) );
+	daw::expecting( 8, a.back( ) );
+	daw::expecting( 1, a.front( ) );
+	daw::expecting_exception<std::out_of_range>( [&] { (void)a.at( 4 ); } );
+
+	// Back inside once it fits
+	a.shrink_to_fit( );
+	daw::expecting( a.is_inline( ) );
+	daw::expecting( 4U, a.capacity( ) );
+	daw::expecting( 8, a[3] );
+
+	auto it = a.erase( a.begin( ) + 1 );
+	daw::expecting( 4, *it );
+	daw::expecting( ( daw::small_vector<int, 4>{ 1, 4, 8 } ), a );
+	a.erase( a.begin( ), a.end( ) );
+	daw::expecting( a.empty( ) );
+}
+
+void daw_small_vector_test_002( ) {
+	{
+		daw::small_vector<counted, 2> a;
+		a.emplace_back( "one" );
+		a.emplace_back( "two" );
+		// An argument referring to an element survives the growth
+		a.push_back( a[0] );
+		daw::expecting( std::string( "one" ), a[2].value );
+		daw::expecting( 3, counted::live );
+
+		auto b = a;
+		daw::expecting( 6, counted::live );
+		auto c = std::move( b );
+		daw::expecting( b.empty( ) );
+		daw::expecting( 6, counted::live );
+
+		daw::small_vector<counted, 2> d;
+		d.emplace_back( "inline" );
+		auto e = std::move( d );
+		daw::expecting( e.is_inline( ) );
+		daw::expecting( std::string( "inline" ), e[0].value );
+		e = c;
+		daw::expecting( 3U, e.size( ) );
+		e = std::move( d );
+		daw::expecting( e.empty( ) );
+		daw::expecting( 6, counted::live );
+
+		a.erase( a.begin( ) + 1, a.end( ) );
+		a.resize( 3, counted( "fill" ) );
+		daw::expecting( std::string( "fill" ), a[2].value );
+		a.assign( 5, a[0] );
+		daw::expecting( std::string( "one" ), a[4].value );
+		swap( a, c );
+		daw::expecting( 3U, a.size( ) );
+		daw::expecting( 5U, c.size( ) );
+	}
+	daw::expecting( 0, counted::live );
+}
+
+void daw_small_vector_test_003( ) {
+	daw::small_vector<std::unique_ptr<int>, 2> a;
+	for( int n = 0; n < 20; ++n ) {
+		a.push_back( std::make_unique<int>( n ) );
+	}
+	for( int n = 0; n < 20; ++n ) {
+		daw::expecting( n, *a[static_cast<std::size_t>( n )] );
+	}
+	auto b = std::move( a );
+	daw::expecting( 19, *b.back( ) );
+}
+
+void daw_small_vector_allocator_001( ) {
+	auto pool = daw::pool_resource( );
+	using alloc_t = daw::pool_allocator<std::string>;
+	auto a = daw::small_vector<std::string, 2, alloc_t>( alloc_t( pool ) );
+	for( int n = 0; n < 10; ++n ) {
+		a.push_back( std::to_string( n ) );
+	}
+	daw::expecting( std::string( "9" ), a.back( ) );
+	daw::expecting( a.get_allocator( ).resource( ) == &pool );
+	// A different resource means the elements are moved, not the buffer
+	auto other = daw::pool_resource( );
+	auto b = daw::small_vector<std::string, 2, alloc_t>( std::move( a ),
+	                                                    alloc_t( other ) );
+	daw::expecting( a.empty( ) );
+	daw::expecting( 10U, b.size( ) );
+	daw::expecting( std::string( "9" ), b.back( ) );
+	daw::expecting( b.get_allocator( ).resource( ) == &other );
+}
+
+void daw_small_vector_bench_001( ) {
+	constexpr std::size_t count = 100'000;
+	daw::bench_n_test<10>( "std::vector<int> x 100k of 3", [&] {
+		std::vector<std::vector<int>> values( count );
+		for( auto &v : values ) {
+			v.push_back( 1 );
+			v.push_back( 2 );
+			v.push_back( 3 );
+		}
+		return values.size( );
+	} );
+	daw::bench_n_test<10>( "daw::small_vector<int, 4> x 100k of 3", [&] {
+		std::vector<daw::small_vector<int, 4>> values( count );
+		for( auto &v : values ) {
+			v.push_back( 1 );
+			v.push_back( 2 );
+			v.push_back( 3 );
+		}
+		return values.size( );
+	} );
+}
+
+int main( ) {
+	daw_small_vector_test_001( );
+	daw_small_vector_test_002( );
+	daw_small_vector_test_003( );
+	daw_small_vector_allocator_001( );
+	daw_small_vector_bench_001( );
+}
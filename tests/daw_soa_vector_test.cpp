@@ -0,0 +1,210 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/header_libraries
+//
+
+#include "daw/daw_benchmark.h"
+#include "daw/daw_memory_resource.h"
+#include "daw/daw_soa_vector.h"
+#include "daw/daw_zipcontainer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+	bool is_aligned( void const *ptr, std::size_t alignment ) {
+		return reinterpret_cast<std::uintptr_t>( ptr ) % alignment == 0;
+	}
+
+	// Relocated by copying, which throws while armed
+	struct throwing_copy {
+		static inline bool armed = false;
+		int value = 0;
+
+		throwing_copy( int v )
+		  : value( v ) {}
+
+		throwing_copy( throwing_copy const &other )
+		  : value( other.value ) {
+			if( armed ) {
+				throw std::runtime_error( "copy" );
+			}
+		}
+
+		throwing_copy &operator=( throwing_copy const & ) = default;
+	};
+} // namespace
+
+void soa_vector_test_001( ) {
+	auto v = daw::soa_vector<int, std::string, double>( );
+	daw::expecting( v.empty( ) );
+	for( int n = 0; n < 100; ++n ) {
+		v.push_back( n, std::to_string( n ), n * 0.5 );
+	}
+	v.emplace_back( 100, "one hundred", 50.0 );
+	daw::expecting( 101U, v.size( ) );
+	daw::expecting( is_aligned( v.column_data<0>( ), 64 ) );
+	daw::expecting( is_aligned( v.column_data<1>( ), 64 ) );
+	daw::expecting( is_aligned( v.column_data<2>( ), 64 ) );
+
+	auto [i, s, d] = v[42];
+	daw::expecting( 42, i );
+	daw::expecting( std::string( "42" ), s );
+	daw::expecting( 21.0, d );
+	// Rows are references into the columns
+	std::get<0>( v[42] ) = -1;
+	daw::expecting( -1, v.column<0>( )[42] );
+	daw::expecting( std::string( "one hundred" ), std::get<1>( v.back( ) ) );
+
+	int sum = 0;
+	for( auto row : v ) {
+		sum += std::get<0>( row );
+	}
+	daw::expecting( 4950 - 42 - 1 + 100, sum );
+
+	double total = 0.0;
+	for( auto [id, value] : v.columns<0, 2>( ) ) {
+		total += id >= 0 ? value : 0.0;
+	}
+	daw::expecting( 2475.0 - 21.0 + 50.0, total );
+
+	auto copy = v;
+	v.pop_back( );
+	daw::expecting( 100U, v.size( ) );
+	daw::expecting( 101U, copy.size( ) );
+	daw::expecting( std::string( "99" ), std::get<1>( copy[99] ) );
+	auto moved = std::move( copy );
+	daw::expecting( copy.empty( ) );
+	daw::expecting( 101U, moved.size( ) );
+	v = moved;
+	daw::expecting( 101U, v.size( ) );
+	v.resize( 10 );
+	daw::expecting( 10U, v.size( ) );
+	v.resize( 12 );
+	daw::expecting( std::string( ), std::get<1>( v[11] ) );
+	v.shrink_to_fit( );
+	daw::expecting( 12U, v.capacity( ) );
+	daw::expecting_exception<std::out_of_range>( [&] { (void)v.at( 12 ); } );
+	v.clear( );
+	daw::expecting( v.empty( ) );
+}
+
+void soa_vector_test_002( ) {
+	// Move only columns and a memory resource
+	auto arena = daw::arena_resource( );
+	using alloc_t = daw::arena_allocator<int>;
+	auto v = daw::basic_soa_vector<alloc_t, int, std::unique_ptr<int>>(
+	  alloc_t( arena ) );
+	v.reserve( 4 );
+	daw::expecting( 4U, v.capacity( ) );
+	for( int n = 0; n < 10; ++n ) {
+		v.emplace_back( n, std::make_unique<int>( n * n ) );
+	}
+	daw::expecting( 81, *std::get<1>( v[9] ) );
+	daw::expecting( v.get_allocator( ).resource( ) == &arena );
+	auto other = std::move( v );
+	daw::expecting( 10U, other.size( ) );
+
+	// Zipping existing storage
+	auto a = std::vector<int>{ 1, 2, 3 };
+	auto b = std::vector<int>{ 10, 20, 30 };
+	int dot = 0;
+	auto zipped = daw::make_zipcontainer( daw::span<int>( a.data( ), 3 ),
+	                                      daw::span<int>( b.data( ), 3 ) );
+	for( auto [x, y] : zipped ) {
+		dot += x * y;
+	}
+	daw::expecting( 140, dot );
+}
+
+void soa_vector_test_003( ) {
+	// Arguments that refer to a row survive the growth they cause
+	auto v = daw::soa_vector<std::string, int>( );
+	v.push_back( "a string long enough to be on the heap", 1 );
+	while( v.size( ) < v.capacity( ) ) {
+		v.push_back( "filler", 0 );
+	}
+	for( int n = 0; n < 3; ++n ) {
+		v.push_back( std::get<0>( v[0] ), std::get<1>( v[0] ) );
+		daw::expecting( std::get<0>( v[0] ), std::get<0>( v.back( ) ) );
+		v.emplace_back( std::get<0>( v[0] ), std::get<1>( v[0] ) );
+		while( v.size( ) < v.capacity( ) ) {
+			v.push_back( "filler", 0 );
+		}
+	}
+}
+
+void soa_vector_test_004( ) {
+	// A throwing copy in one column leaves the moved columns whole
+	auto v = daw::soa_vector<std::string, throwing_copy>( );
+	v.reserve( 4 );
+	v.push_back( "first string long enough to be on the heap", 1 );
+	while( v.size( ) < v.capacity( ) ) {
+		v.push_back( "second string long enough to be on the heap", 2 );
+	}
+	auto const size = v.size( );
+	daw::expecting( 4U, size );
+	throwing_copy::armed = true;
+	daw::expecting_exception<std::runtime_error>(
+	  [&] { v.push_back( "third", 3 ); } );
+	daw::expecting_exception<std::runtime_error>( [&] { v.reserve( 100 ); } );
+	throwing_copy::armed = false;
+	daw::expecting( size, v.size( ) );
+	daw::expecting( std::string( "first string long enough to be on the heap" ),
+	                std::get<0>( v[0] ) );
+	daw::expecting( std::string( "second string long enough to be on the heap" ),
+	                std::get<0>( v.back( ) ) );
+	daw::expecting( 2, std::get<1>( v.back( ) ).value );
+	v.push_back( "third", 3 );
+	daw::expecting( std::get<0>( v[0] ).size( ) > 5U );
+}
+
+void soa_vector_bench_001( ) {
+	constexpr std::size_t count = 1'000'000;
+	struct particle {
+		double x, y, z;
+		double vx, vy, vz;
+		double mass;
+		std::uint64_t id;
+	};
+	auto aos = std::vector<particle>( count );
+	auto soa = daw::soa_vector<double, double, double, double, double, double,
+	                           double, std::uint64_t>( );
+	soa.reserve( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		auto const f = static_cast<double>( n );
+		aos[n] = { f, f, f, 1.0, 2.0, 3.0, 1.0, n };
+		soa.push_back( f, f, f, 1.0, 2.0, 3.0, 1.0, n );
+	}
+	daw::bench_n_test<10>( "aos x += vx", [&] {
+		for( particle &p : aos ) {
+			p.x += p.vx;
+		}
+		return aos[0].x;
+	} );
+	daw::bench_n_test<10>( "soa x += vx", [&] {
+		auto x = soa.column<0>( );
+		auto const vx = soa.column<3>( );
+		for( std::size_t n = 0; n < x.size( ); ++n ) {
+			x[n] += vx[n];
+		}
+		return x[0];
+	} );
+}
+
+int main( ) {
+	soa_vector_test_001( );
+	soa_vector_test_002( );
+	soa_vector_test_003( );
+	soa_vector_test_004( );
+	soa_vector_bench_001( );
+}
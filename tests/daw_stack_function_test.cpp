@@ -10,8 +10,14 @@
 #include "daw/daw_stack_function.h"
 #include "daw/daw_utility.h"
 
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 std::string strfunc( ) {
 	return "Goodbye";
@@ -82,7 +88,126 @@ void stack_function_test_002( ) {
 	fcvf1( );
 }
 
+void stack_function_test_003( ) {
+	auto const counter = std::make_shared<int>( 0 );
+	{
+		// Not trivially copyable, so copies go through the manager
+		daw::function<64, int( int )> f = [counter, s = std::string( 40, 'a' )](
+		                                    int x ) {
+			++*counter;
+			return x + static_cast<int>( s.size( ) );
+		};
+		daw::expecting( 2L, counter.use_count( ) );
+		auto g = f;
+		daw::expecting( 3L, counter.use_count( ) );
+		auto h = std::move( g );
+		daw::expecting( 3L, counter.use_count( ) );
+		daw::expecting( g.empty( ) );
+		daw::expecting( 41, h( 1 ) );
+		g = h;
+		daw::expecting( 42, g( 2 ) );
+		daw::expecting( 2, *counter );
+		// A larger function can hold a copy of a smaller one
+		daw::function<128, int( int )> big = f;
+		daw::expecting( 43, big( 3 ) );
+		daw::expecting( 5L, counter.use_count( ) );
+		f = nullptr;
+		daw::expecting( not f );
+		daw::expecting_exception<std::bad_function_call>( [&] { (void)f( 1 ); } );
+	}
+	daw::expecting( 1L, counter.use_count( ) );
+}
+
+void stack_function_test_004( ) {
+	// Trivially copyable, copied with memcpy
+	int total = 0;
+	daw::function<32, void( int )> f = [&total]( int x ) { total += x; };
+	auto g = f;
+	f( 1 );
+	g( 2 );
+	daw::expecting( 3, total );
+	int ( *fp )( int ) = nullptr;
+	daw::function<32, int( int )> from_null = fp;
+	daw::expecting( from_null.empty( ) );
+	daw::function<32, int( std::unique_ptr<int> )> take =
+	  []( std::unique_ptr<int> p ) { return *p; };
+	daw::expecting( 7, take( std::make_unique<int>( 7 ) ) );
+}
+
+void stack_function_test_005( ) {
+	// The callable fills all of the smaller function's storage
+	auto const counter = std::make_shared<int>( 0 );
+	auto const fill = [counter, pad = std::array<char, 48>{ }]( int x ) {
+		return x + static_cast<int>( pad.size( ) );
+	};
+	static_assert( sizeof( fill ) > 56 );
+	{
+		daw::function<64, int( int )> f = fill;
+		daw::function<72, int( int )> g = f;
+		daw::expecting( 49, g( 1 ) );
+		daw::expecting( 4L, counter.use_count( ) );
+
+		daw::function<128, int( int )> m = std::move( f );
+		daw::expecting( f.empty( ) );
+		daw::expecting( 50, m( 2 ) );
+		daw::expecting( 4L, counter.use_count( ) );
+
+		f = fill;
+		g = f;
+		m = std::move( f );
+		daw::expecting( f.empty( ) );
+		daw::expecting( 51, m( 3 ) );
+		daw::expecting( 4L, counter.use_count( ) );
+	}
+	daw::expecting( 2L, counter.use_count( ) );
+}
+
+int call_ref( daw::function_ref<int( int )> f, int x ) {
+	// Copying a function_ref copies the reference
+	auto copy = f;
+	return copy( x );
+}
+
+void function_ref_test_001( ) {
+	static_assert( sizeof( daw::function_ref<int( int )> ) ==
+	               2U * sizeof( void * ) );
+	int offset = 10;
+	auto add = [&offset]( int x ) { return x + offset; };
+	daw::expecting( 15, call_ref( add, 5 ) );
+	daw::function<32, int( int )> const f = add;
+	daw::expecting( 16, call_ref( f, 6 ) );
+}
+
+void stack_function_bench_001( ) {
+	constexpr std::size_t count = 1'000'000;
+	auto events = std::vector<int>( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		events[n] = static_cast<int>( n % 7U );
+	}
+	long long sum = 0;
+	auto const handler = [&sum]( int e ) { sum += e; };
+	std::function<void( int )> const sf = handler;
+	daw::function<32, void( int )> const df = handler;
+	daw::bench_n_test<10>( "std::function dispatch", [&] {
+		for( int e : events ) {
+			sf( e );
+		}
+		return sum;
+	} );
+	daw::bench_n_test<10>( "daw::function dispatch", [&] {
+		for( int e : events ) {
+			df( e );
+		}
+		return sum;
+	} );
+}
+
 int main( ) {
 	stack_function_test_001( );
 	stack_function_test_002( );
+	stack_function_test_003( );
+	stack_function_test_004( );
+	stack_function_test_005( );
+	function_ref_test_001( );
+	stack_function_bench_001( );
 }
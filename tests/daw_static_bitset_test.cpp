@@ -6,8 +6,15 @@
 // Official repository: https://github.com/beached/header_libraries
 //
 
+#include <algorithm>
 #include <bitset>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include "daw/daw_benchmark.h"
 #include "daw/daw_static_bitset.h"
@@ -21,42 +28,254 @@ static_assert( []( ) {
 	return true;
 }( ) );
 
-bool test_001( ) noexcept {
+constexpr bool test_001( ) noexcept {
 	daw::static_bitset<128> b2(
 	  0U, 0b1000000000000000000000000000000000000000000000000000000000000000 );
 	return 127U == b2.zero_count( );
 };
-// static_assert( test_001( ) );
+static_assert( test_001( ) );
 
-bool test_002( ) noexcept {
+constexpr bool test_002( ) noexcept {
 	daw::static_bitset<64> f( 0xFFFF'FFFF'FFFF'FFFF );
 	f >>= 33U;
 	daw::expecting( 31U, f.one_count( ) );
 	return true;
 };
-// static_assert( test_002( ) );
+static_assert( test_002( ) );
+
+static_assert( []( ) {
+	// Top bit masking to BitWidth
+	daw::static_bitset<16> h1( 0xDEAD'BEEF );
+	daw::static_bitset<16> h2( 0xBEEF );
+	daw::expecting( h1 == h2 );
+	return true;
+}( ) );
+
+static_assert( []( ) {
+	daw::static_bitset<100> b{ };
+	daw::expecting( b.none( ) );
+	daw::expecting( 100U, b.find_first( ) );
+	b.set_bit( 3 );
+	b.set_bit( 64 );
+	b.set_bit( 99 );
+	daw::expecting( b.any( ) );
+	daw::expecting( b.get_bit( 64 ) );
+	daw::expecting( not b.get_bit( 63 ) );
+	daw::expecting( 3U, b.find_first( ) );
+	daw::expecting( 64U, b.find_next( 3 ) );
+	daw::expecting( 99U, b.find_next( 64 ) );
+	daw::expecting( 100U, b.find_next( 99 ) );
+	b.clear_bit( 64 );
+	daw::expecting( 99U, b.find_next( 3 ) );
+	// Bits past BitWidth are not set by flipping
+	daw::expecting( 98U, ( ~b ).count( ) );
+	daw::expecting( ( ~~b ) == b );
+	return true;
+}( ) );
+
+static_assert( []( ) {
+	daw::static_bitset<130> b{ };
+	b.set_bit( 0 );
+	b <<= 65U;
+	daw::expecting( 65U, b.find_first( ) );
+	b <<= 64U;
+	daw::expecting( 129U, b.find_first( ) );
+	b <<= 1U;
+	daw::expecting( b.none( ) );
+	b.set_bit( 129 );
+	b >>= 66U;
+	daw::expecting( 63U, b.find_first( ) );
+	b >>= 63U;
+	daw::expecting( 0U, b.find_first( ) );
+	return true;
+}( ) );
+
+// Large enough for the runtime vector paths, which constant evaluation
+// does not take
+static_assert( []( ) {
+	daw::static_bitset<600> a{ };
+	daw::static_bitset<600> b{ };
+	a.set_bit( 10 );
+	a.set_bit( 590 );
+	b.set_bit( 590 );
+	daw::expecting( 2U, a.count( ) );
+	daw::expecting( 590U, a.find_next( 10 ) );
+	daw::expecting( 1U, ( a & b ).count( ) );
+	daw::expecting( 598U, ( ~a ).count( ) );
+	a.and_not( b );
+	daw::expecting( 10U, a.find_first( ) );
+	daw::expecting( a != b );
+	return true;
+}( ) );
+
+// Checks against std::bitset on random bits
+template<std::size_t N>
+void check_random( unsigned seed ) {
+	auto rng = std::mt19937_64( seed );
+	auto const make = [&]( auto density ) {
+		auto dist = std::bernoulli_distribution( density );
+		std::bitset<N> expected{ };
+		daw::static_bitset<N> result{ };
+		for( std::size_t n = 0; n < N; ++n ) {
+			if( dist( rng ) ) {
+				expected.set( n );
+				result.set_bit( n );
+			}
+		}
+		return std::pair{ expected, result };
+	};
+	for( double density : { 0.0, 0.001, 0.1, 0.5, 1.0 } ) {
+		auto [e1, r1] = make( density );
+		auto [e2, r2] = make( 0.5 );
+		daw::expecting( e1.count( ), r1.count( ) );
+		daw::expecting( e1.any( ), r1.any( ) );
+		daw::expecting( e1.none( ), r1.none( ) );
+		daw::expecting( e1.all( ), r1.all( ) );
+		daw::expecting( e1.to_string( ), r1.to_string( ) );
+
+		auto positions = std::vector<std::size_t>( );
+		for( std::size_t pos : r1.set_bits( ) ) {
+			positions.push_back( pos );
+		}
+		auto expected_positions = std::vector<std::size_t>( );
+		for( std::size_t n = 0; n < N; ++n ) {
+			if( e1.test( n ) ) {
+				expected_positions.push_back( n );
+			}
+		}
+		daw::expecting( expected_positions == positions );
+		auto found = std::vector<std::size_t>( );
+		for( auto pos = r1.find_first( ); pos < N; pos = r1.find_next( pos ) ) {
+			found.push_back( pos );
+		}
+		daw::expecting( expected_positions == found );
+
+		daw::expecting( ( e1 & e2 ).to_string( ), ( r1 & r2 ).to_string( ) );
+		daw::expecting( ( e1 | e2 ).to_string( ), ( r1 | r2 ).to_string( ) );
+		daw::expecting( ( e1 ^ e2 ).to_string( ), ( r1 ^ r2 ).to_string( ) );
+		daw::expecting( ( ~e1 ).to_string( ), ( ~r1 ).to_string( ) );
+		daw::expecting( ( e1 & ~e2 ).to_string( ),
+		                daw::static_bitset<N>( r1 ).and_not( r2 ).to_string( ) );
+		for( std::size_t shift : { 1U, 63U, 64U, 65U, 200U } ) {
+			auto r = r1;
+			r <<= shift;
+			daw::expecting( ( e1 << shift ).to_string( ), r.to_string( ) );
+			r = r1;
+			r >>= shift;
+			daw::expecting( ( e1 >> shift ).to_string( ), r.to_string( ) );
+		}
+		daw::expecting( r1 == r1 );
+		daw::expecting( ( e1 == e2 ) == ( r1 == r2 ) );
+	}
+}
+
+void iterator_test_001( ) {
+	daw::static_bitset<70> b{ };
+	b[69] = true;
+	b[1] = true;
+	b[1] = b[69];
+	daw::expecting( b.get_bit( 1 ) );
+	b[69].flip( );
+	daw::expecting( not b[69] );
+	daw::expecting( 70, std::distance( b.begin( ), b.end( ) ) );
+	daw::expecting( 1, std::count( b.cbegin( ), b.cend( ), true ) );
+	for( auto bit : b ) {
+		bit = true;
+	}
+	daw::expecting( b.all( ) );
+	daw::expecting( *b.rbegin( ) );
+	auto it = b.begin( );
+	it += 5;
+	*it = false;
+	auto const first_clear = std::find( b.cbegin( ), b.cend( ), false );
+	daw::expecting( 5, first_clear - b.cbegin( ) );
+}
+
+void comparison_test_001( ) {
+	daw::static_bitset<64> small( 0xF0U );
+	daw::static_bitset<300> large( small );
+	daw::expecting( small == large );
+	daw::expecting( large == small );
+	large.set_bit( 200 );
+	daw::expecting( small != large );
+	daw::expecting( large != small );
+	daw::expecting( 5U, ( large | small ).count( ) );
+	daw::expecting( 4U, ( large & small ).count( ) );
+	daw::expecting( 1U, ( large ^ small ).count( ) );
+}
+
+void bench_001( ) {
+	constexpr std::size_t bits = 65'536;
+	auto rng = std::mt19937_64( 1 );
+	auto mask = daw::static_bitset<bits>( );
+	auto other = daw::static_bitset<bits>( );
+	auto std_mask = std::bitset<bits>( );
+	for( std::size_t n = 0; n < bits; ++n ) {
+		if( rng( ) % 64U == 0 ) {
+			mask.set_bit( n );
+			std_mask.set( n );
+		}
+		if( rng( ) % 2U == 0 ) {
+			other.set_bit( n );
+		}
+	}
+	constexpr std::size_t bytes = bits / 8U;
+	daw::bench_n_test_mbs<100>(
+	  "std::bitset count", bytes,
+	  []( auto const &b ) { return b.count( ); }, std_mask );
+	daw::bench_n_test_mbs<100>(
+	  "count", bytes, []( auto const &b ) { return b.count( ); }, mask );
+	daw::bench_n_test_mbs<100>(
+	  "std::bitset scan", bytes,
+	  []( auto const &b ) {
+		  std::size_t sum = 0;
+		  for( std::size_t n = 0; n < b.size( ); ++n ) {
+			  if( b.test( n ) ) {
+				  sum += n;
+			  }
+		  }
+		  return sum;
+	  },
+	  std_mask );
+	daw::bench_n_test_mbs<100>(
+	  "set_bits scan", bytes,
+	  []( auto const &b ) {
+		  std::size_t sum = 0;
+		  for( std::size_t pos : b.set_bits( ) ) {
+			  sum += pos;
+		  }
+		  return sum;
+	  },
+	  mask );
+	daw::bench_n_test_mbs<100>(
+	  "&=", bytes * 2U,
+	  [&]( auto b ) {
+		  b &= other;
+		  return b.any( );
+	  },
+	  mask );
+}
 
 int main( ) {
-	auto tst2 = test_002( );
 	daw::static_bitset<128> a( std::numeric_limits<uintmax_t>::max( ) );
-
-	auto ac = a.one_count( );
+	daw::expecting( 64U, a.one_count( ) );
 
 	daw::static_bitset<64> e( 0xFFFF'FFFF'FFFF'FFFF );
 	e <<= 5U;
+	daw::expecting( 59U, e.one_count( ) );
 	std::cout << e << '\n';
 
 	daw::static_bitset<64> g( 0xFFFF'FFFF'FFFF'FFFF );
 	g >>= 64;
 	daw::expecting( 0U, g.one_count( ) );
-	/*
-	  static_assert( []( ) {
-	    // Top bit masking to BitWidth
-	    daw::static_bitset<16> h1( 0xDEAD'BEEF );
-	    daw::static_bitset<16> h2( 0xBEEF );
-	    daw::expecting( h1, h2 );
-	    return true;
-	  }( ) );*/
-
-	std::cout << '\n';
+
+	check_random<1>( 1 );
+	check_random<64>( 2 );
+	check_random<100>( 3 );
+	check_random<256>( 4 );
+	check_random<1000>( 5 );
+	check_random<10'007>( 6 );
+	iterator_test_001( );
+	comparison_test_001( );
+	bench_001( );
 }